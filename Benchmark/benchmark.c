@@ -0,0 +1,153 @@
+/*!****************************************************************************
+ * @file
+ * benchmark.c
+ *
+ * @brief
+ * Cycle time base, interrupt load and reporting for benchmark kernels
+ *
+ * Kernels are timed with the cycle time base ("Timebase/timebase.h"): the
+ * DWT cycle counter on hardware and in armsim, SysTick in QEMU. Results are
+ * reported as test case metrics (see "Testing/testing.h").
+ *
+ * The interrupt load is generated by TIM2 update interrupts, for measurements
+ * under load (e.g. delay accuracy).
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "stm32f1xx.h"
+#include "testing.h"
+#include "timebase.h"
+#include "benchmark.h"
+
+
+/*- Global data --------------------------------------------------------------*/
+static volatile uint32_t s_ulLoadCount; ///< Load interrupts since the start
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Get cycle timestamp
+ *
+ * @return  (uint32_t)  Core clock cycles, wrapping at 2^32
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Benchmark_ulCycles(void)
+{
+  return (uint32_t)Timebase_ullCycles();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get wall-clock timestamp
+ *
+ * Based on the HAL tick and the SysTick counter, so timestamps remain
+ * comparable across core clock changes (e.g. the dump clock boost). Not valid
+ * during clock switches and tickless sleeps, which reprogram SysTick.
+ *
+ * @return  (uint64_t)  Microseconds since the start of the HAL tick
+ * @date  17.10.2026
+ ******************************************************************************/
+uint64_t Benchmark_ullWallUs(void)
+{
+  uint32_t ulTick, ulValue, ulReload;
+  do
+  {
+    ulTick = uwTick;
+    ulValue = SysTick->VAL;
+    ulReload = SysTick->LOAD;
+  } while (ulTick != uwTick);
+
+  uint64_t ullTickUs = 1000uLL * (uint32_t)uwTickFreq;
+  return ((uint64_t)ulTick * 1000uLL) + (((uint64_t)(ulReload - ulValue) * ullTickUs) / (ulReload + 1uLL));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of kernel iterations
+ *
+ * @return  (uint32_t)  "iterations=" parameter, or @c BENCHMARK_ITERATIONS
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Benchmark_ulIterations(void)
+{
+  int32_t lIterations = Testing_lParam("iterations", BENCHMARK_ITERATIONS);
+  return (lIterations > 0) ? (uint32_t)lIterations : 1uL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Report duration of a kernel
+ *
+ * Reports the metrics "cycles" (per iteration) and "total_cycles".
+ *
+ * @param[in] ulStart       Timestamp before the first iteration
+ * @param[in] ulIterations  Number of iterations
+ * @date  17.10.2026
+ ******************************************************************************/
+void Benchmark_vReport(uint32_t ulStart, uint32_t ulIterations)
+{
+  uint32_t ulCycles = Benchmark_ulCycles() - ulStart;
+  Testing_vMetric("cycles", ulCycles / ulIterations);
+  Testing_vMetric("total_cycles", ulCycles);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Start periodic interrupt load
+ *
+ * TIM2 update interrupts at the highest priority; the timer counts micro-
+ * seconds.
+ *
+ * @param[in] ulPeriodUs  Interrupt period in microseconds (2 or more)
+ * @date  17.10.2026
+ ******************************************************************************/
+void Benchmark_vStartLoad(uint32_t ulPeriodUs)
+{
+  // Timer clock is PCLK1, doubled if APB1 is divided
+  uint32_t ulClock = HAL_RCC_GetPCLK1Freq();
+  if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) ulClock *= 2uL;
+
+  __HAL_RCC_TIM2_CLK_ENABLE();
+  TIM2->CR1 = 0uL;
+  TIM2->PSC = (ulClock / 1000000uL) - 1uL;
+  TIM2->ARR = ((ulPeriodUs >= 2uL) ? ulPeriodUs : 2uL) - 1uL;
+  TIM2->EGR = TIM_EGR_UG;
+  TIM2->SR = 0uL;
+  TIM2->DIER = TIM_DIER_UIE;
+  s_ulLoadCount = 0uL;
+  NVIC_SetPriority(TIM2_IRQn, 0uL);
+  NVIC_ClearPendingIRQ(TIM2_IRQn);
+  NVIC_EnableIRQ(TIM2_IRQn);
+  TIM2->CR1 = TIM_CR1_CEN;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Stop periodic interrupt load
+ *
+ * @return  (uint32_t)  Number of load interrupts since the start
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Benchmark_ulStopLoad(void)
+{
+  TIM2->CR1 = 0uL;
+  TIM2->DIER = 0uL;
+  NVIC_DisableIRQ(TIM2_IRQn);
+  __HAL_RCC_TIM2_CLK_DISABLE();
+  return s_ulLoadCount;
+}
+
+/*!****************************************************************************
+ * @brief
+ * TIM2 interrupt handler: interrupt load
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void TIM2_IRQHandler(void)
+{
+  TIM2->SR = ~TIM_SR_UIF;
+  ++s_ulLoadCount;
+}
@@ -0,0 +1,23 @@
+# Benchmark kernels: the sources are part of the firmware sources and register
+# as test cases ("bench_*"; the budget records the kernels valid in QEMU, see
+# "Tools/scripts/budget.py")
+target_include_directories(firmware-common INTERFACE
+	${CMAKE_CURRENT_LIST_DIR}
+)
+
+# Performance budget: run the kernels on both images in QEMU, append the
+# metrics to the history and check them against "Benchmark/budget.json"
+set(BUDGET_HISTORY ${CMAKE_BINARY_DIR}/budget_history.json CACHE FILEPATH "Performance budget history")
+find_program(QEMU_SYSTEM_ARM qemu-system-arm)
+find_package(Python3 COMPONENTS Interpreter)
+if(Python3_FOUND AND QEMU_SYSTEM_ARM)
+	add_custom_target(budget
+		COMMAND ${Python3_EXECUTABLE} ${CMAKE_SOURCE_DIR}/Tools/scripts/budget.py record ${CMAKE_BINARY_DIR}
+			--history ${BUDGET_HISTORY} --qemu ${QEMU_SYSTEM_ARM}
+		COMMAND ${Python3_EXECUTABLE} ${CMAKE_SOURCE_DIR}/Tools/scripts/budget.py compare
+			--history ${BUDGET_HISTORY} --budget ${CMAKE_CURRENT_LIST_DIR}/budget.json
+		DEPENDS ${PROJECT_NAME} ${PROJECT_NAME}-release
+		WORKING_DIRECTORY ${CMAKE_SOURCE_DIR}
+		USES_TERMINAL
+	)
+endif()
@@ -0,0 +1,35 @@
+/*!****************************************************************************
+ * @file
+ * benchmark.h
+ *
+ * @brief
+ * Cycle time base, interrupt load and reporting for benchmark kernels
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Default number of kernel iterations ("iterations=" parameter)
+#ifndef BENCHMARK_ITERATIONS
+#define BENCHMARK_ITERATIONS          1000
+#endif
+
+
+/*- Public interface ---------------------------------------------------------*/
+uint32_t Benchmark_ulCycles(void);
+uint64_t Benchmark_ullWallUs(void);
+uint32_t Benchmark_ulIterations(void);
+void Benchmark_vReport(uint32_t ulStart, uint32_t ulIterations);
+
+// Interrupt load
+void Benchmark_vStartLoad(uint32_t ulPeriodUs);
+uint32_t Benchmark_ulStopLoad(void);
+
+#endif // BENCHMARK_H_
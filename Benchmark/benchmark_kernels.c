@@ -0,0 +1,368 @@
+/*!****************************************************************************
+ * @file
+ * benchmark_kernels.c
+ *
+ * @brief
+ * Benchmark kernels for the performance budget (see "Tools/scripts/budget.py")
+ *
+ * Each kernel runs a HAL operation of the demo "iterations=" times (default
+ * @c BENCHMARK_ITERATIONS) and reports the cycles per iteration. Comparing the
+ * coverage and the release image gives the run time cost of the instrumen-
+ * tation. The "bench_fast_*" kernels run the same operations through the
+ * compile-time specialised GPIO access ("Controller/gpio_fast.h") for compa-
+ * rison with the HAL calls. Select with "tests=bench_*" on the Semihosting
+ * command line.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdio.h>
+#include "stm32f1xx.h"
+#include "coverage.h"
+#include "gpio_fast.h"
+#include "testing.h"
+#include "tickless.h"
+#include "timebase.h"
+#include "benchmark.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Coverage dump file of "bench_dump" ("dump=" parameter)
+#ifndef BENCHMARK_DUMP_FILE
+#define BENCHMARK_DUMP_FILE           "build/bench_dump.bin"
+#endif
+
+/// Default delay of "bench_delay_us" in microseconds ("delay=" parameter)
+#ifndef BENCHMARK_DELAY_US
+#define BENCHMARK_DELAY_US            100
+#endif
+
+/// Default delay of "bench_idle" in milliseconds ("delay=" parameter)
+#ifndef BENCHMARK_IDLE_MS
+#define BENCHMARK_IDLE_MS             100
+#endif
+
+/// Default number of dumps of "bench_dump" ("dumps=" parameter)
+#ifndef BENCHMARK_DUMPS
+#define BENCHMARK_DUMPS               10
+#endif
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+static void vPollDelay(uint32_t ulDelay);
+static uint32_t ulDumpUs(const char* pszFile, uint32_t ulDumps, bool bBoost);
+static void vIdle(const char* pszMode, void (*pfnDelay)(uint32_t ulDelay), uint32_t ulDelay, uint32_t ulDelays);
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Pin configuration, alternating between output and input
+ ******************************************************************************/
+TESTING_CASE(bench_gpio_init)
+{
+  uint32_t ulIterations = Benchmark_ulIterations();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  uint32_t ulStart = Benchmark_ulCycles();
+  for (uint32_t i = 0uL; i < ulIterations; ++i)
+  {
+    HAL_GPIO_Init(GPIOC, &(GPIO_InitTypeDef){
+      .Pin = GPIO_PIN_13,
+      .Mode = (i & 1u) ? GPIO_MODE_INPUT : GPIO_MODE_OUTPUT_PP,
+      .Pull = GPIO_PULLUP,
+      .Speed = GPIO_SPEED_LOW
+    });
+  }
+  Benchmark_vReport(ulStart, ulIterations);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Pin writes, alternating between set and reset
+ ******************************************************************************/
+TESTING_CASE(bench_gpio_write)
+{
+  uint32_t ulIterations = Benchmark_ulIterations();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  uint32_t ulStart = Benchmark_ulCycles();
+  for (uint32_t i = 0uL; i < ulIterations; ++i)
+  {
+    HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, (i & 1u) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+  }
+  Benchmark_vReport(ulStart, ulIterations);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Pin toggles
+ ******************************************************************************/
+TESTING_CASE(bench_gpio_toggle)
+{
+  uint32_t ulIterations = Benchmark_ulIterations();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  uint32_t ulStart = Benchmark_ulCycles();
+  for (uint32_t i = 0uL; i < ulIterations; ++i)
+  {
+    HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13);
+  }
+  Benchmark_vReport(ulStart, ulIterations);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fast path pin configuration, alternating between output and input
+ ******************************************************************************/
+TESTING_CASE(bench_fast_init)
+{
+  uint32_t ulIterations = Benchmark_ulIterations();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  uint32_t ulStart = Benchmark_ulCycles();
+  for (uint32_t i = 0uL; i < ulIterations; ++i)
+  {
+    if (i & 1u) GpioFast_vInit(GPIOC, GPIO_PIN_13, GPIO_MODE_INPUT, GPIO_PULLUP, GPIO_SPEED_FREQ_LOW);
+    else GpioFast_vInit(GPIOC, GPIO_PIN_13, GPIO_MODE_OUTPUT_PP, GPIO_PULLUP, GPIO_SPEED_FREQ_LOW);
+  }
+  Benchmark_vReport(ulStart, ulIterations);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fast path pin writes, alternating between set and reset
+ ******************************************************************************/
+TESTING_CASE(bench_fast_write)
+{
+  uint32_t ulIterations = Benchmark_ulIterations();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  uint32_t ulStart = Benchmark_ulCycles();
+  for (uint32_t i = 0uL; i < ulIterations; ++i)
+  {
+    GpioFast_vWrite(GPIOC, GPIO_PIN_13, (i & 1u) == 0u);
+  }
+  Benchmark_vReport(ulStart, ulIterations);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fast path pin toggles
+ ******************************************************************************/
+TESTING_CASE(bench_fast_toggle)
+{
+  uint32_t ulIterations = Benchmark_ulIterations();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  uint32_t ulStart = Benchmark_ulCycles();
+  for (uint32_t i = 0uL; i < ulIterations; ++i)
+  {
+    GpioFast_vToggle(GPIOC, GPIO_PIN_13);
+  }
+  Benchmark_vReport(ulStart, ulIterations);
+}
+
+/*!****************************************************************************
+ * @brief
+ * HAL tick queries (as in the polling loop of HAL_Delay)
+ ******************************************************************************/
+TESTING_CASE(bench_get_tick)
+{
+  uint32_t ulIterations = Benchmark_ulIterations();
+  uint32_t ulStart = Benchmark_ulCycles();
+  for (uint32_t i = 0uL; i < ulIterations; ++i)
+  {
+    (void)HAL_GetTick();
+  }
+  Benchmark_vReport(ulStart, ulIterations);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Coverage dumps to a file on the host
+ *
+ * Parameters "dumps": number of dumps (default @c BENCHMARK_DUMPS), "dump":
+ * output file. Reports the cycles, bytes and Semihosting operations (open,
+ * writes, close) per dump; the release image doesn't write any data.
+ ******************************************************************************/
+TESTING_CASE(bench_dump)
+{
+  int32_t lDumps = Testing_lParam("dumps", BENCHMARK_DUMPS);
+  uint32_t ulDumps = (lDumps > 0) ? (uint32_t)lDumps : 1uL;
+  const char* pszFile = Testing_pszParam("dump");
+  if (pszFile == NULL) pszFile = BENCHMARK_DUMP_FILE;
+
+  uint32_t ulStart = Benchmark_ulCycles();
+  for (uint32_t i = 0uL; i < ulDumps; ++i)
+  {
+    Coverage_vDump(pszFile);
+  }
+  Benchmark_vReport(ulStart, ulDumps);
+
+  Coverage_DumpStats sStats;
+  Coverage_vGetDumpStats(&sStats);
+  Testing_vMetric("bytes", sStats.ulBytes);
+  Testing_vMetric("semihost_ops", sStats.ulOps);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Coverage dumps at the application clock and at the boost clock
+ *
+ * Parameters as "bench_dump". Reports the wall-clock time per dump in micro-
+ * seconds at the application clock ("us") and at the boost clock
+ * ("boost_us"), the speed-up (per mille) and whether the boost was applied.
+ ******************************************************************************/
+TESTING_CASE(bench_dump_boost)
+{
+  int32_t lDumps = Testing_lParam("dumps", BENCHMARK_DUMPS);
+  uint32_t ulDumps = (lDumps > 0) ? (uint32_t)lDumps : 1uL;
+  const char* pszFile = Testing_pszParam("dump");
+  if (pszFile == NULL) pszFile = BENCHMARK_DUMP_FILE;
+
+  bool bBoost = Coverage_bGetDumpBoost();
+  uint32_t ulUs = ulDumpUs(pszFile, ulDumps, false);
+  uint32_t ulBoostUs = ulDumpUs(pszFile, ulDumps, true);
+  Coverage_DumpStats sStats;
+  Coverage_vGetDumpStats(&sStats);
+  Coverage_vSetDumpBoost(bBoost);
+
+  Testing_vMetric("us", ulUs);
+  Testing_vMetric("boost_us", ulBoostUs);
+  if (ulBoostUs != 0uL) Testing_vMetric("speedup_permille", (uint32_t)((ulUs * 1000uLL) / ulBoostUs));
+  Testing_vMetric("boosted", sStats.bBoosted ? 1uL : 0uL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Accuracy of microsecond delays, optionally under interrupt load
+ *
+ * Parameters "delay": delay in microseconds (default @c BENCHMARK_DELAY_US),
+ * "load": period of the load interrupts in microseconds (default 0: none).
+ * Reports the requested cycles, and the minimum, mean and maximum excess
+ * cycles of the measured delays, and the number of load interrupts.
+ ******************************************************************************/
+TESTING_CASE(bench_delay_us)
+{
+  uint32_t ulIterations = Benchmark_ulIterations();
+  uint32_t ulDelay = (uint32_t)Testing_lParam("delay", BENCHMARK_DELAY_US);
+  int32_t lLoad = Testing_lParam("load", 0);
+  uint32_t ulRequested = ulDelay * Timebase_ulCyclesPerUs();
+
+  if (lLoad > 0) Benchmark_vStartLoad((uint32_t)lLoad);
+  uint32_t ulMin = UINT32_MAX, ulMax = 0uL, ulShort = 0uL;
+  uint64_t ullSum = 0uLL;
+  for (uint32_t i = 0uL; i < ulIterations; ++i)
+  {
+    uint32_t ulStart = Benchmark_ulCycles();
+    Timebase_vDelayUs(ulDelay);
+    uint32_t ulCycles = Benchmark_ulCycles() - ulStart;
+    uint32_t ulExcess = (ulCycles >= ulRequested) ? ulCycles - ulRequested : 0uL;
+    if (ulCycles < ulRequested) ++ulShort;
+    if (ulExcess < ulMin) ulMin = ulExcess;
+    if (ulExcess > ulMax) ulMax = ulExcess;
+    ullSum += ulExcess;
+  }
+  uint32_t ulIrqs = (lLoad > 0) ? Benchmark_ulStopLoad() : 0uL;
+  TESTING_ASSERT_EQUAL(0, ulShort);
+
+  Testing_vMetric("requested_cycles", ulRequested);
+  Testing_vMetric("excess_min", ulMin);
+  Testing_vMetric("excess_mean", (uint32_t)(ullSum / ulIterations));
+  Testing_vMetric("excess_max", ulMax);
+  Testing_vMetric("irqs", ulIrqs);
+}
+
+/*!****************************************************************************
+ * @brief
+ * SysTick interrupts and CPU time of delays, polling vs. tickless idle
+ *
+ * Parameters "delay": delay in milliseconds (default @c BENCHMARK_IDLE_MS),
+ * "delays": number of delays (default 5). Reports the SysTick interrupts per
+ * second and the time asleep (per mille) of the polling delay of the HAL and
+ * of @c Tickless_vDelay, and the number of tickless sleeps.
+ ******************************************************************************/
+TESTING_CASE(bench_idle)
+{
+  int32_t lDelay = Testing_lParam("delay", BENCHMARK_IDLE_MS);
+  int32_t lDelays = Testing_lParam("delays", 5);
+  uint32_t ulDelay = (lDelay > 0) ? (uint32_t)lDelay : 1uL;
+  uint32_t ulDelays = (lDelays > 0) ? (uint32_t)lDelays : 1uL;
+
+  vIdle("poll", vPollDelay, ulDelay, ulDelays);
+  vIdle("tickless", Tickless_vDelay, ulDelay, ulDelays);
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Polling delay (as @c HAL_Delay of the HAL, also in builds replacing it)
+ *
+ * @param[in] ulDelay Delay in milliseconds
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vPollDelay(uint32_t ulDelay)
+{
+  uint32_t ulStart = HAL_GetTick();
+  uint32_t ulWait = ulDelay + (uint32_t)uwTickFreq;
+  while ((HAL_GetTick() - ulStart) < ulWait)
+  {
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Measure coverage dumps
+ *
+ * @param[in] pszFile Output file
+ * @param[in] ulDumps Number of dumps
+ * @param[in] bBoost  Dump at the boost clock
+ * @return  (uint32_t)  Wall-clock time per dump in microseconds
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint32_t ulDumpUs(const char* pszFile, uint32_t ulDumps, bool bBoost)
+{
+  Coverage_vSetDumpBoost(bBoost);
+  uint64_t ullStart = Benchmark_ullWallUs();
+  for (uint32_t i = 0uL; i < ulDumps; ++i)
+  {
+    Coverage_vDump(pszFile);
+  }
+  return (uint32_t)((Benchmark_ullWallUs() - ullStart) / ulDumps);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Measure delays, report metrics "<mode>_irqs_per_s", "<mode>_sleep_permille"
+ * and "<mode>_sleeps"
+ *
+ * SysTick interrupts are the tick increments not made by the tickless idle.
+ *
+ * @param[in] pszMode   Metric name prefix
+ * @param[in] pfnDelay  Delay function
+ * @param[in] ulDelay   Delay in milliseconds
+ * @param[in] ulDelays  Number of delays
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vIdle(const char* pszMode, void (*pfnDelay)(uint32_t ulDelay), uint32_t ulDelay, uint32_t ulDelays)
+{
+  Tickless_vResetStats();
+  uint32_t ulTick = uwTick;
+  uint64_t ullStart = Timebase_ullCycles();
+  for (uint32_t i = 0uL; i < ulDelays; ++i)
+  {
+    pfnDelay(ulDelay);
+  }
+  uint64_t ullCycles = Timebase_ullCycles() - ullStart;
+  uint32_t ulTicks = (uwTick - ulTick) / (uint32_t)uwTickFreq;
+
+  Tickless_Stats sStats;
+  Tickless_vGetStats(&sStats);
+  uint64_t ullIrqs = ulTicks - sStats.ulSkippedTicks;
+
+  char acName[32];
+  snprintf(acName, sizeof(acName), "%s_irqs_per_s", pszMode);
+  Testing_vMetric(acName, (uint32_t)((ullIrqs * SystemCoreClock) / ullCycles));
+  snprintf(acName, sizeof(acName), "%s_sleep_permille", pszMode);
+  Testing_vMetric(acName, (uint32_t)((sStats.ullSleepCycles * 1000uLL) / ullCycles));
+  snprintf(acName, sizeof(acName), "%s_sleeps", pszMode);
+  Testing_vMetric(acName, sStats.ulSleeps);
+}
@@ -0,0 +1,35 @@
+#!/bin/sh
+
+# Compare the HAL GPIO calls with the fast path ("Controller/gpio_fast.h")
+#
+# Runs the "bench_gpio_*" and "bench_fast_*" kernels on the release and the
+# coverage image in "armsim" (timed with the DWT cycle counter) and prints the
+# cycles per call of each operation.
+#
+# Usage (in the build folder): ../Benchmark/compare_gpio.sh
+ARMSIM=${ARMSIM:-../build-tools/armsim/armsim}
+IMAGE=gcov-demo-stm32f103
+
+if [ ! -x "$ARMSIM" ]; then
+  echo "armsim not found ($ARMSIM)"
+  exit 1
+fi
+
+for VARIANT in release coverage; do
+  ELF=$IMAGE.elf
+  [ $VARIANT = release ] && ELF=$IMAGE-release.elf
+  "$ARMSIM" --root . --cmdline "tests=bench_gpio_*,bench_fast_* out=gpio_$VARIANT.bin" $ELF > /dev/null
+  ../Tools/scripts/split_tests.py gpio_$VARIANT.bin -o gpio_$VARIANT |
+    awk '/^(PASS|FAIL) / { name = $2 } /^  cycles = / { print name, $3 }' > gpio_$VARIANT.txt || exit 1
+done
+
+printf "%-10s %14s %14s %14s %14s\n" "operation" "release HAL" "release fast" "coverage HAL" "coverage fast"
+for OP in init write toggle; do
+  printf "%-10s" $OP
+  for VARIANT in release coverage; do
+    for KERNEL in bench_gpio_$OP bench_fast_$OP; do
+      printf " %14s" "$(awk -v k=$KERNEL '$1 == k { print $2 }' gpio_$VARIANT.txt)"
+    done
+  done
+  printf "\n"
+done
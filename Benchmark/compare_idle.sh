@@ -0,0 +1,35 @@
+#!/bin/sh
+
+# Compare polling delays with the tickless idle ("Timebase/tickless.h")
+#
+# Runs the "bench_idle" kernel on the release and the coverage image in
+# "armsim" and prints the SysTick interrupts per second and the time asleep
+# during the delays, per delay implementation and image.
+#
+# Usage (in the build folder): ../Benchmark/compare_idle.sh [<kernel parameters>]
+ARMSIM=${ARMSIM:-../build-tools/armsim/armsim}
+IMAGE=gcov-demo-stm32f103
+
+if [ ! -x "$ARMSIM" ]; then
+  echo "armsim not found ($ARMSIM)"
+  exit 1
+fi
+
+for VARIANT in release coverage; do
+  ELF=$IMAGE.elf
+  [ $VARIANT = release ] && ELF=$IMAGE-release.elf
+  "$ARMSIM" --root . --cmdline "tests=bench_idle $* out=idle_$VARIANT.bin" $ELF > /dev/null
+  ../Tools/scripts/split_tests.py idle_$VARIANT.bin -o idle_$VARIANT |
+    awk '/^  [a-z_]+ = / { print $1, $3 }' > idle_$VARIANT.txt || exit 1
+done
+
+printf "%-10s %16s %16s %16s %16s\n" "delay" "release irqs/s" "release asleep" "coverage irqs/s" "coverage asleep"
+for MODE in poll tickless; do
+  printf "%-10s" $MODE
+  for VARIANT in release coverage; do
+    IRQS=$(awk -v m=${MODE}_irqs_per_s '$1 == m { print $2 }' idle_$VARIANT.txt)
+    SLEEP=$(awk -v m=${MODE}_sleep_permille '$1 == m { printf "%.1f %%", $2 / 10 }' idle_$VARIANT.txt)
+    printf " %16s %16s" "$IRQS" "$SLEEP"
+  done
+  printf "\n"
+done
@@ -0,0 +1,345 @@
+/*!****************************************************************************
+ * @file
+ * irq_latency.c
+ *
+ * @brief
+ * Interrupt latency kernels: SysTick, timer (TIM2) and EXTI line 0
+ *
+ * Each kernel triggers one interrupt repeatedly and records two intervals
+ * per sample:
+ *
+ *     latency   trigger (store to the peripheral or NVIC) to the first
+ *               timestamp in the handler, including the exception entry
+ *               and the probe prologue
+ *     duration  the application's handler ("Controller/stm32f1xx_it.c",
+ *               "benchmark.c"), including the HAL and coverage counter code
+ *
+ * The handlers are timed by a probe: during a kernel, the vector table is
+ * copied to RAM, and the measured exception calls the probe, which calls the
+ * original handler between two timestamps. Timestamps are DWT cycles, or the
+ * SysTick counter in QEMU (relative comparisons only; intervals up to one
+ * tick).
+ *
+ * Parameter "config" selects the NVIC priority configuration:
+ *
+ *     thread   triggered in thread mode (default)
+ *     preempt  triggered in a lowest-priority PendSV handler, preempted by
+ *              the measured interrupt at the highest priority
+ *     tail     triggered in a highest-priority PendSV handler, the measured
+ *              interrupt at the lowest priority is tail-chained
+ *
+ * Peripherals which don't raise the interrupt (not modelled in QEMU or
+ * armsim) are replaced by setting the interrupt pending in the NVIC. Software
+ * triggered SysTick interrupts increment the HAL tick.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "stm32f1xx.h"
+#include "testing.h"
+#include "timebase.h"
+#include "benchmark.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Maximum number of samples per kernel ("samples=" parameter)
+#ifndef BENCHMARK_IRQ_SAMPLES
+#define BENCHMARK_IRQ_SAMPLES         100
+#endif
+
+/// Vector table entries: system exceptions and STM32F103xB interrupts
+#define IRQ_VECTORS                   (16u + 43u)
+
+/// Polls for the interrupt before the NVIC trigger is used instead
+#define IRQ_TIMEOUT                   1000uL
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Exception handler
+typedef void (*IrqHandler)(void);
+
+/// Trigger configuration
+typedef enum IrqConfig
+{
+  IRQ_CONFIG_THREAD,                  ///< Thread mode
+  IRQ_CONFIG_PREEMPT,                 ///< Low-priority handler, preempted
+  IRQ_CONFIG_TAIL,                    ///< High-priority handler, tail-chained
+} IrqConfig;
+
+
+/*- Global data --------------------------------------------------------------*/
+/// Vector table in RAM (aligned to its size rounded up to a power of two)
+static IrqHandler s_apfnVectors[IRQ_VECTORS] __attribute__((aligned(256)));
+static const IrqHandler* s_ppfnOriginal; ///< Vector table of the application
+static bool s_bDwt;                   ///< DWT timestamps (otherwise SysTick)
+
+static IRQn_Type s_eTarget;           ///< Measured interrupt
+static bool s_bNvic;                  ///< Trigger by NVIC pending bit
+static volatile bool s_bArmed;        ///< Sample of the measured interrupt expected
+static uint32_t s_ulTrigger;          ///< Timestamp of the trigger
+static uint32_t s_ulEntry, s_ulExit;  ///< Timestamps of the handler
+
+static uint16_t s_ausLatency[BENCHMARK_IRQ_SAMPLES]; ///< Latency samples
+static uint16_t s_ausDuration[BENCHMARK_IRQ_SAMPLES]; ///< Duration samples
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+static void vMeasure(IRQn_Type eTarget);
+static bool bSample(IrqConfig eConfig);
+static void vTrigger(void);
+static void vProbe(void);
+static void vContext(void);
+static uint32_t ulStamp(void);
+static uint16_t usSpan(uint32_t ulFrom, uint32_t ulTo);
+static void vReport(const char* pszName, uint16_t* pusSamples, uint32_t ulCount);
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * SysTick interrupt (HAL tick and time base update)
+ ******************************************************************************/
+TESTING_CASE(bench_irq_systick)
+{
+  vMeasure(SysTick_IRQn);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Timer interrupt (TIM2 update event)
+ ******************************************************************************/
+TESTING_CASE(bench_irq_timer)
+{
+  __HAL_RCC_TIM2_CLK_ENABLE();
+  TIM2->CR1 = 0uL;
+  TIM2->SR = 0uL;
+  TIM2->DIER = TIM_DIER_UIE;
+  NVIC_ClearPendingIRQ(TIM2_IRQn);
+  NVIC_EnableIRQ(TIM2_IRQn);
+  vMeasure(TIM2_IRQn);
+  TIM2->DIER = 0uL;
+  NVIC_DisableIRQ(TIM2_IRQn);
+  __HAL_RCC_TIM2_CLK_DISABLE();
+}
+
+/*!****************************************************************************
+ * @brief
+ * External interrupt (EXTI line 0, software interrupt event)
+ ******************************************************************************/
+TESTING_CASE(bench_irq_exti)
+{
+  EXTI->PR = EXTI_PR_PR0;
+  EXTI->IMR |= EXTI_IMR_MR0;
+  NVIC_ClearPendingIRQ(EXTI0_IRQn);
+  NVIC_EnableIRQ(EXTI0_IRQn);
+  vMeasure(EXTI0_IRQn);
+  EXTI->IMR &= ~EXTI_IMR_MR0;
+  NVIC_DisableIRQ(EXTI0_IRQn);
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Measure an interrupt, report the distributions of latency and duration
+ *
+ * Parameters "config" (see file header) and "samples" (at most
+ * @c BENCHMARK_IRQ_SAMPLES). Metrics "lat_<stat>" and "dur_<stat>" (min,
+ * p50, p90, max in cycles), and "nvic" (1: triggered in the NVIC).
+ *
+ * @param[in] eTarget Measured interrupt
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vMeasure(IRQn_Type eTarget)
+{
+  const char* pszConfig = Testing_pszParam("config");
+  IrqConfig eConfig = IRQ_CONFIG_THREAD;
+  if ((pszConfig != NULL) && (strcmp(pszConfig, "preempt") == 0)) eConfig = IRQ_CONFIG_PREEMPT;
+  if ((pszConfig != NULL) && (strcmp(pszConfig, "tail") == 0)) eConfig = IRQ_CONFIG_TAIL;
+  int32_t lSamples = Testing_lParam("samples", BENCHMARK_IRQ_SAMPLES);
+  uint32_t ulSamples = ((lSamples > 0) && (lSamples < BENCHMARK_IRQ_SAMPLES)) ? (uint32_t)lSamples :
+                                                                                 BENCHMARK_IRQ_SAMPLES;
+
+  // Probe and priorities
+  s_bDwt = Timebase_bDwt();
+  s_eTarget = eTarget;
+  s_bNvic = false;
+  s_ppfnOriginal = (const IrqHandler*)SCB->VTOR;
+  memcpy(s_apfnVectors, s_ppfnOriginal, sizeof(s_apfnVectors));
+  s_apfnVectors[16 + eTarget] = vProbe;
+  s_apfnVectors[16 + PendSV_IRQn] = vContext;
+  uint32_t ulTargetPriority = NVIC_GetPriority(eTarget);
+  uint32_t ulPendSvPriority = NVIC_GetPriority(PendSV_IRQn);
+  uint32_t ulLowest = (1uL << __NVIC_PRIO_BITS) - 1uL;
+  NVIC_SetPriority(eTarget, (eConfig == IRQ_CONFIG_TAIL) ? ulLowest : 0uL);
+  NVIC_SetPriority(PendSV_IRQn, (eConfig == IRQ_CONFIG_TAIL) ? 0uL : ulLowest);
+  __disable_irq();
+  SCB->VTOR = (uint32_t)s_apfnVectors;
+  __DSB();
+  __enable_irq();
+
+  uint32_t ulCount = 0uL;
+  while ((ulCount < ulSamples) && bSample(eConfig))
+  {
+    s_ausLatency[ulCount] = usSpan(s_ulTrigger, s_ulEntry);
+    s_ausDuration[ulCount] = usSpan(s_ulEntry, s_ulExit);
+    ++ulCount;
+  }
+
+  __disable_irq();
+  SCB->VTOR = (uint32_t)s_ppfnOriginal;
+  __DSB();
+  __enable_irq();
+  NVIC_SetPriority(eTarget, ulTargetPriority);
+  NVIC_SetPriority(PendSV_IRQn, ulPendSvPriority);
+
+  TESTING_ASSERT_EQUAL(ulSamples, ulCount);
+  vReport("lat", s_ausLatency, ulCount);
+  vReport("dur", s_ausDuration, ulCount);
+  Testing_vMetric("nvic", s_bNvic ? 1uL : 0uL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Take one sample
+ *
+ * Switches to the NVIC trigger if the peripheral doesn't raise the interrupt.
+ *
+ * @param[in] eConfig Trigger configuration
+ * @return  (bool)  Sample taken
+ * @date  17.10.2026
+ ******************************************************************************/
+static bool bSample(IrqConfig eConfig)
+{
+  for (uint32_t ulAttempt = 0uL; ulAttempt < 2uL; ++ulAttempt)
+  {
+    s_bArmed = true;
+    if (eConfig == IRQ_CONFIG_THREAD) vTrigger();
+    else SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    __DSB();
+    __ISB();
+
+    for (uint32_t i = 0uL; s_bArmed && (i < IRQ_TIMEOUT); ++i)
+    {
+    }
+    if (!s_bArmed) return true;
+
+    s_bArmed = false;
+    NVIC_ClearPendingIRQ(s_eTarget);
+    s_bNvic = true;
+  }
+  return false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Trigger the measured interrupt
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vTrigger(void)
+{
+  s_ulTrigger = ulStamp();
+  if (s_eTarget == SysTick_IRQn) SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+  else if (s_bNvic) NVIC->ISPR[(uint32_t)s_eTarget >> 5] = 1uL << ((uint32_t)s_eTarget & 0x1Fu);
+  else if (s_eTarget == TIM2_IRQn) TIM2->EGR = TIM_EGR_UG;
+  else EXTI->SWIER = EXTI_SWIER_SWIER0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Probe: time the original handler of the measured interrupt
+ *
+ * Spontaneous interrupts (e.g. the regular SysTick) are passed through.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vProbe(void)
+{
+  uint32_t ulEntry = ulStamp();
+  s_ppfnOriginal[16 + s_eTarget]();
+  uint32_t ulExit = ulStamp();
+  if (s_bArmed)
+  {
+    s_ulEntry = ulEntry;
+    s_ulExit = ulExit;
+    s_bArmed = false;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * PendSV handler: trigger in handler mode
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vContext(void)
+{
+  vTrigger();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get timestamp
+ *
+ * @return  (uint32_t)  DWT cycle counter, or SysTick cycles of the current tick
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint32_t ulStamp(void)
+{
+  return s_bDwt ? DWT->CYCCNT : (SysTick->LOAD - SysTick->VAL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get interval between timestamps
+ *
+ * @param[in] ulFrom  Start timestamp
+ * @param[in] ulTo    End timestamp
+ * @return  (uint16_t)  Cycles (saturated)
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint16_t usSpan(uint32_t ulFrom, uint32_t ulTo)
+{
+  uint32_t ulSpan = ulTo - ulFrom;
+  if (!s_bDwt && (ulTo < ulFrom)) ulSpan += SysTick->LOAD + 1uL;
+  return (ulSpan < UINT16_MAX) ? (uint16_t)ulSpan : UINT16_MAX;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Report distribution: metrics "<name>_min", "_p50", "_p90" and "_max"
+ *
+ * @param[in] pszName     Metric name prefix
+ * @param[inout] pusSamples Samples (sorted)
+ * @param[in] ulCount     Number of samples
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vReport(const char* pszName, uint16_t* pusSamples, uint32_t ulCount)
+{
+  if (ulCount == 0uL) return;
+  for (uint32_t i = 1uL; i < ulCount; ++i)
+  {
+    uint16_t usSample = pusSamples[i];
+    uint32_t j = i;
+    for (; (j > 0uL) && (pusSamples[j - 1uL] > usSample); --j)
+    {
+      pusSamples[j] = pusSamples[j - 1uL];
+    }
+    pusSamples[j] = usSample;
+  }
+
+  static const struct { const char* pszStat; uint32_t ulPercent; } s_asStats[] = {
+    { "min", 0uL }, { "p50", 50uL }, { "p90", 90uL }, { "max", 100uL },
+  };
+  char acName[16];
+  for (uint32_t i = 0uL; i < sizeof(s_asStats) / sizeof(s_asStats[0]); ++i)
+  {
+    snprintf(acName, sizeof(acName), "%s_%s", pszName, s_asStats[i].pszStat);
+    Testing_vMetric(acName, pusSamples[((ulCount - 1uL) * s_asStats[i].ulPercent) / 100uL]);
+  }
+}
@@ -0,0 +1,172 @@
+/*!****************************************************************************
+ * @file
+ * clock_boost.c
+ *
+ * @brief
+ * Temporary switch to the maximum core clock (72 MHz PLL from HSE)
+ *
+ * For CPU-bound phases of an application running from a slower clock, e.g.
+ * the serialisation of the coverage data ("Coverage/coverage.c"): HSE and
+ * the PLL are started, the flash wait states are set for the boost clock,
+ * and the core switches to the PLL with APB1 divided by 2 (36 MHz maximum).
+ * @c ClockBoost_vLeave restores the clock tree, the flash configuration and
+ * @c SystemCoreClock of the application.
+ *
+ * Registers are accessed directly, so the switch doesn't execute (and cover)
+ * HAL code. The HAL tick keeps its period and phase: on each switch, the
+ * remaining time of the current tick is rescaled to the new clock. Timers and
+ * other peripherals clocked from the buses run at different rates during the
+ * boost, and DWT cycle timestamps ("timebase.h") count at the boost clock.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <assert.h>
+#include "stm32f1xx.h"
+#include "timebase.h"
+#include "clock_boost.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// PLL multiplication factor
+#define CLOCK_BOOST_PLL_MUL           (CLOCK_BOOST_HZ / HSE_VALUE)
+static_assert((CLOCK_BOOST_HZ % HSE_VALUE == 0u) && (CLOCK_BOOST_PLL_MUL >= 2u) && (CLOCK_BOOST_PLL_MUL <= 16u),
+              "CLOCK_BOOST_HZ must be 2..16 times HSE_VALUE");
+
+/// Flash wait states: 0 up to 24 MHz, 1 up to 48 MHz, 2 up to 72 MHz
+#define CLOCK_BOOST_LATENCY           ((CLOCK_BOOST_HZ - 1uL) / 24000000uL)
+
+/// Clock switch and bus prescaler bits of RCC_CFGR
+#define CLOCK_BOOST_CFGR_SWITCH       (RCC_CFGR_SW | RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2)
+
+/// Clock source ready timeout in microseconds
+#define CLOCK_BOOST_TIMEOUT_US        (HSE_STARTUP_TIMEOUT * 1000uL)
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+static bool bWaitFlag(volatile uint32_t* pulReg, uint32_t ulMask, uint32_t ulValue);
+static void vRetuneTick(uint32_t ulFrom, uint32_t ulTo);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Switch to @c CLOCK_BOOST_HZ
+ *
+ * Nothing is changed if the PLL is already enabled (e.g. configured by the
+ * application), or if HSE or the PLL doesn't start.
+ *
+ * @param[out] psState  Clock configuration to restore
+ * @return  (bool)  Switched (@c ClockBoost_vLeave to be called)
+ * @date  17.10.2026
+ ******************************************************************************/
+bool ClockBoost_bEnter(ClockBoost_State* psState)
+{
+  *psState = (ClockBoost_State){
+    .ulCr = RCC->CR, .ulCfgr = RCC->CFGR, .ulAcr = FLASH->ACR, .ulCoreClock = SystemCoreClock
+  };
+  if ((psState->ulCr & RCC_CR_PLLON) != 0uL) return false;
+
+  RCC->CR |= RCC_CR_HSEON;
+  if (!bWaitFlag(&RCC->CR, RCC_CR_HSERDY, RCC_CR_HSERDY))
+  {
+    RCC->CR = psState->ulCr;
+    return false;
+  }
+  RCC->CFGR = (psState->ulCfgr & ~(RCC_CFGR_PLLSRC | RCC_CFGR_PLLXTPRE | RCC_CFGR_PLLMULL)) | RCC_CFGR_PLLSRC |
+              ((CLOCK_BOOST_PLL_MUL - 2uL) << RCC_CFGR_PLLMULL_Pos);
+  RCC->CR |= RCC_CR_PLLON;
+  if (!bWaitFlag(&RCC->CR, RCC_CR_PLLRDY, RCC_CR_PLLRDY))
+  {
+    RCC->CR = psState->ulCr;
+    RCC->CFGR = psState->ulCfgr;
+    return false;
+  }
+
+  // Wait states before the clock increases
+  FLASH->ACR = (psState->ulAcr & ~FLASH_ACR_LATENCY) | FLASH_ACR_PRFTBE | CLOCK_BOOST_LATENCY;
+  (void)FLASH->ACR;
+
+  uint32_t ulPrimask = __get_PRIMASK();
+  __disable_irq();
+  RCC->CFGR = (RCC->CFGR & ~CLOCK_BOOST_CFGR_SWITCH) | RCC_CFGR_SW_PLL | RCC_CFGR_PPRE1_DIV2;
+  (void)bWaitFlag(&RCC->CFGR, RCC_CFGR_SWS, RCC_CFGR_SWS_PLL);
+  vRetuneTick(psState->ulCoreClock, CLOCK_BOOST_HZ);
+  __set_PRIMASK(ulPrimask);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Restore the clock configuration of the application
+ *
+ * @param[in] psState Clock configuration saved by @c ClockBoost_bEnter
+ * @date  17.10.2026
+ ******************************************************************************/
+void ClockBoost_vLeave(const ClockBoost_State* psState)
+{
+  uint32_t ulPrimask = __get_PRIMASK();
+  __disable_irq();
+  RCC->CFGR = (RCC->CFGR & ~CLOCK_BOOST_CFGR_SWITCH) | (psState->ulCfgr & CLOCK_BOOST_CFGR_SWITCH);
+  (void)bWaitFlag(&RCC->CFGR, RCC_CFGR_SWS, (psState->ulCfgr & RCC_CFGR_SW) << 2);
+  vRetuneTick(CLOCK_BOOST_HZ, psState->ulCoreClock);
+  __set_PRIMASK(ulPrimask);
+
+  // Wait states after the clock decreased
+  FLASH->ACR = psState->ulAcr;
+  RCC->CR &= ~RCC_CR_PLLON;
+  (void)bWaitFlag(&RCC->CR, RCC_CR_PLLRDY, 0uL);
+  RCC->CR = (RCC->CR & ~RCC_CR_HSEON) | (psState->ulCr & RCC_CR_HSEON);
+  RCC->CFGR = psState->ulCfgr;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Wait for register flags, with timeout
+ *
+ * @param[in] pulReg  Register
+ * @param[in] ulMask  Flag mask
+ * @param[in] ulValue Expected value of the flags
+ * @return  (bool)  Flags reached the value (false: timeout)
+ * @date  17.10.2026
+ ******************************************************************************/
+static bool bWaitFlag(volatile uint32_t* pulReg, uint32_t ulMask, uint32_t ulValue)
+{
+  uint64_t ullDeadline = Timebase_ullDeadlineUs(CLOCK_BOOST_TIMEOUT_US);
+  while ((*pulReg & ulMask) != ulValue)
+  {
+    if (Timebase_bExpired(ullDeadline)) return (*pulReg & ulMask) == ulValue;
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Adapt the HAL tick (SysTick) to a new core clock
+ *
+ * The rest of the current tick is rescaled to the new clock; SysTick reloads
+ * with the regular period of the new clock from the next tick on
+ * (@c Timebase_vRestartTick). Called with
+ * interrupts disabled, directly after the clock switch.
+ *
+ * @param[in] ulFrom  Previous core clock in Hz
+ * @param[in] ulTo    New core clock in Hz
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vRetuneTick(uint32_t ulFrom, uint32_t ulTo)
+{
+  if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0uL)
+  {
+    SystemCoreClock = ulTo;
+    return;
+  }
+
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  uint32_t ulRest = (uint32_t)(((uint64_t)SysTick->VAL * ulTo) / ulFrom);
+  if (ulRest < 2uL) ulRest = 2uL;
+  Timebase_vRestartTick(ulRest, ulTo / (1000uL / (uint32_t)uwTickFreq));
+  SystemCoreClock = ulTo;
+}
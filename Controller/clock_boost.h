@@ -0,0 +1,41 @@
+/*!****************************************************************************
+ * @file
+ * clock_boost.h
+ *
+ * @brief
+ * Temporary switch to the maximum core clock (72 MHz PLL from HSE)
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef CLOCK_BOOST_H_
+#define CLOCK_BOOST_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Core clock of the boost window in Hz (a multiple of HSE_VALUE, 2..16)
+#ifndef CLOCK_BOOST_HZ
+#define CLOCK_BOOST_HZ                72000000uL
+#endif
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Clock configuration of the application, restored by @c ClockBoost_vLeave
+typedef struct ClockBoost_State
+{
+  uint32_t ulCr;                      ///< RCC_CR
+  uint32_t ulCfgr;                    ///< RCC_CFGR
+  uint32_t ulAcr;                     ///< FLASH_ACR
+  uint32_t ulCoreClock;               ///< SystemCoreClock
+} ClockBoost_State;
+
+
+/*- Public interface ---------------------------------------------------------*/
+bool ClockBoost_bEnter(ClockBoost_State* psState);
+void ClockBoost_vLeave(const ClockBoost_State* psState);
+
+#endif // CLOCK_BOOST_H_
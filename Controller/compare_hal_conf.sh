@@ -0,0 +1,55 @@
+#!/bin/sh
+
+# Compare the minimal and the full HAL configuration (see "Controller/hal_conf.cmake")
+#
+# Builds the firmware from scratch with each configuration (without ccache) in
+# "build-hal-full" and "build-hal-minimal" and prints the compile time of the
+# shared objects, the link time and the FLASH usage of the release image.
+# Behaviour is verified by comparing the loaded contents of both release
+# images; if they differ, the test suite is run on both images in "armsim" and
+# the results are compared.
+#
+# Usage (in the repository root): Controller/compare_hal_conf.sh
+ARMSIM=${ARMSIM:-build-tools/armsim/armsim}
+IMAGE=gcov-demo-stm32f103-release.elf
+
+now() {
+  date +%s.%N
+}
+
+seconds() {
+  awk "BEGIN { printf \"%.2f\", $2 - $1 }"
+}
+
+printf "%-10s %12s %12s %10s\n" "HAL_CONF" "compile [s]" "link [s]" "FLASH"
+for CONF in full minimal; do
+  DIR=build-hal-$CONF
+  cmake -B $DIR -DHAL_CONF=$CONF -DUSE_CCACHE=OFF > /dev/null || exit 1
+  cmake --build $DIR --target clean > /dev/null
+  T0=$(now)
+  cmake --build $DIR --parallel --target firmware-objects firmware-units > /dev/null || exit 1
+  T1=$(now)
+  cmake --build $DIR --parallel --target ${IMAGE%.elf} > /dev/null || exit 1
+  T2=$(now)
+  FLASH=$(arm-none-eabi-size $DIR/$IMAGE | awk 'NR == 2 { print $1 + $2 }')
+  printf "%-10s %12s %12s %10s\n" $CONF "$(seconds $T0 $T1)" "$(seconds $T1 $T2)" $FLASH
+  arm-none-eabi-objcopy -O binary $DIR/$IMAGE $DIR/${IMAGE%.elf}.bin
+done
+
+if cmp -s build-hal-full/${IMAGE%.elf}.bin build-hal-minimal/${IMAGE%.elf}.bin; then
+  echo "release images identical"
+  exit 0
+fi
+
+# Different code: compare the test results instead
+echo "release images differ, comparing test results"
+if [ ! -x "$ARMSIM" ]; then
+  echo "armsim not found ($ARMSIM)"
+  exit 1
+fi
+for CONF in full minimal; do
+  DIR=build-hal-$CONF
+  "$ARMSIM" --cmdline "tests=*,-bench_* out=$DIR/hal_tests.bin" $DIR/$IMAGE > /dev/null
+  Tools/scripts/split_tests.py $DIR/hal_tests.bin -o $DIR/hal_tests | sed 's/ ([0-9]* ms)//' > $DIR/hal_tests.txt
+done
+diff build-hal-full/hal_tests.txt build-hal-minimal/hal_tests.txt && echo "test results identical"
@@ -0,0 +1,17 @@
+/*!****************************************************************************
+ * @file
+ * gpio_fast.c
+ *
+ * @brief
+ * Out-of-line definitions of the compile-time specialised GPIO access
+ *
+ * Defines the functions of "gpio_fast.h" in builds with
+ * @c GPIO_FAST_OUT_OF_LINE. Otherwise, all calls are inlined and this unit
+ * is empty.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#define GPIO_FAST_IMPLEMENTATION
+#include "gpio_fast.h"
@@ -0,0 +1,188 @@
+/*!****************************************************************************
+ * @file
+ * gpio_fast.h
+ *
+ * @brief
+ * Compile-time specialised GPIO access
+ *
+ * Inline replacements for the HAL GPIO calls, for constant ports and pins.
+ * Each call compiles to single register accesses, without the parameter checks
+ * and the read-modify-write of the output data register:
+ *
+ *     GpioFast_vSet(GPIOC, GPIO_PIN_13);       // one BSRR store
+ *     GpioFast_vToggle(GPIOC, GPIO_PIN_13);    // ODR load, one BSRR store
+ *     GpioFast_vInit(GPIOC, GPIO_PIN_13, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_LOW);
+ *
+ * Writes and toggles only affect the given pins, so they don't race with
+ * other code driving other pins of the same port (e.g. interrupt handlers).
+ * Set, reset and write are single stores; a toggle isn't atomic against an
+ * interrupt handler changing the same pins (see @c GpioFast_vToggle). The
+ * CRL/CRH values of @c GpioFast_vInit are folded at compile time for constant
+ * arguments. Interrupt and event modes aren't supported, use
+ * @c HAL_GPIO_Init for these.
+ *
+ * Coverage-friendly variant: with @c GPIO_FAST_OUT_OF_LINE defined (CMake
+ * option), the functions are called out of line ("gpio_fast.c"), so their
+ * coverage is reported per function instead of per caller.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef GPIO_FAST_H_
+#define GPIO_FAST_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "stm32f1xx.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Function attributes: inlined (default), or external definitions in
+/// "gpio_fast.c" (@c GPIO_FAST_OUT_OF_LINE)
+#if defined(GPIO_FAST_OUT_OF_LINE)
+#define GPIO_FAST_INLINE
+#else
+#define GPIO_FAST_INLINE              static inline __attribute__((always_inline))
+#endif
+
+/*!****************************************************************************
+ * @brief
+ * Port configuration nibble (CNF[1:0], MODE[1:0]) of a pin
+ *
+ * @param mode  @c GPIO_MODE_INPUT, _OUTPUT_PP, _OUTPUT_OD, _AF_PP, _AF_OD,
+ *              _AF_INPUT or _ANALOG
+ * @param pull  @c GPIO_NOPULL, _PULLUP or _PULLDOWN (inputs)
+ * @param speed @c GPIO_SPEED_FREQ_LOW, _MEDIUM or _HIGH (outputs); these are
+ *              the MODE[1:0] bits
+ ******************************************************************************/
+#define GPIO_FAST_CONFIG(mode, pull, speed)                                    \
+  (((mode) == GPIO_MODE_OUTPUT_PP) ? (uint32_t)(speed) :                       \
+   ((mode) == GPIO_MODE_OUTPUT_OD) ? (0x4u | (uint32_t)(speed)) :              \
+   ((mode) == GPIO_MODE_AF_PP)     ? (0x8u | (uint32_t)(speed)) :              \
+   ((mode) == GPIO_MODE_AF_OD)     ? (0xCu | (uint32_t)(speed)) :              \
+   ((mode) == GPIO_MODE_ANALOG)    ? 0x0u :                                    \
+   ((pull) == GPIO_NOPULL)         ? 0x4u : 0x8u)
+
+/// Bit i of an 8-pin mask moved to bit 4*i (one bit per configuration nibble)
+#define GPIO_FAST_NIBBLES(mask)                                                \
+  ((((mask) & 0x01u) <<  0) | (((mask) & 0x02u) <<  3) |                       \
+   (((mask) & 0x04u) <<  6) | (((mask) & 0x08u) <<  9) |                       \
+   (((mask) & 0x10u) << 12) | (((mask) & 0x20u) << 15) |                       \
+   (((mask) & 0x40u) << 18) | (((mask) & 0x80u) << 21))
+
+
+/*- Public interface ---------------------------------------------------------*/
+#if defined(GPIO_FAST_OUT_OF_LINE) && !defined(GPIO_FAST_IMPLEMENTATION)
+void GpioFast_vSet(GPIO_TypeDef* psPort, uint32_t ulPins);
+void GpioFast_vReset(GPIO_TypeDef* psPort, uint32_t ulPins);
+void GpioFast_vWrite(GPIO_TypeDef* psPort, uint32_t ulPins, bool bState);
+void GpioFast_vToggle(GPIO_TypeDef* psPort, uint32_t ulPins);
+bool GpioFast_bRead(GPIO_TypeDef* psPort, uint32_t ulPins);
+void GpioFast_vInit(GPIO_TypeDef* psPort, uint32_t ulPins, uint32_t ulMode, uint32_t ulPull, uint32_t ulSpeed);
+#else
+/*!****************************************************************************
+ * @brief
+ * Set pins (single BSRR store)
+ *
+ * @param[in] psPort  GPIO port
+ * @param[in] ulPins  Pin mask "GPIO_PIN_..."
+ * @date  17.10.2026
+ ******************************************************************************/
+GPIO_FAST_INLINE void GpioFast_vSet(GPIO_TypeDef* psPort, uint32_t ulPins)
+{
+  psPort->BSRR = ulPins;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset pins (single BRR store)
+ *
+ * @param[in] psPort  GPIO port
+ * @param[in] ulPins  Pin mask "GPIO_PIN_..."
+ * @date  17.10.2026
+ ******************************************************************************/
+GPIO_FAST_INLINE void GpioFast_vReset(GPIO_TypeDef* psPort, uint32_t ulPins)
+{
+  psPort->BRR = ulPins;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write pins (single BSRR store)
+ *
+ * @param[in] psPort  GPIO port
+ * @param[in] ulPins  Pin mask "GPIO_PIN_..."
+ * @param[in] bState  Output state
+ * @date  17.10.2026
+ ******************************************************************************/
+GPIO_FAST_INLINE void GpioFast_vWrite(GPIO_TypeDef* psPort, uint32_t ulPins, bool bState)
+{
+  psPort->BSRR = bState ? ulPins : (ulPins << 16);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Toggle pins
+ *
+ * Sets the pins currently low and resets the pins currently high with one
+ * BSRR store; other pins of the port are unaffected. The ODR load and the
+ * store are separate accesses: if an interrupt handler changes the same pins
+ * in between, its change is overwritten. Disable the interrupt around the
+ * toggle in that case.
+ *
+ * @param[in] psPort  GPIO port
+ * @param[in] ulPins  Pin mask "GPIO_PIN_..."
+ * @date  17.10.2026
+ ******************************************************************************/
+GPIO_FAST_INLINE void GpioFast_vToggle(GPIO_TypeDef* psPort, uint32_t ulPins)
+{
+  uint32_t ulOdr = psPort->ODR;
+  psPort->BSRR = ((ulOdr & ulPins) << 16) | (~ulOdr & ulPins);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read pins
+ *
+ * @param[in] psPort  GPIO port
+ * @param[in] ulPins  Pin mask "GPIO_PIN_..."
+ * @return  (bool)  Any of the pins high
+ * @date  17.10.2026
+ ******************************************************************************/
+GPIO_FAST_INLINE bool GpioFast_bRead(GPIO_TypeDef* psPort, uint32_t ulPins)
+{
+  return (psPort->IDR & ulPins) != 0u;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Configure pins (equivalent of @c HAL_GPIO_Init without interrupt modes)
+ *
+ * Updates only the CRL/CRH halves containing pins. The pull direction of
+ * inputs with pull-up or pull-down is set with a BSRR/BRR store.
+ *
+ * @param[in] psPort  GPIO port
+ * @param[in] ulPins  Pin mask "GPIO_PIN_..."
+ * @param[in] ulMode  Mode "GPIO_MODE_..." (see @c GPIO_FAST_CONFIG)
+ * @param[in] ulPull  Pull "GPIO_NOPULL", "GPIO_PULLUP" or "GPIO_PULLDOWN"
+ * @param[in] ulSpeed Output speed "GPIO_SPEED_FREQ_..."
+ * @date  17.10.2026
+ ******************************************************************************/
+GPIO_FAST_INLINE void GpioFast_vInit(GPIO_TypeDef* psPort, uint32_t ulPins, uint32_t ulMode, uint32_t ulPull,
+                                     uint32_t ulSpeed)
+{
+  uint32_t ulConfig = GPIO_FAST_CONFIG(ulMode, ulPull, ulSpeed);
+  uint32_t ulLow = GPIO_FAST_NIBBLES(ulPins & 0xFFu);
+  uint32_t ulHigh = GPIO_FAST_NIBBLES((ulPins >> 8) & 0xFFu);
+  if (ulLow != 0u) psPort->CRL = (psPort->CRL & ~(ulLow * 0xFu)) | (ulLow * ulConfig);
+  if (ulHigh != 0u) psPort->CRH = (psPort->CRH & ~(ulHigh * 0xFu)) | (ulHigh * ulConfig);
+  if (ulConfig == 0x8u)
+  {
+    if (ulPull == GPIO_PULLUP) psPort->BSRR = ulPins;
+    else psPort->BRR = ulPins;
+  }
+}
+#endif
+
+#endif // GPIO_FAST_H_
@@ -0,0 +1,64 @@
+# HAL module configuration
+#
+# "minimal": a copy of "Controller/stm32f1xx_hal_conf.h" is generated in the
+# build folder with only the HAL modules enabled that are referenced by the
+# application (see "Tools/scripts/halconf.py"). The driver sources of all other
+# modules are removed from TARGET_SOURCES.
+# "full": the configuration header is used unchanged, all modules are built.
+# The full configuration is also used if the analysis fails.
+set(HAL_CONF "minimal" CACHE STRING "HAL module configuration (minimal, full)")
+set_property(CACHE HAL_CONF PROPERTY STRINGS minimal full)
+
+if(HAL_CONF STREQUAL "minimal")
+	set(HAL_DRIVER_DIR ${CMAKE_SOURCE_DIR}/Controller/STM32F1xx/Peripheral)
+
+	# Application sources and headers: everything but the module drivers
+	file(GLOB_RECURSE HAL_CONF_SOURCES ${CMAKE_SOURCE_DIR}/*.h)
+	list(FILTER HAL_CONF_SOURCES EXCLUDE REGEX "build[^\/]*\/.*")
+	list(FILTER HAL_CONF_SOURCES EXCLUDE REGEX "Controller\/STM32F1xx\/.*")
+	list(FILTER HAL_CONF_SOURCES EXCLUDE REGEX "Tools\/.*")
+	list(FILTER HAL_CONF_SOURCES EXCLUDE REGEX "Host\/.*")
+	list(FILTER HAL_CONF_SOURCES EXCLUDE REGEX "stm32f1xx_hal_conf\\.h$")
+	list(APPEND HAL_CONF_SOURCES ${TARGET_SOURCES} ${UNIT_SOURCES} ${COVERAGE_RUNTIME_SOURCES})
+	list(FILTER HAL_CONF_SOURCES EXCLUDE REGEX "\/stm32f1xx_hal_[a-z0-9]+(_ex)?\\.c$")
+	list(REMOVE_DUPLICATES HAL_CONF_SOURCES)
+
+	find_package(Python3 COMPONENTS Interpreter)
+	if(Python3_FOUND)
+		execute_process(
+			COMMAND ${Python3_EXECUTABLE} ${CMAKE_SOURCE_DIR}/Tools/scripts/halconf.py
+				${CMAKE_SOURCE_DIR}/Controller/stm32f1xx_hal_conf.h ${HAL_DRIVER_DIR} ${HAL_CONF_SOURCES}
+				-o ${CMAKE_BINARY_DIR}/hal_conf/stm32f1xx_hal_conf.h --modules ${CMAKE_BINARY_DIR}/hal_conf/modules.txt
+			RESULT_VARIABLE HAL_CONF_RESULT
+			OUTPUT_VARIABLE HAL_CONF_OUTPUT
+			ERROR_VARIABLE HAL_CONF_OUTPUT
+			OUTPUT_STRIP_TRAILING_WHITESPACE
+			ERROR_STRIP_TRAILING_WHITESPACE
+		)
+	endif()
+
+	if(Python3_FOUND AND HAL_CONF_RESULT EQUAL 0)
+		message(STATUS ${HAL_CONF_OUTPUT})
+
+		# Generated header takes precedence over "Controller/stm32f1xx_hal_conf.h"
+		target_include_directories(firmware-common BEFORE INTERFACE
+			${CMAKE_BINARY_DIR}/hal_conf
+		)
+
+		# Skip the driver sources of disabled modules
+		file(STRINGS ${CMAKE_BINARY_DIR}/hal_conf/modules.txt HAL_MODULES)
+		foreach(SOURCE IN LISTS TARGET_SOURCES)
+			if(SOURCE MATCHES "\/stm32f1xx_hal_([a-z0-9]+)(_ex)?\\.c$" AND NOT CMAKE_MATCH_1 IN_LIST HAL_MODULES)
+				list(REMOVE_ITEM TARGET_SOURCES ${SOURCE})
+			endif()
+		endforeach()
+
+		# Re-run the analysis when the application changes
+		set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS
+			${HAL_CONF_SOURCES}
+			${CMAKE_SOURCE_DIR}/Controller/stm32f1xx_hal_conf.h
+		)
+	else()
+		message(WARNING "HAL module analysis failed, using the full configuration: ${HAL_CONF_OUTPUT}")
+	endif()
+endif()
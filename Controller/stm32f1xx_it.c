@@ -20,6 +20,7 @@
 
 /*- Header files -------------------------------------------------------------*/
 #include "stm32f1xx.h"
+#include "timebase.h"
 
 
 /*!*****************************************************************************
@@ -118,9 +119,26 @@ void PendSV_Handler(void)
  * @brief
  * SysTick Interrupt Handler
  *
+ * Increments the HAL tick and extends the cycle time base
+ * ("Timebase/timebase.h").
+ *
  * @date  21.08.2023
  ******************************************************************************/
 void SysTick_Handler(void)
 {
   HAL_IncTick();
+  Timebase_vUpdate();
+}
+
+/*!*****************************************************************************
+ * @brief
+ * EXTI line 0 interrupt handler
+ *
+ * Clears the pending line and calls @c HAL_GPIO_EXTI_Callback.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void EXTI0_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_0);
 }
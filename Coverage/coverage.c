@@ -10,21 +10,39 @@
 
 /*- Header files -------------------------------------------------------------*/
 #include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 #include <gcov.h>
+#include "clock_boost.h"
+#include "memory.h"
 #include "semihost.h"
 #include "coverage.h"
 
 
+/*- Type definitions ---------------------------------------------------------*/
+/// Output stream state of the dump callbacks
+typedef struct DumpStream
+{
+  int32_t lFile;                      ///< Semihosting file handle
+  uint32_t ulBytes;                   ///< Bytes written
+  uint32_t ulOps;                     ///< Semihosting operations
+} DumpStream;
+
+
 /*- Global data --------------------------------------------------------------*/
 // gcov info structures in FLASH memory, placed by the linker
 extern const struct gcov_info* const __gcov_info_start[]; // start marker
 extern const struct gcov_info* const __gcov_info_end[]; // end marker
 
+static Coverage_DumpStats s_sDumpStats; ///< Statistics of the last dump
+static bool s_bDumpBoost = (COVERAGE_DUMP_BOOST != 0); ///< Dumps at the boost clock
+
 
 /*- Prototypes ---------------------------------------------------------------*/
 static void vDumpCb(const void *pData, unsigned uLength, void *pArg);
 static void vFilenameCb(const char *pszFname, void *pArg);
 static void* pAllocateCb(unsigned, void *);
+static void vDumpMeta(const char* pszFilename, const Memory_Usage* psUsage);
 
 
 /*- Public interface ---------------------------------------------------------*/
@@ -35,8 +53,24 @@ static void* pAllocateCb(unsigned, void *);
  * @date  31.10.2025
  ******************************************************************************/
 void Coverage_vInit(void)
+{
+  Coverage_vReset();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset all coverage counters
+ *
+ * Allows coverage to be collected per section of a run, e.g. per test case.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vReset(void)
 {
   __gcov_reset();
+#if defined(COVERAGE_BANKS)
+  Coverage_vResetBanks();
+#endif
 }
 
 /*!****************************************************************************
@@ -44,19 +78,98 @@ void Coverage_vInit(void)
  * Dump coverage data to a file
  *
  * This will dump all collected coverage data to a file on the host machine,
- * using Semihosting file transfers.
+ * using Semihosting file transfers. In @c COVERAGE_BANKS builds, the thread
+ * and handler coverage banks are written to @c COVERAGE_BANKS_OUTPUT_FILE.
+ * The stack and heap usage of the application (scanned before the dump) is
+ * written to @c COVERAGE_META_OUTPUT_FILE.
  *
  * @param[in] pszFilename Output file name on host system
  * @date  31.10.2025
  ******************************************************************************/
 void Coverage_vDump(const char* pszFilename)
 {
+  Memory_Usage sUsage;
+  Memory_vGetUsage(&sUsage);
+
   int32_t lFile = lSemihostOpen(pszFilename, 5 /* wb */);
+  (void)Coverage_ulDumpToFile(lFile);
+  bSemihostClose(lFile);
+  s_sDumpStats.ulOps += 2uL; // open, close
+#if defined(COVERAGE_BANKS)
+  Coverage_vDumpBanks(COVERAGE_BANKS_OUTPUT_FILE);
+#endif
+  vDumpMeta(COVERAGE_META_OUTPUT_FILE, &sUsage);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Dump coverage data to an open file
+ *
+ * Writes the same stream as @c Coverage_vDump at the current file position,
+ * e.g. as one record of a larger output file. With the dump boost enabled,
+ * the core runs at the boost clock during the serialisation.
+ *
+ * @param[in] lFile   Semihosting file handle
+ * @return  (uint32_t)  Number of bytes written
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Coverage_ulDumpToFile(int32_t lFile)
+{
+  ClockBoost_State sClock;
+  bool bBoosted = s_bDumpBoost && ClockBoost_bEnter(&sClock);
+
+  DumpStream sStream = { .lFile = lFile, .ulBytes = 0uL, .ulOps = 0uL };
   for (const struct gcov_info* const* pIt = __gcov_info_start; pIt != __gcov_info_end; ++pIt)
   {
-    __gcov_info_to_gcda(*pIt, vFilenameCb, vDumpCb, pAllocateCb, &lFile);
+    __gcov_info_to_gcda(*pIt, vFilenameCb, vDumpCb, pAllocateCb, &sStream);
   }
-  bSemihostClose(lFile);
+
+  if (bBoosted) ClockBoost_vLeave(&sClock);
+  s_sDumpStats = (Coverage_DumpStats){ .ulBytes = sStream.ulBytes, .ulOps = sStream.ulOps, .bBoosted = bBoosted };
+  return sStream.ulBytes;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get transfer statistics of the last coverage dump
+ *
+ * Used by the benchmarks to track the cost of a dump (see "Benchmark/").
+ *
+ * @param[out] psStats  Bytes and Semihosting operations of the last
+ *                      @c Coverage_vDump or @c Coverage_ulDumpToFile call
+ *                      (without the coverage banks)
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vGetDumpStats(Coverage_DumpStats* psStats)
+{
+  *psStats = s_sDumpStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Enable or disable the clock boost of the dumps
+ *
+ * The default is set by @c COVERAGE_DUMP_BOOST. Without HSE, or with the PLL
+ * already enabled by the application, dumps run at the application clock.
+ *
+ * @param[in] bBoost  Serialise coverage data at @c CLOCK_BOOST_HZ
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vSetDumpBoost(bool bBoost)
+{
+  s_bDumpBoost = bBoost;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get the clock boost setting of the dumps
+ *
+ * @return  (bool)  Coverage data serialised at @c CLOCK_BOOST_HZ
+ * @date  17.10.2026
+ ******************************************************************************/
+bool Coverage_bGetDumpBoost(void)
+{
+  return s_bDumpBoost;
 }
 
 
@@ -67,12 +180,15 @@ void Coverage_vDump(const char* pszFilename)
  *
  * @param[in] pData   Source data buffer
  * @param[in] uLength Source data length in bytes
- * @param[inout] pArg User-defined argument (here used for fp)
+ * @param[inout] pArg User-defined argument (here used for the output stream)
  * @date  31.10.2025
 *******************************************************************************/
 static void vDumpCb(const void *pData, unsigned uLength, void *pArg)
 {
-  lSemihostWrite(*(int32_t*)pArg, pData, uLength);
+  DumpStream* psStream = pArg;
+  int32_t lLeft = lSemihostWrite(psStream->lFile, pData, uLength);
+  psStream->ulBytes += uLength - (uint32_t)lLeft;
+  ++psStream->ulOps;
 }
 
 /*!****************************************************************************
@@ -80,15 +196,25 @@ static void vDumpCb(const void *pData, unsigned uLength, void *pArg)
  * Callback: Serialise filename to gfcn data stream
  *
  * The contained data is deserialised using the "merge-stream" command of the
- * "gcov-tool".
+ * "gcov-tool". The file name is written from the last @c COVERAGE_OBJECT_DIR
+ * component on, so the stream can be processed in any copy of the build folder.
  *
  * @param[in] pszFname  File name of coverage info
- * @param[inout] pArg   User-defined argument (here used for fp)
- * @date  31.10.2025
+ * @param[inout] pArg   User-defined argument (here used for the output stream)
+ * @date  17.10.2026
  ******************************************************************************/
 static void vFilenameCb(const char *pszFname, void *pArg)
 {
-  __gcov_filename_to_gcfn(pszFname, vDumpCb, pArg);
+  const char* pszName = pszFname;
+  for (const char* pszIt = pszFname; *pszIt != '\0'; ++pszIt)
+  {
+    if (((pszIt == pszFname) || (pszIt[-1] == '/')) &&
+        (strncmp(pszIt, COVERAGE_OBJECT_DIR, sizeof(COVERAGE_OBJECT_DIR) - 1u) == 0))
+    {
+      pszName = pszIt;
+    }
+  }
+  __gcov_filename_to_gcfn(pszName, vDumpCb, pArg);
 }
 
 /*!****************************************************************************
@@ -107,3 +233,36 @@ static void* pAllocateCb(unsigned, void *)
   return NULL;
 }
 
+
+/*!****************************************************************************
+ * @brief
+ * Write the dump metadata: stack and heap usage, one "key=value" per line
+ *
+ * The heap and stack configuration reported by the host ("SYS_HEAPINFO") is
+ * added if available, for comparison with the layout of the linker script.
+ *
+ * @param[in] pszFilename Output file name on host system
+ * @param[in] psUsage     Stack and heap usage of the application
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vDumpMeta(const char* pszFilename, const Memory_Usage* psUsage)
+{
+  char acMeta[256];
+  int iLen = snprintf(acMeta, sizeof(acMeta),
+                      "stack_size=%lu\nstack_used=%lu\nstack_peak=%lu\nheap_size=%lu\nheap_used=%lu\nfree=%lu\n",
+                      (unsigned long)psUsage->ulStackSize, (unsigned long)psUsage->ulStackUsed,
+                      (unsigned long)psUsage->ulStackPeak, (unsigned long)psUsage->ulHeapSize,
+                      (unsigned long)psUsage->ulHeapUsed, (unsigned long)psUsage->ulFree);
+  Semihost_HeapInfo sInfo;
+  if (bSemihostGetHeapInfo(&sInfo) && (iLen < (int)sizeof(acMeta)))
+  {
+    iLen += snprintf(&acMeta[iLen], sizeof(acMeta) - (uint32_t)iLen,
+                     "host_heap=%p %p\nhost_stack=%p %p\n",
+                     sInfo.pHeapBase, sInfo.pHeapLimit, sInfo.pStackBase, sInfo.pStackLimit);
+  }
+  if (iLen > (int)sizeof(acMeta) - 1) iLen = (int)sizeof(acMeta) - 1;
+
+  int32_t lFile = lSemihostOpen(pszFilename, 4 /* w */);
+  (void)lSemihostWrite(lFile, acMeta, (uint32_t)iLen);
+  bSemihostClose(lFile);
+}
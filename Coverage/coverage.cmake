@@ -1,15 +1,106 @@
 # List of files to instrument for coverage
-set(INSTRUMENTED_SOURCES
-	main.c
-	Controller/STM32F1xx/Peripheral/src/stm32f1xx_hal.c
-	Controller/STM32F1xx/Peripheral/src/stm32f1xx_hal_gpio.c
-)
+include(${CMAKE_CURRENT_LIST_DIR}/instrumented_sources.cmake)
+
+# Instrumentation can be disabled for runs with external coverage collection
+# (e.g. the QEMU TCG plugin in "Tools/tbcov")
+option(COVERAGE_INSTRUMENT "Instrument INSTRUMENTED_SOURCES for gcov" ON)
+
+# Source file properties apply to every target compiling the file; the instru-
+# mentation options are limited to the coverage image
+set(COVERAGE_IMAGE "$<STREQUAL:$<TARGET_PROPERTY:NAME>,${PROJECT_NAME}>")
 
 # Add build options in order to activate coverage instrumentation for selected files
-set_source_files_properties(
-	${INSTRUMENTED_SOURCES}
-	PROPERTIES COMPILE_FLAGS --coverage
-)
+if(COVERAGE_INSTRUMENT)
+	set_source_files_properties(
+		${INSTRUMENTED_SOURCES}
+		PROPERTIES COMPILE_FLAGS "$<${COVERAGE_IMAGE}:--coverage>"
+	)
+endif()
+
+# Condition coverage (MC/DC, GCC 14 or later) for all instrumented files or the
+# subset listed in COVERAGE_CONDITION_SOURCES. Each decision adds two 64-bit
+# counters (RAM) and the code to update them.
+option(COVERAGE_CONDITIONS "Instrument INSTRUMENTED_SOURCES for condition coverage" OFF)
+set(COVERAGE_CONDITION_SOURCES "" CACHE STRING "Restrict condition coverage to these files (relative to the repository root)")
+if(COVERAGE_INSTRUMENT AND COVERAGE_CONDITIONS)
+	if(CMAKE_C_COMPILER_VERSION VERSION_LESS 14)
+		message(FATAL_ERROR "COVERAGE_CONDITIONS requires GCC 14 or later")
+	endif()
+	if(COVERAGE_CONDITION_SOURCES)
+		foreach(SOURCE IN LISTS COVERAGE_CONDITION_SOURCES)
+			if(NOT SOURCE IN_LIST INSTRUMENTED_SOURCES)
+				message(FATAL_ERROR "${SOURCE} in COVERAGE_CONDITION_SOURCES is not instrumented")
+			endif()
+		endforeach()
+		set(CONDITION_SOURCES ${COVERAGE_CONDITION_SOURCES})
+	else()
+		set(CONDITION_SOURCES ${INSTRUMENTED_SOURCES})
+	endif()
+	set_property(SOURCE ${CONDITION_SOURCES}
+		APPEND_STRING PROPERTY COMPILE_FLAGS " $<${COVERAGE_IMAGE}:-fcondition-coverage>"
+	)
+endif()
+
+# Separate coverage banks for thread and handler (interrupt) context, see
+# "Coverage/coverage_banks.c". The trace-pc hooks are inserted by the sancov
+# pass, which would otherwise only run at link time under LTO.
+option(COVERAGE_BANKS "Record executed blocks of INSTRUMENTED_SOURCES per execution context" OFF)
+if(COVERAGE_BANKS)
+	set_property(SOURCE ${INSTRUMENTED_SOURCES}
+		APPEND_STRING PROPERTY COMPILE_FLAGS " $<${COVERAGE_IMAGE}:-fsanitize-coverage=trace-pc> $<${COVERAGE_IMAGE}:-fno-lto>"
+	)
+	target_compile_definitions(${PROJECT_NAME} PRIVATE
+		-DCOVERAGE_BANKS
+	)
+endif()
+
+# Serialise the coverage data at the 72 MHz PLL clock instead of the clock of
+# the application (see "Controller/clock_boost.c"); Coverage_vSetDumpBoost()
+# changes the setting at run time
+option(COVERAGE_DUMP_BOOST "Switch to the PLL clock during coverage dumps" OFF)
+if(COVERAGE_DUMP_BOOST)
+	target_compile_definitions(${PROJECT_NAME} PRIVATE
+		-DCOVERAGE_DUMP_BOOST=1
+	)
+endif()
+
+# Function-level filter: exclude e.g. hot interrupt paths from instrumentation
+# (COVERAGE_EXCLUDE_FUNCTIONS, COVERAGE_INCLUDE_FUNCTIONS) and report the
+# instrumented functions after each build
+include(${CMAKE_CURRENT_LIST_DIR}/coverage_filter.cmake)
+if(COVERAGE_INSTRUMENT)
+	list(TRANSFORM INSTRUMENTED_SOURCES PREPEND "${CMAKE_SOURCE_DIR}/" OUTPUT_VARIABLE FILTERED_SOURCES)
+	if(COVERAGE_BANKS)
+		coverage_filter_sources("${FILTERED_SOURCES}" no_sanitize_coverage)
+	else()
+		coverage_filter_sources("${FILTERED_SOURCES}")
+	endif()
+
+	find_package(Python3 COMPONENTS Interpreter)
+	if(Python3_FOUND)
+		add_custom_command(TARGET ${PROJECT_NAME} POST_BUILD
+			COMMAND ${Python3_EXECUTABLE} ${CMAKE_SOURCE_DIR}/Tools/scripts/instrumented_functions.py
+				${PROJECT_NAME}${CMAKE_EXECUTABLE_SUFFIX} coverage_functions.txt -o coverage_functions_report.txt
+			BYPRODUCTS coverage_functions_report.txt
+		)
+
+		# Memory cost of the instrumentation per unit, compared to the release
+		# image or another uninstrumented image if given
+		set(COVERAGE_COST_BASELINE "" CACHE FILEPATH "Uninstrumented image for the instrumentation cost report (default: release image)")
+		set(COVERAGE_COST_ARGS --json coverage_cost.json)
+		if(COVERAGE_COST_BASELINE)
+			list(APPEND COVERAGE_COST_ARGS --baseline ${COVERAGE_COST_BASELINE})
+		else()
+			list(APPEND COVERAGE_COST_ARGS --baseline ${PROJECT_NAME}-release${CMAKE_EXECUTABLE_SUFFIX})
+			add_dependencies(${PROJECT_NAME} ${PROJECT_NAME}-release)
+		endif()
+		add_custom_command(TARGET ${PROJECT_NAME} POST_BUILD
+			COMMAND ${Python3_EXECUTABLE} ${CMAKE_SOURCE_DIR}/Tools/scripts/covcost.py
+				${PROJECT_NAME}${CMAKE_EXECUTABLE_SUFFIX} coverage_functions.txt ${COVERAGE_COST_ARGS}
+			BYPRODUCTS coverage_cost.json
+		)
+	endif()
+endif()
 
 # General coverage configuration
 target_compile_options(${PROJECT_NAME} PRIVATE
@@ -20,11 +111,24 @@ target_link_options(${PROJECT_NAME} PRIVATE
 	-T${CMAKE_SOURCE_DIR}/Coverage/gcov_info.ld
 )
 
-# Register ".gcno" files as byproducts
-list(TRANSFORM INSTRUMENTED_SOURCES PREPEND "CMakeFiles/${PROJECT_NAME}.dir/") # dirty...
-list(TRANSFORM INSTRUMENTED_SOURCES APPEND ".gcno")
-list(JOIN INSTRUMENTED_SOURCES " " INSTRUMENTED_SOURCES)
-add_custom_command(TARGET ${PROJECT_NAME} POST_BUILD
-	COMMAND true
-	BYPRODUCTS ${INSTRUMENTED_SOURCES}
-)
\ No newline at end of file
+# Instrumented objects at their fixed location in the object folder, listed in
+# "coverage_notes.txt" (relative to the build folder) for the report scripts.
+# Their ".gcno" notes files are registered as byproducts.
+if(COVERAGE_INSTRUMENT)
+	list(TRANSFORM INSTRUMENTED_SOURCES
+		PREPEND "CMakeFiles/${PROJECT_NAME}.dir/"
+		OUTPUT_VARIABLE COVERAGE_OBJECTS
+	)
+	list(TRANSFORM COVERAGE_OBJECTS APPEND "${CMAKE_C_OUTPUT_EXTENSION}")
+	list(JOIN COVERAGE_OBJECTS "\n" COVERAGE_NOTES)
+	file(CONFIGURE OUTPUT coverage_notes.txt CONTENT "${COVERAGE_NOTES}\n" @ONLY)
+
+	list(TRANSFORM COVERAGE_OBJECTS
+		REPLACE "\\${CMAKE_C_OUTPUT_EXTENSION}$" ".gcno"
+		OUTPUT_VARIABLE COVERAGE_NOTES
+	)
+	add_custom_command(TARGET ${PROJECT_NAME} POST_BUILD
+		COMMAND true
+		BYPRODUCTS ${COVERAGE_NOTES}
+	)
+endif()
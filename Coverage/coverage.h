@@ -11,8 +11,70 @@
 #ifndef COVERAGE_H_
 #define COVERAGE_H_
 
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Coverage data output file, relative to the working directory of the host
+#ifndef COVERAGE_OUTPUT_FILE
+#define COVERAGE_OUTPUT_FILE          "build/coverage.bin"
+#endif
+
+/// Dump metadata output file ("key=value" lines: stack and heap usage)
+#ifndef COVERAGE_META_OUTPUT_FILE
+#define COVERAGE_META_OUTPUT_FILE     "build/coverage_meta.txt"
+#endif
+
+/// Start of the object folder in coverage data file names. The leading part (the
+/// absolute path of the build folder) is not dumped; the data files are created
+/// relative to the working directory of "gcov-tool merge-stream".
+#ifndef COVERAGE_OBJECT_DIR
+#define COVERAGE_OBJECT_DIR           "CMakeFiles/"
+#endif
+
+/// Dumps at the boost clock (see "Controller/clock_boost.h") by default; can
+/// be changed at run time with @c Coverage_vSetDumpBoost
+#ifndef COVERAGE_DUMP_BOOST
+#define COVERAGE_DUMP_BOOST           0
+#endif
+
+/// Thread/handler coverage bank output file (@c COVERAGE_BANKS builds only)
+#ifndef COVERAGE_BANKS_OUTPUT_FILE
+#define COVERAGE_BANKS_OUTPUT_FILE    "build/coverage_banks.bin"
+#endif
+
+/// Code address range covered by the coverage banks (FLASH memory)
+#ifndef COVERAGE_BANKS_TEXT_BASE
+#define COVERAGE_BANKS_TEXT_BASE      0x08000000uL
+#endif
+#ifndef COVERAGE_BANKS_TEXT_SIZE
+#define COVERAGE_BANKS_TEXT_SIZE      0x00010000uL
+#endif
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Transfer statistics of the last coverage dump
+typedef struct Coverage_DumpStats
+{
+  uint32_t ulBytes;                   ///< Bytes written
+  uint32_t ulOps;                     ///< Semihosting operations
+  bool bBoosted;                      ///< Serialised at the boost clock
+} Coverage_DumpStats;
+
+
 /*- Public interface ---------------------------------------------------------*/
 void Coverage_vInit(void);
+void Coverage_vReset(void);
 void Coverage_vDump(const char* pszFilename);
+uint32_t Coverage_ulDumpToFile(int32_t lFile);
+void Coverage_vGetDumpStats(Coverage_DumpStats* psStats);
+void Coverage_vSetDumpBoost(bool bBoost);
+bool Coverage_bGetDumpBoost(void);
+#if defined(COVERAGE_BANKS)
+void Coverage_vResetBanks(void);
+void Coverage_vDumpBanks(const char* pszFilename);
+#endif
 
 #endif // COVERAGE_H_
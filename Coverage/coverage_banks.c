@@ -0,0 +1,133 @@
+/*!****************************************************************************
+ * @file
+ * coverage_banks.c
+ *
+ * @brief
+ * Separate block coverage for thread and handler (interrupt) context
+ *
+ * With @c COVERAGE_BANKS enabled, the instrumented sources are additionally
+ * compiled with "-fsanitize-coverage=trace-pc", which inserts a call to
+ * @c __sanitizer_cov_trace_pc at the start of each basic block. The hook sets
+ * one bit per call site in one of two banks, selected by IPSR: bank 0 for
+ * thread mode, bank 1 for handler mode (any exception, e.g. SysTick).
+ *
+ * Call sites are identified by their return address. Thumb-2 calls are four
+ * bytes long, so one bit per word of the text region is sufficient. The bits
+ * are set through the SRAM bit-band alias with a single store, so the hook
+ * doesn't need a read-modify-write sequence and is safe against preemption by
+ * nested interrupts.
+ *
+ * Costs with the default 64 KiB text region:
+ *  - RAM: 2 banks x 64 KiB / 4 / 8 = 4 KiB
+ *  - About 21 cycles per executed block for the call, 12 instructions and the
+ *    return (DWT cycle count of the -O1 instruction sequence in "armsim"), in
+ *    addition to the gcov counter increments
+ *
+ * The banks are written to @c COVERAGE_BANKS_OUTPUT_FILE by @c Coverage_vDump.
+ * Run "Coverage/process_banks.sh" in the build folder to generate the reports.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#if defined(COVERAGE_BANKS)
+
+/*- Header files -------------------------------------------------------------*/
+#include <string.h>
+#include "stm32f1xx.h"
+#include "semihost.h"
+#include "coverage.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Output file format identification and version
+#define BANKS_MAGIC                   0x4B4E4243uL  // "CBNK"
+#define BANKS_VERSION                 1uL
+
+/// Bytes per bank bit (size of a Thumb-2 "bl" instruction)
+#define BANKS_GRANULE                 4uL
+
+/// Call sites per bank
+#define BANKS_SITES                   (COVERAGE_BANKS_TEXT_SIZE / BANKS_GRANULE)
+
+/// Number of banks: thread mode, handler mode
+#define BANKS_COUNT                   2u
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Output file header
+typedef struct BanksHeader
+{
+  uint32_t ulMagic;                   ///< @c BANKS_MAGIC
+  uint32_t ulVersion;                 ///< @c BANKS_VERSION
+  uint32_t ulTextBase;                ///< Address of the first call site bit
+  uint32_t ulGranule;                 ///< Bytes per bit
+  uint32_t ulSites;                   ///< Bits per bank
+  uint32_t ulBanks;                   ///< Number of banks following the header
+} BanksHeader;
+
+
+/*- Global data --------------------------------------------------------------*/
+/// Call site bits of all banks (bank 0: thread mode, bank 1: handler mode)
+static uint32_t s_aulBanks[BANKS_COUNT * BANKS_SITES / 32u];
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+void __sanitizer_cov_trace_pc(void);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Clear both coverage banks
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vResetBanks(void)
+{
+  memset(s_aulBanks, 0, sizeof(s_aulBanks));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Dump coverage banks to a file
+ *
+ * @param[in] pszFilename Output file name on host system
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vDumpBanks(const char* pszFilename)
+{
+  const BanksHeader sHeader = {
+    .ulMagic = BANKS_MAGIC,
+    .ulVersion = BANKS_VERSION,
+    .ulTextBase = COVERAGE_BANKS_TEXT_BASE,
+    .ulGranule = BANKS_GRANULE,
+    .ulSites = BANKS_SITES,
+    .ulBanks = BANKS_COUNT
+  };
+
+  int32_t lFile = lSemihostOpen(pszFilename, 5 /* wb */);
+  if (lFile < 0) return;
+  (void)lSemihostWrite(lFile, &sHeader, sizeof(sHeader));
+  (void)lSemihostWrite(lFile, s_aulBanks, sizeof(s_aulBanks));
+  bSemihostClose(lFile);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Callback: Basic block entry in instrumented code
+ *
+ * Marks the call site in the bank of the current execution context.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void __sanitizer_cov_trace_pc(void)
+{
+  uint32_t ulSite = ((uint32_t)__builtin_return_address(0) - COVERAGE_BANKS_TEXT_BASE) / BANKS_GRANULE;
+  if (ulSite >= BANKS_SITES) return;
+  if (__get_IPSR() != 0uL) ulSite += BANKS_SITES;
+
+  volatile uint32_t* pulAlias = (volatile uint32_t*)(SRAM_BB_BASE + (((uint32_t)s_aulBanks - SRAM_BASE) << 5));
+  pulAlias[ulSite] = 1uL;
+}
+
+#endif // COVERAGE_BANKS
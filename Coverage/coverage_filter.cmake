@@ -0,0 +1,80 @@
+# Function-level coverage instrumentation filter
+#
+# COVERAGE_EXCLUDE_FUNCTIONS lists regular expressions of function names that
+# are not instrumented, e.g. hot interrupt paths such as "HAL_IncTick". If
+# COVERAGE_INCLUDE_FUNCTIONS is set, only matching functions are instrumented.
+# Expressions must match the whole name.
+#
+# Function definitions are located in the instrumented sources at configure
+# time. Filtered functions are redeclared with the "no_profile_instrument_func-
+# tion" attribute in a generated header, which is force-included into their
+# unit. The types used in the signatures are taken from COVERAGE_FILTER_INCLUDE.
+# All definitions found are listed in "coverage_functions.txt" in the build
+# folder, for the post-build report "Tools/scripts/instrumented_functions.py".
+set(COVERAGE_EXCLUDE_FUNCTIONS "" CACHE STRING "Functions not to instrument (list of regular expressions)")
+set(COVERAGE_INCLUDE_FUNCTIONS "" CACHE STRING "Only instrument these functions (list of regular expressions)")
+set(COVERAGE_FILTER_INCLUDE "stm32f1xx_hal.h" CACHE STRING "Header declaring the types of instrumented function signatures")
+
+# Apply the filter to the given source files (absolute paths). Attributes are
+# appended to the list in ARGN, e.g. "no_sanitize_coverage".
+function(coverage_filter_sources SOURCES)
+	set(ATTRIBUTES no_profile_instrument_function ${ARGN})
+	list(JOIN ATTRIBUTES ", " ATTRIBUTES)
+	set(MANIFEST "")
+
+	foreach(SOURCE IN LISTS SOURCES)
+		file(RELATIVE_PATH UNIT ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/.. ${SOURCE})
+		set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${SOURCE})
+
+		# Function definitions: signature at the start of a line, opening brace on
+		# the following line
+		file(READ ${SOURCE} CONTENT)
+		string(REGEX MATCHALL "\n[A-Za-z_][A-Za-z0-9_ \t*]*[ \t*][A-Za-z_][A-Za-z0-9_]*[ \t]*\\([^;{}]*\\)[ \t\r]*\n[ \t]*{"
+			DEFINITIONS "\n${CONTENT}"
+		)
+
+		set(DECLARATIONS "")
+		foreach(DEFINITION IN LISTS DEFINITIONS)
+			string(REGEX REPLACE "[ \t\r]*\n[ \t]*{$" "" SIGNATURE "${DEFINITION}")
+			string(REGEX REPLACE "^\n" "" SIGNATURE "${SIGNATURE}")
+			string(REGEX REPLACE "[ \t\r\n]+" " " SIGNATURE "${SIGNATURE}")
+			string(REGEX REPLACE "(^| )(__weak|__WEAK) " "\\1" SIGNATURE "${SIGNATURE}")
+			string(REGEX MATCH "([A-Za-z_][A-Za-z0-9_]*) ?\\(" _ "${SIGNATURE}")
+			set(NAME ${CMAKE_MATCH_1})
+
+			set(INSTRUMENT ON)
+			if(COVERAGE_INCLUDE_FUNCTIONS)
+				set(INSTRUMENT OFF)
+				foreach(PATTERN IN LISTS COVERAGE_INCLUDE_FUNCTIONS)
+					if(NAME MATCHES "^(${PATTERN})$")
+						set(INSTRUMENT ON)
+					endif()
+				endforeach()
+			endif()
+			foreach(PATTERN IN LISTS COVERAGE_EXCLUDE_FUNCTIONS)
+				if(NAME MATCHES "^(${PATTERN})$")
+					set(INSTRUMENT OFF)
+				endif()
+			endforeach()
+
+			if(INSTRUMENT)
+				string(APPEND MANIFEST "${UNIT}\t${NAME}\tinstrument\n")
+			else()
+				string(APPEND MANIFEST "${UNIT}\t${NAME}\texclude\n")
+				string(APPEND DECLARATIONS "${SIGNATURE} __attribute__((${ATTRIBUTES}));\n")
+			endif()
+		endforeach()
+
+		# Filter header for units with excluded functions
+		if(DECLARATIONS)
+			string(MAKE_C_IDENTIFIER ${UNIT} HEADER)
+			set(HEADER ${CMAKE_BINARY_DIR}/coverage_filter/${HEADER}.h)
+			file(CONFIGURE OUTPUT ${HEADER} CONTENT
+				"/* Coverage instrumentation filter for ${UNIT}, generated by CMake */\n#include \"${COVERAGE_FILTER_INCLUDE}\"\n${DECLARATIONS}" @ONLY
+			)
+			set_property(SOURCE ${SOURCE} APPEND_STRING PROPERTY COMPILE_FLAGS " -include ${HEADER}")
+		endif()
+	endforeach()
+
+	file(CONFIGURE OUTPUT ${CMAKE_BINARY_DIR}/coverage_functions.txt CONTENT "${MANIFEST}" @ONLY)
+endfunction()
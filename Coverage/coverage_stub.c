@@ -0,0 +1,100 @@
+/*!****************************************************************************
+ * @file
+ * coverage_stub.c
+ *
+ * @brief
+ * Coverage interface of the uninstrumented release image
+ *
+ * Replaces "coverage.c" in the release image, so the application and test
+ * sources are linked unchanged into both images without pulling in the gcov
+ * runtime. No coverage data is collected or written.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "coverage.h"
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Initialise coverage data collection (no-op)
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vInit(void)
+{
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset all coverage counters (no-op)
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vReset(void)
+{
+}
+
+/*!****************************************************************************
+ * @brief
+ * Dump coverage data to a file (no-op, no file is created)
+ *
+ * @param[in] pszFilename Output file name on host system
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vDump(const char* pszFilename)
+{
+  (void)pszFilename;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Dump coverage data to an open file (no-op)
+ *
+ * @param[in] lFile   Semihosting file handle
+ * @return  (uint32_t)  Number of bytes written (always 0)
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Coverage_ulDumpToFile(int32_t lFile)
+{
+  (void)lFile;
+  return 0uL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get transfer statistics of the last coverage dump (always zero)
+ *
+ * @param[out] psStats  Bytes and Semihosting operations
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vGetDumpStats(Coverage_DumpStats* psStats)
+{
+  *psStats = (Coverage_DumpStats){ .ulBytes = 0uL, .ulOps = 0uL, .bBoosted = false };
+}
+
+/*!****************************************************************************
+ * @brief
+ * Enable or disable the clock boost of the dumps (no-op)
+ *
+ * @param[in] bBoost  Serialise coverage data at the boost clock
+ * @date  17.10.2026
+ ******************************************************************************/
+void Coverage_vSetDumpBoost(bool bBoost)
+{
+  (void)bBoost;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get the clock boost setting of the dumps (always disabled)
+ *
+ * @return  (bool)  Coverage data serialised at the boost clock
+ * @date  17.10.2026
+ ******************************************************************************/
+bool Coverage_bGetDumpBoost(void)
+{
+  return false;
+}
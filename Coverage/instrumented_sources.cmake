@@ -0,0 +1,7 @@
+# List of files to instrument for coverage (relative to the repository root,
+# shared by the target and host builds)
+set(INSTRUMENTED_SOURCES
+	main.c
+	Controller/STM32F1xx/Peripheral/src/stm32f1xx_hal.c
+	Controller/STM32F1xx/Peripheral/src/stm32f1xx_hal_gpio.c
+)
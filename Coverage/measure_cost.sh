@@ -0,0 +1,37 @@
+#!/bin/sh
+
+# Measure the run-time and RAM cost of coverage instrumentation in "armsim"
+#
+# Runs the "gpio_init" test case of each image with 100 and 200 iterations; the
+# difference is the cost of 100 HAL_GPIO_Init() calls. The RAM used by the
+# instrumentation is taken from "coverage_cost.json" of the build. Compare e.g.
+# the release image, the default and a build with -DCOVERAGE_CONDITIONS=ON.
+# A build folder stands for its coverage image.
+#
+# Usage (in the repository root): Coverage/measure_cost.sh <build dir or image>...
+ARMSIM=${ARMSIM:-build-tools/armsim/armsim}
+
+cycles() {
+  "$ARMSIM" --stats --cmdline "tests=gpio_init iterations=$3 out=$1/measure.bin" "$2" \
+    | sed -n 's/^ *\([0-9]*\) cycles.*/\1/p'
+}
+
+ram() {
+  if [ -f "$1/coverage_cost.json" ]; then
+    python3 -c 'import json, sys; print(sum(u["ram"] for u in json.load(open(sys.argv[1]))["units"]))' "$1/coverage_cost.json"
+  else
+    echo "-"
+  fi
+}
+
+printf "%-48s %14s %10s\n" "build" "cycles/call" "RAM"
+for arg in "$@"; do
+  if [ -f "$arg" ]; then
+    dir=$(dirname "$arg"); image=$arg; cost=""
+  else
+    dir=$arg; image=$arg/gcov-demo-stm32f103.elf; cost=$arg
+  fi
+  c1=$(cycles "$dir" "$image" 100)
+  c2=$(cycles "$dir" "$image" 200)
+  printf "%-48s %14s %10s\n" "$arg" "$(( (c2 - c1) / 100 ))" "$(ram "$cost")"
+done
@@ -0,0 +1,8 @@
+#!/bin/sh
+
+# Merge target and host-native coverage by source line; run from the reposi-
+# tory root after "process_coverage.sh" in "build" and "build-host"
+mkdir -p build-merged
+find build-merged -name "coverage_report.*" -delete
+gcovr -r . -a build/coverage.json -a build-host/coverage.json \
+  --html-details build-merged/coverage_report.html --html-theme github.green
@@ -0,0 +1,10 @@
+#!/bin/sh
+
+# Delete old coverage bank reports
+rm -rf banks
+
+# Map thread/handler coverage banks "coverage_banks.bin" to source lines; generate one HTML report per bank and the overlay report
+../Tools/scripts/banks2gcov.py gcov-demo-stm32f103.elf coverage_banks.bin -o banks -r .. --html banks/coverage_overlay.html
+for bank in thread handler; do
+  gcovr -r .. -g --html-details banks/coverage_$bank.html --html-theme github.green banks/$bank
+done
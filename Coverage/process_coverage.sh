@@ -1,11 +1,33 @@
 #!/bin/sh
 
+# Instrumented objects, see "coverage_notes.txt" (written by "Coverage/coverage.cmake")
+OBJECTS=$(cat coverage_notes.txt) || exit 1
+
 # Delete old coverage data
-find . -name "*.gcda" -delete
-find . -name "coverage_report.*" -delete
+for f in $OBJECTS; do rm -f "${f%.*}.gcda"; done
+rm -f coverage_report.*
+rm -f coverage.json conditions.json coverage_size.json
+rm -f *.gcov
+
+# Condition coverage data is included in the gcov output with "--conditions" (GCC 14 or later)
+GCOV_OPTIONS=""
+if arm-none-eabi-gcov --help | grep -q -- "--conditions"; then
+  GCOV_OPTIONS="--conditions"
+fi
 
 # Deserialize "coverage.txt" file; generate notes/data files and post-process HTML coverage report
 arm-none-eabi-gcov-tool merge-stream coverage.bin --verbose
-find . -name "*.gcno" -exec sh -c 'for f in $@; do arm-none-eabi-gcov "${f%.gcno}.obj"; done' {} +
-gcovr -r .. -g --html-details coverage_report.html --html-theme github.green
-tar -czf coverage_report.tar.gz coverage_report.*
\ No newline at end of file
+for f in $OBJECTS; do arm-none-eabi-gcov $GCOV_OPTIONS "$f"; done
+gcovr -r .. -g --json coverage.json --html-details coverage_report.html --html-theme github.green
+
+# Code size per line and function of the release image, next to the execution counts
+if [ -f gcov-demo-stm32f103-release.elf ]; then
+  ../Tools/scripts/codesize.py gcov-demo-stm32f103-release.elf coverage.json -r .. --top 10 \
+    --json coverage_size.json --html coverage_report.size.html
+fi
+tar -czf coverage_report.tar.gz coverage_report.*
+
+# Summarise condition coverage (builds with COVERAGE_CONDITIONS)
+if grep -qs "^condition outcomes covered" *.gcov; then
+  ../Tools/scripts/conditions.py . -r .. --json conditions.json
+fi
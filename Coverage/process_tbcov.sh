@@ -0,0 +1,10 @@
+#!/bin/sh
+
+# Delete old coverage data
+rm -rf tbcov
+find . -name "coverage_report.*" -delete
+
+# Convert QEMU TCG plugin output "tbcov.bin" into gcov files; post-process HTML coverage report
+../Tools/scripts/tbcov2gcov.py gcov-demo-stm32f103-release.elf tbcov.bin -o tbcov -r ..
+gcovr -r .. -g --html-details coverage_report.html --html-theme github.green tbcov
+tar -czf coverage_report.tar.gz coverage_report.*
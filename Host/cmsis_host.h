@@ -0,0 +1,147 @@
+/*!****************************************************************************
+ * @file
+ * cmsis_host.h
+ *
+ * @brief
+ * CMSIS compiler and intrinsics layer for host builds
+ *
+ * Force-included into every host translation unit. Defining the include guard
+ * of "cmsis_gcc.h" keeps its Arm inline assembly out of the host build; the
+ * intrinsics are provided here instead. Interrupt masking and IPSR are tracked
+ * by the peripheral mock.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef CMSIS_HOST_H_
+#define CMSIS_HOST_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+// Suppress the Arm-specific compiler header
+#define __CMSIS_GCC_H
+
+/*! @brief Compiler attributes (as defined by cmsis_gcc.h)
+ *  @{                                                                        */
+#define __ASM                         __asm
+#define __INLINE                      inline
+#define __STATIC_INLINE               static inline
+#define __STATIC_FORCEINLINE          __attribute__((always_inline)) static inline
+#define __NO_RETURN                   __attribute__((__noreturn__))
+#define __USED                        __attribute__((used))
+#define __WEAK                        __attribute__((weak))
+#define __PACKED                      __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT               struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                  __attribute__((aligned(x)))
+#define __RESTRICT                    __restrict
+#define __COMPILER_BARRIER()          __asm volatile("" ::: "memory")
+/*! @}                                                                        */
+
+/*! @brief Unaligned access helpers
+ *  @{                                                                        */
+#define __UNALIGNED_UINT16_READ(addr)       HostCmsis_usRead16((const void*)(addr))
+#define __UNALIGNED_UINT16_WRITE(addr, val) HostCmsis_vWrite16((void*)(addr), (uint16_t)(val))
+#define __UNALIGNED_UINT32_READ(addr)       HostCmsis_ulRead32((const void*)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val) HostCmsis_vWrite32((void*)(addr), (uint32_t)(val))
+/*! @}                                                                        */
+
+/*! @brief Hints and barriers
+ *  @{                                                                        */
+#define __NOP()                       __COMPILER_BARRIER()
+#define __ISB()                       __sync_synchronize()
+#define __DSB()                       __sync_synchronize()
+#define __DMB()                       __sync_synchronize()
+#define __SEV()                       __COMPILER_BARRIER()
+#define __WFE()                       HostMock_vWaitForInterrupt()
+#define __WFI()                       HostMock_vWaitForInterrupt()
+#define __BKPT(value)                 __builtin_trap()
+/*! @}                                                                        */
+
+
+/*- Public interface ---------------------------------------------------------*/
+// Core state kept by the peripheral mock
+extern volatile uint32_t HostMock_ulPrimask;
+extern volatile uint32_t HostMock_ulFaultmask;
+extern volatile uint32_t HostMock_ulBasepri;
+extern volatile uint32_t HostMock_ulIpsr;
+void HostMock_vWaitForInterrupt(void);
+
+
+/*- Inline functions ---------------------------------------------------------*/
+static inline uint16_t HostCmsis_usRead16(const void* pAddr) { uint16_t v; memcpy(&v, pAddr, 2u); return v; }
+static inline void HostCmsis_vWrite16(void* pAddr, uint16_t v) { memcpy(pAddr, &v, 2u); }
+static inline uint32_t HostCmsis_ulRead32(const void* pAddr) { uint32_t v; memcpy(&v, pAddr, 4u); return v; }
+static inline void HostCmsis_vWrite32(void* pAddr, uint32_t v) { memcpy(pAddr, &v, 4u); }
+
+/*! @brief Core register access
+ *  @{                                                                        */
+static inline void __enable_irq(void) { HostMock_ulPrimask = 0u; }
+static inline void __disable_irq(void) { HostMock_ulPrimask = 1u; }
+static inline uint32_t __get_PRIMASK(void) { return HostMock_ulPrimask; }
+static inline void __set_PRIMASK(uint32_t ulPriMask) { HostMock_ulPrimask = ulPriMask & 1u; }
+static inline void __enable_fault_irq(void) { HostMock_ulFaultmask = 0u; }
+static inline void __disable_fault_irq(void) { HostMock_ulFaultmask = 1u; }
+static inline uint32_t __get_FAULTMASK(void) { return HostMock_ulFaultmask; }
+static inline void __set_FAULTMASK(uint32_t ulFaultMask) { HostMock_ulFaultmask = ulFaultMask & 1u; }
+static inline uint32_t __get_BASEPRI(void) { return HostMock_ulBasepri; }
+static inline void __set_BASEPRI(uint32_t ulBasePri) { HostMock_ulBasepri = ulBasePri & 0xFFu; }
+static inline void __set_BASEPRI_MAX(uint32_t ulBasePri)
+{
+  if ((ulBasePri & 0xFFu) && (!HostMock_ulBasepri || ((ulBasePri & 0xFFu) < HostMock_ulBasepri)))
+  {
+    HostMock_ulBasepri = ulBasePri & 0xFFu;
+  }
+}
+static inline uint32_t __get_IPSR(void) { return HostMock_ulIpsr; }
+static inline uint32_t __get_xPSR(void) { return HostMock_ulIpsr; }
+static inline uint32_t __get_APSR(void) { return 0u; }
+static inline uint32_t __get_CONTROL(void) { return 0u; }
+static inline void __set_CONTROL(uint32_t ulControl) { (void)ulControl; }
+static inline uint32_t __get_MSP(void) { return 0u; }
+static inline void __set_MSP(uint32_t ulTopOfMainStack) { (void)ulTopOfMainStack; }
+static inline uint32_t __get_PSP(void) { return 0u; }
+static inline void __set_PSP(uint32_t ulTopOfProcStack) { (void)ulTopOfProcStack; }
+/*! @}                                                                        */
+
+/*! @brief Data processing intrinsics
+ *  @{                                                                        */
+static inline uint32_t __REV(uint32_t ulValue) { return __builtin_bswap32(ulValue); }
+static inline uint32_t __REV16(uint32_t ulValue) { return ((ulValue & 0x00FF00FFu) << 8) | ((ulValue >> 8) & 0x00FF00FFu); }
+static inline int16_t __REVSH(int16_t sValue) { return (int16_t)__builtin_bswap16((uint16_t)sValue); }
+static inline uint32_t __ROR(uint32_t ulOp1, uint32_t ulOp2) { ulOp2 &= 31u; return ulOp2 ? (ulOp1 >> ulOp2) | (ulOp1 << (32u - ulOp2)) : ulOp1; }
+static inline uint32_t __RBIT(uint32_t ulValue)
+{
+  uint32_t ulResult = 0u;
+  for (unsigned i = 0u; i < 32u; ++i) ulResult |= ((ulValue >> i) & 1u) << (31u - i);
+  return ulResult;
+}
+static inline uint8_t __CLZ(uint32_t ulValue) { return ulValue ? (uint8_t)__builtin_clz(ulValue) : 32u; }
+static inline int32_t __SSAT(int32_t lVal, uint32_t ulSat)
+{
+  int32_t lMax = (int32_t)((1u << (ulSat - 1u)) - 1u);
+  return (lVal > lMax) ? lMax : (lVal < -lMax - 1) ? -lMax - 1 : lVal;
+}
+static inline uint32_t __USAT(int32_t lVal, uint32_t ulSat)
+{
+  uint32_t ulMax = (1u << ulSat) - 1u;
+  return (lVal < 0) ? 0u : ((uint32_t)lVal > ulMax) ? ulMax : (uint32_t)lVal;
+}
+/*! @}                                                                        */
+
+/*! @brief Exclusive access (single-threaded host: always succeeds)
+ *  @{                                                                        */
+static inline uint8_t __LDREXB(volatile uint8_t* pAddr) { return *pAddr; }
+static inline uint16_t __LDREXH(volatile uint16_t* pAddr) { return *pAddr; }
+static inline uint32_t __LDREXW(volatile uint32_t* pAddr) { return *pAddr; }
+static inline uint32_t __STREXB(uint8_t ucValue, volatile uint8_t* pAddr) { *pAddr = ucValue; return 0u; }
+static inline uint32_t __STREXH(uint16_t usValue, volatile uint16_t* pAddr) { *pAddr = usValue; return 0u; }
+static inline uint32_t __STREXW(uint32_t ulValue, volatile uint32_t* pAddr) { *pAddr = ulValue; return 0u; }
+static inline void __CLREX(void) { }
+/*! @}                                                                        */
+
+#endif // CMSIS_HOST_H_
@@ -0,0 +1,356 @@
+/*!****************************************************************************
+ * @file
+ * fuzz_hal.c
+ *
+ * @brief
+ * Fuzz target: HAL GPIO, RCC and NVIC drivers on the peripheral mock
+ *
+ * Each input is decoded into a sequence of operations: raw register presets,
+ * HAL_GPIO_Init/DeInit with random configurations, pin operations, EXTI inter-
+ * rupts, oscillator/clock configuration and NVIC calls. The register state is
+ * reset before every input, so runs are independent.
+ *
+ * After each HAL_GPIO_Init, the port configuration is checked: pins outside
+ * the pin mask must be unchanged, selected pins must match the requested mode,
+ * and pull-up/-down inputs must have their ODR bit set/cleared. Violations
+ * trap, so the fuzzing driver saves the input as a crash.
+ *
+ * Entry point follows the libFuzzer convention (LLVMFuzzerTestOneInput).
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include "stm32f1xx_hal.h"
+#include "periph_mock.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Maximum number of operations per input
+#define FUZZ_MAX_OPS                  64u
+
+/// Register address as seen by the mock
+#define REG_ADDR(reg)                 ((uint32_t)(uintptr_t)&(reg))
+
+/// Number of elements in array
+#define ARRAY_SIZE(a)                 (sizeof(a) / sizeof((a)[0]))
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Input byte stream; reads past the end return zeros
+typedef struct FuzzInput
+{
+  const uint8_t* pucData;             ///< Next byte
+  size_t uLeft;                       ///< Remaining bytes
+} FuzzInput;
+
+/// Operations
+typedef enum FuzzOp
+{
+  FUZZ_OP_SET_REGISTER = 0,
+  FUZZ_OP_GPIO_INIT,
+  FUZZ_OP_GPIO_DEINIT,
+  FUZZ_OP_GPIO_WRITE,
+  FUZZ_OP_GPIO_TOGGLE,
+  FUZZ_OP_GPIO_READ,
+  FUZZ_OP_GPIO_LOCK,
+  FUZZ_OP_SET_INPUT,
+  FUZZ_OP_EXTI_IRQ,
+  FUZZ_OP_RCC_OSC_CONFIG,
+  FUZZ_OP_RCC_CLOCK_CONFIG,
+  FUZZ_OP_NVIC,
+  FUZZ_OP_DELAY,
+  FUZZ_OP_COUNT
+} FuzzOp;
+
+
+/*- Global data --------------------------------------------------------------*/
+static GPIO_TypeDef* const s_apsPorts[] = { GPIOA, GPIOB, GPIOC, GPIOD, GPIOE };
+
+static const uint32_t s_aulModes[] = {
+  GPIO_MODE_INPUT, GPIO_MODE_OUTPUT_PP, GPIO_MODE_OUTPUT_OD, GPIO_MODE_AF_PP,
+  GPIO_MODE_AF_OD, GPIO_MODE_AF_INPUT, GPIO_MODE_ANALOG,
+  GPIO_MODE_IT_RISING, GPIO_MODE_IT_FALLING, GPIO_MODE_IT_RISING_FALLING,
+  GPIO_MODE_EVT_RISING, GPIO_MODE_EVT_FALLING, GPIO_MODE_EVT_RISING_FALLING
+};
+static const uint32_t s_aulPulls[] = { GPIO_NOPULL, GPIO_PULLUP, GPIO_PULLDOWN };
+static const uint32_t s_aulSpeeds[] = { GPIO_SPEED_FREQ_LOW, GPIO_SPEED_FREQ_MEDIUM, GPIO_SPEED_FREQ_HIGH };
+
+static const uint32_t s_aulHseStates[] = { RCC_HSE_OFF, RCC_HSE_ON, RCC_HSE_BYPASS };
+static const uint32_t s_aulLseStates[] = { RCC_LSE_OFF, RCC_LSE_ON, RCC_LSE_BYPASS };
+static const uint32_t s_aulPllStates[] = { RCC_PLL_NONE, RCC_PLL_OFF, RCC_PLL_ON };
+static const uint32_t s_aulPllMuls[] = {
+  RCC_PLL_MUL2, RCC_PLL_MUL3, RCC_PLL_MUL4, RCC_PLL_MUL5, RCC_PLL_MUL6,
+  RCC_PLL_MUL7, RCC_PLL_MUL8, RCC_PLL_MUL9, RCC_PLL_MUL10, RCC_PLL_MUL11,
+  RCC_PLL_MUL12, RCC_PLL_MUL13, RCC_PLL_MUL14, RCC_PLL_MUL15, RCC_PLL_MUL16
+};
+static const uint32_t s_aulSysclkSources[] = { RCC_SYSCLKSOURCE_HSI, RCC_SYSCLKSOURCE_HSE, RCC_SYSCLKSOURCE_PLLCLK };
+static const uint32_t s_aulAhbDividers[] = {
+  RCC_SYSCLK_DIV1, RCC_SYSCLK_DIV2, RCC_SYSCLK_DIV4, RCC_SYSCLK_DIV8, RCC_SYSCLK_DIV16,
+  RCC_SYSCLK_DIV64, RCC_SYSCLK_DIV128, RCC_SYSCLK_DIV256, RCC_SYSCLK_DIV512
+};
+static const uint32_t s_aulApbDividers[] = { RCC_HCLK_DIV1, RCC_HCLK_DIV2, RCC_HCLK_DIV4, RCC_HCLK_DIV8, RCC_HCLK_DIV16 };
+static const uint32_t s_aulLatencies[] = { FLASH_LATENCY_0, FLASH_LATENCY_1, FLASH_LATENCY_2 };
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+int LLVMFuzzerTestOneInput(const uint8_t* pucData, size_t uSize);
+static uint32_t ulTake(FuzzInput* psIn, unsigned uBytes);
+static uint32_t ulPick(FuzzInput* psIn, const uint32_t* pulTable, size_t uCount);
+static void vPresetRegister(FuzzInput* psIn);
+static void vGpioInit(FuzzInput* psIn, GPIO_TypeDef* psPort);
+static void vRccOscConfig(FuzzInput* psIn);
+static void vRccClockConfig(FuzzInput* psIn);
+static void vNvic(FuzzInput* psIn);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Run one input
+ *
+ * @param[in] pucData Input data
+ * @param[in] uSize   Input size in bytes
+ * @return  (int) Always 0
+ * @date  17.10.2026
+ ******************************************************************************/
+int LLVMFuzzerTestOneInput(const uint8_t* pucData, size_t uSize)
+{
+  FuzzInput sIn = { pucData, uSize };
+
+  HostMock_vReset();
+  HAL_Init();
+
+  for (unsigned uOps = 0u; (sIn.uLeft > 0u) && (uOps < FUZZ_MAX_OPS); ++uOps)
+  {
+    FuzzOp eOp = (FuzzOp)(ulTake(&sIn, 1u) % FUZZ_OP_COUNT);
+    unsigned uPort = ulTake(&sIn, 1u) % ARRAY_SIZE(s_apsPorts);
+    GPIO_TypeDef* psPort = s_apsPorts[uPort];
+    switch (eOp)
+    {
+      case FUZZ_OP_SET_REGISTER:
+        vPresetRegister(&sIn);
+        break;
+      case FUZZ_OP_GPIO_INIT:
+        vGpioInit(&sIn, psPort);
+        break;
+      case FUZZ_OP_GPIO_DEINIT:
+        HAL_GPIO_DeInit(psPort, ulTake(&sIn, 2u));
+        break;
+      case FUZZ_OP_GPIO_WRITE:
+      {
+        uint16_t usPins = (uint16_t)ulTake(&sIn, 2u);
+        HAL_GPIO_WritePin(psPort, usPins, (ulTake(&sIn, 1u) & 1u) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+        break;
+      }
+      case FUZZ_OP_GPIO_TOGGLE:
+        HAL_GPIO_TogglePin(psPort, (uint16_t)ulTake(&sIn, 2u));
+        break;
+      case FUZZ_OP_GPIO_READ:
+        (void)HAL_GPIO_ReadPin(psPort, (uint16_t)ulTake(&sIn, 2u));
+        break;
+      case FUZZ_OP_GPIO_LOCK:
+        (void)HAL_GPIO_LockPin(psPort, (uint16_t)ulTake(&sIn, 2u));
+        break;
+      case FUZZ_OP_SET_INPUT:
+      {
+        uint32_t ulArg = ulTake(&sIn, 1u);
+        HostMock_vSetInput((char)('A' + uPort), (uint8_t)(ulArg & 15u), (ulArg & 16u) != 0u);
+        break;
+      }
+      case FUZZ_OP_EXTI_IRQ:
+      {
+        uint32_t ulLine = ulTake(&sIn, 1u) & 15u;
+        HostMock_vSetRegister(REG_ADDR(EXTI->PR), ulTake(&sIn, 2u));
+        HAL_GPIO_EXTI_IRQHandler((uint16_t)(1u << ulLine));
+        break;
+      }
+      case FUZZ_OP_RCC_OSC_CONFIG:
+        vRccOscConfig(&sIn);
+        break;
+      case FUZZ_OP_RCC_CLOCK_CONFIG:
+        vRccClockConfig(&sIn);
+        break;
+      case FUZZ_OP_NVIC:
+        vNvic(&sIn);
+        break;
+      case FUZZ_OP_DELAY:
+        HAL_Delay(ulTake(&sIn, 1u) & 15u);
+        break;
+      default:
+        break;
+    }
+  }
+  return 0;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Take little-endian value from input
+ *
+ * @param[inout] psIn Input stream
+ * @param[in] uBytes  Number of bytes (1..4)
+ * @return  (uint32_t)  Value; missing bytes read as zero
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint32_t ulTake(FuzzInput* psIn, unsigned uBytes)
+{
+  uint32_t ulValue = 0u;
+  for (unsigned i = 0u; (i < uBytes) && (psIn->uLeft > 0u); ++i, --psIn->uLeft)
+  {
+    ulValue |= (uint32_t)*psIn->pucData++ << (8u * i);
+  }
+  return ulValue;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Pick table entry selected by the next input byte
+ ******************************************************************************/
+static uint32_t ulPick(FuzzInput* psIn, const uint32_t* pulTable, size_t uCount)
+{
+  return pulTable[ulTake(psIn, 1u) % uCount];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Preset a driver-relevant register with a raw value
+ *
+ * SysTick is not included: a stopped tick would stall HAL timeouts, which is
+ * a configuration error rather than a driver defect.
+ *
+ * @param[inout] psIn Input stream
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vPresetRegister(FuzzInput* psIn)
+{
+  const uint32_t aulRegs[] = {
+    REG_ADDR(GPIOA->CRL), REG_ADDR(GPIOA->CRH), REG_ADDR(GPIOA->ODR), REG_ADDR(GPIOA->LCKR),
+    REG_ADDR(GPIOB->CRL), REG_ADDR(GPIOB->CRH), REG_ADDR(GPIOB->ODR), REG_ADDR(GPIOB->LCKR),
+    REG_ADDR(GPIOC->CRL), REG_ADDR(GPIOC->CRH), REG_ADDR(GPIOC->ODR), REG_ADDR(GPIOC->LCKR),
+    REG_ADDR(AFIO->EVCR), REG_ADDR(AFIO->MAPR),
+    REG_ADDR(AFIO->EXTICR[0]), REG_ADDR(AFIO->EXTICR[1]), REG_ADDR(AFIO->EXTICR[2]), REG_ADDR(AFIO->EXTICR[3]),
+    REG_ADDR(EXTI->IMR), REG_ADDR(EXTI->EMR), REG_ADDR(EXTI->RTSR), REG_ADDR(EXTI->FTSR),
+    REG_ADDR(RCC->CR), REG_ADDR(RCC->CFGR), REG_ADDR(RCC->BDCR), REG_ADDR(RCC->CSR),
+    REG_ADDR(FLASH->ACR), REG_ADDR(PWR->CR)
+  };
+  uint32_t ulAddr = aulRegs[ulTake(psIn, 1u) % ARRAY_SIZE(aulRegs)];
+  HostMock_vSetRegister(ulAddr, ulTake(psIn, 4u));
+}
+
+/*!****************************************************************************
+ * @brief
+ * HAL_GPIO_Init with random configuration, followed by a configuration check
+ *
+ * @param[inout] psIn Input stream
+ * @param[in] psPort  GPIO port
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vGpioInit(FuzzInput* psIn, GPIO_TypeDef* psPort)
+{
+  GPIO_InitTypeDef sInit = {
+    .Pin = ulTake(psIn, 2u),
+    .Mode = ulPick(psIn, s_aulModes, ARRAY_SIZE(s_aulModes)),
+    .Pull = ulPick(psIn, s_aulPulls, ARRAY_SIZE(s_aulPulls)),
+    .Speed = ulPick(psIn, s_aulSpeeds, ARRAY_SIZE(s_aulSpeeds))
+  };
+
+  uint64_t ullCfgBefore = ((uint64_t)HostMock_ulGetRegister(REG_ADDR(psPort->CRH)) << 32) | HostMock_ulGetRegister(REG_ADDR(psPort->CRL));
+  uint32_t ulOdrBefore = HostMock_ulGetRegister(REG_ADDR(psPort->ODR));
+  HAL_GPIO_Init(psPort, &sInit);
+  uint64_t ullCfgAfter = ((uint64_t)HostMock_ulGetRegister(REG_ADDR(psPort->CRH)) << 32) | HostMock_ulGetRegister(REG_ADDR(psPort->CRL));
+  uint32_t ulOdrAfter = HostMock_ulGetRegister(REG_ADDR(psPort->ODR));
+
+  // Expected MODE/CNF nibble of the selected pins
+  bool bInput = (sInit.Mode != GPIO_MODE_OUTPUT_PP) && (sInit.Mode != GPIO_MODE_OUTPUT_OD) &&
+                (sInit.Mode != GPIO_MODE_AF_PP) && (sInit.Mode != GPIO_MODE_AF_OD) && (sInit.Mode != GPIO_MODE_ANALOG);
+  uint64_t ullExpected;
+  switch (sInit.Mode)
+  {
+    case GPIO_MODE_OUTPUT_PP: ullExpected = sInit.Speed; break;
+    case GPIO_MODE_OUTPUT_OD: ullExpected = sInit.Speed | 0x4u; break;
+    case GPIO_MODE_AF_PP:     ullExpected = sInit.Speed | 0x8u; break;
+    case GPIO_MODE_AF_OD:     ullExpected = sInit.Speed | 0xCu; break;
+    case GPIO_MODE_ANALOG:    ullExpected = 0x0u; break;
+    default:                  ullExpected = (sInit.Pull == GPIO_NOPULL) ? 0x4u : 0x8u; break;
+  }
+
+  for (unsigned i = 0u; i < 16u; ++i)
+  {
+    uint64_t ullNibbleBefore = (ullCfgBefore >> (4u * i)) & 0xFu;
+    uint64_t ullNibbleAfter = (ullCfgAfter >> (4u * i)) & 0xFu;
+    bool bOdrBefore = (ulOdrBefore >> i) & 1u, bOdrAfter = (ulOdrAfter >> i) & 1u;
+    if (!(sInit.Pin & (1u << i)))
+    {
+      if ((ullNibbleAfter != ullNibbleBefore) || (bOdrAfter != bOdrBefore)) __builtin_trap();
+    }
+    else
+    {
+      if (ullNibbleAfter != ullExpected) __builtin_trap();
+      if (bInput && (sInit.Pull == GPIO_PULLUP) && !bOdrAfter) __builtin_trap();
+      if (bInput && (sInit.Pull == GPIO_PULLDOWN) && bOdrAfter) __builtin_trap();
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * HAL_RCC_OscConfig with random configuration
+ ******************************************************************************/
+static void vRccOscConfig(FuzzInput* psIn)
+{
+  RCC_OscInitTypeDef sOsc = {
+    .OscillatorType = ulTake(psIn, 1u) & (RCC_OSCILLATORTYPE_HSE | RCC_OSCILLATORTYPE_HSI | RCC_OSCILLATORTYPE_LSE | RCC_OSCILLATORTYPE_LSI),
+    .HSEState = ulPick(psIn, s_aulHseStates, ARRAY_SIZE(s_aulHseStates)),
+    .HSEPredivValue = (ulTake(psIn, 1u) & 1u) ? RCC_HSE_PREDIV_DIV2 : RCC_HSE_PREDIV_DIV1,
+    .LSEState = ulPick(psIn, s_aulLseStates, ARRAY_SIZE(s_aulLseStates)),
+    .HSIState = (ulTake(psIn, 1u) & 1u) ? RCC_HSI_ON : RCC_HSI_OFF,
+    .HSICalibrationValue = ulTake(psIn, 1u) & 0x1Fu,
+    .LSIState = (ulTake(psIn, 1u) & 1u) ? RCC_LSI_ON : RCC_LSI_OFF,
+    .PLL = {
+      .PLLState = ulPick(psIn, s_aulPllStates, ARRAY_SIZE(s_aulPllStates)),
+      .PLLSource = (ulTake(psIn, 1u) & 1u) ? RCC_PLLSOURCE_HSE : RCC_PLLSOURCE_HSI_DIV2,
+      .PLLMUL = ulPick(psIn, s_aulPllMuls, ARRAY_SIZE(s_aulPllMuls))
+    }
+  };
+  (void)HAL_RCC_OscConfig(&sOsc);
+}
+
+/*!****************************************************************************
+ * @brief
+ * HAL_RCC_ClockConfig with random configuration
+ ******************************************************************************/
+static void vRccClockConfig(FuzzInput* psIn)
+{
+  RCC_ClkInitTypeDef sClk = {
+    .ClockType = ulTake(psIn, 1u) & (RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2),
+    .SYSCLKSource = ulPick(psIn, s_aulSysclkSources, ARRAY_SIZE(s_aulSysclkSources)),
+    .AHBCLKDivider = ulPick(psIn, s_aulAhbDividers, ARRAY_SIZE(s_aulAhbDividers)),
+    .APB1CLKDivider = ulPick(psIn, s_aulApbDividers, ARRAY_SIZE(s_aulApbDividers)),
+    .APB2CLKDivider = ulPick(psIn, s_aulApbDividers, ARRAY_SIZE(s_aulApbDividers))
+  };
+  (void)HAL_RCC_ClockConfig(&sClk, ulPick(psIn, s_aulLatencies, ARRAY_SIZE(s_aulLatencies)));
+}
+
+/*!****************************************************************************
+ * @brief
+ * NVIC priority, enable and pending operations
+ ******************************************************************************/
+static void vNvic(FuzzInput* psIn)
+{
+  IRQn_Type eIrq = (IRQn_Type)(ulTake(psIn, 1u) % (USBWakeUp_IRQn + 1));
+  uint32_t ulArg = ulTake(psIn, 1u);
+  switch (ulArg & 7u)
+  {
+    case 0u: HAL_NVIC_SetPriority(eIrq, (ulArg >> 3) & 15u, 0u); break;
+    case 1u: HAL_NVIC_EnableIRQ(eIrq); break;
+    case 2u: HAL_NVIC_DisableIRQ(eIrq); break;
+    case 3u: HAL_NVIC_SetPendingIRQ(eIrq); break;
+    case 4u: HAL_NVIC_ClearPendingIRQ(eIrq); break;
+    case 5u: (void)HAL_NVIC_GetPendingIRQ(eIrq); break;
+    default: HAL_NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4); break;
+  }
+}
@@ -0,0 +1,661 @@
+/*!****************************************************************************
+ * @file
+ * fuzz_main.c
+ *
+ * @brief
+ * Standalone coverage-guided fuzzing driver for GCC host builds
+ *
+ * Drives LLVMFuzzerTestOneInput without libFuzzer. Feedback comes from an in-
+ * memory edge map filled by the -fsanitize-coverage=trace-pc callback of the
+ * instrumented driver sources; no files are written per input. Hit counts are
+ * bucketed (1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+) into features.
+ *
+ * Inputs that produce new features are minimised by removing chunks while all
+ * of their new features are retained, then added to the in-memory corpus and
+ * saved to the corpus directory. Crashing inputs and inputs exceeding the time-
+ * out are saved as "crash-<hash>" or "timeout-<hash>" artifacts.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#include "periph_mock.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Edge map size (entries)
+#define FUZZ_MAP_SIZE                 65536u
+
+/// Maximum executions spent on minimising one input
+#define FUZZ_MINIMISE_BUDGET          256u
+
+/// Number of elements in array
+#define ARRAY_SIZE(a)                 (sizeof(a) / sizeof((a)[0]))
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Command-line options
+typedef struct FuzzOptions
+{
+  const char* pszCorpus;              ///< Corpus directory (loaded and extended)
+  const char* pszArtifacts;           ///< Directory for crash/timeout inputs
+  const char* pszMerge;               ///< Write minimal covering corpus subset here
+  uint64_t ullRuns;                   ///< Execution limit (0: unlimited)
+  unsigned uSeconds;                  ///< Time limit (0: unlimited)
+  unsigned uTimeout;                  ///< Per-input timeout in seconds
+  size_t uMaxLen;                     ///< Maximum input length
+  uint64_t ullSeed;                   ///< Random seed
+  char** ppszFiles;                   ///< Inputs to run once
+  int iFiles;
+} FuzzOptions;
+
+/// Corpus entry
+typedef struct FuzzEntry
+{
+  uint8_t* pucData;
+  size_t uLen;
+} FuzzEntry;
+
+/// New feature (map index and bucket bits)
+typedef struct FuzzFeature
+{
+  uint32_t ulIndex;
+  uint8_t ucBits;
+} FuzzFeature;
+
+
+/*- Global data --------------------------------------------------------------*/
+static uint8_t s_aucMap[FUZZ_MAP_SIZE];       ///< Hit counts of current run
+static uint8_t s_aucSeen[FUZZ_MAP_SIZE];      ///< Bucket bits seen so far
+static uint32_t s_ulPrevLoc;
+
+static FuzzEntry* s_asCorpus;
+static size_t s_uCorpusLen, s_uCorpusCap;
+
+static const uint8_t* volatile s_pucCurData;  ///< Input being executed
+static volatile size_t s_uCurLen;
+static const char* s_pszArtifacts = ".";
+static uint64_t s_ullRng;
+
+static FuzzFeature s_asNew[FUZZ_MAP_SIZE];
+static size_t s_uNewCount;
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+int LLVMFuzzerTestOneInput(const uint8_t* pucData, size_t uSize);
+void __sanitizer_cov_trace_pc(void);
+static uint8_t ucBucket(uint8_t ucCount);
+static void vExecute(const uint8_t* pucData, size_t uLen, unsigned uTimeout);
+static size_t uCollectNew(void);
+static bool bHasFeatures(const FuzzFeature* psFeatures, size_t uCount);
+static void vCommit(void);
+static unsigned uCountFeatures(void);
+static size_t uMinimise(uint8_t* pucData, size_t uLen, unsigned uTimeout);
+static size_t uMutate(uint8_t* pucData, size_t uLen, size_t uMaxLen);
+static uint64_t ullRand(void);
+static uint64_t ullHash(const uint8_t* pucData, size_t uLen);
+static void vAddEntry(const uint8_t* pucData, size_t uLen);
+static void vSaveInput(const char* pszDir, const char* pszPrefix, const uint8_t* pucData, size_t uLen);
+static bool bLoadFile(const char* pszPath, size_t uMaxLen);
+static void vLoadCorpus(const char* pszDir, size_t uMaxLen);
+static void vCrashHandler(int iSig);
+static bool bParseArgs(int argc, char* argv[], FuzzOptions* psOpts);
+static double dNow(void);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Coverage callback, inserted by -fsanitize-coverage=trace-pc at every basic
+ * block of the instrumented sources
+ *
+ * Records the edge from the previous block into the hit count map.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void __sanitizer_cov_trace_pc(void)
+{
+  uintptr_t uPc = (uintptr_t)__builtin_return_address(0);
+  uint32_t ulLoc = (uint32_t)((uPc >> 4) ^ (uPc << 8)) & (FUZZ_MAP_SIZE - 1u);
+  uint8_t* pucCount = &s_aucMap[ulLoc ^ s_ulPrevLoc];
+  if (*pucCount != 0xFFu) ++*pucCount;
+  s_ulPrevLoc = ulLoc >> 1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Program entry point
+ *
+ * @return  (int) 0 on completion, 1 if an input crashed or timed out
+ * @date  17.10.2026
+ ******************************************************************************/
+int main(int argc, char* argv[])
+{
+  FuzzOptions sOpts;
+  if (!bParseArgs(argc, argv, &sOpts))
+  {
+    fprintf(stderr,
+      "usage: %s [options] [input ...]\n"
+      "  --corpus DIR      corpus directory, loaded and extended with new inputs\n"
+      "  --artifacts DIR   directory for crash-* and timeout-* inputs (.)\n"
+      "  --merge DIR       write a minimal subset of --corpus covering all features\n"
+      "  --runs N          execution limit (unlimited)\n"
+      "  --time SEC        time limit (unlimited)\n"
+      "  --timeout SEC     per-input timeout (1)\n"
+      "  --max-len N       maximum input length (256)\n"
+      "  --seed N          random seed (time)\n"
+      "Inputs given as arguments are executed once (crash reproduction).\n",
+      argv[0]);
+    return 2;
+  }
+  s_pszArtifacts = sOpts.pszArtifacts;
+  s_ullRng = sOpts.ullSeed | 1u;
+
+  int aiSignals[] = { SIGABRT, SIGILL, SIGFPE, SIGBUS, SIGALRM };
+  for (size_t i = 0u; i < ARRAY_SIZE(aiSignals); ++i) signal(aiSignals[i], vCrashHandler);
+  HostMock_vSetFaultHook(vCrashHandler);
+
+  // Reproduction mode
+  if (sOpts.iFiles > 0)
+  {
+    for (int i = 0; i < sOpts.iFiles; ++i)
+    {
+      if (!bLoadFile(sOpts.ppszFiles[i], SIZE_MAX)) return 2;
+      vExecute(s_asCorpus[s_uCorpusLen - 1u].pucData, s_asCorpus[s_uCorpusLen - 1u].uLen, sOpts.uTimeout);
+      printf("%s: ok\n", sOpts.ppszFiles[i]);
+    }
+    return 0;
+  }
+
+  // Initial corpus: run all entries, smallest first for merging
+  if (sOpts.pszCorpus != NULL) vLoadCorpus(sOpts.pszCorpus, sOpts.uMaxLen);
+  if (s_uCorpusLen == 0u) vAddEntry((const uint8_t*)"", 0u);
+  size_t uLoaded = s_uCorpusLen;
+  size_t uKept = 0u;
+  for (size_t i = 0u; i < uLoaded; ++i)
+  {
+    vExecute(s_asCorpus[i].pucData, s_asCorpus[i].uLen, sOpts.uTimeout);
+    if (uCollectNew() > 0u)
+    {
+      vCommit();
+      if (sOpts.pszMerge != NULL) vSaveInput(sOpts.pszMerge, "", s_asCorpus[i].pucData, s_asCorpus[i].uLen);
+      ++uKept;
+    }
+  }
+  printf("#%zu\tINITED cov: %u corp: %zu (%zu contribute features)\n", uLoaded, uCountFeatures(), s_uCorpusLen, uKept);
+  if (sOpts.pszMerge != NULL) return 0;
+
+  // Fuzzing loop
+  uint8_t* pucBuf = malloc(sOpts.uMaxLen);
+  uint64_t ullExecs = 0u, ullNew = 0u;
+  double dStart = dNow(), dLastReport = dStart;
+  uint64_t ullLastExecs = 0u, ullLastNew = 0u;
+  while (((sOpts.ullRuns == 0u) || (ullExecs < sOpts.ullRuns)) &&
+         ((sOpts.uSeconds == 0u) || (dNow() - dStart < sOpts.uSeconds)))
+  {
+    const FuzzEntry* psBase = &s_asCorpus[ullRand() % s_uCorpusLen];
+    size_t uLen = (psBase->uLen < sOpts.uMaxLen) ? psBase->uLen : sOpts.uMaxLen;
+    memcpy(pucBuf, psBase->pucData, uLen);
+    uLen = uMutate(pucBuf, uLen, sOpts.uMaxLen);
+
+    vExecute(pucBuf, uLen, sOpts.uTimeout);
+    ++ullExecs;
+    if (uCollectNew() > 0u)
+    {
+      size_t uOrigLen = uLen;
+      uLen = uMinimise(pucBuf, uLen, sOpts.uTimeout);
+      vCommit();
+      vAddEntry(pucBuf, uLen);
+      if (sOpts.pszCorpus != NULL) vSaveInput(sOpts.pszCorpus, "", pucBuf, uLen);
+      ++ullNew;
+      printf("#%llu\tNEW cov: %u corp: %zu len: %zu (from %zu) t: %.1fs\n",
+             (unsigned long long)ullExecs, uCountFeatures(), s_uCorpusLen, uLen, uOrigLen, dNow() - dStart);
+    }
+
+    double dTime = dNow();
+    if (dTime - dLastReport >= 1.0)
+    {
+      printf("#%llu\tcov: %u corp: %zu exec/s: %.0f new/s: %.2f\n",
+             (unsigned long long)ullExecs, uCountFeatures(), s_uCorpusLen,
+             (ullExecs - ullLastExecs) / (dTime - dLastReport), (ullNew - ullLastNew) / (dTime - dLastReport));
+      fflush(stdout);
+      dLastReport = dTime;
+      ullLastExecs = ullExecs;
+      ullLastNew = ullNew;
+    }
+  }
+
+  double dTotal = dNow() - dStart;
+  printf("Done: %llu runs in %.1f s (%.0f exec/s), %llu new inputs (%.3f new/s), cov: %u corp: %zu\n",
+         (unsigned long long)ullExecs, dTotal, (dTotal > 0.0) ? ullExecs / dTotal : 0.0,
+         (unsigned long long)ullNew, (dTotal > 0.0) ? ullNew / dTotal : 0.0, uCountFeatures(), s_uCorpusLen);
+  free(pucBuf);
+  return 0;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Map hit count to feature bucket bit
+ ******************************************************************************/
+static uint8_t ucBucket(uint8_t ucCount)
+{
+  if (ucCount == 0u) return 0u;
+  if (ucCount <= 3u) return (uint8_t)(1u << (ucCount - 1u));
+  if (ucCount <= 7u) return 0x08u;
+  if (ucCount <= 15u) return 0x10u;
+  if (ucCount <= 31u) return 0x20u;
+  if (ucCount <= 127u) return 0x40u;
+  return 0x80u;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run input with a clean edge map
+ *
+ * @param[in] pucData   Input data
+ * @param[in] uLen      Input length
+ * @param[in] uTimeout  Timeout in seconds
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vExecute(const uint8_t* pucData, size_t uLen, unsigned uTimeout)
+{
+  memset(s_aucMap, 0, sizeof(s_aucMap));
+  s_ulPrevLoc = 0u;
+  s_pucCurData = pucData;
+  s_uCurLen = uLen;
+
+  struct itimerval sTimer = { .it_value = { .tv_sec = uTimeout } };
+  setitimer(ITIMER_REAL, &sTimer, NULL);
+  (void)LLVMFuzzerTestOneInput(pucData, uLen);
+  sTimer.it_value.tv_sec = 0;
+  setitimer(ITIMER_REAL, &sTimer, NULL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Collect features of the last run which have not been seen before
+ *
+ * @return  (size_t)  Number of map entries with new bucket bits
+ * @date  17.10.2026
+ ******************************************************************************/
+static size_t uCollectNew(void)
+{
+  s_uNewCount = 0u;
+  const uint64_t* pullMap = (const uint64_t*)s_aucMap;
+  for (size_t w = 0u; w < FUZZ_MAP_SIZE / 8u; ++w)
+  {
+    if (pullMap[w] == 0u) continue;
+    for (size_t i = w * 8u; i < w * 8u + 8u; ++i)
+    {
+      uint8_t ucBits = ucBucket(s_aucMap[i]) & (uint8_t)~s_aucSeen[i];
+      if (ucBits != 0u) s_asNew[s_uNewCount++] = (FuzzFeature){ (uint32_t)i, ucBits };
+    }
+  }
+  return s_uNewCount;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check whether the last run covered all given features
+ ******************************************************************************/
+static bool bHasFeatures(const FuzzFeature* psFeatures, size_t uCount)
+{
+  for (size_t i = 0u; i < uCount; ++i)
+  {
+    if (!(ucBucket(s_aucMap[psFeatures[i].ulIndex]) & psFeatures[i].ucBits)) return false;
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Mark collected new features as seen
+ ******************************************************************************/
+static void vCommit(void)
+{
+  for (size_t i = 0u; i < s_uNewCount; ++i) s_aucSeen[s_asNew[i].ulIndex] |= s_asNew[i].ucBits;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Number of features seen so far
+ ******************************************************************************/
+static unsigned uCountFeatures(void)
+{
+  unsigned uCount = 0u;
+  for (size_t i = 0u; i < FUZZ_MAP_SIZE; ++i) uCount += (unsigned)__builtin_popcount(s_aucSeen[i]);
+  return uCount;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Minimise input while retaining its new features
+ *
+ * Removes chunks of decreasing size (len/2 .. 1 byte). The collected new
+ * features are restored afterwards, so they can be committed.
+ *
+ * @param[inout] pucData  Input data, minimised in place
+ * @param[in] uLen        Input length
+ * @param[in] uTimeout    Timeout in seconds
+ * @return  (size_t)  Minimised length
+ * @date  17.10.2026
+ ******************************************************************************/
+static size_t uMinimise(uint8_t* pucData, size_t uLen, unsigned uTimeout)
+{
+  size_t uTarget = s_uNewCount;
+  FuzzFeature* psTarget = malloc(uTarget * sizeof(FuzzFeature));
+  memcpy(psTarget, s_asNew, uTarget * sizeof(FuzzFeature));
+  uint8_t* pucTry = malloc(uLen + 1u);
+  unsigned uBudget = FUZZ_MINIMISE_BUDGET;
+
+  for (size_t uChunk = uLen / 2u; (uChunk > 0u) && (uBudget > 0u); uChunk /= 2u)
+  {
+    for (size_t uOff = 0u; (uOff + uChunk <= uLen) && (uBudget > 0u); --uBudget)
+    {
+      memcpy(pucTry, pucData, uOff);
+      memcpy(pucTry + uOff, pucData + uOff + uChunk, uLen - uOff - uChunk);
+      vExecute(pucTry, uLen - uChunk, uTimeout);
+      if (bHasFeatures(psTarget, uTarget))
+      {
+        uLen -= uChunk;
+        memcpy(pucData, pucTry, uLen);
+      }
+      else
+      {
+        uOff += uChunk;
+      }
+    }
+  }
+
+  memcpy(s_asNew, psTarget, uTarget * sizeof(FuzzFeature));
+  s_uNewCount = uTarget;
+  free(pucTry);
+  free(psTarget);
+  return uLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Apply 1..4 random mutations
+ *
+ * @param[inout] pucData  Input buffer (capacity uMaxLen)
+ * @param[in] uLen        Input length
+ * @param[in] uMaxLen     Maximum input length
+ * @return  (size_t)  New length
+ * @date  17.10.2026
+ ******************************************************************************/
+static size_t uMutate(uint8_t* pucData, size_t uLen, size_t uMaxLen)
+{
+  static const uint32_t aulInteresting[] = {
+    0u, 1u, 0x7Fu, 0x80u, 0xFFu, 0x7FFFu, 0x8000u, 0xFFFFu, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu
+  };
+  unsigned uCount = 1u + (unsigned)(ullRand() % 4u);
+  for (unsigned n = 0u; n < uCount; ++n)
+  {
+    size_t uPos = uLen ? (size_t)(ullRand() % uLen) : 0u;
+    switch (ullRand() % 8u)
+    {
+      case 0u: // flip bit
+        if (uLen) pucData[uPos] ^= (uint8_t)(1u << (ullRand() % 8u));
+        break;
+      case 1u: // random byte
+        if (uLen) pucData[uPos] = (uint8_t)ullRand();
+        break;
+      case 2u: // arithmetic
+        if (uLen) pucData[uPos] = (uint8_t)(pucData[uPos] + (int)(ullRand() % 35u) - 17);
+        break;
+      case 3u: // interesting value
+        if (uLen >= 4u)
+        {
+          uint32_t ulValue = aulInteresting[ullRand() % ARRAY_SIZE(aulInteresting)];
+          memcpy(&pucData[ullRand() % (uLen - 3u)], &ulValue, 4u);
+        }
+        break;
+      case 4u: // insert random bytes
+      {
+        size_t uIns = 1u + (size_t)(ullRand() % 8u);
+        if (uLen + uIns > uMaxLen) break;
+        memmove(&pucData[uPos + uIns], &pucData[uPos], uLen - uPos);
+        for (size_t i = 0u; i < uIns; ++i) pucData[uPos + i] = (uint8_t)ullRand();
+        uLen += uIns;
+        break;
+      }
+      case 5u: // erase range
+      {
+        if (uLen < 2u) break;
+        size_t uDel = 1u + (size_t)(ullRand() % ((uLen - uPos < 16u) ? uLen - uPos : 16u));
+        memmove(&pucData[uPos], &pucData[uPos + uDel], uLen - uPos - uDel);
+        uLen -= uDel;
+        break;
+      }
+      case 6u: // duplicate chunk
+      {
+        if (uLen == 0u) break;
+        size_t uCopy = 1u + (size_t)(ullRand() % ((uLen - uPos < 16u) ? uLen - uPos : 16u));
+        if (uLen + uCopy > uMaxLen) break;
+        size_t uDst = (size_t)(ullRand() % (uLen + 1u));
+        uint8_t aucTmp[16];
+        memcpy(aucTmp, &pucData[uPos], uCopy);
+        memmove(&pucData[uDst + uCopy], &pucData[uDst], uLen - uDst);
+        memcpy(&pucData[uDst], aucTmp, uCopy);
+        uLen += uCopy;
+        break;
+      }
+      default: // splice with another corpus entry
+      {
+        const FuzzEntry* psOther = &s_asCorpus[ullRand() % s_uCorpusLen];
+        if (psOther->uLen == 0u) break;
+        size_t uFrom = (size_t)(ullRand() % psOther->uLen);
+        size_t uCopy = psOther->uLen - uFrom;
+        if (uPos + uCopy > uMaxLen) uCopy = uMaxLen - uPos;
+        memcpy(&pucData[uPos], &psOther->pucData[uFrom], uCopy);
+        if (uPos + uCopy > uLen) uLen = uPos + uCopy;
+        break;
+      }
+    }
+  }
+  return uLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * xorshift64* pseudo-random number generator
+ ******************************************************************************/
+static uint64_t ullRand(void)
+{
+  s_ullRng ^= s_ullRng >> 12;
+  s_ullRng ^= s_ullRng << 25;
+  s_ullRng ^= s_ullRng >> 27;
+  return s_ullRng * 0x2545F4914F6CDD1DuLL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * FNV-1a hash of input, used as file name
+ ******************************************************************************/
+static uint64_t ullHash(const uint8_t* pucData, size_t uLen)
+{
+  uint64_t ullHash = 0xCBF29CE484222325uLL;
+  for (size_t i = 0u; i < uLen; ++i) ullHash = (ullHash ^ pucData[i]) * 0x100000001B3uLL;
+  return ullHash;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Append copy of input to the in-memory corpus
+ ******************************************************************************/
+static void vAddEntry(const uint8_t* pucData, size_t uLen)
+{
+  if (s_uCorpusLen == s_uCorpusCap)
+  {
+    s_uCorpusCap = s_uCorpusCap ? 2u * s_uCorpusCap : 64u;
+    s_asCorpus = realloc(s_asCorpus, s_uCorpusCap * sizeof(FuzzEntry));
+  }
+  FuzzEntry* psEntry = &s_asCorpus[s_uCorpusLen++];
+  psEntry->pucData = malloc(uLen + 1u);
+  memcpy(psEntry->pucData, pucData, uLen);
+  psEntry->uLen = uLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Save input as "<prefix><hash>" in a directory
+ *
+ * Uses only async-signal-safe calls, as it is also called from the crash
+ * handler.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vSaveInput(const char* pszDir, const char* pszPrefix, const uint8_t* pucData, size_t uLen)
+{
+  char acPath[4096];
+  size_t uPos = 0u;
+  for (const char* p = pszDir; *p && (uPos < sizeof(acPath) - 64u); ++p) acPath[uPos++] = *p;
+  acPath[uPos++] = '/';
+  for (const char* p = pszPrefix; *p && (uPos < sizeof(acPath) - 32u); ++p) acPath[uPos++] = *p;
+  uint64_t ullValue = ullHash(pucData, uLen);
+  for (int i = 15; i >= 0; --i) acPath[uPos++] = "0123456789abcdef"[(ullValue >> (4 * i)) & 0xFu];
+  acPath[uPos] = '\0';
+
+  int iFd = open(acPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (iFd < 0) return;
+  (void)!write(iFd, pucData, uLen);
+  close(iFd);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Load input file into the in-memory corpus
+ *
+ * @return  (bool)  File loaded
+ * @date  17.10.2026
+ ******************************************************************************/
+static bool bLoadFile(const char* pszPath, size_t uMaxLen)
+{
+  FILE* psFile = fopen(pszPath, "rb");
+  if (psFile == NULL)
+  {
+    perror(pszPath);
+    return false;
+  }
+  fseek(psFile, 0, SEEK_END);
+  long lSize = ftell(psFile);
+  fseek(psFile, 0, SEEK_SET);
+  size_t uLen = ((size_t)lSize < uMaxLen) ? (size_t)lSize : uMaxLen;
+  uint8_t* pucData = malloc(uLen + 1u);
+  bool bOk = (fread(pucData, 1u, uLen, psFile) == uLen);
+  fclose(psFile);
+  if (bOk) vAddEntry(pucData, uLen);
+  free(pucData);
+  return bOk;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Load all files of the corpus directory, sorted by size
+ ******************************************************************************/
+static void vLoadCorpus(const char* pszDir, size_t uMaxLen)
+{
+  DIR* psDir = opendir(pszDir);
+  if (psDir == NULL)
+  {
+    mkdir(pszDir, 0755);
+    return;
+  }
+  for (struct dirent* psEnt = readdir(psDir); psEnt != NULL; psEnt = readdir(psDir))
+  {
+    if (psEnt->d_name[0] == '.') continue;
+    char acPath[4096];
+    snprintf(acPath, sizeof(acPath), "%s/%s", pszDir, psEnt->d_name);
+    (void)bLoadFile(acPath, uMaxLen);
+  }
+  closedir(psDir);
+
+  // Insertion sort by length: small inputs claim features first
+  for (size_t i = 1u; i < s_uCorpusLen; ++i)
+  {
+    FuzzEntry sEntry = s_asCorpus[i];
+    size_t j = i;
+    for (; (j > 0u) && (s_asCorpus[j - 1u].uLen > sEntry.uLen); --j) s_asCorpus[j] = s_asCorpus[j - 1u];
+    s_asCorpus[j] = sEntry;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Save the current input as artifact and terminate
+ *
+ * @param[in] iSig  Signal number (SIGALRM: timeout)
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vCrashHandler(int iSig)
+{
+  static const char s_acMsgCrash[] = "==fuzz== crash, input saved as crash-<hash>\n";
+  static const char s_acMsgTimeout[] = "==fuzz== timeout, input saved as timeout-<hash>\n";
+  bool bTimeout = (iSig == SIGALRM);
+  vSaveInput(s_pszArtifacts, bTimeout ? "timeout-" : "crash-", s_pucCurData, s_uCurLen);
+  if (bTimeout) (void)!write(STDERR_FILENO, s_acMsgTimeout, sizeof(s_acMsgTimeout) - 1u);
+  else (void)!write(STDERR_FILENO, s_acMsgCrash, sizeof(s_acMsgCrash) - 1u);
+  _exit(1);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Parse command line
+ *
+ * @return  (bool)  Options valid
+ * @date  17.10.2026
+ ******************************************************************************/
+static bool bParseArgs(int argc, char* argv[], FuzzOptions* psOpts)
+{
+  *psOpts = (FuzzOptions){
+    .pszArtifacts = ".", .uTimeout = 1u, .uMaxLen = 256u,
+    .ullSeed = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32)
+  };
+  int i = 1;
+  for (; (i < argc) && (argv[i][0] == '-'); ++i)
+  {
+    const char* pszArg = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* pszValue = argv[++i];
+    if (strcmp(pszArg, "--corpus") == 0) psOpts->pszCorpus = pszValue;
+    else if (strcmp(pszArg, "--artifacts") == 0) psOpts->pszArtifacts = pszValue;
+    else if (strcmp(pszArg, "--merge") == 0) psOpts->pszMerge = pszValue;
+    else if (strcmp(pszArg, "--runs") == 0) psOpts->ullRuns = strtoull(pszValue, NULL, 0);
+    else if (strcmp(pszArg, "--time") == 0) psOpts->uSeconds = (unsigned)strtoul(pszValue, NULL, 0);
+    else if (strcmp(pszArg, "--timeout") == 0) psOpts->uTimeout = (unsigned)strtoul(pszValue, NULL, 0);
+    else if (strcmp(pszArg, "--max-len") == 0) psOpts->uMaxLen = (size_t)strtoul(pszValue, NULL, 0);
+    else if (strcmp(pszArg, "--seed") == 0) psOpts->ullSeed = strtoull(pszValue, NULL, 0);
+    else return false;
+  }
+  psOpts->ppszFiles = &argv[i];
+  psOpts->iFiles = argc - i;
+  if ((psOpts->pszMerge != NULL) && (psOpts->pszCorpus == NULL)) return false;
+  if (psOpts->pszMerge != NULL) mkdir(psOpts->pszMerge, 0755);
+  return (psOpts->uMaxLen > 0u) && (psOpts->uTimeout > 0u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Monotonic time in seconds
+ ******************************************************************************/
+static double dNow(void)
+{
+  struct timespec sNow;
+  clock_gettime(CLOCK_MONOTONIC, &sNow);
+  return (double)sNow.tv_sec + (double)sNow.tv_nsec * 1e-9;
+}
@@ -0,0 +1,32 @@
+/*!****************************************************************************
+ * @file
+ * hal_host.c
+ *
+ * @brief
+ * HAL overrides for host builds
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "stm32f1xx_hal.h"
+#include "periph_mock.h"
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Get tick count, advancing SysTick by one period per call
+ *
+ * Overrides the weak HAL implementation. Polling loops such as @c HAL_Delay
+ * and HAL timeouts therefore progress by one tick per iteration instead of
+ * waiting in real time.
+ *
+ * @return  (uint32_t)  Tick count in milliseconds
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t HAL_GetTick(void)
+{
+  HostMock_vTick();
+  return uwTick;
+}
@@ -0,0 +1,40 @@
+/*!****************************************************************************
+ * @file
+ * memory_host.c
+ *
+ * @brief
+ * Stack and heap usage for host builds: not measured
+ *
+ * Replaces "Memory/memory.c" in the host build. The process stack and heap
+ * are managed by the host system and don't reflect the target layout, so no
+ * memory is painted and all usage values are zero.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "memory.h"
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Paint the free RAM below the stack pointer (no-op)
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Memory_vPaint(void)
+{
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get stack and heap usage (always zero)
+ *
+ * @param[out] psUsage  Stack and heap usage in bytes
+ * @date  17.10.2026
+ ******************************************************************************/
+void Memory_vGetUsage(Memory_Usage* psUsage)
+{
+  *psUsage = (Memory_Usage){ 0 };
+}
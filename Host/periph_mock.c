@@ -0,0 +1,673 @@
+/*!****************************************************************************
+ * @file
+ * periph_mock.c
+ *
+ * @brief
+ * Register-level peripheral mock for host builds
+ *
+ * The CMSIS/HAL headers address peripherals through fixed pointers such as
+ * GPIOC = 0x40011000. On the host, these address ranges are mapped at the same
+ * locations, so the unmodified application and HAL sources run natively.
+ *
+ * Registers are kept in shared memory which is mapped twice: at the fixed
+ * address without access permissions, and at an arbitrary alias address for
+ * the mock itself. Every access of the application faults; the fault handler
+ * updates derived registers (e.g. GPIO IDR), grants access to the page and
+ * single-steps the instruction using the x86 trap flag. The trap handler then
+ * revokes access and applies write side effects (BSRR/BRR to ODR, RCC ready
+ * flags, SysTick COUNTFLAG). Bit-band alias accesses are handled the same way,
+ * with the alias page synthesised from the target bits before the access.
+ *
+ * SysTick does not run in real time. Instead, each call to HAL_GetTick() or
+ * __WFI() advances it by one period and calls SysTick_Handler() if the counter
+ * and its interrupt are enabled, so HAL_Delay() completes after the requested
+ * number of ticks at native speed.
+ *
+ * @note Requires Linux on x86-64 (trap flag single-stepping). When debugging
+ * a host build, let the debugger pass SIGSEGV and SIGTRAP to the program, e.g.
+ * "handle SIGSEGV SIGTRAP nostop noprint pass" in GDB.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "periph_mock.h"
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "The peripheral mock requires Linux on x86-64"
+#endif
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Mapped address ranges
+ *  @{                                                                        */
+#define PERIPH_BASE                   0x40000000uL  ///< APB1/APB2/AHB
+#define PERIPH_SIZE                   0x00030000uL
+#define PERIPH_BB_BASE                0x42000000uL  ///< Peripheral bit-band
+#define PERIPH_BB_SIZE                (PERIPH_SIZE * 32uL)
+#define DWT_BASE                      0xE0001000uL  ///< DWT
+#define SCS_BASE                      0xE000E000uL  ///< NVIC, SysTick, SCB
+#define PPB_PAGE_SIZE                 0x00001000uL
+/*! @}                                                                        */
+
+/*! @brief Register addresses
+ *  @{                                                                        */
+#define GPIOA_BASE                    0x40010800uL
+#define GPIO_PORTS                    7u            ///< GPIOA..GPIOG
+#define GPIO_CRL                      0x00u
+#define GPIO_CRH                      0x04u
+#define GPIO_IDR                      0x08u
+#define GPIO_ODR                      0x0Cu
+#define GPIO_BSRR                     0x10u
+#define GPIO_BRR                      0x14u
+#define RCC_CR                        0x40021000uL
+#define RCC_CFGR                      0x40021004uL
+#define RCC_AHBENR                    0x40021014uL
+#define RCC_BDCR                      0x40021020uL
+#define RCC_CSR                       0x40021024uL
+#define FLASH_ACR                     0x40022000uL
+#define EXTI_PR                       0x40010414uL
+#define DWT_CTRL                      0xE0001000uL
+#define DWT_CYCCNT                    0xE0001004uL
+#define SYST_CSR                      0xE000E010uL
+#define SYST_CVR                      0xE000E018uL
+#define SYST_CALIB                    0xE000E01CuL
+#define NVIC_ISER                     0xE000E100uL
+#define NVIC_ICER                     0xE000E180uL
+#define NVIC_ISPR                     0xE000E200uL
+#define NVIC_ICPR                     0xE000E280uL
+#define SCB_CPUID                     0xE000ED00uL
+#define SCB_ICSR                      0xE000ED04uL
+#define SCB_AIRCR                     0xE000ED0CuL
+#define SCB_CCR                       0xE000ED14uL
+#define SCB_DEMCR                     0xE000EDFCuL
+/*! @}                                                                        */
+
+/// SysTick COUNTFLAG
+#define SYST_CSR_COUNTFLAG            (1uL << 16)
+
+/// x86 EFLAGS trap flag
+#define EFLAGS_TF                     0x100uL
+
+/// Nominal core clock for DWT CYCCNT (HSI)
+#define CYCCNT_HZ                     8000000uLL
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Mapped register region
+typedef struct HostMock_Region
+{
+  uintptr_t uBase;                    ///< Target address
+  size_t uSize;                       ///< Size in bytes
+  bool bBitBand;                      ///< Bit-band alias (no backing store)
+  uint8_t* pAlias;                    ///< Mock-side mapping of the registers
+} HostMock_Region;
+
+
+/*- Global data --------------------------------------------------------------*/
+// Core state (see cmsis_host.h)
+volatile uint32_t HostMock_ulPrimask = 0u;
+volatile uint32_t HostMock_ulFaultmask = 0u;
+volatile uint32_t HostMock_ulBasepri = 0u;
+volatile uint32_t HostMock_ulIpsr = 0u;
+
+static HostMock_Region s_asRegions[] = {
+  { PERIPH_BASE,    PERIPH_SIZE,    false, NULL },
+  { PERIPH_BB_BASE, PERIPH_BB_SIZE, true,  NULL },
+  { DWT_BASE,       PPB_PAGE_SIZE,  false, NULL },
+  { SCS_BASE,       PPB_PAGE_SIZE,  false, NULL },
+};
+
+static size_t s_uPageSize;
+static HostMock_Region* s_psActiveRegion;   ///< Region of the stepped access
+static uintptr_t s_uActivePage;             ///< Page of the stepped access
+static uintptr_t s_uActiveAddr;             ///< Faulting address
+static uint32_t* s_pulSnapshot;             ///< Page contents before access
+
+static uint32_t s_aulInputLevel[GPIO_PORTS];
+static uint32_t s_aulInputDriven[GPIO_PORTS];
+static uint32_t s_aaulToggles[GPIO_PORTS][16];
+static uint32_t s_ulTicks;
+static uint64_t s_ullAccesses;
+static uint32_t s_ulCyccntBase;
+static void (*s_pfnFaultHook)(int iSig);
+static uint64_t s_ullCyccntStartNs;
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+extern void SysTick_Handler(void);
+static void vInit(void) __attribute__((constructor(101)));
+static void vSegvHandler(int iSig, siginfo_t* psInfo, void* pContext);
+static void vTrapHandler(int iSig, siginfo_t* psInfo, void* pContext);
+static volatile uint32_t* pulReg(uintptr_t uAddr);
+static void vRefresh(uintptr_t uAddr);
+static void vOnWrite(uintptr_t uAddr, uint32_t ulOld, uint32_t ulNew);
+static void vSetOdr(unsigned uPort, uint32_t ulOdr);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Reset all registers and mock state
+ *
+ * Restores the register reset values, releases driven inputs and clears tick,
+ * toggle and access counters.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void HostMock_vReset(void)
+{
+  for (size_t i = 0u; i < sizeof(s_asRegions) / sizeof(s_asRegions[0]); ++i)
+  {
+    if (!s_asRegions[i].bBitBand) memset(s_asRegions[i].pAlias, 0, s_asRegions[i].uSize);
+  }
+  memset(s_aulInputLevel, 0, sizeof(s_aulInputLevel));
+  memset(s_aulInputDriven, 0, sizeof(s_aulInputDriven));
+  memset(s_aaulToggles, 0, sizeof(s_aaulToggles));
+  s_ulTicks = 0u;
+  s_ullAccesses = 0u;
+  HostMock_ulPrimask = HostMock_ulFaultmask = HostMock_ulBasepri = HostMock_ulIpsr = 0u;
+
+  for (unsigned uPort = 0u; uPort < GPIO_PORTS; ++uPort)
+  {
+    *pulReg(GPIOA_BASE + 0x400uL * uPort + GPIO_CRL) = 0x44444444uL;
+    *pulReg(GPIOA_BASE + 0x400uL * uPort + GPIO_CRH) = 0x44444444uL;
+  }
+  *pulReg(RCC_CR) = 0x00000083uL;
+  *pulReg(RCC_AHBENR) = 0x00000014uL;
+  *pulReg(RCC_CSR) = 0x0C000000uL;
+  *pulReg(FLASH_ACR) = 0x00000030uL;
+  *pulReg(DWT_CTRL) = 0x40000000uL;
+  *pulReg(SYST_CALIB) = 9000uL;
+  *pulReg(SCB_CPUID) = 0x411FC231uL;
+  *pulReg(SCB_AIRCR) = 0xFA050000uL;
+  *pulReg(SCB_CCR) = 0x00000200uL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Set register value without side effects
+ *
+ * @param[in] ulAddr  Register address
+ * @param[in] ulValue Register value
+ * @date  17.10.2026
+ ******************************************************************************/
+void HostMock_vSetRegister(uint32_t ulAddr, uint32_t ulValue)
+{
+  *pulReg(ulAddr) = ulValue;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get register value without side effects
+ *
+ * @param[in] ulAddr  Register address
+ * @return  (uint32_t)  Register value
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t HostMock_ulGetRegister(uint32_t ulAddr)
+{
+  return *pulReg(ulAddr);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Install handler for faults outside the mapped register regions
+ *
+ * The handler is called from the signal handler before the default action
+ * terminates the process, e.g. to save the input of a fuzzing run.
+ *
+ * @param[in] pfnHook Handler, or NULL
+ * @date  17.10.2026
+ ******************************************************************************/
+void HostMock_vSetFaultHook(void (*pfnHook)(int iSig))
+{
+  s_pfnFaultHook = pfnHook;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Advance SysTick by one period
+ *
+ * Sets COUNTFLAG and calls SysTick_Handler() if the counter and its interrupt
+ * are enabled and interrupts are not masked. Nested calls from within an ex-
+ * ception handler only count the tick.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void HostMock_vTick(void)
+{
+  volatile uint32_t* pulCsr = pulReg(SYST_CSR);
+  if (!(*pulCsr & 1uL)) return;
+
+  ++s_ulTicks;
+  *pulCsr |= SYST_CSR_COUNTFLAG;
+  if ((*pulCsr & 2uL) && !HostMock_ulPrimask && (HostMock_ulIpsr == 0u))
+  {
+    HostMock_ulIpsr = 15u;
+    SysTick_Handler();
+    HostMock_ulIpsr = 0u;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Number of SysTick periods elapsed
+ *
+ * @return  (uint32_t)  Tick count
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t HostMock_ulTicks(void)
+{
+  return s_ulTicks;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wait for interrupt: the next interrupt is always the next SysTick period
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void HostMock_vWaitForInterrupt(void)
+{
+  HostMock_vTick();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Drive GPIO input level
+ *
+ * @param[in] cPort   Port letter ('A'..'G')
+ * @param[in] ucPin   Pin number (0..15)
+ * @param[in] bLevel  Input level
+ * @date  17.10.2026
+ ******************************************************************************/
+void HostMock_vSetInput(char cPort, uint8_t ucPin, bool bLevel)
+{
+  unsigned uPort = (unsigned)(cPort - 'A');
+  if ((uPort >= GPIO_PORTS) || (ucPin > 15u)) return;
+  s_aulInputDriven[uPort] |= 1uL << ucPin;
+  s_aulInputLevel[uPort] = bLevel ? (s_aulInputLevel[uPort] | (1uL << ucPin)) : (s_aulInputLevel[uPort] & ~(1uL << ucPin));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get GPIO output data register
+ *
+ * @param[in] cPort Port letter ('A'..'G')
+ * @return  (uint32_t)  ODR value
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t HostMock_ulGetOutput(char cPort)
+{
+  unsigned uPort = (unsigned)(cPort - 'A');
+  return (uPort < GPIO_PORTS) ? *pulReg(GPIOA_BASE + 0x400uL * uPort + GPIO_ODR) : 0u;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of output level changes of a GPIO pin
+ *
+ * @param[in] cPort Port letter ('A'..'G')
+ * @param[in] ucPin Pin number (0..15)
+ * @return  (uint32_t)  Number of level changes
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t HostMock_ulGetToggles(char cPort, uint8_t ucPin)
+{
+  unsigned uPort = (unsigned)(cPort - 'A');
+  return ((uPort < GPIO_PORTS) && (ucPin < 16u)) ? s_aaulToggles[uPort][ucPin] : 0u;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of trapped register accesses
+ *
+ * @return  (uint64_t)  Number of accesses
+ * @date  17.10.2026
+ ******************************************************************************/
+uint64_t HostMock_ullAccesses(void)
+{
+  return s_ullAccesses;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Map register regions and install access handlers
+ *
+ * Runs before main() and before other constructors.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vInit(void)
+{
+  s_uPageSize = (size_t)sysconf(_SC_PAGESIZE);
+  s_pulSnapshot = malloc(s_uPageSize);
+
+  for (size_t i = 0u; i < sizeof(s_asRegions) / sizeof(s_asRegions[0]); ++i)
+  {
+    HostMock_Region* psRegion = &s_asRegions[i];
+    void* pFixed;
+    if (psRegion->bBitBand)
+    {
+      pFixed = mmap((void*)psRegion->uBase, psRegion->uSize, PROT_NONE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    }
+    else
+    {
+      int iFd = memfd_create("periph_mock", 0);
+      if ((iFd < 0) || (ftruncate(iFd, (off_t)psRegion->uSize) != 0))
+      {
+        perror("periph_mock: memfd");
+        abort();
+      }
+      pFixed = mmap((void*)psRegion->uBase, psRegion->uSize, PROT_NONE,
+                    MAP_SHARED | MAP_FIXED_NOREPLACE, iFd, 0);
+      psRegion->pAlias = mmap(NULL, psRegion->uSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+      close(iFd);
+    }
+    if ((pFixed != (void*)psRegion->uBase) || (psRegion->pAlias == MAP_FAILED))
+    {
+      fprintf(stderr, "periph_mock: cannot map 0x%08lx\n", (unsigned long)psRegion->uBase);
+      abort();
+    }
+  }
+
+  HostMock_vReset();
+
+  struct sigaction sAction;
+  memset(&sAction, 0, sizeof(sAction));
+  sAction.sa_flags = SA_SIGINFO;
+  sigemptyset(&sAction.sa_mask);
+  sAction.sa_sigaction = vSegvHandler;
+  sigaction(SIGSEGV, &sAction, NULL);
+  sAction.sa_sigaction = vTrapHandler;
+  sigaction(SIGTRAP, &sAction, NULL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Register access fault: prepare page, grant access, single-step
+ *
+ * Faults outside the mapped regions are passed to the default handler.
+ *
+ * @param[in] iSig      Signal number
+ * @param[in] psInfo    Fault information
+ * @param[inout] pContext Interrupted context
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vSegvHandler(int iSig, siginfo_t* psInfo, void* pContext)
+{
+  uintptr_t uAddr = (uintptr_t)psInfo->si_addr;
+  HostMock_Region* psRegion = NULL;
+  for (size_t i = 0u; i < sizeof(s_asRegions) / sizeof(s_asRegions[0]); ++i)
+  {
+    if (uAddr - s_asRegions[i].uBase < s_asRegions[i].uSize) psRegion = &s_asRegions[i];
+  }
+  if ((psRegion == NULL) || (s_psActiveRegion != NULL))
+  {
+    if (s_pfnFaultHook != NULL) s_pfnFaultHook(iSig);
+    signal(iSig, SIG_DFL);
+    return;
+  }
+
+  ++s_ullAccesses;
+  s_psActiveRegion = psRegion;
+  s_uActiveAddr = uAddr;
+  s_uActivePage = uAddr & ~(uintptr_t)(s_uPageSize - 1u);
+  mprotect((void*)s_uActivePage, s_uPageSize, PROT_READ | PROT_WRITE);
+
+  if (psRegion->bBitBand)
+  {
+    // Synthesise alias words from the target bits
+    uintptr_t uTarget = PERIPH_BASE + ((s_uActivePage - PERIPH_BB_BASE) >> 5);
+    uint32_t* pulAlias = (uint32_t*)s_uActivePage;
+    for (size_t i = 0u; i < s_uPageSize / 4u; i += 32u)
+    {
+      vRefresh(uTarget + i / 8u);
+      uint32_t ulWord = *pulReg(uTarget + i / 8u);
+      for (size_t b = 0u; b < 32u; ++b) pulAlias[i + b] = (ulWord >> b) & 1uL;
+    }
+  }
+  else
+  {
+    vRefresh(uAddr);
+  }
+  memcpy(s_pulSnapshot, (void*)s_uActivePage, s_uPageSize);
+
+  ((ucontext_t*)pContext)->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TF;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Single-step trap: revoke access and apply write side effects
+ *
+ * @param[in] iSig      Signal number
+ * @param[in] psInfo    Trap information
+ * @param[inout] pContext Interrupted context
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vTrapHandler(int iSig, siginfo_t* psInfo, void* pContext)
+{
+  (void)psInfo;
+  if (s_psActiveRegion == NULL)
+  {
+    signal(iSig, SIG_DFL);
+    raise(iSig);
+    return;
+  }
+  ((ucontext_t*)pContext)->uc_mcontext.gregs[REG_EFL] &= ~EFLAGS_TF;
+
+  const uint32_t* pulPage = (const uint32_t*)s_uActivePage;
+  if (s_psActiveRegion->bBitBand)
+  {
+    uintptr_t uTarget = PERIPH_BASE + ((s_uActivePage - PERIPH_BB_BASE) >> 5);
+    for (size_t i = 0u; i < s_uPageSize / 4u; ++i)
+    {
+      if (pulPage[i] == s_pulSnapshot[i]) continue;
+      uintptr_t uReg = uTarget + (i / 32u) * 4u;
+      volatile uint32_t* pulTarget = pulReg(uReg);
+      uint32_t ulOld = *pulTarget;
+      uint32_t ulNew = (pulPage[i] & 1uL) ? (ulOld | (1uL << (i % 32u))) : (ulOld & ~(1uL << (i % 32u)));
+      *pulTarget = ulNew;
+      vOnWrite(uReg, ulOld, ulNew);
+    }
+  }
+  else
+  {
+    for (size_t i = 0u; i < s_uPageSize / 4u; ++i)
+    {
+      uintptr_t uReg = s_uActivePage + i * 4u;
+      if (pulPage[i] != s_pulSnapshot[i])
+      {
+        vOnWrite(uReg, s_pulSnapshot[i], pulPage[i]);
+      }
+      else if ((uReg == SYST_CSR) && ((s_uActiveAddr & ~3uL) == SYST_CSR))
+      {
+        // Reading the control register clears COUNTFLAG
+        *pulReg(SYST_CSR) &= ~SYST_CSR_COUNTFLAG;
+      }
+    }
+  }
+
+  mprotect((void*)s_uActivePage, s_uPageSize, PROT_NONE);
+  s_psActiveRegion = NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Mock-side pointer to a register
+ ******************************************************************************/
+static volatile uint32_t* pulReg(uintptr_t uAddr)
+{
+  for (size_t i = 0u; i < sizeof(s_asRegions) / sizeof(s_asRegions[0]); ++i)
+  {
+    HostMock_Region* psRegion = &s_asRegions[i];
+    if (!psRegion->bBitBand && (uAddr - psRegion->uBase < psRegion->uSize))
+    {
+      return (volatile uint32_t*)(psRegion->pAlias + ((uAddr - psRegion->uBase) & ~3uL));
+    }
+  }
+  abort();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Update derived register values before an access
+ *
+ * @param[in] uAddr Accessed address
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vRefresh(uintptr_t uAddr)
+{
+  if ((uAddr >= GPIOA_BASE) && (uAddr < GPIOA_BASE + 0x400uL * GPIO_PORTS))
+  {
+    // IDR: outputs read back the latch, inputs the driven level or pull
+    uintptr_t uPortBase = uAddr & ~0x3FFuL;
+    unsigned uPort = (unsigned)((uPortBase - GPIOA_BASE) / 0x400uL);
+    uint32_t ulCrl = *pulReg(uPortBase + GPIO_CRL), ulCrh = *pulReg(uPortBase + GPIO_CRH);
+    uint32_t ulOdr = *pulReg(uPortBase + GPIO_ODR);
+    uint32_t ulIdr = 0u;
+    for (unsigned i = 0u; i < 16u; ++i)
+    {
+      uint32_t ulCfg = ((i < 8u ? ulCrl : ulCrh) >> (4u * (i & 7u))) & 0xFu;
+      bool bLevel;
+      if (ulCfg & 3u) bLevel = (ulOdr >> i) & 1u;
+      else if (s_aulInputDriven[uPort] & (1uL << i)) bLevel = (s_aulInputLevel[uPort] >> i) & 1u;
+      else bLevel = ((ulCfg >> 2) == 2u) && ((ulOdr >> i) & 1u);
+      ulIdr |= (uint32_t)bLevel << i;
+    }
+    *pulReg(uPortBase + GPIO_IDR) = ulIdr;
+  }
+  else if ((uAddr & ~3uL) == DWT_CYCCNT)
+  {
+    struct timespec sNow;
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    uint64_t ullNs = (uint64_t)sNow.tv_sec * 1000000000uLL + (uint64_t)sNow.tv_nsec;
+    if (*pulReg(DWT_CTRL) & 1uL)
+    {
+      *pulReg(DWT_CYCCNT) = s_ulCyccntBase + (uint32_t)((ullNs - s_ullCyccntStartNs) * CYCCNT_HZ / 1000000000uLL);
+    }
+  }
+  else if ((uAddr & ~3uL) == SCB_ICSR)
+  {
+    *pulReg(SCB_ICSR) = HostMock_ulIpsr;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Apply side effects of a register write
+ *
+ * @param[in] uAddr Register address
+ * @param[in] ulOld Value before the write
+ * @param[in] ulNew Value written
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vOnWrite(uintptr_t uAddr, uint32_t ulOld, uint32_t ulNew)
+{
+  volatile uint32_t* pulTarget = pulReg(uAddr);
+
+  if ((uAddr >= GPIOA_BASE) && (uAddr < GPIOA_BASE + 0x400uL * GPIO_PORTS))
+  {
+    unsigned uPort = (unsigned)((uAddr - GPIOA_BASE) / 0x400uL);
+    volatile uint32_t* pulOdr = pulReg((uAddr & ~0x3FFuL) + GPIO_ODR);
+    switch (uAddr & 0x3FFuL)
+    {
+      case GPIO_ODR:
+        *pulOdr = ulOld;
+        vSetOdr(uPort, ulNew);
+        break;
+      case GPIO_BSRR:
+        vSetOdr(uPort, (*pulOdr & ~(ulNew >> 16)) | (ulNew & 0xFFFFuL));
+        *pulTarget = 0u;
+        break;
+      case GPIO_BRR:
+        vSetOdr(uPort, *pulOdr & ~(ulNew & 0xFFFFuL));
+        *pulTarget = 0u;
+        break;
+      default:
+        break;
+    }
+    return;
+  }
+
+  switch (uAddr)
+  {
+    case RCC_CR:
+      // HSIRDY, HSERDY, PLLRDY follow HSION, HSEON, PLLON
+      *pulTarget = (ulNew & ~0x02020002uL) | ((ulNew & 0x01010001uL) << 1);
+      break;
+    case RCC_CFGR:
+      // SWS follows SW
+      *pulTarget = (ulNew & ~0xCuL) | ((ulNew & 3uL) << 2);
+      break;
+    case RCC_BDCR:
+    case RCC_CSR:
+      // LSERDY, LSIRDY follow LSEON, LSION
+      *pulTarget = (ulNew & ~2uL) | ((ulNew & 1uL) << 1);
+      break;
+    case EXTI_PR:
+      // Write 1 to clear
+      *pulTarget = ulOld & ~ulNew;
+      break;
+    case SYST_CSR:
+      *pulTarget = (ulNew & 7uL) | (ulOld & SYST_CSR_COUNTFLAG);
+      break;
+    case SYST_CVR:
+      // Any write clears the counter and COUNTFLAG
+      *pulTarget = 0u;
+      *pulReg(SYST_CSR) &= ~SYST_CSR_COUNTFLAG;
+      break;
+    case SCB_AIRCR:
+      *pulTarget = ((ulNew >> 16) == 0x05FAuL) ? (0xFA050000uL | (ulNew & 0x700uL)) : ulOld;
+      break;
+    case DWT_CTRL:
+    case DWT_CYCCNT:
+    {
+      struct timespec sNow;
+      clock_gettime(CLOCK_MONOTONIC, &sNow);
+      s_ullCyccntStartNs = (uint64_t)sNow.tv_sec * 1000000000uLL + (uint64_t)sNow.tv_nsec;
+      s_ulCyccntBase = *pulReg(DWT_CYCCNT);
+      break;
+    }
+    default:
+      if ((uAddr >= NVIC_ISER) && (uAddr < NVIC_ISPR + 0x100uL))
+      {
+        // Set/clear-enable and set/clear-pending registers share state
+        bool bSet = (uAddr < NVIC_ICER) || ((uAddr >= NVIC_ISPR) && (uAddr < NVIC_ICPR));
+        uintptr_t uSetReg = bSet ? uAddr : uAddr - 0x80uL;
+        uint32_t ulState = *pulReg(uSetReg);
+        if (bSet) ulState = ulOld | ulNew;
+        else ulState = (ulState & ~ulNew);
+        *pulReg(uSetReg) = ulState;
+        *pulReg(uSetReg + 0x80uL) = ulState;
+      }
+      break;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Update GPIO output latch and count level changes
+ ******************************************************************************/
+static void vSetOdr(unsigned uPort, uint32_t ulOdr)
+{
+  volatile uint32_t* pulOdr = pulReg(GPIOA_BASE + 0x400uL * uPort + GPIO_ODR);
+  uint32_t ulChanged = (*pulOdr ^ ulOdr) & 0xFFFFuL;
+  for (unsigned i = 0u; i < 16u; ++i)
+  {
+    if (ulChanged & (1uL << i)) ++s_aaulToggles[uPort][i];
+  }
+  *pulOdr = ulOdr & 0xFFFFuL;
+}
@@ -0,0 +1,38 @@
+/*!****************************************************************************
+ * @file
+ * periph_mock.h
+ *
+ * @brief
+ * Register-level peripheral mock for host builds
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef PERIPH_MOCK_H_
+#define PERIPH_MOCK_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Public interface ---------------------------------------------------------*/
+// Register state
+void HostMock_vReset(void);
+void HostMock_vSetRegister(uint32_t ulAddr, uint32_t ulValue);
+uint32_t HostMock_ulGetRegister(uint32_t ulAddr);
+void HostMock_vSetFaultHook(void (*pfnHook)(int iSig));
+
+// SysTick
+void HostMock_vTick(void);
+uint32_t HostMock_ulTicks(void);
+
+// GPIO
+void HostMock_vSetInput(char cPort, uint8_t ucPin, bool bLevel);
+uint32_t HostMock_ulGetOutput(char cPort);
+uint32_t HostMock_ulGetToggles(char cPort, uint8_t ucPin);
+
+// Statistics
+uint64_t HostMock_ullAccesses(void);
+
+#endif // PERIPH_MOCK_H_
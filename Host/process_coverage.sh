@@ -0,0 +1,12 @@
+#!/bin/sh
+
+# Delete old coverage data
+find . -name "*.gcda" -delete
+find . -name "coverage_report.*" -delete
+rm -f coverage.json
+
+# Deserialize "coverage.bin" file using the host toolchain; generate HTML report
+# and a JSON tracefile for merging with the target report
+gcov-tool merge-stream coverage.bin --verbose
+gcovr -r .. --json coverage.json --html-details coverage_report.html --html-theme github.green
+tar -czf coverage_report.tar.gz coverage_report.*
@@ -0,0 +1,363 @@
+/*!****************************************************************************
+ * @file
+ * semihost_posix.c
+ *
+ * @brief
+ * Semihosting API for host builds, implemented with POSIX file I/O
+ *
+ * Replaces "semihost.c" in the host build. Return values follow the semi-
+ * hosting conventions of the target implementation (e.g. read and write return
+ * the number of bytes not transferred), so callers behave identically. Paths
+ * are relative to the working directory of the process.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "semihost.h"
+
+
+/*- Global data --------------------------------------------------------------*/
+/// open() flags for the SYS_OPEN modes "r", "rb", "r+", "r+b", "w", "wb", ...
+static const int s_aiOpenFlags[12] = {
+  O_RDONLY, O_RDONLY,
+  O_RDWR, O_RDWR,
+  O_WRONLY | O_CREAT | O_TRUNC, O_WRONLY | O_CREAT | O_TRUNC,
+  O_RDWR | O_CREAT | O_TRUNC, O_RDWR | O_CREAT | O_TRUNC,
+  O_WRONLY | O_CREAT | O_APPEND, O_WRONLY | O_CREAT | O_APPEND,
+  O_RDWR | O_CREAT | O_APPEND, O_RDWR | O_CREAT | O_APPEND
+};
+
+static int s_iErrno;
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+static uint64_t ullNowNs(void);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Request custom operation: not available on the host
+ *
+ * @return  (uint64_t)  -1
+ * @date  17.10.2026
+ ******************************************************************************/
+uint64_t ullSemihostReqOp(uint32_t ulCmd, uint32_t ulArg)
+{
+  (void)ulCmd; (void)ulArg;
+  return (uint64_t)-1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write character to stdout
+ ******************************************************************************/
+void vSemihostWriteC(char cChar)
+{
+  (void)write(STDOUT_FILENO, &cChar, 1u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write null-terminated string to stdout
+ ******************************************************************************/
+void vSemihostWrite0(const char* pszStr)
+{
+  (void)write(STDOUT_FILENO, pszStr, strlen(pszStr));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read character from stdin
+ ******************************************************************************/
+char cSemihostReadC(void)
+{
+  char cChar = 0;
+  (void)read(STDIN_FILENO, &cChar, 1u);
+  return cChar;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get command line of the host process
+ *
+ * Arguments are joined by spaces, as passed to a target by the debugger.
+ *
+ * @param[out] pBuf   Destination buffer
+ * @param[in] ulSize  Buffer size in bytes
+ * @return  (uint32_t)  Command line string length
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t ulSemihostGetCmdline(void* pBuf, uint32_t ulSize)
+{
+  int iFd = open("/proc/self/cmdline", O_RDONLY);
+  if ((iFd < 0) || (ulSize == 0u)) return 0u;
+  ssize_t lLen = read(iFd, pBuf, ulSize - 1u);
+  close(iFd);
+  if (lLen <= 0) return 0u;
+
+  char* pcBuf = pBuf;
+  while ((lLen > 0) && (pcBuf[lLen - 1] == '\0')) --lLen;
+  for (ssize_t i = 0; i < lLen; ++i)
+  {
+    if (pcBuf[i] == '\0') pcBuf[i] = ' ';
+  }
+  pcBuf[lLen] = '\0';
+  return (uint32_t)lLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run command on host shell
+ ******************************************************************************/
+int32_t lSemihostSystem(const char* pszCmd)
+{
+  return (int32_t)system(pszCmd);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Open a file
+ *
+ * @param[in] pszPath Null terminated file path; ":tt" opens the console
+ * @param[in] ulMode  SYS_OPEN mode (0..11)
+ * @return  (int32_t) File handle
+ * @retval  -1  Open failed
+ * @date  17.10.2026
+ ******************************************************************************/
+int32_t lSemihostOpen(const char* pszPath, uint32_t ulMode)
+{
+  if (ulMode >= 12u)
+  {
+    s_iErrno = EINVAL;
+    return -1;
+  }
+  if (strcmp(pszPath, ":tt") == 0)
+  {
+    return (ulMode < 4u) ? SEMIHOST_STDIN : (ulMode < 8u) ? SEMIHOST_STDOUT : SEMIHOST_STDERR;
+  }
+  int iFd = open(pszPath, s_aiOpenFlags[ulMode], 0644);
+  if (iFd < 0) s_iErrno = errno;
+  return iFd;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Close a file
+ ******************************************************************************/
+bool bSemihostClose(int32_t lFile)
+{
+  if (lFile <= SEMIHOST_STDERR) return true;
+  if (close(lFile) == 0) return true;
+  s_iErrno = errno;
+  return false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write data to file
+ *
+ * @return  (int32_t) Remaining bytes not written to file
+ * @date  17.10.2026
+ ******************************************************************************/
+int32_t lSemihostWrite(int32_t lFile, const void* pData, uint32_t ulLen)
+{
+  const uint8_t* pucData = pData;
+  uint32_t ulLeft = ulLen;
+  while (ulLeft > 0u)
+  {
+    ssize_t lDone = write(lFile, pucData, ulLeft);
+    if (lDone <= 0)
+    {
+      s_iErrno = errno;
+      break;
+    }
+    pucData += lDone;
+    ulLeft -= (uint32_t)lDone;
+  }
+  return (int32_t)ulLeft;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read data from file into buffer
+ *
+ * @return  (int32_t) Remaining number of bytes not read
+ * @date  17.10.2026
+ ******************************************************************************/
+int32_t lSemihostRead(int32_t lFile, void* pBuf, uint32_t ulLen)
+{
+  ssize_t lDone = read(lFile, pBuf, ulLen);
+  if (lDone < 0)
+  {
+    s_iErrno = errno;
+    return (int32_t)ulLen;
+  }
+  return (int32_t)(ulLen - (uint32_t)lDone);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Seek to absolute position in file
+ ******************************************************************************/
+bool bSemihostSeek(int32_t lFile, uint32_t ulPos)
+{
+  if (lseek(lFile, (off_t)ulPos, SEEK_SET) >= 0) return true;
+  s_iErrno = errno;
+  return false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get file size
+ ******************************************************************************/
+int32_t lSemihostGetFLen(int32_t lFile)
+{
+  struct stat sStat;
+  if (fstat(lFile, &sStat) == 0) return (int32_t)sStat.st_size;
+  s_iErrno = errno;
+  return -1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if file is an interactive device
+ ******************************************************************************/
+bool bSemihostIsTTY(int32_t lFile)
+{
+  return isatty(lFile) == 1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get errno of the last failed operation
+ ******************************************************************************/
+int32_t lSemihostGetErrno(void)
+{
+  return s_iErrno;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Delete file
+ ******************************************************************************/
+int32_t lSemihostRemove(const char* pszPath)
+{
+  if (remove(pszPath) == 0) return 0;
+  s_iErrno = errno;
+  return -1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Rename file
+ ******************************************************************************/
+int32_t lSemihostRename(const char* pszFrom, const char* pszTo)
+{
+  if (rename(pszFrom, pszTo) == 0) return 0;
+  s_iErrno = errno;
+  return -1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Generate a temporary filename
+ ******************************************************************************/
+bool bSemihostGetTmpnam(char* pszBuf, uint8_t ucId, uint32_t ulSize)
+{
+  int iLen = snprintf(pszBuf, ulSize, "/tmp/semihost-%d-%03u.tmp", (int)getpid(), ucId);
+  return (iLen > 0) && ((uint32_t)iLen < ulSize);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Test error indication
+ ******************************************************************************/
+bool bSemihostIsError(int32_t lStatus)
+{
+  return lStatus < 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get execution duration in centiseconds
+ ******************************************************************************/
+uint32_t ulSemihostGetClock(void)
+{
+  return (uint32_t)(ullNowNs() / 10000000uLL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get Unix timestamp
+ ******************************************************************************/
+uint32_t ulSemihostGetTime(void)
+{
+  return (uint32_t)time(NULL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get execution duration in ticks (nanoseconds)
+ ******************************************************************************/
+bool bSemihostGetElapsed(uint64_t* pullElapsed)
+{
+  *pullElapsed = ullNowNs();
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get tick frequency of @c bSemihostGetElapsed
+ ******************************************************************************/
+uint32_t ulSemihostGetTickFreq(void)
+{
+  return 1000000000uL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get heap and stack configuration: not available on the host
+ *
+ * @return  (bool)  false
+ * @date  17.10.2026
+ ******************************************************************************/
+bool bSemihostGetHeapInfo(Semihost_HeapInfo* psInfo)
+{
+  memset(psInfo, 0, sizeof(*psInfo));
+  return false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Report application exit: terminates the process (status 0 on success)
+ *
+ * @param[in] ulReason  Exit reason "SEMIHOST_EXIT_..."
+ * @date  17.10.2026
+ ******************************************************************************/
+void vSemihostExit(uint32_t ulReason)
+{
+  exit((ulReason == SEMIHOST_EXIT_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Process CPU time in nanoseconds (starts at zero, like target execution time)
+ ******************************************************************************/
+static uint64_t ullNowNs(void)
+{
+  struct timespec sNow;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &sNow);
+  return (uint64_t)sNow.tv_sec * 1000000000uLL + (uint64_t)sNow.tv_nsec;
+}
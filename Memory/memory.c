@@ -0,0 +1,134 @@
+/*!****************************************************************************
+ * @file
+ * memory.c
+ *
+ * @brief
+ * Stack and heap usage: stack painting and high-water mark scan
+ *
+ * @c Memory_vPaint fills the free RAM between the program break (end of the
+ * heap) and the stack pointer with @c MEMORY_PAINT. The stack grows down into
+ * the painted area; @c Memory_vGetUsage scans upwards from the program break
+ * for the first overwritten word, which is the deepest stack level reached
+ * since the paint. Painting again (e.g. per test case) restarts the high-water
+ * mark; the peak since boot is kept.
+ *
+ * The application runs on the main stack only (no RTOS, the process stack is
+ * unused), so exception handlers share the main stack: the high-water mark
+ * includes the exception frames and the nesting of all interrupts. The usage
+ * reported is at least the stack depth of the last paint, plus
+ * @c MEMORY_PAINT_GUARD.
+ *
+ * Neither the stack nor the heap size is enforced at run time; the sizes of
+ * the linker script are only reserved. A stack exceeding its size overwrites
+ * free RAM first (reported as usage above the size), and then the heap
+ * (reported as no free RAM left).
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include "stm32f1xx.h"
+#include "memory.h"
+
+
+/*- Global data --------------------------------------------------------------*/
+// Memory layout, defined by the linker script (sizes as symbol addresses)
+extern uint8_t end[];                 // start of the heap
+extern uint8_t _estack[];             // top of the stack
+extern uint8_t _Min_Heap_Size[];      // reserved heap size
+extern uint8_t _Min_Stack_Size[];     // reserved stack size
+
+static uint32_t* s_pulPaintBase;      ///< Start of the painted area (NULL: not painted)
+static uint32_t s_ulPeak;             ///< High-water mark of the previous paints
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+// Program break (newlib system call)
+extern void* _sbrk(ptrdiff_t lIncrement);
+
+static uint32_t* pulBreak(void);
+static uint32_t* pulScanBase(void);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Paint the free RAM below the stack pointer
+ *
+ * Called at boot (first statement of @c main), and to restart the high-water
+ * mark of the stack.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Memory_vPaint(void)
+{
+  if (s_pulPaintBase != NULL)
+  {
+    Memory_Usage sUsage;
+    Memory_vGetUsage(&sUsage);
+  }
+
+  uint32_t* pulTop = (uint32_t*)(uintptr_t)((__get_MSP() - MEMORY_PAINT_GUARD) & ~3uL);
+  s_pulPaintBase = pulBreak();
+  for (uint32_t* pulIt = s_pulPaintBase; pulIt < pulTop; ++pulIt)
+  {
+    *pulIt = MEMORY_PAINT;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get stack and heap usage
+ *
+ * Scans the painted area for the stack high-water mark (one read per word of
+ * free RAM at most). Without a paint, the stack usage is the current stack
+ * depth.
+ *
+ * @param[out] psUsage  Stack and heap usage in bytes
+ * @date  17.10.2026
+ ******************************************************************************/
+void Memory_vGetUsage(Memory_Usage* psUsage)
+{
+  uint32_t* pulBase = pulScanBase();
+  uint32_t* pulLow = (s_pulPaintBase != NULL) ? pulBase : (uint32_t*)(uintptr_t)__get_MSP();
+  while ((pulLow < (uint32_t*)_estack) && (*pulLow == MEMORY_PAINT)) ++pulLow;
+
+  uint32_t ulUsed = (uint32_t)((uintptr_t)_estack - (uintptr_t)pulLow);
+  if (ulUsed > s_ulPeak) s_ulPeak = ulUsed;
+  *psUsage = (Memory_Usage){
+    .ulStackSize = (uint32_t)(uintptr_t)_Min_Stack_Size,
+    .ulStackUsed = ulUsed,
+    .ulStackPeak = s_ulPeak,
+    .ulHeapSize = (uint32_t)(uintptr_t)_Min_Heap_Size,
+    .ulHeapUsed = (uint32_t)((uintptr_t)pulBreak() - (uintptr_t)end),
+    .ulFree = (s_pulPaintBase != NULL) ? (uint32_t)((uintptr_t)pulLow - (uintptr_t)pulBase) : 0uL
+  };
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Current program break, word aligned
+ *
+ * @return  (uint32_t*)  First word above the heap
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint32_t* pulBreak(void)
+{
+  return (uint32_t*)(((uintptr_t)_sbrk(0) + 3u) & ~(uintptr_t)3u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Start of the scan: painted area not allocated to the heap since the paint
+ *
+ * @return  (uint32_t*)  Lowest word that may still hold the paint
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint32_t* pulScanBase(void)
+{
+  uint32_t* pulHeap = pulBreak();
+  return (s_pulPaintBase > pulHeap) ? s_pulPaintBase : pulHeap;
+}
@@ -0,0 +1,45 @@
+/*!****************************************************************************
+ * @file
+ * memory.h
+ *
+ * @brief
+ * Stack and heap usage: stack painting and high-water mark scan
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Fill pattern of the unused stack
+#define MEMORY_PAINT                  0xA5A5A5A5uL
+
+/// Bytes below the stack pointer not painted (frame of the painting code)
+#ifndef MEMORY_PAINT_GUARD
+#define MEMORY_PAINT_GUARD            64u
+#endif
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Stack and heap usage in bytes
+typedef struct Memory_Usage
+{
+  uint32_t ulStackSize;               ///< Reserved stack ("_Min_Stack_Size" of the linker script)
+  uint32_t ulStackUsed;               ///< High-water mark since the last @c Memory_vPaint
+  uint32_t ulStackPeak;               ///< High-water mark since boot
+  uint32_t ulHeapSize;                ///< Reserved heap ("_Min_Heap_Size")
+  uint32_t ulHeapUsed;                ///< Allocated heap (program break - "end")
+  uint32_t ulFree;                    ///< Never written between the program break and the stack (0: collision)
+} Memory_Usage;
+
+
+/*- Public interface ---------------------------------------------------------*/
+void Memory_vPaint(void);
+void Memory_vGetUsage(Memory_Usage* psUsage);
+
+#endif // MEMORY_H_
@@ -0,0 +1,182 @@
+/*!****************************************************************************
+ * @file
+ * demo_tests.c
+ *
+ * @brief
+ * Test cases for the demo: LED pin output and SysTick delay
+ *
+ * Select with e.g. "tests=gpio_* toggles=20" on the Semihosting command line.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "stm32f1xx.h"
+#include "gpio_fast.h"
+#include "testing.h"
+#include "timebase.h"
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Configure LED pin (PC13) as push-pull output
+ ******************************************************************************/
+static void vInitLed(void)
+{
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  HAL_GPIO_Init(GPIOC, &(GPIO_InitTypeDef){
+    .Pin = GPIO_PIN_13,
+    .Mode = GPIO_MODE_OUTPUT_PP,
+    .Pull = GPIO_NOPULL,
+    .Speed = GPIO_SPEED_LOW
+  });
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Pin writes are reflected in the output data register
+ ******************************************************************************/
+TESTING_CASE(gpio_write)
+{
+  vInitLed();
+  HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_SET);
+  TESTING_ASSERT((GPIOC->ODR & GPIO_PIN_13) != 0u);
+  HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_RESET);
+  TESTING_ASSERT((GPIOC->ODR & GPIO_PIN_13) == 0u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Toggling restores the pin state after an even number of toggles
+ *
+ * Parameter "toggles": number of toggles (default 6)
+ ******************************************************************************/
+TESTING_CASE(gpio_toggle)
+{
+  int32_t lToggles = Testing_lParam("toggles", 6);
+  vInitLed();
+  HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_SET);
+  for (int32_t i = 0; i < lToggles; ++i)
+  {
+    HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13);
+  }
+  TESTING_ASSERT_EQUAL((lToggles % 2) == 0, (GPIOC->ODR & GPIO_PIN_13) != 0u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * HAL_Delay waits at least the requested time
+ *
+ * Parameter "delay": delay in ms (default 10)
+ ******************************************************************************/
+TESTING_CASE(hal_delay)
+{
+  int32_t lDelay = Testing_lParam("delay", 10);
+  uint32_t ulStart = HAL_GetTick();
+  HAL_Delay((uint32_t)lDelay);
+  TESTING_ASSERT((int32_t)(HAL_GetTick() - ulStart) >= lDelay);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Timebase_vDelayUs waits at least the requested time, and the time base
+ * advances monotonically
+ *
+ * Parameter "delay_us": delay in microseconds (default 250)
+ ******************************************************************************/
+TESTING_CASE(timebase_delay)
+{
+  int32_t lDelay = Testing_lParam("delay_us", 250);
+  uint64_t ullStart = Timebase_ullMicros();
+  Timebase_vDelayUs((uint32_t)lDelay);
+  uint64_t ullEnd = Timebase_ullMicros();
+  TESTING_ASSERT(ullEnd - ullStart >= (uint64_t)lDelay);
+
+  uint64_t ullDeadline = Timebase_ullDeadlineUs((uint32_t)lDelay);
+  TESTING_ASSERT(!Timebase_bExpired(ullDeadline));
+  Timebase_vDelayUs((uint32_t)lDelay);
+  TESTING_ASSERT(Timebase_bExpired(ullDeadline));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Pin configuration is written to the port configuration register
+ *
+ * Parameter "iterations": number of configurations, alternating between output
+ * and input (default 1); used by "Coverage/measure_cost.sh"
+ ******************************************************************************/
+TESTING_CASE(gpio_init)
+{
+  int32_t lIterations = Testing_lParam("iterations", 1);
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  for (int32_t i = 0; i < lIterations; ++i)
+  {
+    HAL_GPIO_Init(GPIOC, &(GPIO_InitTypeDef){
+      .Pin = GPIO_PIN_13,
+      .Mode = (i & 1) ? GPIO_MODE_INPUT : GPIO_MODE_OUTPUT_PP,
+      .Pull = GPIO_PULLUP,
+      .Speed = GPIO_SPEED_LOW
+    });
+  }
+
+  // PC13 configuration in CRH[23:20]: input with pull-up (0x8) or 2 MHz push-pull output (0x2)
+  uint32_t ulExpected = (((lIterations - 1) & 1) != 0) ? 0x8u : 0x2u;
+  TESTING_ASSERT_EQUAL(ulExpected, (GPIOC->CRH >> 20) & 0xFu);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fast path pin writes and toggles are reflected in the output data register
+ ******************************************************************************/
+TESTING_CASE(gpio_fast_write)
+{
+  vInitLed();
+  GpioFast_vSet(GPIOC, GPIO_PIN_13);
+  TESTING_ASSERT((GPIOC->ODR & GPIO_PIN_13) != 0u);
+  GpioFast_vReset(GPIOC, GPIO_PIN_13);
+  TESTING_ASSERT((GPIOC->ODR & GPIO_PIN_13) == 0u);
+  GpioFast_vWrite(GPIOC, GPIO_PIN_13, true);
+  TESTING_ASSERT((GPIOC->ODR & GPIO_PIN_13) != 0u);
+  GpioFast_vToggle(GPIOC, GPIO_PIN_13);
+  TESTING_ASSERT((GPIOC->ODR & GPIO_PIN_13) == 0u);
+  GpioFast_vToggle(GPIOC, GPIO_PIN_13);
+  TESTING_ASSERT((GPIOC->ODR & GPIO_PIN_13) != 0u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fast path pin configuration matches HAL_GPIO_Init
+ ******************************************************************************/
+TESTING_CASE(gpio_fast_init)
+{
+  static const uint32_t aulModes[] = {
+    GPIO_MODE_INPUT, GPIO_MODE_OUTPUT_PP, GPIO_MODE_OUTPUT_OD, GPIO_MODE_AF_PP, GPIO_MODE_AF_OD, GPIO_MODE_ANALOG
+  };
+  static const uint32_t aulPulls[] = { GPIO_NOPULL, GPIO_PULLUP, GPIO_PULLDOWN };
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  for (uint32_t i = 0uL; i < sizeof(aulModes) / sizeof(aulModes[0]); ++i)
+  {
+    for (uint32_t j = 0uL; j < sizeof(aulPulls) / sizeof(aulPulls[0]); ++j)
+    {
+      HAL_GPIO_Init(GPIOC, &(GPIO_InitTypeDef){
+        .Pin = GPIO_PIN_13,
+        .Mode = aulModes[i],
+        .Pull = aulPulls[j],
+        .Speed = GPIO_SPEED_FREQ_MEDIUM
+      });
+      // Invert the PC13 configuration and pull direction, then reconfigure
+      uint32_t ulCrh = GPIOC->CRH, ulOdr = GPIOC->ODR & GPIO_PIN_13;
+      GPIOC->CRH = ulCrh ^ (0xFuL << 20);
+      GPIOC->ODR ^= GPIO_PIN_13;
+      GpioFast_vInit(GPIOC, GPIO_PIN_13, aulModes[i], aulPulls[j], GPIO_SPEED_FREQ_MEDIUM);
+      TESTING_ASSERT_EQUAL(ulCrh, GPIOC->CRH);
+      if (GPIO_FAST_CONFIG(aulModes[i], aulPulls[j], GPIO_SPEED_FREQ_MEDIUM) == 0x8u)
+      {
+        TESTING_ASSERT_EQUAL(ulOdr, GPIOC->ODR & GPIO_PIN_13);
+      }
+    }
+  }
+}
@@ -0,0 +1,33 @@
+#!/bin/sh
+
+# Split "tests.bin" into results and per-test coverage; generate a coverage
+# tracefile per test case and a combined HTML report in "tests/". Run inside
+# the build folder; pass "--host" in "build-host".
+HOST=0
+[ "$1" = "--host" ] && HOST=1
+
+rm -rf tests
+../Tools/scripts/split_tests.py tests.bin -o tests --junit tests/junit.xml
+STATUS=$?
+
+for STREAM in tests/*.bin; do
+  [ -e "$STREAM" ] || continue
+  NAME=$(basename "$STREAM" .bin)
+  if [ $HOST -eq 1 ]; then
+    find . -name "*.gcda" -delete
+    gcov-tool merge-stream "$STREAM"
+    gcovr -r .. --json "tests/$NAME.json"
+  else
+    OBJECTS=$(cat coverage_notes.txt) || exit 1
+    for f in $OBJECTS; do rm -f "${f%.*}.gcda"; done
+    rm -f *.gcov
+    arm-none-eabi-gcov-tool merge-stream "$STREAM"
+    for f in $OBJECTS; do arm-none-eabi-gcov "$f"; done > /dev/null
+    gcovr -r .. -g --json "tests/$NAME.json"
+  fi
+done
+
+# Combined report; each test's lines are available in its tracefile
+TRACEFILES=$(for f in tests/*.json; do [ -e "$f" ] && printf -- '-a %s ' "$f"; done)
+[ -n "$TRACEFILES" ] && gcovr -r .. $TRACEFILES --html-details tests/coverage_report.html --html-theme github.green
+exit $STATUS
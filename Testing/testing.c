@@ -0,0 +1,410 @@
+/*!****************************************************************************
+ * @file
+ * testing.c
+ *
+ * @brief
+ * On-target test registry and runner
+ *
+ * Test cases register themselves using @c TESTING_CASE. At startup, the runner
+ * reads the Semihosting command line; the parameter "tests=" selects cases by
+ * name, all other "key=value" tokens are available to the cases as parameters
+ * (e.g. "tests=gpio_*,-gpio_lock toggles=20"). Tokens without "=", such as
+ * the program name, are ignored. One flashed image can thus run any subset of
+ * the suite with different parameters.
+ *
+ * Coverage counters are reset before each case and dumped after it, so each
+ * case gets its own coverage data. The stack is painted before each case
+ * ("Memory/memory.h"), for the stack high-water mark of the case. Cases may
+ * report numeric results with @c Testing_vMetric (e.g. benchmark cycle
+ * counts). Results and coverage are written as records to a single output
+ * file ("out=" parameter, or the default file):
+ *
+ *     "TRUN" <command line>
+ *     "TCAS" <status> <duration ms> <name> NUL <message> NUL
+ *     "TMET" (<value> <name> NUL)...   (only if the case reported metrics)
+ *     "TMEM" <stack used> <stack size> <heap used> <heap size> <free RAM>
+ *     "GCOV" <coverage stream of the preceding case>
+ *     ...
+ *     "TEND" <cases run> <cases failed>
+ *
+ * Each record starts with the 4-character tag and the payload length (32-bit
+ * little endian). "Tools/scripts/split_tests.py" prints the results and
+ * extracts the per-test coverage streams.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32f1xx.h"
+#include "coverage.h"
+#include "memory.h"
+#include "semihost.h"
+#include "testing.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Command line buffer size
+#define TESTING_CMDLINE_SIZE          256u
+
+/// Maximum number of command line parameters
+#define TESTING_MAX_PARAMS            16u
+
+/// Metrics buffer size per test case (value, name and terminator per metric)
+#define TESTING_METRICS_SIZE          256u
+
+/*! @brief Result record tags and test status
+ *  @{                                                                        */
+#define TESTING_TAG_RUN               "TRUN"
+#define TESTING_TAG_CASE              "TCAS"
+#define TESTING_TAG_METRICS           "TMET"
+#define TESTING_TAG_MEMORY            "TMEM"
+#define TESTING_TAG_GCOV              "GCOV"
+#define TESTING_TAG_END               "TEND"
+
+#define TESTING_STATUS_PASS           0uL
+#define TESTING_STATUS_FAIL           1uL
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Command line parameter
+typedef struct Testing_Param
+{
+  const char* pszKey;
+  const char* pszValue;
+} Testing_Param;
+
+
+/*- Global data --------------------------------------------------------------*/
+// Registered test cases, placed by the linker
+extern const Testing_Case* const __test_cases_start[]; // start marker
+extern const Testing_Case* const __test_cases_end[]; // end marker
+
+static char s_acCmdline[TESTING_CMDLINE_SIZE];
+static char s_acCmdlineCopy[TESTING_CMDLINE_SIZE];
+static Testing_Param s_asParams[TESTING_MAX_PARAMS];
+static uint32_t s_ulNumParams;
+
+static jmp_buf s_sAbort;              ///< Return point of a failed assertion
+static char s_acMessage[128];         ///< Failure message of the running case
+static uint8_t s_aucMetrics[TESTING_METRICS_SIZE]; ///< Metrics of the running case
+static uint32_t s_ulMetricsLen;
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+static bool bSelected(const char* pszName);
+static const char* pszBasename(const char* pszPath);
+static bool bMatch(const char* pszPattern, uint32_t ulPatternLen, const char* pszName);
+static void vWriteRecord(int32_t lFile, uint32_t* pulPos, const char* pszTag, const void* pData, uint32_t ulLen);
+static void vWriteCoverage(int32_t lFile, uint32_t* pulPos);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Read test selection and parameters from the command line
+ *
+ * @return  (bool)  Tests requested ("tests=" parameter present)
+ * @date  17.10.2026
+ ******************************************************************************/
+bool Testing_bInit(void)
+{
+  s_ulNumParams = 0uL;
+  uint32_t ulLen = ulSemihostGetCmdline(s_acCmdline, sizeof(s_acCmdline));
+  if (ulLen >= sizeof(s_acCmdline)) ulLen = 0uL;
+  s_acCmdline[ulLen] = '\0';
+  memcpy(s_acCmdlineCopy, s_acCmdline, sizeof(s_acCmdlineCopy));
+
+  // Split into "key=value" tokens in place
+  for (char* pszTok = strtok(s_acCmdline, " \t"); pszTok != NULL; pszTok = strtok(NULL, " \t"))
+  {
+    char* pcEq = strchr(pszTok, '=');
+    if ((pcEq == NULL) || (s_ulNumParams >= TESTING_MAX_PARAMS)) continue;
+    *pcEq = '\0';
+    s_asParams[s_ulNumParams++] = (Testing_Param){ .pszKey = pszTok, .pszValue = pcEq + 1 };
+  }
+  return Testing_pszParam("tests") != NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run selected test cases
+ *
+ * Results are printed to the debug console and written with per-test coverage
+ * data to the output file.
+ *
+ * @param[in] pszFilename Output file, unless set by the "out=" parameter
+ * @return  (uint32_t)  Number of failed test cases
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Testing_ulRun(const char* pszFilename)
+{
+  const char* pszOut = Testing_pszParam("out");
+  int32_t lFile = lSemihostOpen((pszOut != NULL) ? pszOut : pszFilename, 5 /* wb */);
+  uint32_t ulPos = 0uL;
+  vWriteRecord(lFile, &ulPos, TESTING_TAG_RUN, s_acCmdlineCopy, strlen(s_acCmdlineCopy));
+
+  uint32_t aulSummary[2] = { 0uL, 0uL };  // run, failed
+  for (const Testing_Case* const* ppsCase = __test_cases_start; ppsCase != __test_cases_end; ++ppsCase)
+  {
+    const Testing_Case* psCase = *ppsCase;
+    if (!bSelected(psCase->pszName)) continue;
+
+    s_acMessage[0] = '\0';
+    s_ulMetricsLen = 0uL;
+    uint32_t ulStatus = TESTING_STATUS_PASS;
+    Coverage_vReset();
+    Memory_vPaint();
+    uint32_t ulStart = HAL_GetTick();
+    if (setjmp(s_sAbort) == 0)
+    {
+      psCase->pfnRun();
+    }
+    else
+    {
+      ulStatus = TESTING_STATUS_FAIL;
+    }
+    uint32_t ulDuration = HAL_GetTick() - ulStart;
+    Memory_Usage sUsage;
+    Memory_vGetUsage(&sUsage);
+
+    // Result record: status, duration, name and message
+    uint8_t aucRecord[8u + 64u + sizeof(s_acMessage)];
+    uint32_t ulNameLen = strlen(psCase->pszName);
+    if (ulNameLen > 63u) ulNameLen = 63u;
+    uint32_t ulMsgLen = strlen(s_acMessage);
+    memcpy(&aucRecord[0], &ulStatus, 4u);
+    memcpy(&aucRecord[4], &ulDuration, 4u);
+    memcpy(&aucRecord[8], psCase->pszName, ulNameLen);
+    aucRecord[8u + ulNameLen] = '\0';
+    memcpy(&aucRecord[9u + ulNameLen], s_acMessage, ulMsgLen + 1u);
+    vWriteRecord(lFile, &ulPos, TESTING_TAG_CASE, aucRecord, 10u + ulNameLen + ulMsgLen);
+    if (s_ulMetricsLen != 0uL)
+    {
+      vWriteRecord(lFile, &ulPos, TESTING_TAG_METRICS, s_aucMetrics, s_ulMetricsLen);
+    }
+    uint32_t aulMemory[5] = {
+      sUsage.ulStackUsed, sUsage.ulStackSize, sUsage.ulHeapUsed, sUsage.ulHeapSize, sUsage.ulFree
+    };
+    vWriteRecord(lFile, &ulPos, TESTING_TAG_MEMORY, aulMemory, sizeof(aulMemory));
+    vWriteCoverage(lFile, &ulPos);
+
+    char acLine[64u + sizeof(s_acMessage)];
+    snprintf(acLine, sizeof(acLine), "%s %s (%lu ms)%s%s\n", (ulStatus == TESTING_STATUS_PASS) ? "PASS" : "FAIL",
+             psCase->pszName, (unsigned long)ulDuration, (ulMsgLen != 0u) ? ": " : "", s_acMessage);
+    vSemihostWrite0(acLine);
+
+    ++aulSummary[0];
+    if (ulStatus != TESTING_STATUS_PASS) ++aulSummary[1];
+  }
+
+  vWriteRecord(lFile, &ulPos, TESTING_TAG_END, aulSummary, sizeof(aulSummary));
+  bSemihostClose(lFile);
+
+  char acLine[64];
+  snprintf(acLine, sizeof(acLine), "%lu tests, %lu failed\n", (unsigned long)aulSummary[0],
+           (unsigned long)aulSummary[1]);
+  vSemihostWrite0(acLine);
+  return aulSummary[1];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get command line parameter
+ *
+ * @param[in] pszKey  Parameter name
+ * @return  (const char*) Value, or NULL if not set
+ * @date  17.10.2026
+ ******************************************************************************/
+const char* Testing_pszParam(const char* pszKey)
+{
+  for (uint32_t i = 0uL; i < s_ulNumParams; ++i)
+  {
+    if (strcmp(s_asParams[i].pszKey, pszKey) == 0) return s_asParams[i].pszValue;
+  }
+  return NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get integer command line parameter
+ *
+ * @param[in] pszKey    Parameter name
+ * @param[in] lDefault  Value if not set
+ * @return  (int32_t) Value (decimal, or hexadecimal with "0x")
+ * @date  17.10.2026
+ ******************************************************************************/
+int32_t Testing_lParam(const char* pszKey, int32_t lDefault)
+{
+  const char* pszValue = Testing_pszParam(pszKey);
+  return (pszValue != NULL) ? (int32_t)strtol(pszValue, NULL, 0) : lDefault;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Report a metric of the running test case
+ *
+ * Metrics are written after the result record and listed by
+ * "Tools/scripts/split_tests.py". Metrics exceeding the buffer are dropped.
+ *
+ * @param[in] pszName Metric name (e.g. "cycles")
+ * @param[in] ulValue Value
+ * @date  17.10.2026
+ ******************************************************************************/
+void Testing_vMetric(const char* pszName, uint32_t ulValue)
+{
+  uint32_t ulNameLen = strlen(pszName);
+  if (s_ulMetricsLen + 5u + ulNameLen > sizeof(s_aucMetrics)) return;
+  memcpy(&s_aucMetrics[s_ulMetricsLen], &ulValue, 4u);
+  memcpy(&s_aucMetrics[s_ulMetricsLen + 4u], pszName, ulNameLen + 1u);
+  s_ulMetricsLen += 5u + ulNameLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fail running test case
+ *
+ * @param[in] pszFile File name of the assertion
+ * @param[in] ulLine  Line number of the assertion
+ * @param[in] pszExpr Failed expression
+ * @date  17.10.2026
+ ******************************************************************************/
+void Testing_vFail(const char* pszFile, uint32_t ulLine, const char* pszExpr)
+{
+  snprintf(s_acMessage, sizeof(s_acMessage), "%s:%lu: %s", pszBasename(pszFile), (unsigned long)ulLine, pszExpr);
+  longjmp(s_sAbort, 1);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fail running test case on unequal values
+ *
+ * @param[in] pszFile     File name of the assertion
+ * @param[in] ulLine      Line number of the assertion
+ * @param[in] pszExpr     Checked expression
+ * @param[in] lExpected   Expected value
+ * @param[in] lActual     Actual value
+ * @date  17.10.2026
+ ******************************************************************************/
+void Testing_vFailEqual(const char* pszFile, uint32_t ulLine, const char* pszExpr,
+                        int32_t lExpected, int32_t lActual)
+{
+  snprintf(s_acMessage, sizeof(s_acMessage), "%s:%lu: %s == %ld, expected %ld", pszBasename(pszFile),
+           (unsigned long)ulLine, pszExpr, (long)lActual, (long)lExpected);
+  longjmp(s_sAbort, 1);
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Check test case against the "tests=" filter
+ *
+ * The filter is a comma-separated list of patterns ('*' and '?' wildcards).
+ * A case is selected if it matches any pattern, and no pattern prefixed with
+ * '-'. An empty filter or "*" selects all cases.
+ *
+ * @param[in] pszName Test case name
+ * @return  (bool)  Test case selected
+ * @date  17.10.2026
+ ******************************************************************************/
+static bool bSelected(const char* pszName)
+{
+  const char* pszFilter = Testing_pszParam("tests");
+  bool bIncluded = false, bAnyInclude = false;
+  while ((pszFilter != NULL) && (*pszFilter != '\0'))
+  {
+    uint32_t ulLen = strcspn(pszFilter, ",");
+    bool bExclude = (pszFilter[0] == '-');
+    const char* pszPattern = bExclude ? pszFilter + 1 : pszFilter;
+    uint32_t ulPatternLen = bExclude ? ulLen - 1u : ulLen;
+    if (ulPatternLen != 0u)
+    {
+      if (bExclude && bMatch(pszPattern, ulPatternLen, pszName)) return false;
+      if (!bExclude)
+      {
+        bAnyInclude = true;
+        bIncluded |= bMatch(pszPattern, ulPatternLen, pszName);
+      }
+    }
+    pszFilter += ulLen + ((pszFilter[ulLen] == ',') ? 1u : 0u);
+  }
+  return bIncluded || !bAnyInclude;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wildcard match ('*': any sequence, '?': any character)
+ ******************************************************************************/
+static bool bMatch(const char* pszPattern, uint32_t ulPatternLen, const char* pszName)
+{
+  if (ulPatternLen == 0u) return *pszName == '\0';
+  if (*pszPattern == '*')
+  {
+    do
+    {
+      if (bMatch(pszPattern + 1, ulPatternLen - 1u, pszName)) return true;
+    } while (*pszName++ != '\0');
+    return false;
+  }
+  if ((*pszName == '\0') || ((*pszPattern != '?') && (*pszPattern != *pszName))) return false;
+  return bMatch(pszPattern + 1, ulPatternLen - 1u, pszName + 1);
+}
+
+/*!****************************************************************************
+ * @brief
+ * File name without directory (__FILE__ holds absolute paths)
+ ******************************************************************************/
+static const char* pszBasename(const char* pszPath)
+{
+  const char* pszSep = strrchr(pszPath, '/');
+  return (pszSep != NULL) ? pszSep + 1 : pszPath;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write record to the output file
+ *
+ * @param[in] lFile     Semihosting file handle
+ * @param[inout] pulPos File position
+ * @param[in] pszTag    4-character record tag
+ * @param[in] pData     Payload
+ * @param[in] ulLen     Payload length
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vWriteRecord(int32_t lFile, uint32_t* pulPos, const char* pszTag, const void* pData, uint32_t ulLen)
+{
+  uint8_t aucHeader[8];
+  memcpy(&aucHeader[0], pszTag, 4u);
+  memcpy(&aucHeader[4], &ulLen, 4u);
+  lSemihostWrite(lFile, aucHeader, sizeof(aucHeader));
+  lSemihostWrite(lFile, pData, ulLen);
+  *pulPos += sizeof(aucHeader) + ulLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write coverage record of the last test case
+ *
+ * The stream length is known only afterwards, so the record header is written
+ * with a placeholder and patched.
+ *
+ * @param[in] lFile     Semihosting file handle
+ * @param[inout] pulPos File position
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vWriteCoverage(int32_t lFile, uint32_t* pulPos)
+{
+  uint32_t ulHeaderPos = *pulPos;
+  vWriteRecord(lFile, pulPos, TESTING_TAG_GCOV, NULL, 0uL);
+  uint32_t ulLen = Coverage_ulDumpToFile(lFile);
+  *pulPos += ulLen;
+
+  bSemihostSeek(lFile, ulHeaderPos + 4u);
+  lSemihostWrite(lFile, &ulLen, sizeof(ulLen));
+  bSemihostSeek(lFile, *pulPos);
+}
@@ -0,0 +1,8 @@
+# On-target test registry: the test case sources are part of the firmware
+# sources; registered cases are collected in the ".test_cases" section
+target_include_directories(firmware-common INTERFACE
+	${CMAKE_CURRENT_LIST_DIR}
+)
+target_link_options(firmware-common INTERFACE
+	-T${CMAKE_CURRENT_LIST_DIR}/testing.ld
+)
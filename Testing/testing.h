@@ -0,0 +1,84 @@
+/*!****************************************************************************
+ * @file
+ * testing.h
+ *
+ * @brief
+ * On-target test registry and runner
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef TESTING_H_
+#define TESTING_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Test results output file, relative to the working directory of the host
+#ifndef TESTING_OUTPUT_FILE
+#define TESTING_OUTPUT_FILE           "build/tests.bin"
+#endif
+
+/*!****************************************************************************
+ * @brief
+ * Define and register a test case
+ *
+ * The case is placed in the ".test_cases" section and found by the runner,
+ * so no central list needs to be maintained. Usage:
+ *
+ *     TESTING_CASE(gpio_toggle)
+ *     {
+ *       TESTING_ASSERT(...);
+ *     }
+ *
+ * @param name  Test case name (C identifier), used by the command line filter
+ ******************************************************************************/
+#define TESTING_CASE(name)                                                     \
+  static void name(void);                                                      \
+  static const Testing_Case s_sTestCase_##name = { #name, name };              \
+  __attribute__((used, section(".test_cases")))                                \
+  static const Testing_Case* const s_psTestCase_##name = &s_sTestCase_##name;  \
+  static void name(void)
+
+/*! @brief Assertions: a failed assertion ends the running test case
+ *  @{                                                                        */
+#define TESTING_ASSERT(expr)                                                   \
+  do { if (!(expr)) Testing_vFail(__FILE__, __LINE__, #expr); } while (0)
+
+#define TESTING_ASSERT_EQUAL(lExpected, lActual)                               \
+  do {                                                                         \
+    int32_t lExp_ = (int32_t)(lExpected), lAct_ = (int32_t)(lActual);          \
+    if (lExp_ != lAct_) Testing_vFailEqual(__FILE__, __LINE__, #lActual, lExp_, lAct_); \
+  } while (0)
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Registered test case
+typedef struct Testing_Case
+{
+  const char* pszName;                ///< Test case name
+  void (*pfnRun)(void);               ///< Test body
+} Testing_Case;
+
+
+/*- Public interface ---------------------------------------------------------*/
+bool Testing_bInit(void);
+uint32_t Testing_ulRun(const char* pszFilename);
+
+// Parameters from the command line
+const char* Testing_pszParam(const char* pszKey);
+int32_t Testing_lParam(const char* pszKey, int32_t lDefault);
+
+// Numeric results of the running case
+void Testing_vMetric(const char* pszName, uint32_t ulValue);
+
+// Failure reporting (used by the assertion macros)
+__attribute__((noreturn)) void Testing_vFail(const char* pszFile, uint32_t ulLine, const char* pszExpr);
+__attribute__((noreturn)) void Testing_vFailEqual(const char* pszFile, uint32_t ulLine, const char* pszExpr,
+                                                  int32_t lExpected, int32_t lActual);
+
+#endif // TESTING_H_
@@ -0,0 +1,200 @@
+/*!****************************************************************************
+ * @file
+ * vector_stream.c
+ *
+ * @brief
+ * Double-buffered streaming of test vector files over Semihosting
+ *
+ * Streams files of any size through a small buffer provided by the caller,
+ * which is split into two halves. While the test code works on the block in
+ * one half (handed out as a zero-copy view), the next block is loaded into the
+ * other half. Blocks always contain whole records, so fixed-size test vectors
+ * are never split across blocks. Files ending with an incomplete record are
+ * rejected when opened; a short read ends the stream at the last whole record.
+ *
+ * Semihosting transfers halt the core, so a transfer cannot run concurrently
+ * with the test code. Instead, @c VectorStream_vPrefetch loads the next block
+ * at a point chosen by the caller, e.g. while waiting for a peripheral, and
+ * @c VectorStream_bNext then returns without a transfer. Without prefetching,
+ * @c VectorStream_bNext loads the block itself.
+ *
+ * Transfer bandwidth is measured with the host timer (SYS_ELAPSED), as target
+ * timers stop while the core is halted by the debugger.
+ *
+ * Usage:
+ *
+ *     static uint8_t s_aucBuf[4096];
+ *     VectorStream sStream;
+ *     VectorStream_Block sBlock;
+ *     VectorStream_bOpen(&sStream, "vectors.bin", s_aucBuf, sizeof(s_aucBuf), 16u);
+ *     while (VectorStream_bNext(&sStream, &sBlock))
+ *     {
+ *       VectorStream_vPrefetch(&sStream);
+ *       ... process sBlock.ulLen / 16 records at sBlock.pucData ...
+ *     }
+ *     VectorStream_vClose(&sStream);
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include "semihost.h"
+#include "vector_stream.h"
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+static void vLoad(VectorStream* psStream, uint8_t ucBuf);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Open test vector file and load the first block
+ *
+ * @param[out] psStream     Stream state
+ * @param[in] pszPath       File path on the host
+ * @param[in] pBuffer       Buffer storage for two blocks
+ * @param[in] ulBufferSize  Buffer storage size in bytes
+ * @param[in] ulRecordSize  Record size in bytes; blocks hold whole records
+ * @return  (bool)  File opened; false if it cannot be opened, its length is not
+ *                  a multiple of the record size, or the buffer is smaller
+ *                  than two records
+ * @date  17.10.2026
+ ******************************************************************************/
+bool VectorStream_bOpen(VectorStream* psStream, const char* pszPath, void* pBuffer, uint32_t ulBufferSize,
+                        uint32_t ulRecordSize)
+{
+  *psStream = (VectorStream){ .lFile = -1 };
+  if (ulRecordSize == 0u) return false;
+  psStream->ulRecordSize = ulRecordSize;
+  psStream->ulBlockSize = ((ulBufferSize / 2u) / ulRecordSize) * ulRecordSize;
+  if (psStream->ulBlockSize == 0u) return false;
+
+  psStream->lFile = lSemihostOpen(pszPath, 1 /* rb */);
+  if (psStream->lFile < 0) return false;
+  int32_t lLen = lSemihostGetFLen(psStream->lFile);
+  psStream->ulFileLen = (lLen > 0) ? (uint32_t)lLen : 0u;
+  if ((psStream->ulFileLen % ulRecordSize) != 0u)
+  {
+    VectorStream_vClose(psStream);
+    return false;
+  }
+  psStream->apucBuf[0] = pBuffer;
+  psStream->apucBuf[1] = (uint8_t*)pBuffer + psStream->ulBlockSize;
+
+  uint64_t ullNow;
+  psStream->ulTickFreq = bSemihostGetElapsed(&ullNow) ? ulSemihostGetTickFreq() : 0u;
+
+  // First block goes to buffer 0
+  psStream->ucCurrent = 1u;
+  VectorStream_vPrefetch(psStream);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get next block
+ *
+ * Hands out the prefetched block, or loads it if it has not been prefetched.
+ * The view of the previous block becomes invalid.
+ *
+ * @param[inout] psStream Stream state
+ * @param[out] psBlock    View of the block
+ * @return  (bool)  Block available; false at the end of the file
+ * @date  17.10.2026
+ ******************************************************************************/
+bool VectorStream_bNext(VectorStream* psStream, VectorStream_Block* psBlock)
+{
+  uint8_t ucNext = psStream->ucCurrent ^ 1u;
+  if (!psStream->abLoaded[ucNext]) VectorStream_vPrefetch(psStream);
+  if (!psStream->abLoaded[ucNext]) return false;
+
+  psStream->abLoaded[ucNext] = false;
+  psStream->ucCurrent = ucNext;
+  *psBlock = (VectorStream_Block){
+    .pucData = psStream->apucBuf[ucNext],
+    .ulLen = psStream->aulLen[ucNext],
+    .ulOffset = psStream->aulOffset[ucNext]
+  };
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Load the next block into the free buffer
+ *
+ * Does nothing if the next block is already loaded or the end of the file is
+ * reached. The block handed out last is not affected.
+ *
+ * @param[inout] psStream Stream state
+ * @date  17.10.2026
+ ******************************************************************************/
+void VectorStream_vPrefetch(VectorStream* psStream)
+{
+  uint8_t ucFree = psStream->ucCurrent ^ 1u;
+  if ((psStream->lFile < 0) || psStream->abLoaded[ucFree] || (psStream->ulNextOffset >= psStream->ulFileLen)) return;
+  vLoad(psStream, ucFree);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get transfer bandwidth
+ *
+ * @param[in] psStream  Stream state
+ * @return  (uint32_t)  Bytes per second of host transfer time, 0 if unknown
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t VectorStream_ulBandwidth(const VectorStream* psStream)
+{
+  if ((psStream->ulTickFreq == 0u) || (psStream->ullTicks == 0u)) return 0u;
+  return (uint32_t)((psStream->ullBytes * psStream->ulTickFreq) / psStream->ullTicks);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Close test vector file
+ *
+ * @param[inout] psStream Stream state
+ * @date  17.10.2026
+ ******************************************************************************/
+void VectorStream_vClose(VectorStream* psStream)
+{
+  if (psStream->lFile >= 0) bSemihostClose(psStream->lFile);
+  psStream->lFile = -1;
+  psStream->abLoaded[0] = psStream->abLoaded[1] = false;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Read next block from the file
+ *
+ * A short read ends the stream after the whole records received.
+ *
+ * @param[inout] psStream Stream state
+ * @param[in] ucBuf       Destination buffer index
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vLoad(VectorStream* psStream, uint8_t ucBuf)
+{
+  uint32_t ulLen = psStream->ulFileLen - psStream->ulNextOffset;
+  if (ulLen > psStream->ulBlockSize) ulLen = psStream->ulBlockSize;
+
+  uint64_t ullStart = 0u, ullEnd = 0u;
+  if (psStream->ulTickFreq != 0u) (void)bSemihostGetElapsed(&ullStart);
+  int32_t lLeft = lSemihostRead(psStream->lFile, psStream->apucBuf[ucBuf], ulLen);
+  if (psStream->ulTickFreq != 0u) (void)bSemihostGetElapsed(&ullEnd);
+
+  uint32_t ulGot = ((lLeft >= 0) && ((uint32_t)lLeft <= ulLen)) ? ulLen - (uint32_t)lLeft : 0u;
+  psStream->ullBytes += ulGot;
+  psStream->ullTicks += ullEnd - ullStart;
+
+  // An incomplete record of a short read is not handed out
+  ulGot -= ulGot % psStream->ulRecordSize;
+  psStream->aulLen[ucBuf] = ulGot;
+  psStream->aulOffset[ucBuf] = psStream->ulNextOffset;
+  psStream->abLoaded[ucBuf] = (ulGot != 0u);
+  psStream->ulNextOffset = (ulGot == ulLen) ? psStream->ulNextOffset + ulGot : psStream->ulFileLen;
+}
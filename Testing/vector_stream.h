@@ -0,0 +1,56 @@
+/*!****************************************************************************
+ * @file
+ * vector_stream.h
+ *
+ * @brief
+ * Double-buffered streaming of test vector files over Semihosting
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef VECTOR_STREAM_H_
+#define VECTOR_STREAM_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Zero-copy view of a block; valid until the next @c VectorStream_bNext call
+/// (@c VectorStream_vPrefetch does not overwrite it)
+typedef struct VectorStream_Block
+{
+  const uint8_t* pucData;             ///< Block data in the stream buffer
+  uint32_t ulLen;                     ///< Block length in bytes
+  uint32_t ulOffset;                  ///< File offset of the block
+} VectorStream_Block;
+
+/// Stream state
+typedef struct VectorStream
+{
+  int32_t lFile;                      ///< Semihosting file handle
+  uint32_t ulFileLen;                 ///< File length in bytes
+  uint32_t ulRecordSize;              ///< Record size in bytes
+  uint32_t ulBlockSize;               ///< Buffer size (multiple of the record size)
+  uint8_t* apucBuf[2];                ///< Buffers (halves of the caller's storage)
+  uint32_t aulLen[2];                 ///< Loaded bytes per buffer
+  uint32_t aulOffset[2];              ///< File offset per buffer
+  bool abLoaded[2];                   ///< Buffer holds a block not yet handed out
+  uint8_t ucCurrent;                  ///< Buffer of the block handed out last
+  uint32_t ulNextOffset;              ///< File offset of the next block to load
+  uint32_t ulTickFreq;                ///< Host timer frequency, 0 if unavailable
+  uint64_t ullBytes;                  ///< Bytes transferred
+  uint64_t ullTicks;                  ///< Host timer ticks spent in transfers
+} VectorStream;
+
+
+/*- Public interface ---------------------------------------------------------*/
+bool VectorStream_bOpen(VectorStream* psStream, const char* pszPath, void* pBuffer, uint32_t ulBufferSize,
+                        uint32_t ulRecordSize);
+bool VectorStream_bNext(VectorStream* psStream, VectorStream_Block* psBlock);
+void VectorStream_vPrefetch(VectorStream* psStream);
+uint32_t VectorStream_ulBandwidth(const VectorStream* psStream);
+void VectorStream_vClose(VectorStream* psStream);
+
+#endif // VECTOR_STREAM_H_
@@ -0,0 +1,112 @@
+/*!****************************************************************************
+ * @file
+ * vector_stream_tests.c
+ *
+ * @brief
+ * Test cases for the test vector stream
+ *
+ * The vector files are written by the test cases over Semihosting (in the
+ * working directory of the host) and removed afterwards.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "semihost.h"
+#include "testing.h"
+#include "vector_stream.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Vector file written by the test cases
+#define VECTOR_TESTS_FILE             "vector_stream_test.bin"
+
+/// Record size and stream buffer size: blocks of 8 records
+#define VECTOR_TESTS_RECORD_SIZE      4u
+#define VECTOR_TESTS_BUFFER_SIZE      64u
+
+/// Records in the file: three full blocks and a partial block of 3 records
+#define VECTOR_TESTS_RECORDS          27u
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Write the vector file: records holding their index, plus extra bytes
+ *
+ * @param[in] ulRecords Number of records
+ * @param[in] ulExtra   Bytes of an incomplete record appended
+ ******************************************************************************/
+static void vWriteVectors(uint32_t ulRecords, uint32_t ulExtra)
+{
+  int32_t lFile = lSemihostOpen(VECTOR_TESTS_FILE, 5 /* wb */);
+  TESTING_ASSERT(lFile >= 0);
+  for (uint32_t i = 0uL; i < ulRecords; ++i)
+  {
+    TESTING_ASSERT_EQUAL(0, lSemihostWrite(lFile, &i, sizeof(i)));
+  }
+  static const uint8_t aucExtra[VECTOR_TESTS_RECORD_SIZE - 1u] = { 0xA5u, 0xA5u, 0xA5u };
+  if (ulExtra != 0u) TESTING_ASSERT_EQUAL(0, lSemihostWrite(lFile, aucExtra, ulExtra));
+  bSemihostClose(lFile);
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * A file spanning several blocks is handed out in order: block offsets and
+ * lengths, record contents and the final partial block
+ ******************************************************************************/
+TESTING_CASE(vector_stream_blocks)
+{
+  static uint32_t s_aulBuf[VECTOR_TESTS_BUFFER_SIZE / sizeof(uint32_t)];
+  const uint32_t ulBlockSize = VECTOR_TESTS_BUFFER_SIZE / 2u;
+  vWriteVectors(VECTOR_TESTS_RECORDS, 0u);
+
+  VectorStream sStream;
+  VectorStream_Block sBlock;
+  TESTING_ASSERT(VectorStream_bOpen(&sStream, VECTOR_TESTS_FILE, s_aulBuf, sizeof(s_aulBuf),
+                                    VECTOR_TESTS_RECORD_SIZE));
+  uint32_t ulBlocks = 0uL, ulRecord = 0uL;
+  while (VectorStream_bNext(&sStream, &sBlock))
+  {
+    // Prefetching must not overwrite the block handed out
+    VectorStream_vPrefetch(&sStream);
+    uint32_t ulExpected = VECTOR_TESTS_RECORDS * VECTOR_TESTS_RECORD_SIZE - ulBlocks * ulBlockSize;
+    if (ulExpected > ulBlockSize) ulExpected = ulBlockSize;
+    TESTING_ASSERT_EQUAL(ulBlocks * ulBlockSize, sBlock.ulOffset);
+    TESTING_ASSERT_EQUAL(ulExpected, sBlock.ulLen);
+    for (uint32_t i = 0uL; i < sBlock.ulLen; i += VECTOR_TESTS_RECORD_SIZE)
+    {
+      const uint8_t* pucRecord = &sBlock.pucData[i];
+      uint32_t ulValue = pucRecord[0] | (pucRecord[1] << 8) | (pucRecord[2] << 16) | ((uint32_t)pucRecord[3] << 24);
+      TESTING_ASSERT_EQUAL(ulRecord, ulValue);
+      ++ulRecord;
+    }
+    ++ulBlocks;
+  }
+  VectorStream_vClose(&sStream);
+  lSemihostRemove(VECTOR_TESTS_FILE);
+
+  TESTING_ASSERT_EQUAL(4, ulBlocks);
+  TESTING_ASSERT_EQUAL(VECTOR_TESTS_RECORDS, ulRecord);
+}
+
+/*!****************************************************************************
+ * @brief
+ * A file ending with an incomplete record is rejected
+ ******************************************************************************/
+TESTING_CASE(vector_stream_partial_record)
+{
+  static uint32_t s_aulBuf[VECTOR_TESTS_BUFFER_SIZE / sizeof(uint32_t)];
+  vWriteVectors(VECTOR_TESTS_RECORDS, 2u);
+
+  VectorStream sStream;
+  bool bOpened = VectorStream_bOpen(&sStream, VECTOR_TESTS_FILE, s_aulBuf, sizeof(s_aulBuf),
+                                    VECTOR_TESTS_RECORD_SIZE);
+  VectorStream_vClose(&sStream);
+  lSemihostRemove(VECTOR_TESTS_FILE);
+
+  TESTING_ASSERT(!bOpened);
+  TESTING_ASSERT(sStream.lFile < 0);
+}
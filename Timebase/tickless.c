@@ -0,0 +1,172 @@
+/*!****************************************************************************
+ * @file
+ * tickless.c
+ *
+ * @brief
+ * Tickless idle: delays sleeping with WFI instead of polling the HAL tick
+ *
+ * @c Tickless_vIdle suppresses the SysTick interrupts for a number of ticks:
+ * SysTick is reprogrammed to expire at the tick boundary of the wake-up, and
+ * the core sleeps with WFI. On wake-up (at the boundary, or earlier by any
+ * other interrupt), the ticks elapsed are added to the HAL tick and SysTick
+ * continues with its regular period, phase-aligned to the previous ticks.
+ * The tick is corrected before the interrupt that woke the core is handled,
+ * so HAL timeouts in interrupt handlers see the correct time. The SysTick
+ * interrupt is suppressed for all ticks counted by the tickless idle.
+ *
+ * In builds with @c TICKLESS_IDLE (CMake option), @c HAL_Delay is replaced by
+ * @c Tickless_vDelay, so the HAL's own delay isn't run (nor covered).
+ *
+ * The tick drifts by the few cycles SysTick is stopped for each reprogram-
+ * ming (restart with @c Timebase_vRestartTick). While the core sleeps, the
+ * SysTick fallback of the cycle time base ("timebase.h") is not valid; the DWT
+ * cycle counter is unaffected.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "stm32f1xx.h"
+#include "timebase.h"
+#include "tickless.h"
+
+
+/*- Global data --------------------------------------------------------------*/
+static Tickless_Stats s_sStats;       ///< Idle statistics
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Sleep for up to a number of ticks
+ *
+ * Returns after the number of ticks, or earlier after any interrupt. Sleeps
+ * of less than two ticks (or if a tick is pending) use a plain WFI, woken by
+ * the next tick. The sleep length is limited by the 24-bit SysTick counter
+ * (2 s at 8 MHz, 233 ms at 72 MHz).
+ *
+ * @param[in] ulTicks Ticks to sleep
+ * @date  17.10.2026
+ ******************************************************************************/
+void Tickless_vIdle(uint32_t ulTicks)
+{
+  uint32_t ulPeriod = SysTick->LOAD + 1uL;
+  uint32_t ulMax = SysTick_LOAD_RELOAD_Msk / ulPeriod;
+  if (ulTicks > ulMax) ulTicks = ulMax;
+  if (ulTicks < 2uL)
+  {
+    __WFI();
+    return;
+  }
+
+  // Interrupts wake the core, but are handled after the tick correction
+  uint32_t ulPrimask = __get_PRIMASK();
+  __disable_irq();
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  uint32_t ulToTick = SysTick->VAL;
+  if (((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0uL) || (ulToTick == 0uL))
+  {
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    __set_PRIMASK(ulPrimask);
+    return;
+  }
+
+  // Expire at the boundary of the last tick
+  uint32_t ulSleep = ulToTick + ((ulTicks - 1uL) * ulPeriod);
+  SysTick->LOAD = ulSleep - 1uL;
+  SysTick->VAL = 0uL;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  __DSB();
+  __WFI();
+  __ISB();
+
+  // Cycles slept: expired (and reloaded), or woken earlier by another interrupt
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+  uint32_t ulValue = SysTick->VAL;
+  uint32_t ulElapsed = (ulSleep - 1uL) - ulValue;
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0uL)
+  {
+    if (ulValue != 0uL) ulElapsed += ulSleep;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+  }
+
+  // Count all tick boundaries passed, restart SysTick at the next boundary
+  uint32_t ulSkipped = 0uL;
+  uint32_t ulNext = ulToTick - ulElapsed;
+  if (ulElapsed >= ulToTick)
+  {
+    ulSkipped = 1uL + ((ulElapsed - ulToTick) / ulPeriod);
+    ulNext = ulPeriod - ((ulElapsed - ulToTick) % ulPeriod);
+  }
+  if (ulNext < 2uL)
+  {
+    // Reload value 1 at least (0 stops the counter)
+    ++ulSkipped;
+    ulNext += ulPeriod;
+  }
+  Timebase_vRestartTick(ulNext, ulPeriod);
+
+  uwTick += ulSkipped * (uint32_t)uwTickFreq;
+  s_sStats.ulSkippedTicks += ulSkipped;
+  s_sStats.ullSleepCycles += ulElapsed;
+  ++s_sStats.ulSleeps;
+  __set_PRIMASK(ulPrimask);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wait for a number of milliseconds (same timing as @c HAL_Delay)
+ *
+ * @param[in] ulDelay Delay in milliseconds
+ * @date  17.10.2026
+ ******************************************************************************/
+void Tickless_vDelay(uint32_t ulDelay)
+{
+  uint32_t ulStart = HAL_GetTick();
+  uint32_t ulWait = ulDelay;
+  if (ulWait < HAL_MAX_DELAY) ulWait += (uint32_t)uwTickFreq;
+
+  uint32_t ulElapsed;
+  while ((ulElapsed = HAL_GetTick() - ulStart) < ulWait)
+  {
+    Tickless_vIdle((ulWait - ulElapsed) / (uint32_t)uwTickFreq);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get idle statistics
+ *
+ * @param[out] psStats  Statistics since the last @c Tickless_vResetStats
+ * @date  17.10.2026
+ ******************************************************************************/
+void Tickless_vGetStats(Tickless_Stats* psStats)
+{
+  *psStats = s_sStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset idle statistics
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Tickless_vResetStats(void)
+{
+  s_sStats = (Tickless_Stats){ .ulSleeps = 0uL, .ulSkippedTicks = 0uL, .ullSleepCycles = 0uLL };
+}
+
+#if defined(TICKLESS_IDLE)
+/*!****************************************************************************
+ * @brief
+ * Replaces the polling @c HAL_Delay (weak in the HAL)
+ *
+ * @param[in] Delay Delay in milliseconds
+ * @date  17.10.2026
+ ******************************************************************************/
+void HAL_Delay(uint32_t Delay)
+{
+  Tickless_vDelay(Delay);
+}
+#endif
+
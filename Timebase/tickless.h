@@ -0,0 +1,36 @@
+/*!****************************************************************************
+ * @file
+ * tickless.h
+ *
+ * @brief
+ * Tickless idle: delays sleeping with WFI instead of polling the HAL tick
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef TICKLESS_H_
+#define TICKLESS_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Idle statistics since the last @c Tickless_vResetStats
+typedef struct Tickless_Stats
+{
+  uint32_t ulSleeps;                  ///< Tickless sleeps (WFI with SysTick reprogrammed)
+  uint32_t ulSkippedTicks;            ///< Ticks without SysTick interrupt
+  uint64_t ullSleepCycles;            ///< Core clock cycles spent sleeping
+} Tickless_Stats;
+
+
+/*- Public interface ---------------------------------------------------------*/
+void Tickless_vIdle(uint32_t ulTicks);
+void Tickless_vDelay(uint32_t ulDelay);
+
+// Statistics
+void Tickless_vGetStats(Tickless_Stats* psStats);
+void Tickless_vResetStats(void);
+
+#endif // TICKLESS_H_
@@ -0,0 +1,259 @@
+/*!****************************************************************************
+ * @file
+ * timebase.c
+ *
+ * @brief
+ * 64-bit cycle time base, microsecond delays and timeouts
+ *
+ * Timestamps count core clock cycles since @c Timebase_vInit. They are based
+ * on the DWT cycle counter, extended to 64 bits in software: each read
+ * compares the counter with the previous value and counts wrap-arounds.
+ * @c Timebase_vUpdate is called by the SysTick handler, so no wrap-around
+ * (every 2^32 cycles, 536 s at 8 MHz) is missed while the time base isn't
+ * read.
+ *
+ * Cores without a running DWT cycle counter (e.g. QEMU) fall back to the
+ * SysTick counter and the HAL tick count, with the same resolution while
+ * interrupts are enabled.
+ *
+ * Conversions to microseconds use the current @c SystemCoreClock, so cycle
+ * timestamps taken before a clock change can't be converted afterwards.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "stm32f1xx.h"
+#include "timebase.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Polls for the first reload of a restarted SysTick (more than one SysTick
+/// clock, also with the HCLK/8 clock source)
+#define TIMEBASE_RESTART_POLLS        16uL
+
+
+/*- Global data --------------------------------------------------------------*/
+static bool s_bDwt;                   ///< DWT cycle counter running
+static uint32_t s_ulLast;             ///< Counter value of the last read
+static uint32_t s_ulHigh;             ///< Wrap-arounds since the start
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+static uint64_t ullSysTickCycles(void);
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Start the time base
+ *
+ * Enables the DWT cycle counter and checks that it counts. Call after
+ * @c HAL_Init (SysTick fallback).
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Timebase_vInit(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0uL;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  // Not implemented: NOCYCCNT set, or the counter reads as a constant
+  s_bDwt = false;
+  uint32_t ulStart = DWT->CYCCNT;
+  for (uint32_t i = 0uL; (i < 100uL) && !s_bDwt; ++i)
+  {
+    s_bDwt = ((DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk) == 0uL) && (DWT->CYCCNT != ulStart);
+  }
+
+  s_ulHigh = 0uL;
+  s_ulLast = s_bDwt ? DWT->CYCCNT : 0uL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Extend the cycle counter (called by the SysTick handler)
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Timebase_vUpdate(void)
+{
+  (void)Timebase_ullCycles();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check the time source
+ *
+ * @return  (bool)  DWT cycle counter used (otherwise SysTick)
+ * @date  17.10.2026
+ ******************************************************************************/
+bool Timebase_bDwt(void)
+{
+  return s_bDwt;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get cycle timestamp
+ *
+ * @return  (uint64_t)  Core clock cycles since @c Timebase_vInit
+ * @date  17.10.2026
+ ******************************************************************************/
+uint64_t Timebase_ullCycles(void)
+{
+  if (!s_bDwt) return ullSysTickCycles();
+
+  // Counter and extension are updated together, also from the SysTick handler
+  uint32_t ulPrimask = __get_PRIMASK();
+  __disable_irq();
+  uint32_t ulNow = DWT->CYCCNT;
+  if (ulNow < s_ulLast) ++s_ulHigh;
+  s_ulLast = ulNow;
+  uint64_t ullCycles = ((uint64_t)s_ulHigh << 32) | ulNow;
+  __set_PRIMASK(ulPrimask);
+  return ullCycles;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get microsecond timestamp
+ *
+ * @return  (uint64_t)  Microseconds since @c Timebase_vInit
+ * @date  17.10.2026
+ ******************************************************************************/
+uint64_t Timebase_ullMicros(void)
+{
+  return Timebase_ullCycles() / Timebase_ulCyclesPerUs();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get core clock cycles per microsecond
+ *
+ * @return  (uint32_t)  Cycles per microsecond (at least 1)
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Timebase_ulCyclesPerUs(void)
+{
+  uint32_t ulCycles = SystemCoreClock / 1000000uL;
+  return (ulCycles != 0uL) ? ulCycles : 1uL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get deadline
+ *
+ * @param[in] ulMicros  Time from now in microseconds
+ * @return  (uint64_t)  Deadline (cycle timestamp) for @c Timebase_bExpired
+ * @date  17.10.2026
+ ******************************************************************************/
+uint64_t Timebase_ullDeadlineUs(uint32_t ulMicros)
+{
+  return Timebase_ullCycles() + ((uint64_t)ulMicros * Timebase_ulCyclesPerUs());
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check deadline
+ *
+ * @param[in] ullDeadline Deadline from @c Timebase_ullDeadlineUs
+ * @return  (bool)  Deadline reached
+ * @date  17.10.2026
+ ******************************************************************************/
+bool Timebase_bExpired(uint64_t ullDeadline)
+{
+  return Timebase_ullCycles() >= ullDeadline;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wait for a condition with timeout
+ *
+ * @param[in] pfnDone     Condition, polled until true
+ * @param[in] pArg        Argument of @c pfnDone
+ * @param[in] ulTimeoutUs Timeout in microseconds
+ * @return  (bool)  Condition met (false: timeout)
+ * @date  17.10.2026
+ ******************************************************************************/
+bool Timebase_bWaitUs(bool (*pfnDone)(void* pArg), void* pArg, uint32_t ulTimeoutUs)
+{
+  uint64_t ullDeadline = Timebase_ullDeadlineUs(ulTimeoutUs);
+  while (!pfnDone(pArg))
+  {
+    if (Timebase_bExpired(ullDeadline)) return pfnDone(pArg);
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wait for a number of microseconds
+ *
+ * Busy-waits on the cycle counter; interrupts during the delay only extend
+ * it if they end after the deadline.
+ *
+ * @param[in] ulMicros  Delay in microseconds
+ * @date  17.10.2026
+ ******************************************************************************/
+void Timebase_vDelayUs(uint32_t ulMicros)
+{
+  uint64_t ullDeadline = Timebase_ullDeadlineUs(ulMicros);
+  while (!Timebase_bExpired(ullDeadline))
+  {
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Restart SysTick with a shortened first period
+ *
+ * The counter is started from @c ulFirst cycles to the next tick; the reload
+ * value is changed to the regular period once the counter has loaded the first
+ * period (on the first SysTick clock after enabling, i.e. when it is no longer
+ * 0). Called with SysTick stopped and interrupts disabled, e.g. to realign
+ * the tick after a sleep or a clock switch.
+ *
+ * @param[in] ulFirst   Cycles to the next tick (2 at least)
+ * @param[in] ulPeriod  Regular tick period in cycles
+ * @date  17.10.2026
+ ******************************************************************************/
+void Timebase_vRestartTick(uint32_t ulFirst, uint32_t ulPeriod)
+{
+  SysTick->LOAD = ulFirst - 1uL;
+  SysTick->VAL = 0uL;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  for (uint32_t ulPoll = 0uL; (SysTick->VAL == 0uL) && (ulPoll < TIMEBASE_RESTART_POLLS); ++ulPoll)
+  {
+  }
+  SysTick->LOAD = ulPeriod - 1uL;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Get cycle timestamp from SysTick
+ *
+ * The tick count is read again if the SysTick interrupt incremented it while
+ * the counter was read. @c uwTick is read directly, so the time base isn't
+ * affected by the instrumentation of the HAL. Each SysTick period advances it
+ * by @c uwTickFreq milliseconds.
+ *
+ * @return  (uint64_t)  Core clock cycles since the start of the HAL tick
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint64_t ullSysTickCycles(void)
+{
+  uint32_t ulTick, ulValue;
+  do
+  {
+    ulTick = uwTick;
+    ulValue = SysTick->VAL;
+  } while (ulTick != uwTick);
+
+  uint32_t ulReload = SysTick->LOAD;
+  uint32_t ulPeriods = ulTick / (uint32_t)uwTickFreq;
+  return ((uint64_t)ulPeriods * (ulReload + 1uL)) + (ulReload - ulValue);
+}
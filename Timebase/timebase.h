@@ -0,0 +1,38 @@
+/*!****************************************************************************
+ * @file
+ * timebase.h
+ *
+ * @brief
+ * 64-bit cycle time base, microsecond delays and timeouts
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Public interface ---------------------------------------------------------*/
+void Timebase_vInit(void);
+void Timebase_vUpdate(void);
+bool Timebase_bDwt(void);
+
+// Timestamps
+uint64_t Timebase_ullCycles(void);
+uint64_t Timebase_ullMicros(void);
+uint32_t Timebase_ulCyclesPerUs(void);
+
+// Deadlines, timeouts and delays
+uint64_t Timebase_ullDeadlineUs(uint32_t ulMicros);
+bool Timebase_bExpired(uint64_t ullDeadline);
+bool Timebase_bWaitUs(bool (*pfnDone)(void* pArg), void* pArg, uint32_t ulTimeoutUs);
+void Timebase_vDelayUs(uint32_t ulMicros);
+
+// HAL tick
+void Timebase_vRestartTick(uint32_t ulFirst, uint32_t ulPeriod);
+
+#endif // TIMEBASE_H_
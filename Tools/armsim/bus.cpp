@@ -0,0 +1,206 @@
+/*!****************************************************************************
+ * @file
+ * bus.cpp
+ *
+ * @brief
+ * STM32F103 memory map: flash, SRAM, bit-band aliases and peripheral devices
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "bus.h"
+
+
+namespace armsim {
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Device page table coverage
+ *  @{                                                                        */
+static constexpr uint32_t PERIPH_SIZE     = 0x00030000u;  ///< APB1/APB2/AHB
+static constexpr uint32_t PPB_SIZE        = 0x00100000u;  ///< Private periph.
+static constexpr uint32_t BB_REGION_SIZE  = 0x00100000u;  ///< Bit-band region
+/*! @}                                                                        */
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Create bus with given memory sizes
+ *
+ * @param[in] flashSize Flash memory size in bytes
+ * @param[in] sramSize  SRAM size in bytes
+ * @date  17.10.2026
+ ******************************************************************************/
+Bus::Bus(uint32_t flashSize, uint32_t sramSize)
+  : m_flash(flashSize, 0xFFu),
+    m_sram(sramSize, 0u),
+    m_periphPages(PERIPH_SIZE >> PAGE_SHIFT, nullptr),
+    m_ppbPages(PPB_SIZE >> PAGE_SHIFT, nullptr)
+{
+}
+
+/*!****************************************************************************
+ * @brief
+ * Attach device to the bus
+ *
+ * @param[in] pDevice Device; must outlive the bus
+ * @date  17.10.2026
+ ******************************************************************************/
+void Bus::attach(Device* pDevice)
+{
+  for (uint32_t addr = pDevice->base(); addr < pDevice->base() + pDevice->size(); addr += 1u << PAGE_SHIFT)
+  {
+    if (addr - PERIPH_BASE < PERIPH_SIZE)
+    {
+      m_periphPages[(addr - PERIPH_BASE) >> PAGE_SHIFT] = pDevice;
+    }
+    else if (addr - PPB_BASE < PPB_SIZE)
+    {
+      m_ppbPages[(addr - PPB_BASE) >> PAGE_SHIFT] = pDevice;
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Load data into memory
+ *
+ * @param[in] addr  Destination address (flash or SRAM)
+ * @param[in] pData Source data
+ * @param[in] len   Length in bytes
+ * @return  (bool)  Destination range is valid
+ * @date  17.10.2026
+ ******************************************************************************/
+bool Bus::load(uint32_t addr, const uint8_t* pData, uint32_t len)
+{
+  uint8_t* pDest = hostPtr(addr, len);
+  if (pDest == nullptr) return false;
+  std::memcpy(pDest, pData, len);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get host pointer to memory contents
+ *
+ * @param[in] addr  Target address (flash or SRAM)
+ * @param[in] len   Length of the accessed range in bytes
+ * @return  (uint8_t*)  Host pointer, or nullptr if the range is not backed by
+ *                      flash or SRAM
+ * @date  17.10.2026
+ ******************************************************************************/
+uint8_t* Bus::hostPtr(uint32_t addr, uint32_t len)
+{
+  if ((addr - SRAM_BASE <= m_sram.size()) && (len <= m_sram.size() - (addr - SRAM_BASE)))
+  {
+    return m_sram.data() + (addr - SRAM_BASE);
+  }
+  if ((addr - FLASH_BASE <= m_flash.size()) && (len <= m_flash.size() - (addr - FLASH_BASE)))
+  {
+    return m_flash.data() + (addr - FLASH_BASE);
+  }
+  return nullptr;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Look up device for peripheral or PPB address
+ ******************************************************************************/
+Device* Bus::device(uint32_t addr)
+{
+  if (addr - PERIPH_BASE < PERIPH_SIZE) return m_periphPages[(addr - PERIPH_BASE) >> PAGE_SHIFT];
+  if (addr - PPB_BASE < PPB_SIZE) return m_ppbPages[(addr - PPB_BASE) >> PAGE_SHIFT];
+  return nullptr;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read access outside the SRAM/flash fast path
+ *
+ * Handles the flash boot alias at address 0, bit-band alias regions and memory-
+ * mapped devices.
+ *
+ * @param[in] addr  Address
+ * @param[in] size  Access size in bytes (1, 2 or 4)
+ * @return  (uint32_t)  Value read
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Bus::slowRead(uint32_t addr, unsigned size)
+{
+  // Boot alias (BOOT0 = 0)
+  if (addr <= m_flash.size() - size)
+  {
+    uint32_t ulVal = 0u; std::memcpy(&ulVal, &m_flash[addr], size); return ulVal;
+  }
+
+  // Bit-band aliases
+  if ((addr - SRAM_BB_BASE < BB_REGION_SIZE * 32u) || (addr - PERIPH_BB_BASE < BB_REGION_SIZE * 32u))
+  {
+    uint32_t ulRegion = addr & 0xF0000000u;
+    uint32_t ulOff = (addr - ulRegion - 0x02000000u) >> 5;
+    uint32_t ulBit = (addr >> 2) & 7u;
+    return (slowRead8Aligned(ulRegion + ulOff) >> ulBit) & 1u;
+  }
+
+  Device* pDevice = device(addr);
+  if (pDevice == nullptr) throw BusFault{ addr, false };
+  uint32_t ulOff = addr - pDevice->base();
+  uint32_t ulWord = pDevice->read(ulOff & ~3u);
+  ulWord >>= 8u * (ulOff & 3u);
+  return (size == 4u) ? ulWord : ulWord & ((1u << (8u * size)) - 1u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write access outside the SRAM fast path
+ *
+ * Flash is read-only for the application; writes raise a bus fault.
+ *
+ * @param[in] addr  Address
+ * @param[in] value Value
+ * @param[in] size  Access size in bytes (1, 2 or 4)
+ * @date  17.10.2026
+ ******************************************************************************/
+void Bus::slowWrite(uint32_t addr, uint32_t value, unsigned size)
+{
+  // Bit-band aliases: read-modify-write of a single bit
+  if ((addr - SRAM_BB_BASE < BB_REGION_SIZE * 32u) || (addr - PERIPH_BB_BASE < BB_REGION_SIZE * 32u))
+  {
+    uint32_t ulRegion = addr & 0xF0000000u;
+    uint32_t ulTarget = ulRegion + ((addr - ulRegion - 0x02000000u) >> 5);
+    uint32_t ulBit = (addr >> 2) & 7u;
+    uint8_t ucByte = (uint8_t)slowRead8Aligned(ulTarget);
+    ucByte = (value & 1u) ? (ucByte | (1u << ulBit)) : (ucByte & ~(1u << ulBit));
+    if (ulTarget - SRAM_BASE < m_sram.size())
+    {
+      m_sram[ulTarget - SRAM_BASE] = ucByte;
+    }
+    else
+    {
+      slowWrite(ulTarget, ucByte, 1u);
+    }
+    return;
+  }
+
+  Device* pDevice = device(addr);
+  if (pDevice == nullptr) throw BusFault{ addr, true };
+  uint32_t ulOff = addr - pDevice->base();
+  uint32_t ulShift = 8u * (ulOff & 3u);
+  uint32_t ulMask = (size == 4u) ? 0xFFFFFFFFu : ((1u << (8u * size)) - 1u) << ulShift;
+  pDevice->write(ulOff & ~3u, value << ulShift, ulMask);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read the byte targeted by a bit-band alias access
+ ******************************************************************************/
+uint32_t Bus::slowRead8Aligned(uint32_t addr)
+{
+  if (addr - SRAM_BASE < m_sram.size()) return m_sram[addr - SRAM_BASE];
+  return slowRead(addr, 1u);
+}
+
+} // namespace armsim
@@ -0,0 +1,183 @@
+/*!****************************************************************************
+ * @file
+ * bus.h
+ *
+ * @brief
+ * STM32F103 memory map: flash, SRAM, bit-band aliases and peripheral devices
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef ARMSIM_BUS_H_
+#define ARMSIM_BUS_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace armsim {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Bus fault raised on accesses to unmapped or read-only addresses
+struct BusFault
+{
+  uint32_t ulAddr;                    ///< Faulting address
+  bool bWrite;                        ///< Fault on write access
+};
+
+/// Memory-mapped peripheral device
+class Device
+{
+public:
+  Device(std::string name, uint32_t base, uint32_t size)
+    : m_name(std::move(name)), m_base(base), m_size(size) {}
+  virtual ~Device() = default;
+
+  /// Read 32-bit register at word-aligned offset
+  virtual uint32_t read(uint32_t offset) = 0;
+
+  /// Write 32-bit register at word-aligned offset; only bits in mask are written
+  virtual void write(uint32_t offset, uint32_t value, uint32_t mask) = 0;
+
+  const std::string& name() const { return m_name; }
+  uint32_t base() const { return m_base; }
+  uint32_t size() const { return m_size; }
+
+private:
+  std::string m_name;
+  uint32_t m_base;
+  uint32_t m_size;
+};
+
+/// System bus with STM32F1 memory map
+class Bus
+{
+public:
+  /*! @brief Memory map
+   *  @{                                                                      */
+  static constexpr uint32_t FLASH_BASE    = 0x08000000u;  ///< Flash memory
+  static constexpr uint32_t SRAM_BASE     = 0x20000000u;  ///< SRAM
+  static constexpr uint32_t SRAM_BB_BASE  = 0x22000000u;  ///< SRAM bit-band
+  static constexpr uint32_t PERIPH_BASE   = 0x40000000u;  ///< Peripherals
+  static constexpr uint32_t PERIPH_BB_BASE= 0x42000000u;  ///< Periph. bit-band
+  static constexpr uint32_t PPB_BASE      = 0xE0000000u;  ///< Private periph.
+  static constexpr uint32_t PAGE_SHIFT    = 10u;          ///< Device page size
+  /*! @}                                                                      */
+
+  Bus(uint32_t flashSize, uint32_t sramSize);
+
+  /// Register device; device address ranges must be aligned to 1 KiB pages
+  void attach(Device* pDevice);
+
+  /// Load data into flash or SRAM, bypassing write protection
+  bool load(uint32_t addr, const uint8_t* pData, uint32_t len);
+
+  /// Direct pointer to flash or SRAM contents, or nullptr
+  uint8_t* hostPtr(uint32_t addr, uint32_t len);
+
+  /*! @brief Data access; throw BusFault on invalid accesses
+   *  @{                                                                      */
+  inline uint32_t read32(uint32_t addr);
+  inline uint16_t read16(uint32_t addr);
+  inline uint8_t read8(uint32_t addr);
+  inline void write32(uint32_t addr, uint32_t value);
+  inline void write16(uint32_t addr, uint16_t value);
+  inline void write8(uint32_t addr, uint8_t value);
+  /*! @}                                                                      */
+
+  /// Instruction fetch (halfword)
+  inline uint16_t fetch16(uint32_t addr);
+
+  uint32_t flashSize() const { return (uint32_t)m_flash.size(); }
+  uint32_t sramSize() const { return (uint32_t)m_sram.size(); }
+
+private:
+  uint32_t slowRead(uint32_t addr, unsigned size);
+  void slowWrite(uint32_t addr, uint32_t value, unsigned size);
+  uint32_t slowRead8Aligned(uint32_t addr);
+  Device* device(uint32_t addr);
+
+  std::vector<uint8_t> m_flash;
+  std::vector<uint8_t> m_sram;
+  std::vector<Device*> m_periphPages;   ///< 0x40000000..0x40030000
+  std::vector<Device*> m_ppbPages;      ///< 0xE0000000..0xE0100000
+};
+
+
+/*- Inline functions ---------------------------------------------------------*/
+inline uint32_t Bus::read32(uint32_t addr)
+{
+  uint32_t ulOff = addr - SRAM_BASE;
+  if (ulOff <= m_sram.size() - 4u)
+  {
+    uint32_t ulVal; std::memcpy(&ulVal, &m_sram[ulOff], 4u); return ulVal;
+  }
+  ulOff = addr - FLASH_BASE;
+  if (ulOff <= m_flash.size() - 4u)
+  {
+    uint32_t ulVal; std::memcpy(&ulVal, &m_flash[ulOff], 4u); return ulVal;
+  }
+  return slowRead(addr, 4u);
+}
+
+inline uint16_t Bus::read16(uint32_t addr)
+{
+  uint32_t ulOff = addr - SRAM_BASE;
+  if (ulOff <= m_sram.size() - 2u)
+  {
+    uint16_t usVal; std::memcpy(&usVal, &m_sram[ulOff], 2u); return usVal;
+  }
+  ulOff = addr - FLASH_BASE;
+  if (ulOff <= m_flash.size() - 2u)
+  {
+    uint16_t usVal; std::memcpy(&usVal, &m_flash[ulOff], 2u); return usVal;
+  }
+  return (uint16_t)slowRead(addr, 2u);
+}
+
+inline uint8_t Bus::read8(uint32_t addr)
+{
+  uint32_t ulOff = addr - SRAM_BASE;
+  if (ulOff < m_sram.size()) return m_sram[ulOff];
+  ulOff = addr - FLASH_BASE;
+  if (ulOff < m_flash.size()) return m_flash[ulOff];
+  return (uint8_t)slowRead(addr, 1u);
+}
+
+inline void Bus::write32(uint32_t addr, uint32_t value)
+{
+  uint32_t ulOff = addr - SRAM_BASE;
+  if (ulOff <= m_sram.size() - 4u) { std::memcpy(&m_sram[ulOff], &value, 4u); return; }
+  slowWrite(addr, value, 4u);
+}
+
+inline void Bus::write16(uint32_t addr, uint16_t value)
+{
+  uint32_t ulOff = addr - SRAM_BASE;
+  if (ulOff <= m_sram.size() - 2u) { std::memcpy(&m_sram[ulOff], &value, 2u); return; }
+  slowWrite(addr, value, 2u);
+}
+
+inline void Bus::write8(uint32_t addr, uint8_t value)
+{
+  uint32_t ulOff = addr - SRAM_BASE;
+  if (ulOff < m_sram.size()) { m_sram[ulOff] = value; return; }
+  slowWrite(addr, value, 1u);
+}
+
+inline uint16_t Bus::fetch16(uint32_t addr)
+{
+  uint32_t ulOff = addr - FLASH_BASE;
+  if (ulOff <= m_flash.size() - 2u)
+  {
+    uint16_t usVal; std::memcpy(&usVal, &m_flash[ulOff], 2u); return usVal;
+  }
+  return read16(addr);
+}
+
+} // namespace armsim
+
+#endif // ARMSIM_BUS_H_
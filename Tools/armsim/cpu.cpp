@@ -0,0 +1,1850 @@
+/*!****************************************************************************
+ * @file
+ * cpu.cpp
+ *
+ * @brief
+ * ARMv7-M (Cortex-M3) core: Thumb/Thumb-2 interpreter and exception model
+ *
+ * Implements the ARMv7-M Thumb instruction set without the DSP (v7E-M), float-
+ * ing-point and coprocessor extensions, i.e. everything GCC emits for
+ * "-mcpu=cortex-m3". Instructions are decoded directly from memory on each
+ * step; timed devices are only serviced when their next event is due, and
+ * pending exceptions are only re-evaluated after state changes that may affect
+ * them.
+ *
+ * The cycle model is approximate: one cycle per instruction, plus pipeline
+ * refill for taken branches, one cycle per memory transfer and fixed exception
+ * entry/return latencies.
+ *
+ * Reference: ARMv7-M Architecture Reference Manual (DDI 0403E)
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <algorithm>
+#include <cstdio>
+#include "cpu.h"
+
+
+namespace armsim {
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Cycle model
+ *  @{                                                                        */
+static constexpr unsigned CYC_BRANCH        = 2u;   ///< Pipeline refill
+static constexpr unsigned CYC_MEM           = 1u;   ///< Per memory transfer
+static constexpr unsigned CYC_DIV           = 6u;   ///< Average divide
+static constexpr unsigned CYC_EXC_ENTRY     = 12u;  ///< Exception entry
+static constexpr unsigned CYC_EXC_RETURN    = 10u;  ///< Exception return
+/*! @}                                                                        */
+
+/// Semihosting BKPT immediate
+static constexpr uint32_t BKPT_SEMIHOSTING  = 0xABu;
+
+/// Number of implemented priority bits (STM32F1)
+static constexpr unsigned PRIO_BITS         = 4u;
+
+
+/*- Private functions --------------------------------------------------------*/
+/// Undefined instruction
+struct Undefined {};
+
+/*!****************************************************************************
+ * @brief
+ * Rotate right
+ ******************************************************************************/
+static inline uint32_t ror(uint32_t x, unsigned n)
+{
+  n &= 31u;
+  return n ? (x >> n) | (x << (32u - n)) : x;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Sign-extend value of given bit width
+ ******************************************************************************/
+static inline uint32_t sext(uint32_t x, unsigned bits)
+{
+  uint32_t m = 1u << (bits - 1u);
+  x &= (bits == 32u) ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+  return (x ^ m) - m;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Shift with carry out (Shift_C)
+ *
+ * @param[in] value   Value to be shifted
+ * @param[in] type    0: LSL, 1: LSR, 2: ASR, 3: ROR, 4: RRX
+ * @param[in] amount  Shift amount
+ * @param[inout] carry  Carry in / carry out
+ * @return  (uint32_t)  Shifted value
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint32_t shiftC(uint32_t value, unsigned type, unsigned amount, bool& carry)
+{
+  if ((amount == 0u) && (type != 4u)) return value;
+  switch (type)
+  {
+    case 0u:
+      if (amount < 32u) { carry = (value >> (32u - amount)) & 1u; return value << amount; }
+      carry = (amount == 32u) ? (value & 1u) : false;
+      return 0u;
+
+    case 1u:
+      if (amount < 32u) { carry = (value >> (amount - 1u)) & 1u; return value >> amount; }
+      carry = (amount == 32u) ? (value >> 31) : false;
+      return 0u;
+
+    case 2u:
+      if (amount < 32u) { carry = (value >> (amount - 1u)) & 1u; return (uint32_t)((int32_t)value >> amount); }
+      carry = value >> 31;
+      return carry ? 0xFFFFFFFFu : 0u;
+
+    case 3u:
+    {
+      uint32_t ulResult = ror(value, amount);
+      carry = ulResult >> 31;
+      return ulResult;
+    }
+
+    default:
+    {
+      uint32_t ulResult = ((uint32_t)carry << 31) | (value >> 1);
+      carry = value & 1u;
+      return ulResult;
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Decode immediate shift (DecodeImmShift); returns shift type, updates amount
+ ******************************************************************************/
+static inline unsigned decodeImmShift(unsigned type, unsigned& amount)
+{
+  switch (type)
+  {
+    case 0u: return 0u;
+    case 1u: if (amount == 0u) amount = 32u; return 1u;
+    case 2u: if (amount == 0u) amount = 32u; return 2u;
+    default: if (amount == 0u) { amount = 1u; return 4u; } return 3u;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Addition with carry and overflow (AddWithCarry)
+ ******************************************************************************/
+static inline uint32_t addWithCarry(uint32_t x, uint32_t y, bool carryIn, bool& carry, bool& overflow)
+{
+  uint64_t ullUnsigned = (uint64_t)x + y + carryIn;
+  int64_t llSigned = (int64_t)(int32_t)x + (int32_t)y + carryIn;
+  uint32_t ulResult = (uint32_t)ullUnsigned;
+  carry = (ullUnsigned >> 32) & 1u;
+  overflow = (int64_t)(int32_t)ulResult != llSigned;
+  return ulResult;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Expand modified immediate constant (ThumbExpandImm_C)
+ ******************************************************************************/
+static uint32_t thumbExpandImm(uint32_t imm12, bool& carry)
+{
+  if ((imm12 >> 10) == 0u)
+  {
+    uint32_t imm8 = imm12 & 0xFFu;
+    switch ((imm12 >> 8) & 3u)
+    {
+      case 0u: return imm8;
+      case 1u: return (imm8 << 16) | imm8;
+      case 2u: return (imm8 << 24) | (imm8 << 8);
+      default: return imm8 * 0x01010101u;
+    }
+  }
+  uint32_t ulResult = ror(0x80u | (imm12 & 0x7Fu), imm12 >> 7);
+  carry = ulResult >> 31;
+  return ulResult;
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Create core attached to a bus
+ *
+ * @param[in] bus System bus
+ * @date  17.10.2026
+ ******************************************************************************/
+Cpu::Cpu(Bus& bus)
+  : m_bus(bus), m_cycles(0u), m_insns(0u)
+{
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset core
+ *
+ * Loads the initial stack pointer and reset vector from the vector table at
+ * address 0 (flash boot alias).
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::reset()
+{
+  std::fill(std::begin(m_r), std::end(m_r), 0u);
+  m_n = m_z = m_c = m_v = m_q = false;
+  m_itState = 0u;
+  m_ipsr = 0u;
+  m_primask = m_faultmask = false;
+  m_basepri = 0u;
+  m_control = 0u;
+  m_msp = m_psp = 0u;
+  m_vtor = 0u;
+  m_priGroup = 0u;
+  m_exclusive = false;
+
+  for (unsigned i = 0u; i < NUM_EXC; ++i)
+  {
+    m_pending[i] = m_active[i] = false;
+    m_prio[i] = 0u;
+    m_enabled[i] = (i == EXC_NMI) || (i == EXC_HARDFAULT) || (i == EXC_SVCALL) ||
+                   (i == 12u) || (i == EXC_PENDSV) || (i == EXC_SYSTICK);
+  }
+  m_activeCount = 0u;
+  m_excCheck = true;
+
+  m_nextEvent = 0u;
+  m_sleeping = false;
+  m_exitRequested = false;
+  m_exitCode = 0;
+  m_faultInfo.clear();
+
+  m_r[13] = m_bus.read32(0u) & ~3u;
+  m_pc = m_nextPc = m_bus.read32(4u) & ~1u;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Execute instructions
+ *
+ * @param[in] limit Absolute cycle count at which execution stops
+ * @return  (StopReason)  Reason for stopping
+ * @date  17.10.2026
+ ******************************************************************************/
+StopReason Cpu::run(uint64_t limit)
+{
+  m_stop = false;
+  while (!m_stop)
+  {
+    if (m_cycles >= m_nextEvent)
+    {
+      uint64_t ullNext = UINT64_MAX;
+      for (Timed* pTimed : m_timed)
+      {
+        pTimed->advance(m_cycles);
+        ullNext = std::min(ullNext, pTimed->nextEvent());
+      }
+      m_nextEvent = ullNext;
+    }
+
+    if (m_excCheck)
+    {
+      m_excCheck = false;
+      checkExceptions();
+      if (m_sleeping && (pendingHighest() != 0u)) m_sleeping = false;
+    }
+
+    if (m_cycles >= limit) return StopReason::CycleLimit;
+
+    if (m_sleeping)
+    {
+      // Sleep until the next timed event; stop if nothing can wake the core
+      if (m_nextEvent == UINT64_MAX) return StopReason::Halt;
+      m_cycles = std::min(std::max(m_nextEvent, m_cycles), limit);
+      continue;
+    }
+
+    step();
+    if (m_exitRequested)
+    {
+      return StopReason::Exit;
+    }
+  }
+  return m_stopReason;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Set exception pending
+ *
+ * @param[in] exc Exception number
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::setPending(unsigned exc)
+{
+  if (exc >= NUM_EXC) return;
+  m_pending[exc] = true;
+  m_excCheck = true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Clear pending exception
+ *
+ * @param[in] exc Exception number
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::clearPending(unsigned exc)
+{
+  if (exc >= NUM_EXC) return;
+  m_pending[exc] = false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Enable or disable exception (NVIC_ISER/ICER, SHCSR)
+ *
+ * @param[in] exc     Exception number
+ * @param[in] enable  Enable state
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::setEnabled(unsigned exc, bool enable)
+{
+  if (exc >= NUM_EXC) return;
+  m_enabled[exc] = enable;
+  m_excCheck = true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Set exception priority; only the implemented upper bits are stored
+ *
+ * @param[in] exc   Exception number (configurable priorities only)
+ * @param[in] prio  Priority value
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::setPriority(unsigned exc, uint8_t prio)
+{
+  if ((exc < EXC_MEMMANAGE) || (exc >= NUM_EXC)) return;
+  m_prio[exc] = prio & (uint8_t)(0xFFu << (8u - PRIO_BITS));
+  m_excCheck = true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get highest-priority pending and enabled exception
+ *
+ * @return  (unsigned)  Exception number, or 0 if none is pending
+ * @date  17.10.2026
+ ******************************************************************************/
+unsigned Cpu::pendingHighest() const
+{
+  unsigned uBest = 0u;
+  int iBestPrio = 0x7FFFFFFF;
+  for (unsigned i = EXC_NMI; i < NUM_EXC; ++i)
+  {
+    if (!m_pending[i] || !m_enabled[i]) continue;
+    int iPrio = groupPriority(i);
+    if (iPrio < iBestPrio)
+    {
+      iBestPrio = iPrio;
+      uBest = i;
+    }
+  }
+  return uBest;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Group priority of an exception
+ ******************************************************************************/
+int Cpu::groupPriority(unsigned exc) const
+{
+  if (exc == EXC_NMI) return -2;
+  if (exc == EXC_HARDFAULT) return -1;
+  return m_prio[exc] >> (m_priGroup + 1u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Current execution priority
+ *
+ * Lowest group priority of all active exceptions, boosted by PRIMASK, FAULT-
+ * MASK and BASEPRI.
+ *
+ * @return  (int) Execution priority (256 in thread mode without masking)
+ * @date  17.10.2026
+ ******************************************************************************/
+int Cpu::executionPriority() const
+{
+  int iPrio = 256;
+  if (m_activeCount != 0u)
+  {
+    for (unsigned i = EXC_NMI; i < NUM_EXC; ++i)
+    {
+      if (m_active[i]) iPrio = std::min(iPrio, groupPriority(i));
+    }
+  }
+  if (m_basepri != 0u) iPrio = std::min(iPrio, (int)(m_basepri >> (m_priGroup + 1u)));
+  if (m_primask) iPrio = std::min(iPrio, 0);
+  if (m_faultmask) iPrio = std::min(iPrio, -1);
+  return iPrio;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Take highest-priority pending exception, if it preempts
+ *
+ * @return  (bool)  Exception taken
+ * @date  17.10.2026
+ ******************************************************************************/
+bool Cpu::checkExceptions()
+{
+  unsigned uExc = pendingHighest();
+  if ((uExc == 0u) || (groupPriority(uExc) >= executionPriority())) return false;
+  exceptionEntry(uExc, m_pc);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Exception entry: stack frame, switch to handler mode, jump to vector
+ *
+ * @param[in] exc         Exception number
+ * @param[in] returnAddr  Return address to be stacked
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::exceptionEntry(unsigned exc, uint32_t returnAddr)
+{
+  bool bPsp = (m_ipsr == 0u) && (m_control & 2u);
+  uint32_t ulFrame = m_r[13];
+  bool bAlign = (ulFrame & 4u) != 0u;
+  uint32_t ulSp = (ulFrame - 0x20u) & ~4u;
+  uint32_t ulXpsr = xpsr() | (bAlign ? (1u << 9) : 0u);
+
+  m_bus.write32(ulSp + 0x00u, m_r[0]);
+  m_bus.write32(ulSp + 0x04u, m_r[1]);
+  m_bus.write32(ulSp + 0x08u, m_r[2]);
+  m_bus.write32(ulSp + 0x0Cu, m_r[3]);
+  m_bus.write32(ulSp + 0x10u, m_r[12]);
+  m_bus.write32(ulSp + 0x14u, m_r[14]);
+  m_bus.write32(ulSp + 0x18u, returnAddr);
+  m_bus.write32(ulSp + 0x1Cu, ulXpsr);
+
+  m_r[14] = (m_ipsr != 0u) ? 0xFFFFFFF1u : (bPsp ? 0xFFFFFFFDu : 0xFFFFFFF9u);
+  if (bPsp)
+  {
+    m_psp = ulSp;
+    m_r[13] = m_msp;
+  }
+  else
+  {
+    m_r[13] = ulSp;
+  }
+
+  m_ipsr = exc;
+  m_active[exc] = true;
+  ++m_activeCount;
+  m_pending[exc] = false;
+  m_itState = 0u;
+  m_exclusive = false;
+  m_sleeping = false;
+  m_pc = m_nextPc = m_bus.read32(m_vtor + 4u * exc) & ~1u;
+  m_cycles += CYC_EXC_ENTRY;
+  m_excCheck = true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Exception return: unstack frame, return to thread or handler mode
+ *
+ * @param[in] excReturn EXC_RETURN value written to the PC
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::exceptionReturn(uint32_t excReturn)
+{
+  unsigned uExc = m_ipsr;
+  if (m_active[uExc])
+  {
+    m_active[uExc] = false;
+    --m_activeCount;
+  }
+
+  uint32_t ulFrame;
+  switch (excReturn & 0xFu)
+  {
+    case 0x1u:
+    case 0x9u:
+      ulFrame = m_r[13];
+      break;
+    case 0xDu:
+      m_msp = m_r[13];
+      ulFrame = m_psp;
+      break;
+    default:
+      throw Fault{ EXC_USAGEFAULT, "invalid EXC_RETURN" };
+  }
+
+  m_r[0] = m_bus.read32(ulFrame + 0x00u);
+  m_r[1] = m_bus.read32(ulFrame + 0x04u);
+  m_r[2] = m_bus.read32(ulFrame + 0x08u);
+  m_r[3] = m_bus.read32(ulFrame + 0x0Cu);
+  m_r[12] = m_bus.read32(ulFrame + 0x10u);
+  m_r[14] = m_bus.read32(ulFrame + 0x14u);
+  uint32_t ulPc = m_bus.read32(ulFrame + 0x18u);
+  uint32_t ulXpsr = m_bus.read32(ulFrame + 0x1Cu);
+
+  m_r[13] = ulFrame + 0x20u + (((ulXpsr >> 9) & 1u) ? 4u : 0u);
+  if ((excReturn & 0xFu) == 0xDu)
+  {
+    m_control |= 2u;
+  }
+  else if ((excReturn & 0xFu) == 0x9u)
+  {
+    m_control &= ~2u;
+  }
+
+  setXpsr(ulXpsr);
+  m_nextPc = ulPc & ~1u;
+  m_exclusive = false;
+  m_cycles += CYC_EXC_RETURN;
+  m_excCheck = true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Take a synchronous fault
+ *
+ * Configurable faults escalate to HardFault if they are disabled or cannot
+ * preempt. A fault at HardFault priority or above locks up the core, which
+ * stops the simulation.
+ *
+ * @param[in] fault Fault description
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::takeFault(const Fault& fault)
+{
+  char acBuf[96];
+  std::snprintf(acBuf, sizeof(acBuf), "%s at pc=0x%08x", fault.pszWhat, m_pc);
+  m_faultInfo = acBuf;
+
+  unsigned uExc = fault.exc;
+  if (!m_enabled[uExc] || (groupPriority(uExc) >= executionPriority()))
+  {
+    uExc = EXC_HARDFAULT;
+  }
+  if (groupPriority(uExc) >= executionPriority())
+  {
+    m_stop = true;
+    m_stopReason = StopReason::Lockup;
+    return;
+  }
+  exceptionEntry(uExc, m_pc);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Combined program status register value
+ ******************************************************************************/
+uint32_t Cpu::xpsr() const
+{
+  return ((uint32_t)m_n << 31) | ((uint32_t)m_z << 30) | ((uint32_t)m_c << 29) |
+         ((uint32_t)m_v << 28) | ((uint32_t)m_q << 27) |
+         ((uint32_t)(m_itState & 3u) << 25) | (1u << 24) |
+         ((uint32_t)(m_itState >> 2) << 10) | m_ipsr;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Restore program status register from stacked value
+ ******************************************************************************/
+void Cpu::setXpsr(uint32_t value)
+{
+  m_n = (value >> 31) & 1u;
+  m_z = (value >> 30) & 1u;
+  m_c = (value >> 29) & 1u;
+  m_v = (value >> 28) & 1u;
+  m_q = (value >> 27) & 1u;
+  m_itState = (uint8_t)(((value >> 25) & 3u) | (((value >> 10) & 0x3Fu) << 2));
+  m_ipsr = value & 0x1FFu;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Evaluate condition code against APSR flags
+ ******************************************************************************/
+bool Cpu::condPassed(unsigned cond) const
+{
+  bool bResult;
+  switch (cond >> 1)
+  {
+    case 0u: bResult = m_z; break;
+    case 1u: bResult = m_c; break;
+    case 2u: bResult = m_n; break;
+    case 3u: bResult = m_v; break;
+    case 4u: bResult = m_c && !m_z; break;
+    case 5u: bResult = (m_n == m_v); break;
+    case 6u: bResult = (m_n == m_v) && !m_z; break;
+    default: return true;
+  }
+  return (cond & 1u) ? !bResult : bResult;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Advance IT block state (ITAdvance)
+ ******************************************************************************/
+void Cpu::itAdvance()
+{
+  if ((m_itState & 7u) == 0u)
+  {
+    m_itState = 0u;
+  }
+  else
+  {
+    m_itState = (uint8_t)((m_itState & 0xE0u) | ((m_itState << 1) & 0x1Fu));
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Interworking branch (BXWritePC / LoadWritePC)
+ *
+ * Handles exception returns in handler mode.
+ *
+ * @param[in] addr  Target address
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::bxWritePc(uint32_t addr)
+{
+  if ((m_ipsr != 0u) && ((addr >> 28) == 0xFu))
+  {
+    exceptionReturn(addr);
+    return;
+  }
+  if ((addr & 1u) == 0u) throw Fault{ EXC_USAGEFAULT, "interworking to ARM state" };
+  m_nextPc = addr & ~1u;
+  m_cycles += CYC_BRANCH;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write register; writes to the PC branch
+ *
+ * @param[in] n           Register number
+ * @param[in] value       Value
+ * @param[in] interworking  PC write is an interworking branch (loads)
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::writeReg(unsigned n, uint32_t value, bool interworking)
+{
+  if (n != 15u)
+  {
+    m_r[n] = value;
+  }
+  else if (interworking)
+  {
+    bxWritePc(value);
+  }
+  else
+  {
+    branchTo(value);
+    m_cycles += CYC_BRANCH;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Execute one instruction
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::step()
+{
+  uint8_t ucItBefore = m_itState;
+  uint64_t ullCyclesBefore = m_cycles;
+  try
+  {
+    uint16_t usOp = m_bus.fetch16(m_pc);
+    bool bWide = (usOp >> 11) >= 0x1Du;
+    m_nextPc = m_pc + (bWide ? 4u : 2u);
+
+    // Conditional execution in IT block; state advances before execution
+    bool bExec = true;
+    m_inItInsn = inIt();
+    if (m_inItInsn)
+    {
+      bExec = condPassed(m_itState >> 4);
+      itAdvance();
+    }
+
+    if (bExec)
+    {
+      if (bWide)
+      {
+        step32(((uint32_t)usOp << 16) | m_bus.fetch16(m_pc + 2u));
+      }
+      else
+      {
+        step16(usOp);
+      }
+    }
+  }
+  catch (const BusFault& fault)
+  {
+    m_itState = ucItBefore;
+    m_cycles = ullCyclesBefore;
+    char acBuf[48];
+    std::snprintf(acBuf, sizeof(acBuf), "bus fault (%s 0x%08x)", fault.bWrite ? "write" : "read", fault.ulAddr);
+    m_faultText = acBuf;
+    takeFault(Fault{ EXC_BUSFAULT, m_faultText.c_str() });
+    return;
+  }
+  catch (const Fault& fault)
+  {
+    m_itState = ucItBefore;
+    m_cycles = ullCyclesBefore;
+    takeFault(fault);
+    return;
+  }
+  catch (const Undefined&)
+  {
+    m_itState = ucItBefore;
+    m_cycles = ullCyclesBefore;
+    takeFault(Fault{ EXC_USAGEFAULT, "undefined instruction" });
+    return;
+  }
+
+  m_pc = m_nextPc;
+  ++m_cycles;
+  ++m_insns;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Execute 16-bit Thumb instruction
+ *
+ * @param[in] op  Instruction
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::step16(uint16_t op)
+{
+  const bool bSetFlags = !m_inItInsn;
+  bool c, v;
+
+  switch (op >> 12)
+  {
+    case 0x0u:
+    case 0x1u:
+    {
+      unsigned uRd = op & 7u, uRm = (op >> 3) & 7u;
+      if ((op >> 11) == 3u)
+      {
+        // ADD/SUB register or 3-bit immediate
+        uint32_t ulB = (op & (1u << 10)) ? ((op >> 6) & 7u) : m_r[(op >> 6) & 7u];
+        uint32_t ulResult = (op & (1u << 9))
+          ? addWithCarry(m_r[uRm], ~ulB, true, c, v)
+          : addWithCarry(m_r[uRm], ulB, false, c, v);
+        m_r[uRd] = ulResult;
+        if (bSetFlags) { setNZ(ulResult); m_c = c; m_v = v; }
+      }
+      else
+      {
+        // LSL/LSR/ASR immediate (LSL #0: MOVS)
+        unsigned uAmount = (op >> 6) & 0x1Fu;
+        unsigned uType = decodeImmShift((op >> 11) & 3u, uAmount);
+        c = m_c;
+        uint32_t ulResult = shiftC(m_r[uRm], uType, uAmount, c);
+        m_r[uRd] = ulResult;
+        if (bSetFlags) { setNZ(ulResult); m_c = c; }
+      }
+      return;
+    }
+
+    case 0x2u:
+    case 0x3u:
+    {
+      // MOV/CMP/ADD/SUB 8-bit immediate
+      unsigned uRdn = (op >> 8) & 7u;
+      uint32_t ulImm = op & 0xFFu;
+      switch ((op >> 11) & 3u)
+      {
+        case 0u:
+          m_r[uRdn] = ulImm;
+          if (bSetFlags) setNZ(ulImm);
+          break;
+        case 1u:
+        {
+          uint32_t ulResult = addWithCarry(m_r[uRdn], ~ulImm, true, c, v);
+          setNZ(ulResult); m_c = c; m_v = v;
+          break;
+        }
+        case 2u:
+        {
+          uint32_t ulResult = addWithCarry(m_r[uRdn], ulImm, false, c, v);
+          m_r[uRdn] = ulResult;
+          if (bSetFlags) { setNZ(ulResult); m_c = c; m_v = v; }
+          break;
+        }
+        default:
+        {
+          uint32_t ulResult = addWithCarry(m_r[uRdn], ~ulImm, true, c, v);
+          m_r[uRdn] = ulResult;
+          if (bSetFlags) { setNZ(ulResult); m_c = c; m_v = v; }
+          break;
+        }
+      }
+      return;
+    }
+
+    case 0x4u:
+      if ((op >> 10) == 0x10u)
+      {
+        // Data processing (register)
+        unsigned uRdn = op & 7u, uRm = (op >> 3) & 7u;
+        uint32_t a = m_r[uRdn], b = m_r[uRm], ulResult = 0u;
+        bool bWrite = true, bArith = false;
+        c = m_c; v = m_v;
+        switch ((op >> 6) & 0xFu)
+        {
+          case 0x0u: ulResult = a & b; break;
+          case 0x1u: ulResult = a ^ b; break;
+          case 0x2u: ulResult = shiftC(a, 0u, b & 0xFFu, c); break;
+          case 0x3u: ulResult = shiftC(a, 1u, b & 0xFFu, c); break;
+          case 0x4u: ulResult = shiftC(a, 2u, b & 0xFFu, c); break;
+          case 0x5u: ulResult = addWithCarry(a, b, m_c, c, v); bArith = true; break;
+          case 0x6u: ulResult = addWithCarry(a, ~b, m_c, c, v); bArith = true; break;
+          case 0x7u: ulResult = shiftC(a, 3u, b & 0xFFu, c); break;
+          case 0x8u: ulResult = a & b; bWrite = false; break;
+          case 0x9u: ulResult = addWithCarry(~b, 0u, true, c, v); bArith = true; a = b; break;
+          case 0xAu: ulResult = addWithCarry(a, ~b, true, c, v); bArith = true; bWrite = false; break;
+          case 0xBu: ulResult = addWithCarry(a, b, false, c, v); bArith = true; bWrite = false; break;
+          case 0xCu: ulResult = a | b; break;
+          case 0xDu: ulResult = a * b; break;
+          case 0xEu: ulResult = a & ~b; break;
+          default:   ulResult = ~b; break;
+        }
+        if (bWrite) m_r[uRdn] = ulResult;
+        if (bSetFlags || !bWrite)
+        {
+          setNZ(ulResult);
+          m_c = c;
+          if (bArith) m_v = v;
+        }
+        return;
+      }
+      if ((op >> 10) == 0x11u)
+      {
+        // Special data instructions and branch/exchange
+        unsigned uRm = (op >> 3) & 0xFu;
+        unsigned uRdn = (op & 7u) | ((op >> 4) & 8u);
+        switch ((op >> 8) & 3u)
+        {
+          case 0u:
+            // ADD (register, high registers)
+            writeReg(uRdn, ((uRdn == 15u) ? pcRead() : m_r[uRdn]) + ((uRm == 15u) ? pcRead() : m_r[uRm]), false);
+            return;
+          case 1u:
+          {
+            uint32_t a = (uRdn == 15u) ? pcRead() : m_r[uRdn];
+            uint32_t b = (uRm == 15u) ? pcRead() : m_r[uRm];
+            uint32_t ulResult = addWithCarry(a, ~b, true, c, v);
+            setNZ(ulResult); m_c = c; m_v = v;
+            return;
+          }
+          case 2u:
+            writeReg(uRdn, (uRm == 15u) ? pcRead() : m_r[uRm], false);
+            return;
+          default:
+          {
+            uint32_t ulTarget = (uRm == 15u) ? pcRead() : m_r[uRm];
+            if (op & 0x80u) m_r[14] = m_nextPc | 1u;
+            bxWritePc(ulTarget);
+            return;
+          }
+        }
+      }
+      // LDR (literal)
+      m_r[(op >> 8) & 7u] = m_bus.read32(((m_pc + 4u) & ~3u) + ((op & 0xFFu) << 2));
+      m_cycles += CYC_MEM;
+      return;
+
+    case 0x5u:
+    {
+      // Load/store (register offset)
+      unsigned uRt = op & 7u;
+      uint32_t ulAddr = m_r[(op >> 3) & 7u] + m_r[(op >> 6) & 7u];
+      switch ((op >> 9) & 7u)
+      {
+        case 0u: m_bus.write32(ulAddr, m_r[uRt]); break;
+        case 1u: m_bus.write16(ulAddr, (uint16_t)m_r[uRt]); break;
+        case 2u: m_bus.write8(ulAddr, (uint8_t)m_r[uRt]); break;
+        case 3u: m_r[uRt] = sext(m_bus.read8(ulAddr), 8u); break;
+        case 4u: m_r[uRt] = m_bus.read32(ulAddr); break;
+        case 5u: m_r[uRt] = m_bus.read16(ulAddr); break;
+        case 6u: m_r[uRt] = m_bus.read8(ulAddr); break;
+        default: m_r[uRt] = sext(m_bus.read16(ulAddr), 16u); break;
+      }
+      m_cycles += CYC_MEM;
+      return;
+    }
+
+    case 0x6u:
+    case 0x7u:
+    {
+      // Load/store word/byte (immediate offset)
+      unsigned uRt = op & 7u;
+      uint32_t ulImm = (op >> 6) & 0x1Fu;
+      uint32_t ulBase = m_r[(op >> 3) & 7u];
+      switch ((op >> 11) & 3u)
+      {
+        case 0u: m_bus.write32(ulBase + (ulImm << 2), m_r[uRt]); break;
+        case 1u: m_r[uRt] = m_bus.read32(ulBase + (ulImm << 2)); break;
+        case 2u: m_bus.write8(ulBase + ulImm, (uint8_t)m_r[uRt]); break;
+        default: m_r[uRt] = m_bus.read8(ulBase + ulImm); break;
+      }
+      m_cycles += CYC_MEM;
+      return;
+    }
+
+    case 0x8u:
+    {
+      // Load/store halfword (immediate offset)
+      unsigned uRt = op & 7u;
+      uint32_t ulAddr = m_r[(op >> 3) & 7u] + (((op >> 6) & 0x1Fu) << 1);
+      if (op & (1u << 11)) m_r[uRt] = m_bus.read16(ulAddr);
+      else m_bus.write16(ulAddr, (uint16_t)m_r[uRt]);
+      m_cycles += CYC_MEM;
+      return;
+    }
+
+    case 0x9u:
+    {
+      // Load/store SP-relative
+      unsigned uRt = (op >> 8) & 7u;
+      uint32_t ulAddr = m_r[13] + ((op & 0xFFu) << 2);
+      if (op & (1u << 11)) m_r[uRt] = m_bus.read32(ulAddr);
+      else m_bus.write32(ulAddr, m_r[uRt]);
+      m_cycles += CYC_MEM;
+      return;
+    }
+
+    case 0xAu:
+      // ADR / ADD (SP plus immediate)
+      m_r[(op >> 8) & 7u] = ((op & (1u << 11)) ? m_r[13] : ((m_pc + 4u) & ~3u)) + ((op & 0xFFu) << 2);
+      return;
+
+    case 0xBu:
+      exec16Misc(op);
+      return;
+
+    case 0xCu:
+    {
+      // STM / LDM
+      unsigned uRn = (op >> 8) & 7u;
+      uint32_t ulAddr = m_r[uRn];
+      unsigned uRegs = op & 0xFFu;
+      bool bLoad = (op & (1u << 11)) != 0u;
+      for (unsigned i = 0u; i < 8u; ++i)
+      {
+        if (!(uRegs & (1u << i))) continue;
+        if (bLoad) m_r[i] = m_bus.read32(ulAddr);
+        else m_bus.write32(ulAddr, m_r[i]);
+        ulAddr += 4u;
+        m_cycles += CYC_MEM;
+      }
+      if (!bLoad || !(uRegs & (1u << uRn))) m_r[uRn] = ulAddr;
+      return;
+    }
+
+    case 0xDu:
+    {
+      unsigned uCond = (op >> 8) & 0xFu;
+      if (uCond == 0xEu) throw Undefined{};
+      if (uCond == 0xFu)
+      {
+        // SVC: taken before the next instruction
+        setPending(EXC_SVCALL);
+        return;
+      }
+      if (condPassed(uCond))
+      {
+        branchTo(m_pc + 4u + sext((op & 0xFFu) << 1, 9u));
+        m_cycles += CYC_BRANCH;
+      }
+      return;
+    }
+
+    case 0xEu:
+    {
+      // B (unconditional); branch-to-self stops the simulation
+      uint32_t ulTarget = m_pc + 4u + sext((op & 0x7FFu) << 1, 12u);
+      if (ulTarget == m_pc) stopOnLoop();
+      branchTo(ulTarget);
+      m_cycles += CYC_BRANCH;
+      return;
+    }
+
+    default:
+      throw Undefined{};
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Execute 16-bit miscellaneous instruction (encoding group 1011xxxx)
+ *
+ * @param[in] op  Instruction
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::exec16Misc(uint16_t op)
+{
+  if ((op & 0xFF00u) == 0xB000u)
+  {
+    // ADD/SUB SP, SP, #imm7
+    uint32_t ulImm = (op & 0x7Fu) << 2;
+    m_r[13] = (op & 0x80u) ? m_r[13] - ulImm : m_r[13] + ulImm;
+    return;
+  }
+  if ((op & 0xF500u) == 0xB100u)
+  {
+    // CBZ / CBNZ
+    uint32_t ulOffset = (((op >> 9) & 1u) << 6) | (((op >> 3) & 0x1Fu) << 1);
+    bool bZero = (m_r[op & 7u] == 0u);
+    if (bZero != ((op & 0x800u) != 0u))
+    {
+      branchTo(m_pc + 4u + ulOffset);
+      m_cycles += CYC_BRANCH;
+    }
+    return;
+  }
+  if ((op & 0xFF00u) == 0xB200u)
+  {
+    // SXTH / SXTB / UXTH / UXTB
+    uint32_t ulVal = m_r[(op >> 3) & 7u];
+    switch ((op >> 6) & 3u)
+    {
+      case 0u: ulVal = sext(ulVal, 16u); break;
+      case 1u: ulVal = sext(ulVal, 8u); break;
+      case 2u: ulVal &= 0xFFFFu; break;
+      default: ulVal &= 0xFFu; break;
+    }
+    m_r[op & 7u] = ulVal;
+    return;
+  }
+  if ((op & 0xFE00u) == 0xB400u)
+  {
+    // PUSH
+    unsigned uRegs = (op & 0xFFu) | ((op & 0x100u) ? (1u << 14) : 0u);
+    storeMultipleDb(13u, uRegs, true);
+    return;
+  }
+  if ((op & 0xFFE8u) == 0xB660u)
+  {
+    // CPS
+    bool bDisable = (op & 0x10u) != 0u;
+    if (op & 2u) m_primask = bDisable;
+    if (op & 1u) m_faultmask = bDisable;
+    m_excCheck = true;
+    return;
+  }
+  if ((op & 0xFF00u) == 0xBA00u)
+  {
+    // REV / REV16 / REVSH
+    uint32_t ulVal = m_r[(op >> 3) & 7u];
+    switch ((op >> 6) & 3u)
+    {
+      case 0u: ulVal = __builtin_bswap32(ulVal); break;
+      case 1u: ulVal = ((ulVal & 0x00FF00FFu) << 8) | ((ulVal >> 8) & 0x00FF00FFu); break;
+      case 3u: ulVal = sext(((ulVal & 0xFFu) << 8) | ((ulVal >> 8) & 0xFFu), 16u); break;
+      default: throw Undefined{};
+    }
+    m_r[op & 7u] = ulVal;
+    return;
+  }
+  if ((op & 0xFE00u) == 0xBC00u)
+  {
+    // POP
+    unsigned uRegs = (op & 0xFFu) | ((op & 0x100u) ? (1u << 15) : 0u);
+    loadMultipleIa(13u, uRegs, true);
+    return;
+  }
+  if ((op & 0xFF00u) == 0xBE00u)
+  {
+    // BKPT: semihosting or debug halt
+    if (((op & 0xFFu) == BKPT_SEMIHOSTING) && m_semihost)
+    {
+      m_semihost(*this);
+      return;
+    }
+    m_stop = true;
+    m_stopReason = StopReason::Breakpoint;
+    m_nextPc = m_pc;
+    return;
+  }
+  if ((op & 0xFF00u) == 0xBF00u)
+  {
+    if (op & 0xFu)
+    {
+      // IT
+      m_itState = (uint8_t)(op & 0xFFu);
+      return;
+    }
+    // Hints: NOP, YIELD, WFE, WFI, SEV
+    if (((op >> 4) & 0xFu) == 3u) enterSleep();
+    return;
+  }
+  throw Undefined{};
+}
+
+/*!****************************************************************************
+ * @brief
+ * Enter sleep mode (WFI) unless an exception is already pending
+ ******************************************************************************/
+void Cpu::enterSleep()
+{
+  if (pendingHighest() == 0u)
+  {
+    m_sleeping = true;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Stop on branch-to-self
+ *
+ * The idle loop after main() and the fault handlers of this project are plain
+ * "b ." instructions. In thread mode this ends the simulation normally; in a
+ * handler it indicates a fault or an unhandled interrupt.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::stopOnLoop()
+{
+  if (!m_haltOnLoop) return;
+  m_stop = true;
+  m_stopReason = (m_ipsr == 0u) ? StopReason::Halt : StopReason::Fault;
+  if (m_ipsr != 0u)
+  {
+    char acBuf[64];
+    std::snprintf(acBuf, sizeof(acBuf), "loop in exception handler %u at pc=0x%08x", m_ipsr, m_pc);
+    m_faultInfo = m_faultInfo.empty() ? std::string(acBuf) : m_faultInfo + ", " + acBuf;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Store multiple, decrement before (STMDB / PUSH)
+ ******************************************************************************/
+void Cpu::storeMultipleDb(unsigned rn, unsigned regs, bool writeback)
+{
+  uint32_t ulAddr = m_r[rn] - 4u * (unsigned)__builtin_popcount(regs);
+  uint32_t ulStart = ulAddr;
+  for (unsigned i = 0u; i < 15u; ++i)
+  {
+    if (!(regs & (1u << i))) continue;
+    m_bus.write32(ulAddr, m_r[i]);
+    ulAddr += 4u;
+    m_cycles += CYC_MEM;
+  }
+  if (writeback) m_r[rn] = ulStart;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Store multiple, increment after (STMIA)
+ ******************************************************************************/
+void Cpu::storeMultipleIa(unsigned rn, unsigned regs, bool writeback)
+{
+  uint32_t ulAddr = m_r[rn];
+  for (unsigned i = 0u; i < 15u; ++i)
+  {
+    if (!(regs & (1u << i))) continue;
+    m_bus.write32(ulAddr, m_r[i]);
+    ulAddr += 4u;
+    m_cycles += CYC_MEM;
+  }
+  if (writeback) m_r[rn] = ulAddr;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Load multiple, increment after (LDMIA / POP); loading the PC interworks
+ ******************************************************************************/
+void Cpu::loadMultipleIa(unsigned rn, unsigned regs, bool writeback)
+{
+  uint32_t ulAddr = m_r[rn];
+  uint32_t ulPc = 0u;
+  for (unsigned i = 0u; i < 16u; ++i)
+  {
+    if (!(regs & (1u << i))) continue;
+    uint32_t ulVal = m_bus.read32(ulAddr);
+    if (i == 15u) ulPc = ulVal; else m_r[i] = ulVal;
+    ulAddr += 4u;
+    m_cycles += CYC_MEM;
+  }
+  if (writeback && !(regs & (1u << rn))) m_r[rn] = ulAddr;
+  if (regs & (1u << 15)) bxWritePc(ulPc);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Load multiple, decrement before (LDMDB); loading the PC interworks
+ ******************************************************************************/
+void Cpu::loadMultipleDb(unsigned rn, unsigned regs, bool writeback)
+{
+  uint32_t ulStart = m_r[rn] - 4u * (unsigned)__builtin_popcount(regs);
+  uint32_t ulAddr = ulStart;
+  uint32_t ulPc = 0u;
+  for (unsigned i = 0u; i < 16u; ++i)
+  {
+    if (!(regs & (1u << i))) continue;
+    uint32_t ulVal = m_bus.read32(ulAddr);
+    if (i == 15u) ulPc = ulVal; else m_r[i] = ulVal;
+    ulAddr += 4u;
+    m_cycles += CYC_MEM;
+  }
+  if (writeback && !(regs & (1u << rn))) m_r[rn] = ulStart;
+  if (regs & (1u << 15)) bxWritePc(ulPc);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Execute 32-bit Thumb-2 instruction
+ *
+ * @param[in] op  Instruction (first halfword in bits 31:16)
+ * @date  17.10.2026
+ ******************************************************************************/
+void Cpu::step32(uint32_t op)
+{
+  uint32_t ulHw1 = op >> 16;
+  switch ((ulHw1 >> 11) & 3u)
+  {
+    case 1u:
+      if ((ulHw1 & 0x0640u) == 0x0000u) { exec32LoadStoreMultiple(op); return; }
+      if ((ulHw1 & 0x0640u) == 0x0040u) { exec32LoadStoreDual(op); return; }
+      if ((ulHw1 & 0x0600u) == 0x0200u) { exec32DataProcShifted(op); return; }
+      throw Undefined{};
+
+    case 2u:
+      if (op & 0x8000u) { exec32BranchMisc(op); return; }
+      if (ulHw1 & 0x0200u) { exec32PlainImm(op); return; }
+      exec32DataProcImm(op);
+      return;
+
+    case 3u:
+      if ((ulHw1 & 0x0710u) == 0x0000u) { exec32StoreSingle(op); return; }
+      if ((ulHw1 & 0x0610u) == 0x0010u) { exec32LoadSingle(op); return; }
+      if ((ulHw1 & 0x0700u) == 0x0200u) { exec32DataProcReg(op); return; }
+      if ((ulHw1 & 0x0780u) == 0x0300u) { exec32Multiply(op); return; }
+      if ((ulHw1 & 0x0780u) == 0x0380u) { exec32LongMultiply(op); return; }
+      throw Undefined{};
+
+    default:
+      throw Undefined{};
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: load/store multiple (LDM/STM IA/DB, PUSH.W, POP.W)
+ ******************************************************************************/
+void Cpu::exec32LoadStoreMultiple(uint32_t op)
+{
+  unsigned uRn = (op >> 16) & 0xFu;
+  unsigned uRegs = op & 0xFFFFu;
+  bool bWb = (op >> 21) & 1u;
+  bool bLoad = (op >> 20) & 1u;
+  switch ((op >> 23) & 3u)
+  {
+    case 1u:
+      if (bLoad) loadMultipleIa(uRn, uRegs, bWb); else storeMultipleIa(uRn, uRegs, bWb);
+      return;
+    case 2u:
+      if (bLoad) loadMultipleDb(uRn, uRegs, bWb); else storeMultipleDb(uRn, uRegs, bWb);
+      return;
+    default:
+      throw Undefined{};
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: load/store dual, exclusive, table branch
+ ******************************************************************************/
+void Cpu::exec32LoadStoreDual(uint32_t op)
+{
+  unsigned uOp1 = (op >> 23) & 3u, uOp2 = (op >> 20) & 3u, uOp3 = (op >> 4) & 0xFu;
+  unsigned uRn = (op >> 16) & 0xFu, uRt = (op >> 12) & 0xFu, uRd = (op >> 8) & 0xFu;
+  // PC base: word aligned for LDRD (literal), unaligned for TBB/TBH
+  uint32_t ulBase = (uRn == 15u) ? ((m_pc + 4u) & ~3u) : m_r[uRn];
+  uint32_t ulTable = (uRn == 15u) ? (m_pc + 4u) : m_r[uRn];
+
+  if ((uOp1 == 0u) && (uOp2 == 0u))
+  {
+    // STREX
+    uint32_t ulAddr = ulBase + ((op & 0xFFu) << 2);
+    if (m_exclusive) m_bus.write32(ulAddr, m_r[uRt]);
+    m_r[uRd] = m_exclusive ? 0u : 1u;
+    m_exclusive = false;
+    m_cycles += CYC_MEM;
+    return;
+  }
+  if ((uOp1 == 0u) && (uOp2 == 1u))
+  {
+    // LDREX
+    m_r[uRt] = m_bus.read32(ulBase + ((op & 0xFFu) << 2));
+    m_exclusive = true;
+    m_cycles += CYC_MEM;
+    return;
+  }
+  if ((uOp1 == 1u) && (uOp2 == 0u))
+  {
+    // STREXB / STREXH
+    unsigned uRs = op & 0xFu;
+    if (m_exclusive)
+    {
+      if (uOp3 == 4u) m_bus.write8(ulBase, (uint8_t)m_r[uRt]);
+      else if (uOp3 == 5u) m_bus.write16(ulBase, (uint16_t)m_r[uRt]);
+      else throw Undefined{};
+    }
+    m_r[uRs] = m_exclusive ? 0u : 1u;
+    m_exclusive = false;
+    m_cycles += CYC_MEM;
+    return;
+  }
+  if ((uOp1 == 1u) && (uOp2 == 1u))
+  {
+    unsigned uRm = op & 0xFu;
+    switch (uOp3)
+    {
+      case 0u:
+        // TBB
+        branchTo(m_pc + 4u + 2u * m_bus.read8(ulTable + m_r[uRm]));
+        m_cycles += CYC_MEM + CYC_BRANCH;
+        return;
+      case 1u:
+        // TBH
+        branchTo(m_pc + 4u + 2u * m_bus.read16(ulTable + 2u * m_r[uRm]));
+        m_cycles += CYC_MEM + CYC_BRANCH;
+        return;
+      case 4u:
+        m_r[uRt] = m_bus.read8(ulBase);
+        m_exclusive = true;
+        return;
+      case 5u:
+        m_r[uRt] = m_bus.read16(ulBase);
+        m_exclusive = true;
+        return;
+      default:
+        throw Undefined{};
+    }
+  }
+
+  // LDRD / STRD (immediate)
+  bool bP = (op >> 24) & 1u, bU = (op >> 23) & 1u, bW = (op >> 21) & 1u;
+  uint32_t ulOffset = (op & 0xFFu) << 2;
+  uint32_t ulOffAddr = bU ? ulBase + ulOffset : ulBase - ulOffset;
+  uint32_t ulAddr = bP ? ulOffAddr : ulBase;
+  if (uOp2 & 1u)
+  {
+    m_r[uRt] = m_bus.read32(ulAddr);
+    m_r[uRd] = m_bus.read32(ulAddr + 4u);
+  }
+  else
+  {
+    m_bus.write32(ulAddr, m_r[uRt]);
+    m_bus.write32(ulAddr + 4u, m_r[uRd]);
+  }
+  if (bW) m_r[uRn] = ulOffAddr;
+  m_cycles += 2u * CYC_MEM;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Data processing operation shared by the 32-bit encodings
+ *
+ * @param[in] opc       Operation (bits 24:21 of the T32 encoding)
+ * @param[in] a         First operand (Rn)
+ * @param[in] b         Second operand (shifted register or immediate)
+ * @param[in] carry     Shifter carry out
+ * @param[in] setFlags  Update APSR
+ * @param[in] rd        Destination register
+ * @param[out] write    Result is to be written to rd
+ * @return  (uint32_t)  Result
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Cpu::dataProc(unsigned opc, uint32_t a, uint32_t b, bool carry, bool setFlags, unsigned rd, bool& write)
+{
+  uint32_t ulResult;
+  bool c = carry, v = m_v, bArith = false;
+  write = true;
+  switch (opc)
+  {
+    case 0x0u: ulResult = a & b; write = !((rd == 15u) && setFlags); break;
+    case 0x1u: ulResult = a & ~b; break;
+    case 0x2u: ulResult = a | b; break;
+    case 0x3u: ulResult = a | ~b; break;
+    case 0x4u: ulResult = a ^ b; write = !((rd == 15u) && setFlags); break;
+    case 0x8u: ulResult = addWithCarry(a, b, false, c, v); bArith = true; write = !((rd == 15u) && setFlags); break;
+    case 0xAu: ulResult = addWithCarry(a, b, m_c, c, v); bArith = true; break;
+    case 0xBu: ulResult = addWithCarry(a, ~b, m_c, c, v); bArith = true; break;
+    case 0xDu: ulResult = addWithCarry(a, ~b, true, c, v); bArith = true; write = !((rd == 15u) && setFlags); break;
+    case 0xEu: ulResult = addWithCarry(~a, b, true, c, v); bArith = true; break;
+    default: throw Undefined{};
+  }
+  if (setFlags)
+  {
+    setNZ(ulResult);
+    m_c = c;
+    if (bArith) m_v = v;
+  }
+  return ulResult;
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: data processing (shifted register)
+ ******************************************************************************/
+void Cpu::exec32DataProcShifted(uint32_t op)
+{
+  unsigned uOpc = (op >> 21) & 0xFu;
+  bool bS = (op >> 20) & 1u;
+  unsigned uRn = (op >> 16) & 0xFu, uRd = (op >> 8) & 0xFu, uRm = op & 0xFu;
+  unsigned uAmount = (((op >> 12) & 7u) << 2) | ((op >> 6) & 3u);
+  unsigned uType = decodeImmShift((op >> 4) & 3u, uAmount);
+
+  bool c = m_c;
+  uint32_t b = shiftC(m_r[uRm], uType, uAmount, c);
+
+  // MOV/shifts and MVN are ORR/ORN with Rn = PC
+  uint32_t a = (uRn == 15u) ? 0u : m_r[uRn];
+  bool bWrite;
+  uint32_t ulResult = dataProc(uOpc, a, b, c, bS, uRd, bWrite);
+  if (bWrite) writeReg(uRd, ulResult, false);
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: data processing (modified immediate)
+ ******************************************************************************/
+void Cpu::exec32DataProcImm(uint32_t op)
+{
+  unsigned uOpc = (op >> 21) & 0xFu;
+  bool bS = (op >> 20) & 1u;
+  unsigned uRn = (op >> 16) & 0xFu, uRd = (op >> 8) & 0xFu;
+  uint32_t ulImm12 = (((op >> 26) & 1u) << 11) | (((op >> 12) & 7u) << 8) | (op & 0xFFu);
+
+  bool c = m_c;
+  uint32_t b = thumbExpandImm(ulImm12, c);
+  uint32_t a = (uRn == 15u) ? 0u : m_r[uRn];
+  bool bWrite;
+  uint32_t ulResult = dataProc(uOpc, a, b, c, bS, uRd, bWrite);
+  if (bWrite) writeReg(uRd, ulResult, false);
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: data processing (plain binary immediate)
+ ******************************************************************************/
+void Cpu::exec32PlainImm(uint32_t op)
+{
+  unsigned uOp = (op >> 20) & 0x1Fu;
+  unsigned uRn = (op >> 16) & 0xFu, uRd = (op >> 8) & 0xFu;
+  uint32_t ulImm12 = (((op >> 26) & 1u) << 11) | (((op >> 12) & 7u) << 8) | (op & 0xFFu);
+  unsigned uLsb = (((op >> 12) & 7u) << 2) | ((op >> 6) & 3u);
+  unsigned uField = op & 0x1Fu;
+
+  switch (uOp)
+  {
+    case 0x00u:
+      // ADDW / ADR
+      m_r[uRd] = ((uRn == 15u) ? ((m_pc + 4u) & ~3u) : m_r[uRn]) + ulImm12;
+      return;
+    case 0x04u:
+      // MOVW
+      m_r[uRd] = (((op >> 16) & 0xFu) << 12) | ulImm12;
+      return;
+    case 0x0Au:
+      // SUBW / ADR
+      m_r[uRd] = ((uRn == 15u) ? ((m_pc + 4u) & ~3u) : m_r[uRn]) - ulImm12;
+      return;
+    case 0x0Cu:
+      // MOVT
+      m_r[uRd] = (m_r[uRd] & 0xFFFFu) | (((((op >> 16) & 0xFu) << 12) | ulImm12) << 16);
+      return;
+    case 0x10u:
+    case 0x18u:
+    {
+      // SSAT / USAT
+      bool c = m_c;
+      int64_t llVal = (int32_t)shiftC(m_r[uRn], (op & (1u << 21)) ? 2u : 0u, uLsb, c);
+      bool bSigned = (uOp == 0x10u);
+      unsigned uBits = bSigned ? uField + 1u : uField;
+      int64_t llMax = bSigned ? ((1LL << (uBits - 1u)) - 1) : ((1LL << uBits) - 1);
+      int64_t llMin = bSigned ? -(1LL << (uBits - 1u)) : 0;
+      if (llVal > llMax) { llVal = llMax; m_q = true; }
+      if (llVal < llMin) { llVal = llMin; m_q = true; }
+      m_r[uRd] = (uint32_t)llVal;
+      return;
+    }
+    case 0x14u:
+      // SBFX
+      m_r[uRd] = sext(m_r[uRn] >> uLsb, uField + 1u);
+      return;
+    case 0x16u:
+    {
+      // BFI / BFC
+      if (uField < uLsb) throw Undefined{};
+      unsigned uWidth = uField - uLsb + 1u;
+      uint32_t ulMask = ((uWidth == 32u) ? 0xFFFFFFFFu : ((1u << uWidth) - 1u)) << uLsb;
+      uint32_t ulSrc = (uRn == 15u) ? 0u : (m_r[uRn] << uLsb);
+      m_r[uRd] = (m_r[uRd] & ~ulMask) | (ulSrc & ulMask);
+      return;
+    }
+    case 0x1Cu:
+    {
+      // UBFX
+      unsigned uWidth = uField + 1u;
+      m_r[uRd] = (m_r[uRn] >> uLsb) & ((uWidth == 32u) ? 0xFFFFFFFFu : ((1u << uWidth) - 1u));
+      return;
+    }
+    default:
+      throw Undefined{};
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: branches and miscellaneous control
+ ******************************************************************************/
+void Cpu::exec32BranchMisc(uint32_t op)
+{
+  unsigned uOp1 = (op >> 12) & 7u;
+  unsigned uOp = (op >> 20) & 0x7Fu;
+  uint32_t ulS = (op >> 26) & 1u, ulJ1 = (op >> 13) & 1u, ulJ2 = (op >> 11) & 1u;
+
+  if (uOp1 & 1u)
+  {
+    // B (T4) / BL
+    uint32_t ulI1 = !(ulJ1 ^ ulS), ulI2 = !(ulJ2 ^ ulS);
+    uint32_t ulOffset = (ulS << 24) | (ulI1 << 23) | (ulI2 << 22) | (((op >> 16) & 0x3FFu) << 12) | ((op & 0x7FFu) << 1);
+    uint32_t ulTarget = m_pc + 4u + sext(ulOffset, 25u);
+    if (uOp1 & 4u)
+    {
+      m_r[14] = m_nextPc | 1u;
+    }
+    else if (ulTarget == m_pc)
+    {
+      stopOnLoop();
+    }
+    branchTo(ulTarget);
+    m_cycles += CYC_BRANCH;
+    return;
+  }
+
+  if (uOp1 == 0u)
+  {
+    if ((uOp & 0x38u) != 0x38u)
+    {
+      // B<cond> (T3)
+      uint32_t ulOffset = (ulS << 20) | (ulJ2 << 19) | (ulJ1 << 18) | (((op >> 16) & 0x3Fu) << 12) | ((op & 0x7FFu) << 1);
+      if (condPassed((op >> 22) & 0xFu))
+      {
+        branchTo(m_pc + 4u + sext(ulOffset, 21u));
+        m_cycles += CYC_BRANCH;
+      }
+      return;
+    }
+    if ((uOp & 0x7Eu) == 0x38u)
+    {
+      msr((op >> 16) & 0xFu, op & 0xFFu, (op >> 10) & 3u);
+      return;
+    }
+    if (uOp == 0x3Au)
+    {
+      // Hints: NOP, YIELD, WFE, WFI, SEV
+      if ((op & 0xFFu) == 3u) enterSleep();
+      return;
+    }
+    if (uOp == 0x3Bu)
+    {
+      // CLREX, DSB, DMB, ISB
+      if (((op >> 4) & 0xFu) == 2u) m_exclusive = false;
+      return;
+    }
+    if ((uOp & 0x7Eu) == 0x3Eu)
+    {
+      m_r[(op >> 8) & 0xFu] = mrs(op & 0xFFu);
+      return;
+    }
+  }
+  throw Undefined{};
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read special register (MRS)
+ ******************************************************************************/
+uint32_t Cpu::mrs(unsigned sysm)
+{
+  switch (sysm)
+  {
+    case 8u: return ((m_ipsr == 0u) && (m_control & 2u)) ? m_msp : m_r[13];
+    case 9u: return ((m_ipsr == 0u) && (m_control & 2u)) ? m_r[13] : m_psp;
+    case 16u: return m_primask;
+    case 17u:
+    case 18u: return m_basepri;
+    case 19u: return m_faultmask;
+    case 20u: return m_control;
+    default:
+      if (sysm > 7u) throw Undefined{};
+      return ((sysm & 4u) ? 0u : (xpsr() & 0xF8000000u)) | ((sysm & 1u) ? m_ipsr : 0u);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write special register (MSR)
+ ******************************************************************************/
+void Cpu::msr(unsigned rn, unsigned sysm, unsigned mask)
+{
+  uint32_t ulVal = m_r[rn];
+  bool bPspActive = (m_ipsr == 0u) && (m_control & 2u);
+  switch (sysm)
+  {
+    case 8u: if (bPspActive) m_msp = ulVal & ~3u; else m_r[13] = ulVal & ~3u; break;
+    case 9u: if (bPspActive) m_r[13] = ulVal & ~3u; else m_psp = ulVal & ~3u; break;
+    case 16u: m_primask = ulVal & 1u; break;
+    case 17u: m_basepri = (uint8_t)(ulVal & (0xFFu << (8u - PRIO_BITS))); break;
+    case 18u:
+    {
+      uint8_t ucVal = (uint8_t)(ulVal & (0xFFu << (8u - PRIO_BITS)));
+      if ((ucVal != 0u) && ((m_basepri == 0u) || (ucVal < m_basepri))) m_basepri = ucVal;
+      break;
+    }
+    case 19u: if (m_ipsr != EXC_NMI) m_faultmask = ulVal & 1u; break;
+    case 20u:
+      if ((m_ipsr == 0u) && ((ulVal ^ m_control) & 2u))
+      {
+        // Switch active stack pointer in thread mode
+        if (ulVal & 2u) { m_msp = m_r[13]; m_r[13] = m_psp; }
+        else { m_psp = m_r[13]; m_r[13] = m_msp; }
+      }
+      m_control = ulVal & 3u;
+      break;
+    default:
+      if (sysm > 7u) throw Undefined{};
+      if ((sysm & 4u) == 0u && (mask & 2u))
+      {
+        m_n = (ulVal >> 31) & 1u; m_z = (ulVal >> 30) & 1u; m_c = (ulVal >> 29) & 1u;
+        m_v = (ulVal >> 28) & 1u; m_q = (ulVal >> 27) & 1u;
+      }
+      break;
+  }
+  m_excCheck = true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Compute address for 32-bit single load/store encodings
+ *
+ * Handles the imm12, imm8 (pre/post-indexed, negative, unprivileged) and reg-
+ * ister offset forms; performs the base register writeback.
+ *
+ * @param[in] op  Instruction
+ * @return  (uint32_t)  Effective address
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Cpu::address32(uint32_t op)
+{
+  unsigned uRn = (op >> 16) & 0xFu;
+
+  if (uRn == 15u)
+  {
+    // Literal
+    uint32_t ulBase = (m_pc + 4u) & ~3u;
+    return (op & (1u << 23)) ? ulBase + (op & 0xFFFu) : ulBase - (op & 0xFFFu);
+  }
+  if (op & (1u << 23))
+  {
+    return m_r[uRn] + (op & 0xFFFu);
+  }
+  if (op & (1u << 11))
+  {
+    bool bP = (op >> 10) & 1u, bU = (op >> 9) & 1u, bW = (op >> 8) & 1u;
+    uint32_t ulOffAddr = bU ? m_r[uRn] + (op & 0xFFu) : m_r[uRn] - (op & 0xFFu);
+    uint32_t ulAddr = bP ? ulOffAddr : m_r[uRn];
+    if (bW) m_r[uRn] = ulOffAddr;
+    return ulAddr;
+  }
+  if (((op >> 6) & 0x3Fu) == 0u)
+  {
+    return m_r[uRn] + (m_r[op & 0xFu] << ((op >> 4) & 3u));
+  }
+  throw Undefined{};
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: store single data item (STR, STRH, STRB)
+ ******************************************************************************/
+void Cpu::exec32StoreSingle(uint32_t op)
+{
+  unsigned uRt = (op >> 12) & 0xFu;
+  uint32_t ulVal = m_r[uRt];
+  if (((op >> 16) & 0xFu) == 15u) throw Undefined{};
+  uint32_t ulAddr = address32(op);
+  switch ((op >> 21) & 3u)
+  {
+    case 0u: m_bus.write8(ulAddr, (uint8_t)ulVal); break;
+    case 1u: m_bus.write16(ulAddr, (uint16_t)ulVal); break;
+    case 2u: m_bus.write32(ulAddr, ulVal); break;
+    default: throw Undefined{};
+  }
+  m_cycles += CYC_MEM;
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: load byte, halfword or word (LDR, LDRH, LDRSH, LDRB, LDRSB, PLD)
+ ******************************************************************************/
+void Cpu::exec32LoadSingle(uint32_t op)
+{
+  unsigned uRt = (op >> 12) & 0xFu;
+  unsigned uSize = (op >> 21) & 3u;
+  bool bSigned = (op >> 24) & 1u;
+  uint32_t ulAddr = address32(op);
+
+  // PLD/PLI: preload hints
+  if ((uRt == 15u) && (uSize != 2u)) return;
+
+  uint32_t ulVal;
+  switch (uSize)
+  {
+    case 0u: ulVal = m_bus.read8(ulAddr); if (bSigned) ulVal = sext(ulVal, 8u); break;
+    case 1u: ulVal = m_bus.read16(ulAddr); if (bSigned) ulVal = sext(ulVal, 16u); break;
+    case 2u: if (bSigned) throw Undefined{}; ulVal = m_bus.read32(ulAddr); break;
+    default: throw Undefined{};
+  }
+  m_cycles += CYC_MEM;
+  writeReg(uRt, ulVal, true);
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: data processing (register): shifts, extends, REV, RBIT, CLZ
+ ******************************************************************************/
+void Cpu::exec32DataProcReg(uint32_t op)
+{
+  unsigned uOp1 = (op >> 20) & 0xFu, uOp2 = (op >> 4) & 0xFu;
+  unsigned uRn = (op >> 16) & 0xFu, uRd = (op >> 8) & 0xFu, uRm = op & 0xFu;
+
+  if ((uOp1 & 8u) == 0u && uOp2 == 0u)
+  {
+    // LSL/LSR/ASR/ROR (register)
+    bool c = m_c;
+    uint32_t ulResult = shiftC(m_r[uRn], (uOp1 >> 1) & 3u, m_r[uRm] & 0xFFu, c);
+    m_r[uRd] = ulResult;
+    if (uOp1 & 1u) { setNZ(ulResult); m_c = c; }
+    return;
+  }
+  if ((uOp1 & 8u) == 0u && (uOp2 & 8u) && (uRn == 15u))
+  {
+    // SXTH/UXTH/SXTB/UXTB with rotation
+    uint32_t ulVal = ror(m_r[uRm], 8u * ((op >> 4) & 3u));
+    switch (uOp1)
+    {
+      case 0u: m_r[uRd] = sext(ulVal, 16u); return;
+      case 1u: m_r[uRd] = ulVal & 0xFFFFu; return;
+      case 4u: m_r[uRd] = sext(ulVal, 8u); return;
+      case 5u: m_r[uRd] = ulVal & 0xFFu; return;
+      default: throw Undefined{};
+    }
+  }
+  if ((uOp1 & 0xCu) == 8u && (uOp2 & 0xCu) == 8u)
+  {
+    uint32_t ulVal = m_r[uRm];
+    switch (((uOp1 & 3u) << 2) | (uOp2 & 3u))
+    {
+      case 0x4u: m_r[uRd] = __builtin_bswap32(ulVal); return;
+      case 0x5u: m_r[uRd] = ((ulVal & 0x00FF00FFu) << 8) | ((ulVal >> 8) & 0x00FF00FFu); return;
+      case 0x6u:
+      {
+        uint32_t ulResult = 0u;
+        for (unsigned i = 0u; i < 32u; ++i) ulResult |= ((ulVal >> i) & 1u) << (31u - i);
+        m_r[uRd] = ulResult;
+        return;
+      }
+      case 0x7u: m_r[uRd] = sext(((ulVal & 0xFFu) << 8) | ((ulVal >> 8) & 0xFFu), 16u); return;
+      case 0xCu: m_r[uRd] = ulVal ? (uint32_t)__builtin_clz(ulVal) : 32u; return;
+      default: throw Undefined{};
+    }
+  }
+  throw Undefined{};
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: multiply and multiply-accumulate (MUL, MLA, MLS)
+ ******************************************************************************/
+void Cpu::exec32Multiply(uint32_t op)
+{
+  unsigned uRn = (op >> 16) & 0xFu, uRa = (op >> 12) & 0xFu, uRd = (op >> 8) & 0xFu, uRm = op & 0xFu;
+  if (((op >> 20) & 7u) != 0u) throw Undefined{};
+  uint32_t ulProduct = m_r[uRn] * m_r[uRm];
+  switch ((op >> 4) & 3u)
+  {
+    case 0u: m_r[uRd] = (uRa == 15u) ? ulProduct : m_r[uRa] + ulProduct; return;
+    case 1u: m_r[uRd] = m_r[uRa] - ulProduct; return;
+    default: throw Undefined{};
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * 32-bit: long multiply and divide (SMULL, UMULL, SMLAL, UMLAL, SDIV, UDIV)
+ ******************************************************************************/
+void Cpu::exec32LongMultiply(uint32_t op)
+{
+  unsigned uRn = (op >> 16) & 0xFu, uRdLo = (op >> 12) & 0xFu, uRdHi = (op >> 8) & 0xFu, uRm = op & 0xFu;
+  uint64_t ullResult;
+  switch ((((op >> 20) & 7u) << 4) | ((op >> 4) & 0xFu))
+  {
+    case 0x00u: ullResult = (uint64_t)((int64_t)(int32_t)m_r[uRn] * (int32_t)m_r[uRm]); break;
+    case 0x20u: ullResult = (uint64_t)m_r[uRn] * m_r[uRm]; break;
+    case 0x40u:
+      ullResult = (uint64_t)((int64_t)(int32_t)m_r[uRn] * (int32_t)m_r[uRm]) +
+                  (((uint64_t)m_r[uRdHi] << 32) | m_r[uRdLo]);
+      break;
+    case 0x60u:
+      ullResult = (uint64_t)m_r[uRn] * m_r[uRm] + (((uint64_t)m_r[uRdHi] << 32) | m_r[uRdLo]);
+      break;
+    case 0x1Fu:
+    {
+      // SDIV (divide by zero yields 0, DIV_0_TRP clear)
+      int32_t lN = (int32_t)m_r[uRn], lM = (int32_t)m_r[uRm];
+      uint32_t ulQ = (lM == 0) ? 0u : ((lN == INT32_MIN) && (lM == -1)) ? (uint32_t)INT32_MIN : (uint32_t)(lN / lM);
+      m_r[uRdHi] = ulQ;
+      m_cycles += CYC_DIV;
+      return;
+    }
+    case 0x3Fu:
+      // UDIV
+      m_r[uRdHi] = (m_r[uRm] == 0u) ? 0u : m_r[uRn] / m_r[uRm];
+      m_cycles += CYC_DIV;
+      return;
+    default:
+      throw Undefined{};
+  }
+  m_r[uRdLo] = (uint32_t)ullResult;
+  m_r[uRdHi] = (uint32_t)(ullResult >> 32);
+  m_cycles += 2u;
+}
+
+} // namespace armsim
@@ -0,0 +1,223 @@
+/*!****************************************************************************
+ * @file
+ * cpu.h
+ *
+ * @brief
+ * ARMv7-M (Cortex-M3) core: Thumb/Thumb-2 interpreter and exception model
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef ARMSIM_CPU_H_
+#define ARMSIM_CPU_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "bus.h"
+
+
+namespace armsim {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Device with time-dependent behaviour, advanced by the core
+class Timed
+{
+public:
+  virtual ~Timed() = default;
+
+  /// Bring device state up to date with the given cycle count
+  virtual void advance(uint64_t now) = 0;
+
+  /// Cycle count of the next event, or UINT64_MAX if none is scheduled
+  virtual uint64_t nextEvent() const = 0;
+};
+
+/// Reason for returning from Cpu::run
+enum class StopReason
+{
+  CycleLimit,                         ///< Cycle limit reached
+  Exit,                               ///< Application exit (semihosting)
+  Halt,                               ///< Branch-to-self in thread mode
+  Fault,                              ///< Branch-to-self in a fault handler
+  Lockup,                             ///< Fault during HardFault handler
+  Breakpoint,                         ///< BKPT other than semihosting
+};
+
+/// ARMv7-M core
+class Cpu
+{
+public:
+  /*! @brief Exception numbers
+   *  @{                                                                      */
+  static constexpr unsigned EXC_NMI        = 2u;
+  static constexpr unsigned EXC_HARDFAULT  = 3u;
+  static constexpr unsigned EXC_MEMMANAGE  = 4u;
+  static constexpr unsigned EXC_BUSFAULT   = 5u;
+  static constexpr unsigned EXC_USAGEFAULT = 6u;
+  static constexpr unsigned EXC_SVCALL     = 11u;
+  static constexpr unsigned EXC_PENDSV     = 14u;
+  static constexpr unsigned EXC_SYSTICK    = 15u;
+  static constexpr unsigned EXC_IRQ0       = 16u;
+  static constexpr unsigned NUM_EXC        = 16u + 68u;
+  /*! @}                                                                      */
+
+  /// Semihosting handler: called on "bkpt 0xAB"; r0/r1 hold operation and
+  /// argument, the handler stores results in r0 (and r1)
+  using BkptHandler = std::function<void(Cpu&)>;
+
+  explicit Cpu(Bus& bus);
+
+  /// Reset core; SP and PC are loaded from the vector table at address 0
+  void reset();
+
+  /// Execute until a stop condition occurs or the cycle count reaches limit
+  StopReason run(uint64_t limit);
+
+  /// Register a timed device
+  void addTimed(Timed* pTimed) { m_timed.push_back(pTimed); }
+
+  /// Request re-evaluation of timed device events (after register writes)
+  void reschedule() { m_nextEvent = 0u; }
+
+  /// Set semihosting handler
+  void setSemihostHandler(BkptHandler handler) { m_semihost = std::move(handler); }
+
+  /// Stop execution after the current instruction (e.g. SYS_EXIT)
+  void requestExit(int code) { m_exitCode = code; m_exitRequested = true; }
+
+  /// Stop execution after the current instruction with the given reason
+  void requestStop(StopReason reason, const char* pszInfo)
+  {
+    m_stop = true; m_stopReason = reason; m_faultInfo = pszInfo;
+  }
+
+  /// Advance time without executing (e.g. service time of a semihosting call)
+  void stall(uint64_t cycles) { m_cycles += cycles; }
+
+  /// Stop on branch-to-self ("b .") instead of executing it
+  void setHaltOnLoop(bool enable) { m_haltOnLoop = enable; }
+
+  /*! @brief Exception control (NVIC/SCB)
+   *  @{                                                                      */
+  void setPending(unsigned exc);
+  void clearPending(unsigned exc);
+  bool isPending(unsigned exc) const { return m_pending[exc]; }
+  bool isActive(unsigned exc) const { return m_active[exc]; }
+  void setEnabled(unsigned exc, bool enable);
+  bool isEnabled(unsigned exc) const { return m_enabled[exc]; }
+  void setPriority(unsigned exc, uint8_t prio);
+  uint8_t priority(unsigned exc) const { return m_prio[exc]; }
+  void setPriGroup(unsigned group) { m_priGroup = group & 7u; m_excCheck = true; }
+  unsigned priGroup() const { return m_priGroup; }
+  uint32_t ipsr() const { return m_ipsr; }
+  unsigned pendingHighest() const;
+  /*! @}                                                                      */
+
+  /*! @brief Register and state access
+   *  @{                                                                      */
+  uint32_t reg(unsigned n) const { return (n == 15u) ? m_pc : m_r[n]; }
+  void setReg(unsigned n, uint32_t value) { if (n == 15u) m_pc = value & ~1u; else m_r[n] = value; }
+  uint32_t pc() const { return m_pc; }
+  uint64_t cycles() const { return m_cycles; }
+  uint64_t instructions() const { return m_insns; }
+  int exitCode() const { return m_exitCode; }
+  uint32_t vtor() const { return m_vtor; }
+  void setVtor(uint32_t vtor) { m_vtor = vtor & 0xFFFFFF80u; }
+  Bus& bus() { return m_bus; }
+  /*! @}                                                                      */
+
+  /// Fault description of the last stop (empty if none)
+  const std::string& faultInfo() const { return m_faultInfo; }
+
+private:
+  struct Fault { unsigned exc; const char* pszWhat; };
+
+  void step();
+  void step16(uint16_t op);
+  void step32(uint32_t op);
+  void exec32LoadStoreMultiple(uint32_t op);
+  void exec32LoadStoreDual(uint32_t op);
+  void exec32DataProcShifted(uint32_t op);
+  void exec32DataProcImm(uint32_t op);
+  void exec32PlainImm(uint32_t op);
+  void exec32BranchMisc(uint32_t op);
+  void exec32StoreSingle(uint32_t op);
+  void exec32LoadSingle(uint32_t op);
+  void exec32DataProcReg(uint32_t op);
+  void exec32Multiply(uint32_t op);
+  void exec32LongMultiply(uint32_t op);
+  void exec16Misc(uint16_t op);
+  uint32_t address32(uint32_t op);
+  uint32_t mrs(unsigned sysm);
+  void msr(unsigned rn, unsigned sysm, unsigned mask);
+  void storeMultipleDb(unsigned rn, unsigned regs, bool writeback);
+  void storeMultipleIa(unsigned rn, unsigned regs, bool writeback);
+  void loadMultipleIa(unsigned rn, unsigned regs, bool writeback);
+  void loadMultipleDb(unsigned rn, unsigned regs, bool writeback);
+  void enterSleep();
+  void stopOnLoop();
+
+  uint32_t dataProc(unsigned opc, uint32_t a, uint32_t b, bool carry, bool setFlags, unsigned rd, bool& write);
+  bool condPassed(unsigned cond) const;
+  void setNZ(uint32_t result) { m_n = result >> 31; m_z = (result == 0u); }
+  uint32_t pcRead() const { return m_pc + 4u; }
+  void branchTo(uint32_t addr) { m_nextPc = addr & ~1u; }
+  void bxWritePc(uint32_t addr);
+  void writeReg(unsigned n, uint32_t value, bool interworking);
+  bool inIt() const { return (m_itState & 0xFu) != 0u; }
+  void itAdvance();
+  uint32_t xpsr() const;
+  void setXpsr(uint32_t value);
+
+  int executionPriority() const;
+  int groupPriority(unsigned exc) const;
+  bool checkExceptions();
+  void exceptionEntry(unsigned exc, uint32_t returnAddr);
+  void exceptionReturn(uint32_t excReturn);
+  void takeFault(const Fault& fault);
+
+  Bus& m_bus;
+  uint32_t m_r[16];                   ///< r0..r14 (r15 unused, see m_pc)
+  uint32_t m_pc;                      ///< Address of current instruction
+  uint32_t m_nextPc;                  ///< Address of next instruction
+  bool m_n, m_z, m_c, m_v, m_q;       ///< APSR flags
+  uint8_t m_itState;                  ///< IT block state
+  bool m_inItInsn = false;            ///< Current instruction is in IT block
+  uint32_t m_ipsr;                    ///< Current exception number
+  bool m_primask, m_faultmask;        ///< Exception masks
+  uint8_t m_basepri;                  ///< Base priority mask
+  uint32_t m_control;                 ///< CONTROL register
+  uint32_t m_msp, m_psp;              ///< Banked stack pointers (inactive)
+  uint32_t m_vtor;                    ///< Vector table offset
+  unsigned m_priGroup;                ///< Priority grouping (AIRCR.PRIGROUP)
+  bool m_exclusive;                   ///< Exclusive monitor state
+
+  bool m_pending[NUM_EXC];
+  bool m_active[NUM_EXC];
+  bool m_enabled[NUM_EXC];
+  uint8_t m_prio[NUM_EXC];
+  unsigned m_activeCount;
+  bool m_excCheck;                    ///< Re-evaluate pending exceptions
+
+  uint64_t m_cycles;
+  uint64_t m_insns;
+  uint64_t m_nextEvent;
+  std::vector<Timed*> m_timed;
+  bool m_sleeping;
+
+  BkptHandler m_semihost;
+  bool m_haltOnLoop = true;
+  bool m_exitRequested = false;
+  int m_exitCode = 0;
+  bool m_stop = false;
+  StopReason m_stopReason = StopReason::Halt;
+  std::string m_faultInfo;
+  std::string m_faultText;
+};
+
+} // namespace armsim
+
+#endif // ARMSIM_CPU_H_
@@ -0,0 +1,130 @@
+/*!****************************************************************************
+ * @file
+ * elf.cpp
+ *
+ * @brief
+ * ELF32 image loader
+ *
+ * Segments are placed at their load address (LMA), as a debug probe would
+ * program them. Initialised data is copied to SRAM by the start-up code.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include "elf.h"
+
+
+namespace armsim {
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief ELF constants
+ *  @{                                                                        */
+static constexpr uint16_t EM_ARM      = 40u;
+static constexpr uint32_t PT_LOAD     = 1u;
+static constexpr uint32_t SHT_SYMTAB  = 2u;
+/*! @}                                                                        */
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Read little-endian value from image with bounds check
+ ******************************************************************************/
+template <typename T>
+static T get(const std::vector<uint8_t>& image, size_t offset)
+{
+  if ((offset > image.size()) || (image.size() - offset < sizeof(T)))
+  {
+    throw std::runtime_error("truncated ELF file");
+  }
+  T value = 0;
+  for (size_t i = 0u; i < sizeof(T); ++i) value |= (T)((T)image[offset + i] << (8u * i));
+  return value;
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Load ELF image
+ *
+ * @param[in] path      Image file
+ * @param[inout] bus    Target bus
+ * @param[out] symbols  Symbol table
+ * @date  17.10.2026
+ ******************************************************************************/
+void loadElf(const std::string& path, Bus& bus, SymbolTable& symbols)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) throw std::runtime_error("cannot open " + path);
+  std::vector<uint8_t> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  if ((image.size() < 52u) || (image[0] != 0x7Fu) || (image[1] != 'E') || (image[2] != 'L') || (image[3] != 'F'))
+  {
+    throw std::runtime_error(path + ": not an ELF file");
+  }
+  if ((image[4] != 1u) || (image[5] != 1u) || (get<uint16_t>(image, 18u) != EM_ARM))
+  {
+    throw std::runtime_error(path + ": not a 32-bit little-endian ARM image");
+  }
+
+  // Program headers
+  uint32_t ulPhoff = get<uint32_t>(image, 28u);
+  uint16_t usPhentsize = get<uint16_t>(image, 42u);
+  uint16_t usPhnum = get<uint16_t>(image, 44u);
+  for (unsigned i = 0u; i < usPhnum; ++i)
+  {
+    size_t ph = ulPhoff + (size_t)i * usPhentsize;
+    if (get<uint32_t>(image, ph) != PT_LOAD) continue;
+    uint32_t ulOffset = get<uint32_t>(image, ph + 4u);
+    uint32_t ulPaddr = get<uint32_t>(image, ph + 12u);
+    uint32_t ulFilesz = get<uint32_t>(image, ph + 16u);
+    if (ulFilesz == 0u) continue;
+    if ((ulOffset > image.size()) || (image.size() - ulOffset < ulFilesz))
+    {
+      throw std::runtime_error(path + ": segment exceeds file");
+    }
+    if (!bus.load(ulPaddr, &image[ulOffset], ulFilesz))
+    {
+      char acBuf[64];
+      std::snprintf(acBuf, sizeof(acBuf), ": segment at 0x%08x does not fit", ulPaddr);
+      throw std::runtime_error(path + acBuf);
+    }
+  }
+
+  // Symbol table
+  uint32_t ulShoff = get<uint32_t>(image, 32u);
+  uint16_t usShentsize = get<uint16_t>(image, 46u);
+  uint16_t usShnum = get<uint16_t>(image, 48u);
+  for (unsigned i = 0u; i < usShnum; ++i)
+  {
+    size_t sh = ulShoff + (size_t)i * usShentsize;
+    if (get<uint32_t>(image, sh + 4u) != SHT_SYMTAB) continue;
+    uint32_t ulSymOff = get<uint32_t>(image, sh + 16u);
+    uint32_t ulSymSize = get<uint32_t>(image, sh + 20u);
+    uint32_t ulLink = get<uint32_t>(image, sh + 24u);
+    size_t strtab = ulShoff + (size_t)ulLink * usShentsize;
+    uint32_t ulStrOff = get<uint32_t>(image, strtab + 16u);
+    uint32_t ulStrSize = get<uint32_t>(image, strtab + 20u);
+    if ((ulStrOff > image.size()) || (image.size() - ulStrOff < ulStrSize))
+    {
+      throw std::runtime_error(path + ": string table exceeds file");
+    }
+
+    for (uint32_t sym = 0u; sym + 16u <= ulSymSize; sym += 16u)
+    {
+      uint32_t ulName = get<uint32_t>(image, ulSymOff + sym);
+      if ((ulName == 0u) || (ulName >= ulStrSize)) continue;
+      const char* pszName = reinterpret_cast<const char*>(&image[ulStrOff + ulName]);
+      symbols[std::string(pszName, strnlen(pszName, ulStrSize - ulName))] = get<uint32_t>(image, ulSymOff + sym + 4u);
+    }
+  }
+}
+
+} // namespace armsim
@@ -0,0 +1,34 @@
+/*!****************************************************************************
+ * @file
+ * elf.h
+ *
+ * @brief
+ * ELF32 image loader
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef ARMSIM_ELF_H_
+#define ARMSIM_ELF_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdint>
+#include <map>
+#include <string>
+#include "bus.h"
+
+
+namespace armsim {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Symbol table: name -> value
+using SymbolTable = std::map<std::string, uint32_t>;
+
+/*- Public interface ---------------------------------------------------------*/
+/// Load PT_LOAD segments at their physical (load) addresses; read the symbol
+/// table if present. Throws std::runtime_error on invalid images.
+void loadElf(const std::string& path, Bus& bus, SymbolTable& symbols);
+
+} // namespace armsim
+
+#endif // ARMSIM_ELF_H_
@@ -0,0 +1,153 @@
+/*!****************************************************************************
+ * @file
+ * machine.cpp
+ *
+ * @brief
+ * STM32F103 machine: core, memory map, system and peripheral devices
+ *
+ * Peripherals without a dedicated model are backed by a plain register file,
+ * so that HAL initialisation code for unused peripherals runs through. Accesses
+ * outside flash, SRAM, the peripheral region and the private peripheral bus
+ * raise a bus fault.
+ *
+ * Semihosting requests are served by the semihosting library on the bus; the
+ * modelled service time of each request is added to the cycle count.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "machine.h"
+
+
+namespace armsim {
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Peripheral addresses
+ *  @{                                                                        */
+static constexpr uint32_t PERIPH_SIZE     = 0x00030000u;
+static constexpr uint32_t GPIOA_BASE      = 0x40010800u;
+static constexpr uint32_t FLASH_R_BASE    = 0x40022000u;
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Target memory view of the bus for the semihosting service
+class BusMemory : public semihost::TargetMemory
+{
+public:
+  explicit BusMemory(Bus& bus) : m_bus(bus) {}
+
+  void read(uint32_t addr, void* pBuf, size_t len) override
+  {
+    uint8_t* pucBuf = static_cast<uint8_t*>(pBuf);
+    for (size_t i = 0u; i < len; ++i) pucBuf[i] = m_bus.read8(addr + (uint32_t)i);
+  }
+
+  void write(uint32_t addr, const void* pData, size_t len) override
+  {
+    const uint8_t* pucData = static_cast<const uint8_t*>(pData);
+    for (size_t i = 0u; i < len; ++i) m_bus.write8(addr + (uint32_t)i, pucData[i]);
+  }
+
+private:
+  Bus& m_bus;
+};
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Create machine and load image
+ *
+ * @param[in] config  Machine configuration
+ * @param[in] image   ELF image path
+ * @param[in] console Semihosting console sink
+ * @date  17.10.2026
+ ******************************************************************************/
+Machine::Machine(const MachineConfig& config, const std::string& image, ConsoleSink console)
+  : m_bus(config.flashSize, config.sramSize),
+    m_cpu(m_bus),
+    m_dwt(m_cpu),
+    m_scs(m_cpu, m_dwt),
+    m_rcc(m_cpu),
+    m_periph("PERIPH", Bus::PERIPH_BASE, PERIPH_SIZE),
+    m_flashIf("FLASH", FLASH_R_BASE, 0x400u, { { 0x00u, 0x00000030u } }),
+    m_console(std::move(console))
+{
+  // Generic backing first; specific models override their pages
+  m_bus.attach(&m_periph);
+  m_bus.attach(&m_flashIf);
+  m_bus.attach(&m_rcc);
+  for (unsigned i = 0u; i < 5u; ++i)
+  {
+    m_gpio.emplace_back(new Gpio((char)('A' + i), GPIOA_BASE + 0x400u * i));
+    m_bus.attach(m_gpio.back().get());
+  }
+  m_bus.attach(&m_scs);
+  m_bus.attach(&m_dwt);
+  m_cpu.addTimed(&m_scs);
+  m_cpu.setHaltOnLoop(config.haltOnLoop);
+
+  loadElf(image, m_bus, m_symbols);
+
+  // Time operations report simulated time; SYS_ELAPSED ticks are core cycles
+  semihost::SessionConfig session = config.semihost;
+  session.server.heap = semihost::heapInfo(m_symbols);
+  semihost::Environment env;
+  env.nanoseconds = [this]() { return nanoseconds(); };
+  env.ticks = [this]() { return m_cpu.cycles(); };
+  env.tickFreq = [this]() {
+    uint64_t ullNs = nanoseconds();
+    return (ullNs != 0u) ? (uint32_t)(m_cpu.cycles() * 1000000000ull / ullNs) : Rcc::HSI_HZ;
+  };
+  m_semihost.reset(new semihost::Session(session, env));
+  m_cpu.setSemihostHandler([this](Cpu& cpu) { semihostRequest(cpu); });
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset and run
+ *
+ * @param[in] maxCycles Cycle limit
+ * @return  (StopReason)  Reason for stopping
+ * @date  17.10.2026
+ ******************************************************************************/
+StopReason Machine::run(uint64_t maxCycles)
+{
+  m_cpu.reset();
+  StopReason reason = m_cpu.run(maxCycles);
+  if (m_semihostError.empty()) m_semihost->finish();
+  return reason;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Handle "bkpt 0xAB"
+ *
+ * Trace divergence or replay errors stop the simulation with a fault.
+ *
+ * @param[inout] cpu  Core; r0 holds the operation, r1 the argument
+ * @date  17.10.2026
+ ******************************************************************************/
+void Machine::semihostRequest(Cpu& cpu)
+{
+  BusMemory mem(cpu.bus());
+  try
+  {
+    semihost::Response rsp = m_semihost->handle(cpu.reg(0u), cpu.reg(1u), mem);
+    cpu.setReg(0u, rsp.r0);
+    if (!rsp.console.empty()) m_console(rsp.console.data(), rsp.console.size());
+    if (rsp.exit) cpu.requestExit(rsp.exitCode);
+    cpu.stall(rsp.latencyNs * m_rcc.hclk() / 1000000000ull);
+  }
+  catch (const std::runtime_error& e)
+  {
+    m_semihostError = e.what();
+    cpu.requestStop(StopReason::Fault, m_semihostError.c_str());
+  }
+}
+
+} // namespace armsim
@@ -0,0 +1,79 @@
+/*!****************************************************************************
+ * @file
+ * machine.h
+ *
+ * @brief
+ * STM32F103 machine: core, memory map, system and peripheral devices
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef ARMSIM_MACHINE_H_
+#define ARMSIM_MACHINE_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <functional>
+#include <memory>
+#include <vector>
+#include "bus.h"
+#include "cpu.h"
+#include "elf.h"
+#include "periph.h"
+#include "scs.h"
+#include "session.h"
+
+
+namespace armsim {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Machine configuration
+struct MachineConfig
+{
+  uint32_t flashSize = 128u * 1024u;  ///< STM32F103x8 (64 KiB nominal, 128 KiB usable)
+  uint32_t sramSize = 20u * 1024u;
+  bool haltOnLoop = true;
+  semihost::SessionConfig semihost;
+};
+
+/// Complete simulated system
+class Machine
+{
+public:
+  /// Console output sink (SYS_WRITEC, SYS_WRITE0, writes to ":tt")
+  using ConsoleSink = std::function<void(const char* pData, size_t len)>;
+
+  Machine(const MachineConfig& config, const std::string& image, ConsoleSink console);
+
+  /// Run from reset until stop or cycle limit, then complete the semihosting
+  /// session (throws std::runtime_error, e.g. on an incomplete replay)
+  StopReason run(uint64_t maxCycles);
+
+  Cpu& cpu() { return m_cpu; }
+  Rcc& rcc() { return m_rcc; }
+  Gpio& gpio(unsigned port) { return *m_gpio[port]; }
+  const SymbolTable& symbols() const { return m_symbols; }
+  const semihost::Session& semihost() const { return *m_semihost; }
+
+  /// Simulated time in nanoseconds
+  uint64_t nanoseconds() { return m_rcc.nanoseconds(m_cpu.cycles()); }
+
+private:
+  void semihostRequest(Cpu& cpu);
+
+  Bus m_bus;
+  Cpu m_cpu;
+  Dwt m_dwt;
+  Scs m_scs;
+  Rcc m_rcc;
+  RegisterFile m_periph;
+  RegisterFile m_flashIf;
+  std::vector<std::unique_ptr<Gpio>> m_gpio;
+  SymbolTable m_symbols;
+  ConsoleSink m_console;
+  std::unique_ptr<semihost::Session> m_semihost;
+  std::string m_semihostError;
+};
+
+} // namespace armsim
+
+#endif // ARMSIM_MACHINE_H_
@@ -0,0 +1,303 @@
+/*!****************************************************************************
+ * @file
+ * main.cpp
+ *
+ * @brief
+ * armsim: run STM32F103 firmware images on the host
+ *
+ * Runs one or more ELF images from reset until the application exits via
+ * semihosting, reaches its final idle loop, faults, or exceeds the cycle limit.
+ * Semihosting file operations act on the host file system, so the coverage
+ * dump of an instrumented image can be processed like one from a debug probe.
+ * Alternatively, files are served from memory (--vfs), and the semihosting
+ * traffic can be recorded and replayed without host access.
+ *
+ * With several images, up to -j simulations run in parallel; console output of
+ * each image is printed in one piece when it has finished. Files written by an
+ * image go to its own output directory <root>/<image name without extension>,
+ * so parallel runs do not overwrite each other's coverage and test results.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#include "machine.h"
+
+using namespace armsim;
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Command-line options
+struct Options
+{
+  MachineConfig machine;
+  uint64_t maxCycles = 10000000000ull;
+  unsigned jobs = 1u;
+  bool stats = false;
+  std::vector<std::string> images;
+};
+
+/// Result of a single run
+struct Result
+{
+  StopReason reason = StopReason::Fault;
+  int exitCode = 1;
+  std::string console;
+  std::string summary;
+};
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Print usage
+ ******************************************************************************/
+static void vUsage(const char* pszProg)
+{
+  std::fprintf(stderr,
+    "usage: %s [options] image.elf [image.elf ...]\n"
+    "  --cmdline STR       SYS_GET_CMDLINE string\n"
+    "  --root DIR          base directory for relative semihosting paths (.)\n"
+    "  --max-cycles N      cycle limit (10000000000)\n"
+    "  --flash KIB         flash size (128)\n"
+    "  --sram KIB          SRAM size (20)\n"
+    "  --no-halt-on-loop   execute branch-to-self instead of stopping\n"
+    "  --allow-system      permit SYS_SYSTEM\n"
+    "  --vfs               serve files from memory, write modified files to --root at exit\n"
+    "  --vfs-import PATH   copy file from --root into memory (repeatable)\n"
+    "  --latency SPEC      semihosting service time per operation, added to the\n"
+    "                      simulated time, e.g. \"*=20000,write=50000+100\" (ns)\n"
+    "  --record FILE       record semihosting traffic (single image)\n"
+    "  --replay FILE       replay recorded traffic instead of accessing the host\n"
+    "  --no-verify         do not compare target memory with the recording\n"
+    "  -j N                parallel simulations for multiple images (1); each\n"
+    "                      image writes its files below --root/<image name>\n"
+    "  --stats             print cycle, instruction and throughput statistics\n",
+    pszProg);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Textual stop reason
+ ******************************************************************************/
+static const char* pszReason(StopReason reason)
+{
+  switch (reason)
+  {
+    case StopReason::CycleLimit: return "cycle limit";
+    case StopReason::Exit: return "exit";
+    case StopReason::Halt: return "halt";
+    case StopReason::Fault: return "fault";
+    case StopReason::Lockup: return "lockup";
+    default: return "breakpoint";
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Image file name without directory and extension
+ ******************************************************************************/
+static std::string imageStem(const std::string& image)
+{
+  size_t start = image.find_last_of('/');
+  start = (start == std::string::npos) ? 0u : start + 1u;
+  size_t end = image.find_last_of('.');
+  if ((end == std::string::npos) || (end <= start)) end = image.size();
+  return image.substr(start, end - start);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Parse command line
+ *
+ * @return  (bool)  Options valid
+ * @date  17.10.2026
+ ******************************************************************************/
+static bool bParseArgs(int argc, char* argv[], Options& opts)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    auto value = [&]() -> const char* {
+      if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+      return argv[++i];
+    };
+    if (arg == "--cmdline") opts.machine.semihost.server.cmdline = value();
+    else if (arg == "--root") opts.machine.semihost.root = value();
+    else if (arg == "--max-cycles") opts.maxCycles = std::strtoull(value(), nullptr, 0);
+    else if (arg == "--flash") opts.machine.flashSize = (uint32_t)std::strtoul(value(), nullptr, 0) * 1024u;
+    else if (arg == "--sram") opts.machine.sramSize = (uint32_t)std::strtoul(value(), nullptr, 0) * 1024u;
+    else if (arg == "--no-halt-on-loop") opts.machine.haltOnLoop = false;
+    else if (arg == "--allow-system") opts.machine.semihost.server.allowSystem = true;
+    else if (arg == "--vfs") opts.machine.semihost.vfs = true;
+    else if (arg == "--vfs-import") opts.machine.semihost.vfsImport.push_back(value());
+    else if (arg == "--latency") opts.machine.semihost.server.latency = semihost::parseLatency(value());
+    else if (arg == "--record") opts.machine.semihost.record = value();
+    else if (arg == "--replay") opts.machine.semihost.replay = value();
+    else if (arg == "--no-verify") opts.machine.semihost.verify = false;
+    else if (arg == "-j") opts.jobs = (unsigned)std::strtoul(value(), nullptr, 0);
+    else if (arg == "--stats") opts.stats = true;
+    else if ((arg == "-h") || (arg == "--help")) return false;
+    else if (arg[0] == '-') throw std::runtime_error("unknown option " + arg);
+    else opts.images.push_back(arg);
+  }
+  if (opts.jobs == 0u) opts.jobs = 1u;
+  const semihost::SessionConfig& session = opts.machine.semihost;
+  if (!session.record.empty() && !session.replay.empty())
+  {
+    throw std::runtime_error("--record and --replay are exclusive");
+  }
+  if ((!session.record.empty() || !session.replay.empty()) && (opts.images.size() > 1u))
+  {
+    throw std::runtime_error("--record and --replay require a single image");
+  }
+  std::set<std::string> stems;
+  for (const std::string& image : opts.images)
+  {
+    if ((opts.images.size() > 1u) && !stems.insert(imageStem(image)).second)
+    {
+      throw std::runtime_error("images of a batch need distinct names: " + image);
+    }
+  }
+  return !opts.images.empty();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Simulate one image
+ *
+ * @param[in] opts    Options
+ * @param[in] image   Image path
+ * @param[in] buffer  Batch run: buffer console output instead of writing it to
+ *                    stdout, write files to the output directory of the image
+ * @return  (Result)  Run result
+ * @date  17.10.2026
+ ******************************************************************************/
+static Result sRunImage(const Options& opts, const std::string& image, bool buffer)
+{
+  Result result;
+  auto console = [&result, buffer](const char* pData, size_t len) {
+    if (buffer)
+    {
+      result.console.append(pData, len);
+    }
+    else
+    {
+      std::fwrite(pData, 1u, len, stdout);
+      std::fflush(stdout);
+    }
+  };
+
+  try
+  {
+    MachineConfig config = opts.machine;
+    if (buffer)
+    {
+      config.semihost.output = config.semihost.root + "/" + imageStem(image);
+      mkdir(config.semihost.output.c_str(), 0777);
+    }
+    Machine machine(config, image, console);
+    auto start = std::chrono::steady_clock::now();
+    result.reason = machine.run(opts.maxCycles);
+    double dHostSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Cpu& cpu = machine.cpu();
+    result.exitCode = (result.reason == StopReason::Exit) ? cpu.exitCode()
+                    : (result.reason == StopReason::Halt) ? 0 : 1;
+
+    char acBuf[256];
+    std::snprintf(acBuf, sizeof(acBuf), "%s: %s (exit code %d) at pc=0x%08x%s%s\n",
+                  image.c_str(), pszReason(result.reason), result.exitCode, cpu.pc(),
+                  cpu.faultInfo().empty() ? "" : ", ", cpu.faultInfo().c_str());
+    result.summary = acBuf;
+    if (opts.stats)
+    {
+      std::snprintf(acBuf, sizeof(acBuf),
+                    "  %llu cycles, %llu instructions, %.3f ms simulated, %.3f s host, %.1f MIPS\n",
+                    (unsigned long long)cpu.cycles(), (unsigned long long)cpu.instructions(),
+                    machine.nanoseconds() / 1e6, dHostSec,
+                    (dHostSec > 0.0) ? cpu.instructions() / dHostSec / 1e6 : 0.0);
+      result.summary += acBuf;
+      for (const auto& op : machine.semihost().opCounts())
+      {
+        std::snprintf(acBuf, sizeof(acBuf), "  semihosting op 0x%02x (%s): %llu calls\n",
+                      op.first, semihost::opName(op.first).c_str(), (unsigned long long)op.second);
+        result.summary += acBuf;
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    result.summary = image + ": " + e.what() + "\n";
+  }
+  return result;
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Program entry point
+ *
+ * @return  (int) Exit code of the image (single image), or number of failed
+ *                images (batch)
+ * @date  17.10.2026
+ ******************************************************************************/
+int main(int argc, char* argv[])
+{
+  Options opts;
+  try
+  {
+    if (!bParseArgs(argc, argv, opts))
+    {
+      vUsage(argv[0]);
+      return 2;
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 2;
+  }
+
+  if (opts.images.size() == 1u)
+  {
+    Result result = sRunImage(opts, opts.images[0], false);
+    std::fputs(result.summary.c_str(), stderr);
+    return result.exitCode;
+  }
+
+  // Batch: worker threads pick images in order, output is serialised
+  std::atomic<size_t> next(0u);
+  std::atomic<int> failed(0);
+  std::mutex output;
+  std::vector<std::thread> workers;
+  for (unsigned t = 0u; t < std::min<size_t>(opts.jobs, opts.images.size()); ++t)
+  {
+    workers.emplace_back([&]() {
+      for (size_t i = next++; i < opts.images.size(); i = next++)
+      {
+        Result result = sRunImage(opts, opts.images[i], true);
+        if (result.exitCode != 0) ++failed;
+        std::lock_guard<std::mutex> lock(output);
+        std::printf("== %s\n%s", opts.images[i].c_str(), result.console.c_str());
+        std::fflush(stdout);
+        std::fputs(result.summary.c_str(), stderr);
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  return failed;
+}
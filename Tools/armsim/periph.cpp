@@ -0,0 +1,261 @@
+/*!****************************************************************************
+ * @file
+ * periph.cpp
+ *
+ * @brief
+ * STM32F1 peripheral models: RCC, GPIO and a generic register file
+ *
+ * Only the behaviour that the HAL start-up and GPIO code depend on is modelled:
+ * ready flags follow their enable bits without delay, the system clock switch
+ * status follows the selection, and GPIO inputs read back the output latch or
+ * the configured pull level.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "periph.h"
+
+
+namespace armsim {
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief RCC register offsets
+ *  @{                                                                        */
+static constexpr uint32_t RCC_CR        = 0x00u;
+static constexpr uint32_t RCC_CFGR      = 0x04u;
+static constexpr uint32_t RCC_CIR       = 0x08u;
+static constexpr uint32_t RCC_APB2RSTR  = 0x0Cu;
+static constexpr uint32_t RCC_APB1RSTR  = 0x10u;
+static constexpr uint32_t RCC_AHBENR    = 0x14u;
+static constexpr uint32_t RCC_APB2ENR   = 0x18u;
+static constexpr uint32_t RCC_APB1ENR   = 0x1Cu;
+static constexpr uint32_t RCC_BDCR      = 0x20u;
+static constexpr uint32_t RCC_CSR       = 0x24u;
+/*! @}                                                                        */
+
+/*! @brief GPIO register offsets
+ *  @{                                                                        */
+static constexpr uint32_t GPIO_CRL      = 0x00u;
+static constexpr uint32_t GPIO_CRH      = 0x04u;
+static constexpr uint32_t GPIO_IDR      = 0x08u;
+static constexpr uint32_t GPIO_ODR      = 0x0Cu;
+static constexpr uint32_t GPIO_BSRR     = 0x10u;
+static constexpr uint32_t GPIO_BRR      = 0x14u;
+static constexpr uint32_t GPIO_LCKR     = 0x18u;
+/*! @}                                                                        */
+
+/// AHB prescaler shift per HPRE setting
+static const unsigned s_auHpreShift[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9 };
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Read register; unwritten registers read as zero
+ ******************************************************************************/
+uint32_t RegisterFile::read(uint32_t offset)
+{
+  auto it = m_regs.find(offset);
+  return (it != m_regs.end()) ? it->second : 0u;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write register
+ ******************************************************************************/
+void RegisterFile::write(uint32_t offset, uint32_t value, uint32_t mask)
+{
+  uint32_t& ulReg = m_regs[offset];
+  ulReg = (ulReg & ~mask) | (value & mask);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read RCC register
+ ******************************************************************************/
+uint32_t Rcc::read(uint32_t offset)
+{
+  switch (offset)
+  {
+    case RCC_CR: return m_cr;
+    case RCC_CFGR: return m_cfgr;
+    case RCC_CIR: return m_cir;
+    case RCC_APB2RSTR: return m_apb2rstr;
+    case RCC_APB1RSTR: return m_apb1rstr;
+    case RCC_AHBENR: return m_ahbenr;
+    case RCC_APB2ENR: return m_apb2enr;
+    case RCC_APB1ENR: return m_apb1enr;
+    case RCC_BDCR: return m_bdcr;
+    case RCC_CSR: return m_csr;
+    default: return 0u;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write RCC register
+ *
+ * Ready flags (HSIRDY, HSERDY, PLLRDY, LSERDY, LSIRDY) are set as soon as the
+ * corresponding enable bit is written, and SWS follows SW.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+void Rcc::write(uint32_t offset, uint32_t value, uint32_t mask)
+{
+  auto merge = [&](uint32_t& reg) { reg = (reg & ~mask) | (value & mask); };
+  switch (offset)
+  {
+    case RCC_CR:
+      merge(m_cr);
+      m_cr = (m_cr & ~0x02020002u) | ((m_cr & 0x01010001u) << 1);
+      break;
+    case RCC_CFGR:
+      merge(m_cfgr);
+      m_cfgr = (m_cfgr & ~0xCu) | ((m_cfgr & 3u) << 2);
+      break;
+    case RCC_CIR: merge(m_cir); break;
+    case RCC_APB2RSTR: merge(m_apb2rstr); break;
+    case RCC_APB1RSTR: merge(m_apb1rstr); break;
+    case RCC_AHBENR: merge(m_ahbenr); break;
+    case RCC_APB2ENR: merge(m_apb2enr); break;
+    case RCC_APB1ENR: merge(m_apb1enr); break;
+    case RCC_BDCR:
+      merge(m_bdcr);
+      m_bdcr = (m_bdcr & ~2u) | ((m_bdcr & 1u) << 1);
+      break;
+    case RCC_CSR:
+      merge(m_csr);
+      m_csr = (m_csr & ~2u) | ((m_csr & 1u) << 1);
+      break;
+    default:
+      break;
+  }
+  updateClock();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Simulated time
+ *
+ * @param[in] now Current cycle count
+ * @return  (uint64_t)  Nanoseconds since reset
+ * @date  17.10.2026
+ ******************************************************************************/
+uint64_t Rcc::nanoseconds(uint64_t now) const
+{
+  return m_timeBaseNs + (now - m_timeBaseCycles) * 1000000000ull / m_hclk;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Compute HCLK from the current clock tree configuration
+ ******************************************************************************/
+uint32_t Rcc::computeHclk() const
+{
+  uint32_t ulSysclk;
+  switch ((m_cfgr >> 2) & 3u)
+  {
+    case 1u:
+      ulSysclk = HSE_HZ;
+      break;
+    case 2u:
+    {
+      uint32_t ulMul = ((m_cfgr >> 18) & 0xFu) + 2u;
+      if (ulMul > 16u) ulMul = 16u;
+      uint32_t ulIn = (m_cfgr & (1u << 16)) ? ((m_cfgr & (1u << 17)) ? HSE_HZ / 2u : HSE_HZ) : HSI_HZ / 2u;
+      ulSysclk = ulIn * ulMul;
+      break;
+    }
+    default:
+      ulSysclk = HSI_HZ;
+      break;
+  }
+  return ulSysclk >> s_auHpreShift[(m_cfgr >> 4) & 0xFu];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fold elapsed time into the time base on clock changes
+ ******************************************************************************/
+void Rcc::updateClock()
+{
+  uint32_t ulHclk = computeHclk();
+  if (ulHclk == m_hclk) return;
+  uint64_t ullNow = m_cpu.cycles();
+  m_timeBaseNs = nanoseconds(ullNow);
+  m_timeBaseCycles = ullNow;
+  m_hclk = ulHclk;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read GPIO register
+ ******************************************************************************/
+uint32_t Gpio::read(uint32_t offset)
+{
+  switch (offset)
+  {
+    case GPIO_CRL: return m_crl;
+    case GPIO_CRH: return m_crh;
+    case GPIO_IDR: return idr();
+    case GPIO_ODR: return m_odr;
+    case GPIO_LCKR: return m_lckr;
+    default: return 0u;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write GPIO register
+ ******************************************************************************/
+void Gpio::write(uint32_t offset, uint32_t value, uint32_t mask)
+{
+  value &= mask;
+  switch (offset)
+  {
+    case GPIO_CRL: m_crl = (m_crl & ~mask) | value; break;
+    case GPIO_CRH: m_crh = (m_crh & ~mask) | value; break;
+    case GPIO_ODR: setOdr((m_odr & ~mask) | (value & 0xFFFFu)); break;
+    case GPIO_BSRR: setOdr((m_odr & ~(value >> 16)) | (value & 0xFFFFu)); break;
+    case GPIO_BRR: setOdr(m_odr & ~(value & 0xFFFFu)); break;
+    case GPIO_LCKR: m_lckr = (m_lckr & ~mask) | (value & 0x1FFFFu); break;
+    default: break;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Input data: output pins read back their latch, pull-up/down inputs their
+ * pull level, floating and analog inputs read low
+ ******************************************************************************/
+uint32_t Gpio::idr() const
+{
+  uint32_t ulIdr = 0u;
+  for (unsigned i = 0u; i < 16u; ++i)
+  {
+    uint32_t ulCfg = ((i < 8u ? m_crl : m_crh) >> (4u * (i & 7u))) & 0xFu;
+    bool bOutput = (ulCfg & 3u) != 0u;
+    bool bPull = !bOutput && ((ulCfg >> 2) == 2u);
+    if ((bOutput || bPull) && (m_odr & (1u << i))) ulIdr |= 1u << i;
+  }
+  return ulIdr;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Update output latch and count level changes
+ ******************************************************************************/
+void Gpio::setOdr(uint32_t odr)
+{
+  uint32_t ulChanged = (odr ^ m_odr) & 0xFFFFu;
+  for (unsigned i = 0u; i < 16u; ++i)
+  {
+    if (ulChanged & (1u << i)) ++m_toggles[i];
+  }
+  m_odr = odr & 0xFFFFu;
+}
+
+} // namespace armsim
@@ -0,0 +1,106 @@
+/*!****************************************************************************
+ * @file
+ * periph.h
+ *
+ * @brief
+ * STM32F1 peripheral models: RCC, GPIO and a generic register file
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef ARMSIM_PERIPH_H_
+#define ARMSIM_PERIPH_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <map>
+#include "bus.h"
+#include "cpu.h"
+
+
+namespace armsim {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Plain read/write registers with reset values; backs unmodelled peripherals
+class RegisterFile : public Device
+{
+public:
+  RegisterFile(std::string name, uint32_t base, uint32_t size,
+               std::map<uint32_t, uint32_t> resetValues = {})
+    : Device(std::move(name), base, size), m_regs(std::move(resetValues)) {}
+
+  uint32_t read(uint32_t offset) override;
+  void write(uint32_t offset, uint32_t value, uint32_t mask) override;
+
+private:
+  std::map<uint32_t, uint32_t> m_regs;
+};
+
+/// Reset and clock control; oscillators and the PLL lock immediately
+class Rcc : public Device
+{
+public:
+  static constexpr uint32_t BASE = 0x40021000u;
+
+  /// External crystal frequency (Blue Pill, Nucleo-F103: 8 MHz)
+  static constexpr uint32_t HSE_HZ = 8000000u;
+  static constexpr uint32_t HSI_HZ = 8000000u;
+
+  explicit Rcc(Cpu& cpu) : Device("RCC", BASE, 0x400u), m_cpu(cpu) {}
+
+  uint32_t read(uint32_t offset) override;
+  void write(uint32_t offset, uint32_t value, uint32_t mask) override;
+
+  /// Current core (HCLK) frequency
+  uint32_t hclk() const { return m_hclk; }
+
+  /// Simulated time in nanoseconds, integrated over clock changes
+  uint64_t nanoseconds(uint64_t now) const;
+
+private:
+  uint32_t computeHclk() const;
+  void updateClock();
+
+  Cpu& m_cpu;
+  uint32_t m_cr = 0x00000083u;
+  uint32_t m_cfgr = 0u;
+  uint32_t m_cir = 0u;
+  uint32_t m_apb2rstr = 0u;
+  uint32_t m_apb1rstr = 0u;
+  uint32_t m_ahbenr = 0x00000014u;
+  uint32_t m_apb2enr = 0u;
+  uint32_t m_apb1enr = 0u;
+  uint32_t m_bdcr = 0u;
+  uint32_t m_csr = 0x0C000000u;
+
+  uint32_t m_hclk = HSI_HZ;
+  uint64_t m_timeBaseCycles = 0u;     ///< Cycle count at last clock change
+  uint64_t m_timeBaseNs = 0u;         ///< Simulated time at last clock change
+};
+
+/// General-purpose I/O port (F1 layout with CRL/CRH)
+class Gpio : public Device
+{
+public:
+  Gpio(char port, uint32_t base) : Device(std::string("GPIO") + port, base, 0x400u) {}
+
+  uint32_t read(uint32_t offset) override;
+  void write(uint32_t offset, uint32_t value, uint32_t mask) override;
+
+  /// Number of output level changes per pin
+  const uint64_t* toggles() const { return m_toggles; }
+  uint32_t odr() const { return m_odr; }
+
+private:
+  uint32_t idr() const;
+  void setOdr(uint32_t odr);
+
+  uint32_t m_crl = 0x44444444u;
+  uint32_t m_crh = 0x44444444u;
+  uint32_t m_odr = 0u;
+  uint32_t m_lckr = 0u;
+  uint64_t m_toggles[16] = {};
+};
+
+} // namespace armsim
+
+#endif // ARMSIM_PERIPH_H_
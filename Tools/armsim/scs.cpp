@@ -0,0 +1,431 @@
+/*!****************************************************************************
+ * @file
+ * scs.cpp
+ *
+ * @brief
+ * Cortex-M3 system control space: NVIC, SCB, SysTick, DWT cycle counter
+ *
+ * SysTick and the DWT cycle counter are not clocked per instruction. Their
+ * values are computed from the core cycle count on access, and SysTick
+ * schedules its next wrap as a timed event so the core can skip WFI sleep
+ * directly to the next interrupt.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "scs.h"
+
+
+namespace armsim {
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief SCS register offsets
+ *  @{                                                                        */
+static constexpr uint32_t ICTR        = 0x004u;
+static constexpr uint32_t SYST_CSR    = 0x010u;
+static constexpr uint32_t SYST_RVR    = 0x014u;
+static constexpr uint32_t SYST_CVR    = 0x018u;
+static constexpr uint32_t SYST_CALIB  = 0x01Cu;
+static constexpr uint32_t NVIC_ISER   = 0x100u;
+static constexpr uint32_t NVIC_ICER   = 0x180u;
+static constexpr uint32_t NVIC_ISPR   = 0x200u;
+static constexpr uint32_t NVIC_ICPR   = 0x280u;
+static constexpr uint32_t NVIC_IABR   = 0x300u;
+static constexpr uint32_t NVIC_IPR    = 0x400u;
+static constexpr uint32_t CPUID       = 0xD00u;
+static constexpr uint32_t ICSR        = 0xD04u;
+static constexpr uint32_t VTOR        = 0xD08u;
+static constexpr uint32_t AIRCR       = 0xD0Cu;
+static constexpr uint32_t SCR         = 0xD10u;
+static constexpr uint32_t CCR         = 0xD14u;
+static constexpr uint32_t SHPR1       = 0xD18u;
+static constexpr uint32_t SHCSR       = 0xD24u;
+static constexpr uint32_t CFSR        = 0xD28u;
+static constexpr uint32_t HFSR        = 0xD2Cu;
+static constexpr uint32_t DEMCR       = 0xDFCu;
+static constexpr uint32_t STIR        = 0xF00u;
+/*! @}                                                                        */
+
+/// Number of external interrupts (STM32F103: 60, rounded to NVIC register)
+static constexpr unsigned NUM_IRQ     = Cpu::NUM_EXC - Cpu::EXC_IRQ0;
+
+/// SysTick calibration value: 9000 ticks of HCLK/8 = 1 ms at 72 MHz
+static constexpr uint32_t CALIB_VALUE = 9000u;
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Read DWT register
+ ******************************************************************************/
+uint32_t Dwt::read(uint32_t offset)
+{
+  switch (offset)
+  {
+    case 0x000u: return m_ctrl;
+    case 0x004u: return cyccnt();
+    default: return 0u;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write DWT register
+ ******************************************************************************/
+void Dwt::write(uint32_t offset, uint32_t value, uint32_t mask)
+{
+  switch (offset)
+  {
+    case 0x000u:
+      rebase();
+      m_ctrl = (m_ctrl & ~(mask & 1u)) | (value & mask & 1u);
+      break;
+    case 0x004u:
+      rebase();
+      m_cyccntBase = (m_cyccntBase & ~mask) | (value & mask);
+      break;
+    default:
+      break;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Set trace enable state (DEMCR.TRCENA)
+ ******************************************************************************/
+void Dwt::setTraceEnabled(bool enable)
+{
+  rebase();
+  m_trcena = enable;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Current cycle counter value
+ ******************************************************************************/
+uint32_t Dwt::cyccnt() const
+{
+  if (!m_trcena || !(m_ctrl & 1u)) return m_cyccntBase;
+  return m_cyccntBase + (uint32_t)(m_cpu.cycles() - m_cycleBase);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fold elapsed cycles into the counter base before a state change
+ ******************************************************************************/
+void Dwt::rebase()
+{
+  m_cyccntBase = cyccnt();
+  m_cycleBase = m_cpu.cycles();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read SCS register
+ *
+ * @param[in] offset  Register offset
+ * @return  (uint32_t)  Register value
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Scs::read(uint32_t offset)
+{
+  const uint64_t ullNow = m_cpu.cycles();
+
+  if ((offset >= NVIC_ISER) && (offset < NVIC_IPR + NUM_IRQ))
+  {
+    unsigned uBank = offset & 0x7Cu;
+    if (offset >= NVIC_IPR)
+    {
+      uint32_t ulVal = 0u;
+      for (unsigned i = 0u; i < 4u; ++i)
+      {
+        unsigned uIrq = offset - NVIC_IPR + i;
+        if (uIrq < NUM_IRQ) ulVal |= (uint32_t)m_cpu.priority(Cpu::EXC_IRQ0 + uIrq) << (8u * i);
+      }
+      return ulVal;
+    }
+    uint32_t ulVal = 0u;
+    for (unsigned i = 0u; i < 32u; ++i)
+    {
+      unsigned uIrq = (uBank * 8u) + i;
+      if (uIrq >= NUM_IRQ) break;
+      unsigned uExc = Cpu::EXC_IRQ0 + uIrq;
+      bool bBit;
+      switch (offset & 0xF80u)
+      {
+        case NVIC_ISER:
+        case NVIC_ICER: bBit = m_cpu.isEnabled(uExc); break;
+        case NVIC_ISPR:
+        case NVIC_ICPR: bBit = m_cpu.isPending(uExc); break;
+        default:        bBit = m_cpu.isActive(uExc); break;
+      }
+      ulVal |= (uint32_t)bBit << i;
+    }
+    return ulVal;
+  }
+
+  if ((offset >= SHPR1) && (offset < SHPR1 + 12u))
+  {
+    uint32_t ulVal = 0u;
+    for (unsigned i = 0u; i < 4u; ++i)
+    {
+      ulVal |= (uint32_t)m_cpu.priority(4u + (offset - SHPR1) + i) << (8u * i);
+    }
+    return ulVal;
+  }
+
+  switch (offset)
+  {
+    case ICTR:
+      return (NUM_IRQ + 31u) / 32u - 1u;
+
+    case SYST_CSR:
+    {
+      advance(ullNow);
+      uint32_t ulVal = m_stCtrl | (m_stCountFlag ? (1u << 16) : 0u);
+      m_stCountFlag = false;
+      return ulVal;
+    }
+    case SYST_RVR: return m_stLoad;
+    case SYST_CVR: return systickValue(ullNow);
+    case SYST_CALIB: return CALIB_VALUE;
+
+    case CPUID: return 0x411FC231u;
+    case ICSR:
+    {
+      unsigned uPending = m_cpu.pendingHighest();
+      uint32_t ulVal = m_cpu.ipsr() | ((uint32_t)uPending << 12);
+      if (uPending >= Cpu::EXC_IRQ0) ulVal |= 1u << 22;
+      if (m_cpu.isPending(Cpu::EXC_PENDSV)) ulVal |= 1u << 28;
+      if (m_cpu.isPending(Cpu::EXC_SYSTICK)) ulVal |= 1u << 26;
+      if (m_cpu.isPending(Cpu::EXC_NMI)) ulVal |= 1u << 31;
+      return ulVal;
+    }
+    case VTOR: return m_cpu.vtor();
+    case AIRCR: return 0xFA050000u | (m_cpu.priGroup() << 8);
+    case SCR: return m_scr;
+    case CCR: return m_ccr;
+    case SHCSR:
+    {
+      uint32_t ulVal = 0u;
+      if (m_cpu.isEnabled(Cpu::EXC_MEMMANAGE)) ulVal |= 1u << 16;
+      if (m_cpu.isEnabled(Cpu::EXC_BUSFAULT)) ulVal |= 1u << 17;
+      if (m_cpu.isEnabled(Cpu::EXC_USAGEFAULT)) ulVal |= 1u << 18;
+      if (m_cpu.isActive(Cpu::EXC_MEMMANAGE)) ulVal |= 1u << 0;
+      if (m_cpu.isActive(Cpu::EXC_BUSFAULT)) ulVal |= 1u << 1;
+      if (m_cpu.isActive(Cpu::EXC_USAGEFAULT)) ulVal |= 1u << 3;
+      if (m_cpu.isActive(Cpu::EXC_SVCALL)) ulVal |= 1u << 7;
+      if (m_cpu.isActive(Cpu::EXC_PENDSV)) ulVal |= 1u << 10;
+      if (m_cpu.isActive(Cpu::EXC_SYSTICK)) ulVal |= 1u << 11;
+      return ulVal;
+    }
+    case CFSR: return m_cfsr;
+    case HFSR: return m_hfsr;
+    case DEMCR: return m_demcr;
+    default: return 0u;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write SCS register
+ *
+ * @param[in] offset  Register offset
+ * @param[in] value   Value
+ * @param[in] mask    Written bits (byte/halfword accesses)
+ * @date  17.10.2026
+ ******************************************************************************/
+void Scs::write(uint32_t offset, uint32_t value, uint32_t mask)
+{
+  const uint64_t ullNow = m_cpu.cycles();
+  value &= mask;
+
+  if ((offset >= NVIC_ISER) && (offset < NVIC_IPR + NUM_IRQ))
+  {
+    if (offset >= NVIC_IPR)
+    {
+      for (unsigned i = 0u; i < 4u; ++i)
+      {
+        unsigned uIrq = offset - NVIC_IPR + i;
+        if ((uIrq < NUM_IRQ) && ((mask >> (8u * i)) & 0xFFu))
+        {
+          m_cpu.setPriority(Cpu::EXC_IRQ0 + uIrq, (uint8_t)(value >> (8u * i)));
+        }
+      }
+      return;
+    }
+    unsigned uBank = offset & 0x7Cu;
+    for (unsigned i = 0u; i < 32u; ++i)
+    {
+      unsigned uIrq = (uBank * 8u) + i;
+      if ((uIrq >= NUM_IRQ) || !(value & (1u << i))) continue;
+      unsigned uExc = Cpu::EXC_IRQ0 + uIrq;
+      switch (offset & 0xF80u)
+      {
+        case NVIC_ISER: m_cpu.setEnabled(uExc, true); break;
+        case NVIC_ICER: m_cpu.setEnabled(uExc, false); break;
+        case NVIC_ISPR: m_cpu.setPending(uExc); break;
+        case NVIC_ICPR: m_cpu.clearPending(uExc); break;
+        default: break;
+      }
+    }
+    return;
+  }
+
+  if ((offset >= SHPR1) && (offset < SHPR1 + 12u))
+  {
+    for (unsigned i = 0u; i < 4u; ++i)
+    {
+      if ((mask >> (8u * i)) & 0xFFu)
+      {
+        m_cpu.setPriority(4u + (offset - SHPR1) + i, (uint8_t)(value >> (8u * i)));
+      }
+    }
+    return;
+  }
+
+  switch (offset)
+  {
+    case SYST_CSR:
+    {
+      uint32_t ulValue = systickValue(ullNow);
+      m_stCtrl = (m_stCtrl & ~mask) | (value & 7u);
+      systickRestart(ullNow, ulValue);
+      break;
+    }
+    case SYST_RVR:
+    {
+      uint32_t ulValue = systickValue(ullNow);
+      m_stLoad = (m_stLoad & ~mask) | (value & 0x00FFFFFFu);
+      systickRestart(ullNow, ulValue);
+      break;
+    }
+    case SYST_CVR:
+      // Any write clears the counter and COUNTFLAG
+      m_stCountFlag = false;
+      systickRestart(ullNow, 0u);
+      break;
+
+    case ICSR:
+      if (value & (1u << 31)) m_cpu.setPending(Cpu::EXC_NMI);
+      if (value & (1u << 28)) m_cpu.setPending(Cpu::EXC_PENDSV);
+      if (value & (1u << 27)) m_cpu.clearPending(Cpu::EXC_PENDSV);
+      if (value & (1u << 26)) m_cpu.setPending(Cpu::EXC_SYSTICK);
+      if (value & (1u << 25)) m_cpu.clearPending(Cpu::EXC_SYSTICK);
+      break;
+    case VTOR:
+      m_cpu.setVtor((m_cpu.vtor() & ~mask) | value);
+      break;
+    case AIRCR:
+      if ((value >> 16) == 0x05FAu)
+      {
+        m_cpu.setPriGroup((value >> 8) & 7u);
+        if (value & 4u) m_cpu.requestStop(StopReason::Halt, "system reset requested");
+      }
+      break;
+    case SCR: m_scr = (m_scr & ~mask) | (value & 0x16u); break;
+    case CCR: m_ccr = (m_ccr & ~mask) | (value & 0x31Bu); break;
+    case SHCSR:
+      if (mask & 0x00070000u)
+      {
+        m_cpu.setEnabled(Cpu::EXC_MEMMANAGE, value & (1u << 16));
+        m_cpu.setEnabled(Cpu::EXC_BUSFAULT, value & (1u << 17));
+        m_cpu.setEnabled(Cpu::EXC_USAGEFAULT, value & (1u << 18));
+      }
+      break;
+    case CFSR: m_cfsr &= ~value; break;
+    case HFSR: m_hfsr &= ~value; break;
+    case DEMCR:
+      m_demcr = (m_demcr & ~mask) | value;
+      m_dwt.setTraceEnabled(m_demcr & (1u << 24));
+      break;
+    case STIR:
+      if ((value & 0x1FFu) < NUM_IRQ) m_cpu.setPending(Cpu::EXC_IRQ0 + (value & 0x1FFu));
+      break;
+    default:
+      break;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Process SysTick wraps up to the given cycle count
+ *
+ * @param[in] now Current cycle count
+ * @date  17.10.2026
+ ******************************************************************************/
+void Scs::advance(uint64_t now)
+{
+  if (now < m_nextWrap) return;
+
+  m_stCountFlag = true;
+  if (m_stCtrl & 2u) m_cpu.setPending(Cpu::EXC_SYSTICK);
+
+  if (m_stLoad == 0u)
+  {
+    // Counter stops at zero when the reload value is zero
+    m_nextWrap = UINT64_MAX;
+    return;
+  }
+
+  // Skip intermediate wraps; the pending bit and COUNTFLAG do not count them
+  uint64_t ullPeriod = (uint64_t)(m_stLoad + 1u) * systickDivider();
+  m_nextWrap += ((now - m_nextWrap) / ullPeriod + 1u) * ullPeriod;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * SysTick current value
+ *
+ * The counter counts down from the value at the last restart, reloads from
+ * LOAD on the tick after reaching zero, and so on.
+ *
+ * @param[in] now Current cycle count
+ * @return  (uint32_t)  Counter value
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Scs::systickValue(uint64_t now) const
+{
+  if (!(m_stCtrl & 1u)) return m_stStartValue;
+
+  uint64_t ullTicks = (now - m_stStart) / systickDivider();
+  if (ullTicks <= m_stStartValue) return m_stStartValue - (uint32_t)ullTicks;
+  if (m_stLoad == 0u) return 0u;
+  return m_stLoad - (uint32_t)((ullTicks - m_stStartValue - 1u) % (m_stLoad + 1u));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Restart SysTick from a counter value after a configuration change
+ *
+ * @param[in] now   Current cycle count
+ * @param[in] value Counter value at restart
+ * @date  17.10.2026
+ ******************************************************************************/
+void Scs::systickRestart(uint64_t now, uint32_t value)
+{
+  m_stStart = now;
+  m_stStartValue = value;
+  if (!(m_stCtrl & 1u))
+  {
+    m_nextWrap = UINT64_MAX;
+  }
+  else if (value != 0u)
+  {
+    m_nextWrap = now + (uint64_t)value * systickDivider();
+  }
+  else if (m_stLoad != 0u)
+  {
+    m_nextWrap = now + (uint64_t)(m_stLoad + 1u) * systickDivider();
+  }
+  else
+  {
+    m_nextWrap = UINT64_MAX;
+  }
+  m_cpu.reschedule();
+}
+
+} // namespace armsim
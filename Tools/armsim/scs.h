@@ -0,0 +1,88 @@
+/*!****************************************************************************
+ * @file
+ * scs.h
+ *
+ * @brief
+ * Cortex-M3 system control space: NVIC, SCB, SysTick, DWT cycle counter
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef ARMSIM_SCS_H_
+#define ARMSIM_SCS_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include "bus.h"
+#include "cpu.h"
+
+
+namespace armsim {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// DWT unit; only the cycle counter is implemented
+class Dwt : public Device
+{
+public:
+  static constexpr uint32_t BASE = 0xE0001000u;
+
+  explicit Dwt(Cpu& cpu) : Device("DWT", BASE, 0x1000u), m_cpu(cpu) {}
+
+  uint32_t read(uint32_t offset) override;
+  void write(uint32_t offset, uint32_t value, uint32_t mask) override;
+
+  /// DEMCR.TRCENA gates the DWT
+  void setTraceEnabled(bool enable);
+
+private:
+  uint32_t cyccnt() const;
+  void rebase();
+
+  Cpu& m_cpu;
+  uint32_t m_ctrl = 0x40000000u;      ///< NUMCOMP = 4
+  bool m_trcena = false;
+  uint32_t m_cyccntBase = 0u;         ///< CYCCNT at m_cycleBase
+  uint64_t m_cycleBase = 0u;
+};
+
+/// System control space (0xE000E000..0xE000EFFF)
+class Scs : public Device, public Timed
+{
+public:
+  static constexpr uint32_t BASE = 0xE000E000u;
+
+  Scs(Cpu& cpu, Dwt& dwt) : Device("SCS", BASE, 0x1000u), m_cpu(cpu), m_dwt(dwt) {}
+
+  uint32_t read(uint32_t offset) override;
+  void write(uint32_t offset, uint32_t value, uint32_t mask) override;
+
+  void advance(uint64_t now) override;
+  uint64_t nextEvent() const override { return m_nextWrap; }
+
+private:
+  uint32_t systickValue(uint64_t now) const;
+  void systickRestart(uint64_t now, uint32_t value);
+  unsigned systickDivider() const { return (m_stCtrl & 4u) ? 1u : 8u; }
+
+  Cpu& m_cpu;
+  Dwt& m_dwt;
+
+  /*! @brief SysTick state; the counter value is computed on demand
+   *  @{                                                                      */
+  uint32_t m_stCtrl = 0u;
+  uint32_t m_stLoad = 0u;
+  uint32_t m_stStartValue = 0u;       ///< Counter value at m_stStart
+  uint64_t m_stStart = 0u;            ///< Cycle count of last restart
+  uint64_t m_nextWrap = UINT64_MAX;   ///< Cycle count of next 1 -> 0 transition
+  bool m_stCountFlag = false;
+  /*! @}                                                                      */
+
+  uint32_t m_scr = 0u;
+  uint32_t m_ccr = 0x00000200u;       ///< STKALIGN
+  uint32_t m_cfsr = 0u;
+  uint32_t m_hfsr = 0u;
+  uint32_t m_demcr = 0u;
+};
+
+} // namespace armsim
+
+#endif // ARMSIM_SCS_H_
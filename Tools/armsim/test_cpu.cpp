@@ -0,0 +1,167 @@
+/*!****************************************************************************
+ * @file
+ * test_cpu.cpp
+ *
+ * @brief
+ * Unit tests of the core: instruction sequences run from flash
+ *
+ * Each case loads a vector table and a short Thumb program into flash, runs
+ * it from reset until the final "b ." and checks the registers. Prints the
+ * failed checks; the exit status is 1 if a check failed.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdio>
+#include <vector>
+#include "bus.h"
+#include "cpu.h"
+
+using namespace armsim;
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Memory sizes of the test bus
+static constexpr uint32_t FLASH_SIZE = 0x1000u;
+static constexpr uint32_t SRAM_SIZE = 0x1000u;
+
+/// Program start (after the initial SP and reset vector)
+static constexpr uint32_t PROGRAM = Bus::FLASH_BASE + 8u;
+
+/// Cycle limit per case
+static constexpr uint64_t MAX_CYCLES = 1000u;
+
+/// Record a failed check with its source line
+#define CHECK(cond)                                                           \
+  do                                                                          \
+  {                                                                           \
+    if (!(cond)) vFail(__FILE__, __LINE__, #cond);                            \
+  } while (0)
+
+
+/*- Global data --------------------------------------------------------------*/
+static unsigned s_uFailures = 0u;     ///< Failed checks
+static const char* s_pszCase = "";    ///< Current test case
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Report a failed check
+ ******************************************************************************/
+static void vFail(const char* pszFile, int iLine, const char* pszCond)
+{
+  std::printf("%s:%d: %s: check failed: %s\n", pszFile, iLine, s_pszCase, pszCond);
+  ++s_uFailures;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run a program from reset until it halts
+ *
+ * @param[in] bus       Bus of the core
+ * @param[in] cpu       Core
+ * @param[in] program   Halfwords at PROGRAM (instructions and inline data)
+ * @return  (StopReason)  Reason the run ended
+ * @date  17.10.2026
+ ******************************************************************************/
+static StopReason eRun(Bus& bus, Cpu& cpu, const std::vector<uint16_t>& program)
+{
+  std::vector<uint8_t> image = {
+    0x00u, 0x10u, 0x00u, 0x20u,       // initial SP: end of SRAM
+    (uint8_t)(PROGRAM | 1u), (uint8_t)(PROGRAM >> 8), (uint8_t)(PROGRAM >> 16), (uint8_t)(PROGRAM >> 24)
+  };
+  for (uint16_t usHalf : program)
+  {
+    image.push_back((uint8_t)usHalf);
+    image.push_back((uint8_t)(usHalf >> 8));
+  }
+  bus.load(Bus::FLASH_BASE, image.data(), (uint32_t)image.size());
+  cpu.setHaltOnLoop(true);
+  cpu.reset();
+  return cpu.run(MAX_CYCLES);
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * TBB with the PC as base at an address = 2 (mod 4): the table starts at the
+ * unaligned PC + 4
+ ******************************************************************************/
+static void vTestTbbUnaligned()
+{
+  Bus bus(FLASH_SIZE, SRAM_SIZE);
+  Cpu cpu(bus);
+  StopReason eStop = eRun(bus, cpu, {
+    0x2001u,                          // 0x08: movs r0, #1
+    0xE8DFu, 0xF000u,                 // 0x0A: tbb [pc, r0]
+    0x0301u,                          // 0x0E: table: 0x10, 0x14
+    0x210Au, 0xE7FEu,                 // 0x10: movs r1, #10; b .
+    0x210Bu, 0xE7FEu,                 // 0x14: movs r1, #11; b .
+  });
+  CHECK(eStop == StopReason::Halt);
+  CHECK(cpu.reg(1) == 11u);
+  CHECK(cpu.pc() == PROGRAM + 0x0Eu);
+}
+
+/*!****************************************************************************
+ * @brief
+ * TBH with the PC as base at an address = 2 (mod 4)
+ ******************************************************************************/
+static void vTestTbhUnaligned()
+{
+  Bus bus(FLASH_SIZE, SRAM_SIZE);
+  Cpu cpu(bus);
+  StopReason eStop = eRun(bus, cpu, {
+    0x2001u,                          // 0x08: movs r0, #1
+    0xE8DFu, 0xF010u,                 // 0x0A: tbh [pc, r0, lsl #1]
+    0x0002u, 0x0004u,                 // 0x0E: table: 0x12, 0x16
+    0x2114u, 0xE7FEu,                 // 0x12: movs r1, #20; b .
+    0x2115u, 0xE7FEu,                 // 0x16: movs r1, #21; b .
+  });
+  CHECK(eStop == StopReason::Halt);
+  CHECK(cpu.reg(1) == 21u);
+  CHECK(cpu.pc() == PROGRAM + 0x10u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * LDRD (literal) uses the word-aligned PC as base
+ ******************************************************************************/
+static void vTestLdrdLiteral()
+{
+  Bus bus(FLASH_SIZE, SRAM_SIZE);
+  Cpu cpu(bus);
+  StopReason eStop = eRun(bus, cpu, {
+    0xBF00u,                          // 0x08: nop
+    0xE9DFu, 0x0102u,                 // 0x0A: ldrd r0, r1, [pc, #8]
+    0xE7FEu,                          // 0x0E: b .
+    0xFFFFu, 0xFFFFu,                 // 0x10: (skipped by the aligned base)
+    0x5678u, 0x1234u,                 // 0x14: r0
+    0xDEF0u, 0x9ABCu,                 // 0x18: r1
+  });
+  CHECK(eStop == StopReason::Halt);
+  CHECK(cpu.reg(0) == 0x12345678u);
+  CHECK(cpu.reg(1) == 0x9ABCDEF0u);
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+int main()
+{
+  const struct { const char* pszName; void (*pfnTest)(); } cases[] = {
+    { "tbb_unaligned", vTestTbbUnaligned },
+    { "tbh_unaligned", vTestTbhUnaligned },
+    { "ldrd_literal", vTestLdrdLiteral },
+  };
+  for (const auto& entry : cases)
+  {
+    s_pszCase = entry.pszName;
+    entry.pfnTest();
+  }
+
+  std::printf("%u failed checks\n", s_uFailures);
+  return (s_uFailures != 0u) ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Convert thread/handler coverage banks ("coverage_banks.bin") into gcov files
+
+Each bank holds one bit per call site of the "__sanitizer_cov_trace_pc" hook,
+indexed by the return address. Call sites are located in the disassembly of
+the .elf file. Every instruction of a function is attributed to the closest
+preceding call site (the entry block's call site for the prologue), i.e. to
+the basic block it belongs to. A source line is executed in a bank if one of
+its instructions belongs to a block whose call site bit is set.
+
+One directory of .gcov files is written per bank ("thread", "handler"), with
+an execution count of 1 for executed lines. With --html, an overlay report is
+written that marks each line as executed in thread mode, handler mode, both or
+neither.
+
+Usage: banks2gcov.py <elf> <coverage_banks.bin> [-o <output dir>] [-r <source root>] [--html <file>]
+"""
+
+import argparse
+import bisect
+import html
+import os
+import struct
+import sys
+from collections import defaultdict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import elfinfo
+import gcovfile
+
+BANKS_MAGIC = b"CBNK"
+BANKS_VERSION = 1
+BANK_NAMES = ("thread", "handler")
+HOOK = "__sanitizer_cov_trace_pc"
+
+
+def load(path):
+  """Read bank file: text base, granule, list of bank bitmaps (bytes)"""
+  with open(path, "rb") as f:
+    data = f.read()
+  if data[:4] != BANKS_MAGIC:
+    raise ValueError("%s: not a coverage bank file" % path)
+  version, base, granule, sites, n_banks = struct.unpack_from("<5I", data, 4)
+  if version != BANKS_VERSION:
+    raise ValueError("%s: unsupported format version %u" % (path, version))
+  size, pos, banks = sites // 8, 24, []
+  for _ in range(n_banks):
+    if pos + size > len(data):
+      raise ValueError("%s: truncated" % path)
+    banks.append(data[pos:pos + size])
+    pos += size
+  return base, granule, banks
+
+
+def is_set(bank, index):
+  return 0 <= index < len(bank) * 8 and (bank[index >> 3] >> (index & 7)) & 1
+
+
+def convert(elf, base, granule, banks, root):
+  """Map bank bits to source lines. Returns dict path -> dict line -> list of
+  0/1 per bank."""
+  hook = [s.addr for s in elfinfo.symbols(elf) if s.name == HOOK]
+  if not hook:
+    raise ValueError("%s: no %s, not built with COVERAGE_BANKS" % (elf, HOOK))
+  insns = elfinfo.instructions(elf)
+  addrs = [i.addr for i in insns]
+  sites = [i for i in insns if i.mnemonic.startswith("bl") and elfinfo.branch_target(i) == hook[0]]
+  site_addrs = [s.addr for s in sites]
+
+  # Instructions of the functions containing call sites, with their block
+  block_of = {}
+  for func in elfinfo.functions(elf):
+    first = bisect.bisect_left(site_addrs, func.addr)
+    last = bisect.bisect_left(site_addrs, func.addr + func.size)
+    if first == last:
+      continue
+    start, end = bisect.bisect_left(addrs, func.addr), bisect.bisect_left(addrs, func.addr + func.size)
+    for insn in insns[start:end]:
+      index = max(first, bisect.bisect_right(site_addrs, insn.addr, first, last) - 1)
+      block_of[insn.addr] = sites[index]
+
+  locs = elfinfo.line_info(elf, block_of)
+  lines = defaultdict(dict)
+  for addr, site in block_of.items():
+    loc = locs.get(addr)
+    if loc is None or (root and not loc[0].startswith(root + os.sep)):
+      continue
+    index = (site.addr + site.size - base) // granule
+    hits = lines[loc[0]].setdefault(loc[1], [0] * len(banks))
+    for b, bank in enumerate(banks):
+      hits[b] |= is_set(bank, index)
+  return lines
+
+
+def write_overlay(path, lines, names):
+  """Write an HTML report with the bank(s) executing each line"""
+  styles = {0: "none", 1: "thread", 2: "handler", 3: "both"}
+  with open(path, "w") as f:
+    f.write("<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Coverage banks</title><style>\n"
+            "body{font-family:sans-serif} pre{margin:0} td{padding:0 6px;vertical-align:top}\n"
+            ".none{background:#fdd} .thread{background:#dfd} .handler{background:#ddf} .both{background:#ffd}\n"
+            "</style></head><body>\n<h1>Coverage banks</h1>\n"
+            "<p><span class=\"thread\">%s</span> <span class=\"handler\">%s</span> "
+            "<span class=\"both\">both</span> <span class=\"none\">not executed</span></p>\n" % tuple(names[:2]))
+    f.write("<table><tr><th>File</th><th>Lines</th>%s</tr>\n" % "".join("<th>%s</th>" % n for n in names))
+    for source in sorted(lines):
+      total = len(lines[source])
+      counts = ["%d" % sum(h[b] for h in lines[source].values()) for b in range(len(names))]
+      f.write("<tr><td><a href=\"#%s\">%s</a></td><td>%d</td>%s</tr>\n" % (
+        html.escape(gcovfile.gcov_name(source)), html.escape(source), total,
+        "".join("<td>%s</td>" % c for c in counts)))
+    f.write("</table>\n")
+    for source in sorted(lines):
+      try:
+        with open(source, errors="replace") as src:
+          text = src.read().splitlines()
+      except OSError:
+        continue
+      f.write("<h2 id=\"%s\">%s</h2>\n<table>\n" % (html.escape(gcovfile.gcov_name(source)), html.escape(source)))
+      for lineno, content in enumerate(text, start=1):
+        hits = lines[source].get(lineno)
+        mark, cls = "", ""
+        if hits is not None:
+          key = (1 if hits[0] else 0) | (2 if len(hits) > 1 and hits[1] else 0)
+          cls = " class=\"%s\"" % styles[key]
+          mark = {0: "#####", 1: "T", 2: "H", 3: "T+H"}[key]
+        f.write("<tr%s><td>%d</td><td>%s</td><td><pre>%s</pre></td></tr>\n" % (
+          cls, lineno, mark, html.escape(content)))
+      f.write("</table>\n")
+    f.write("</body></html>\n")
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("elf", help="firmware image built with COVERAGE_BANKS")
+  parser.add_argument("banks", help="coverage bank file")
+  parser.add_argument("-o", "--output", default="banks", help="output directory for .gcov files")
+  parser.add_argument("-r", "--root", default=None, help="only report sources below this directory")
+  parser.add_argument("--html", help="write overlay HTML report")
+  args = parser.parse_args()
+
+  base, granule, banks = load(args.banks)
+  root = os.path.normpath(os.path.abspath(args.root)) if args.root else None
+  lines = convert(args.elf, base, granule, banks, root)
+  names = [BANK_NAMES[b] if b < len(BANK_NAMES) else "bank%d" % b for b in range(len(banks))]
+
+  for b, name in enumerate(names):
+    out_dir = os.path.join(args.output, name)
+    os.makedirs(out_dir, exist_ok=True)
+    for source in sorted(lines):
+      gcovfile.write(out_dir, source, {n: h[b] for n, h in lines[source].items()})
+    print("%s: %d lines executed" % (name, sum(h[b] for f in lines.values() for h in f.values())))
+  if args.html:
+    write_overlay(args.html, lines, names)
+
+
+if __name__ == "__main__":
+  main()
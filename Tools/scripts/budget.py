@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""
+Track the performance budget of the coverage infrastructure
+
+"record" runs the benchmark kernels ("Benchmark/benchmark_kernels.c") on the
+release and the coverage image of a build folder in QEMU (or armsim), and
+appends the metrics to a JSON history in the build folder (default), tagged
+with the current commit:
+
+  dump_cycles        cycles per coverage dump ("bench_dump")
+  dump_bytes         bytes per coverage dump
+  dump_semihost_ops  Semihosting operations per coverage dump
+  counter_ram        RAM of the arc and condition counters
+  instr_flash        FLASH cost of the instrumentation including the gcov
+                     runtime ("coverage_cost.json", see "covcost.py")
+  instr_ram          RAM cost of the instrumentation including the runtime
+  cycles.<kernel>    cycles per iteration of a kernel in the coverage image
+  ratio.<kernel>     cycles per iteration, coverage image / release image
+  irq_lat.<source>   median interrupt latency in the coverage image
+                     ("bench_irq_<source>", thread mode)
+  irq_dur.<source>   median handler duration in the coverage image
+  host_seconds       host processing time of one dump: "gcov-tool
+                     merge-stream" and gcov of all instrumented units (the
+                     coverage data files of the build folder are replaced)
+
+Only the kernels of KERNELS are run; the STM32F1 specific kernels (idle,
+microsecond delays, clock boost) depend on peripherals that QEMU doesn't
+model. The interrupt latency kernels replace the TIM2 and EXTI triggers by the
+NVIC there. Cycles are counted by the SysTick time base of the image. In QEMU,
+the emulated clock advances per instruction ("-icount"), so cycle values are only
+comparable between entries of the same runner.
+
+"compare" checks the latest entry against the previous one (or --base, a
+commit prefix or history index) with the thresholds of the budget file:
+
+  { "<metric pattern>": { "max_increase": <relative>, "max": <absolute> } }
+
+Patterns may contain wildcards (e.g. "ratio.*"). The exit status is 1 if a
+threshold is exceeded.
+
+Usage: budget.py record <build dir> [--history <file>] [--qemu <path> | --armsim <path>] [--iterations <n>]
+       budget.py compare [<build dir>] [--history <file>] [--budget <file>] [--base <commit|index>]
+"""
+
+import argparse
+import datetime
+import fnmatch
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import split_tests
+
+IMAGE = "gcov-demo-stm32f103"
+RELEASE_IMAGE = IMAGE + "-release"
+CROSS_COMPILE = os.environ.get("CROSS_COMPILE", "arm-none-eabi-")
+
+# QEMU machine: Cortex-M with flash at 0x08000000 and at least 20 KiB RAM at
+# 0x20000000 (the STM32F1 peripherals aren't modelled, register accesses of
+# the kernels have no effect)
+QEMU_MACHINE = "netduinoplus2"
+TIMEOUT = 600
+
+# Kernels recorded ("tests=" filter): valid without the STM32F1 peripherals
+KERNELS = "bench_gpio_*,bench_fast_*,bench_get_tick,bench_dump,bench_irq_*"
+
+# History file in the build folder
+HISTORY = "budget_history.json"
+
+
+def run(args, build, image, params, out):
+  """Run an image with semihosting parameters in QEMU or armsim: test cases of the output file"""
+  elf = os.path.abspath(os.path.join(build, image + ".elf"))
+  params = [os.path.splitext(os.path.basename(sys.argv[0]))[0]] + params + ["out=" + out, "exit=1"]
+  if args.armsim:
+    cmd = [args.armsim, "--root", build, "--cmdline", " ".join(params), elf]
+  else:
+    cmd = [args.qemu, "-M", args.machine, "-nographic", "-monitor", "none", "-serial", "null",
+           "-icount", "shift=0", "-kernel", elf,
+           "-semihosting-config", "enable=on,target=native," + ",".join("arg=" + p for p in params)]
+  path = os.path.join(build, out)
+  if os.path.exists(path):
+    os.remove(path)
+  result = subprocess.run(cmd, cwd=build, capture_output=True, text=True, timeout=TIMEOUT)
+  if not os.path.exists(path):
+    sys.exit("error: %s: no results\n%s" % (image, result.stdout + result.stderr))
+  _, cases, summary = split_tests.load(path)
+  failed = [c[0] for c in cases if c[1] != split_tests.STATUS_PASS]
+  if summary is None or failed:
+    sys.exit("error: %s: incomplete run or failed kernels %s" % (image, " ".join(failed)))
+  return cases
+
+
+def run_kernels(args, build, image):
+  """Metrics per kernel of an image: dict kernel -> metrics"""
+  params = ["tests=" + KERNELS, "iterations=%u" % args.iterations, "dump=budget_dump.bin"]
+  cases = run(args, build, image, params, "budget_%s.bin" % image)
+  return {name[len("bench_"):]: metrics for name, _, _, _, _, metrics, _ in cases}
+
+
+def cost(build):
+  """Instrumentation cost from "coverage_cost.json", or {}"""
+  path = os.path.join(build, "coverage_cost.json")
+  if not os.path.exists(path):
+    return {}
+  with open(path) as f:
+    data = json.load(f)
+  runtime = data.get("runtime") or {"flash": 0, "ram": 0}
+  return {
+    "counter_ram": sum(u["counters"] + u["conds"] for u in data["units"]),
+    "instr_flash": sum(u["flash"] for u in data["units"]) + runtime["flash"],
+    "instr_ram": sum(u["ram"] for u in data["units"]) + runtime["ram"],
+  }
+
+
+def host_processing(build):
+  """Seconds to process the dump of "bench_dump", or None"""
+  dump = os.path.join(build, "budget_dump.bin")
+  notes = os.path.join(build, "coverage_notes.txt")
+  if not os.path.exists(dump) or not os.path.exists(notes):
+    return None
+  with open(notes) as f:
+    objects = f.read().split()
+  # As in "Coverage/process_coverage.sh"; the gcov output is discarded
+  steps = [[CROSS_COMPILE + "gcov-tool", "merge-stream", "budget_dump.bin"]]
+  steps += [[CROSS_COMPILE + "gcov", "--stdout", obj] for obj in objects]
+  start = time.perf_counter()
+  for step in steps:
+    if subprocess.run(step, cwd=build, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL).returncode != 0:
+      return None
+  return round(time.perf_counter() - start, 3)
+
+
+def git(*args):
+  result = subprocess.run(["git"] + list(args), capture_output=True, text=True)
+  return result.stdout.strip() if result.returncode == 0 else None
+
+
+def record(args):
+  release, coverage = run_kernels(args, args.build, RELEASE_IMAGE), run_kernels(args, args.build, IMAGE)
+  metrics = {}
+  dump = coverage.get("dump", {})
+  for key in ("cycles", "bytes", "semihost_ops"):
+    if key in dump:
+      metrics["dump_" + key] = dump[key]
+  metrics.update(cost(args.build))
+  for kernel in sorted(coverage):
+    if kernel.startswith("irq_"):
+      for interval in ("lat", "dur"):
+        if interval + "_p50" in coverage[kernel]:
+          metrics["irq_%s.%s" % (interval, kernel[len("irq_"):])] = coverage[kernel][interval + "_p50"]
+    if kernel == "dump" or "cycles" not in coverage[kernel]:
+      continue
+    metrics["cycles." + kernel] = coverage[kernel]["cycles"]
+    plain = release.get(kernel, {}).get("cycles")
+    if plain:
+      metrics["ratio." + kernel] = round(coverage[kernel]["cycles"] / plain, 3)
+  seconds = host_processing(args.build)
+  if seconds is not None:
+    metrics["host_seconds"] = seconds
+
+  entry = {
+    "commit": git("rev-parse", "HEAD"),
+    "dirty": bool(git("status", "--porcelain", "--untracked-files=no")),
+    "date": datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds"),
+    "runner": "armsim" if args.armsim else "qemu-" + args.machine,
+    "iterations": args.iterations,
+    "metrics": metrics,
+  }
+  history = load_history(args.history)
+  history.append(entry)
+  with open(args.history, "w") as f:
+    json.dump(history, f, indent=2)
+  for key, value in metrics.items():
+    print("%-24s %12s" % (key, value))
+  print("recorded %s%s as entry %u of %s" % ((entry["commit"] or "?")[:10], " (dirty)" if entry["dirty"] else "",
+                                           len(history) - 1, args.history))
+
+
+def load_history(path):
+  if not os.path.exists(path):
+    return []
+  with open(path) as f:
+    return json.load(f)
+
+
+def find_base(history, base):
+  """Index of the base entry: history index, or last entry of a commit"""
+  if base is None:
+    return len(history) - 2
+  if re.fullmatch(r"-?\d{1,6}", base):
+    return int(base) % len(history)
+  matches = [i for i, e in enumerate(history[:-1]) if (e["commit"] or "").startswith(base)]
+  if not matches:
+    sys.exit("error: no entry for %s" % base)
+  return matches[-1]
+
+
+def limits(budget, metric):
+  """Thresholds of the first matching pattern"""
+  for pattern, limit in budget.items():
+    if fnmatch.fnmatchcase(metric, pattern):
+      return limit
+  return None
+
+
+def compare(args):
+  history = load_history(args.history)
+  if len(history) < 2:
+    print("no base entry in %s, nothing to compare" % args.history)
+    return
+  with open(args.budget) as f:
+    budget = json.load(f)
+  base, latest = history[find_base(history, args.base)], history[-1]
+  if base.get("runner") != latest.get("runner"):
+    print("warning: runners differ (%s, %s)" % (base.get("runner"), latest.get("runner")))
+
+  print("%s -> %s" % ((base["commit"] or "?")[:10], (latest["commit"] or "?")[:10]))
+  violations = 0
+  for metric in sorted(set(base["metrics"]) | set(latest["metrics"])):
+    old, new = base["metrics"].get(metric), latest["metrics"].get(metric)
+    limit = limits(budget, metric) or {}
+    status = ""
+    if new is not None and "max" in limit and new > limit["max"]:
+      status = "over budget (max %s)" % limit["max"]
+    elif old is not None and new is not None and "max_increase" in limit:
+      if new > old * (1.0 + limit["max_increase"]):
+        status = "regression (max +%g%%)" % (100.0 * limit["max_increase"])
+    change = "%+.1f%%" % (100.0 * (new - old) / old) if old and new is not None else ""
+    print("%-24s %12s %12s %8s  %s" % (metric, "-" if old is None else old, "-" if new is None else new,
+                                       change, status))
+    violations += 1 if status else 0
+  if violations:
+    print("%u metric(s) exceed the budget" % violations)
+    sys.exit(1)
+  print("within budget")
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  commands = parser.add_subparsers(dest="command", required=True)
+  rec = commands.add_parser("record", help="run the benchmarks and append the metrics to the history")
+  rec.add_argument("build", help="build folder with both images")
+  rec.add_argument("--history", help="JSON history file (default: %s in the build folder)" % HISTORY)
+  rec.add_argument("--qemu", default="qemu-system-arm", help="QEMU executable")
+  rec.add_argument("--machine", default=QEMU_MACHINE, help="QEMU machine")
+  rec.add_argument("--armsim", help="run in armsim instead of QEMU")
+  rec.add_argument("--iterations", type=int, default=1000, help="kernel iterations")
+  comp = commands.add_parser("compare", help="check the latest entry against the budget")
+  comp.add_argument("build", nargs="?", default="build", help="build folder (default: build)")
+  comp.add_argument("--history", help="JSON history file (default: %s in the build folder)" % HISTORY)
+  comp.add_argument("--budget", default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                                     "..", "..", "Benchmark", "budget.json"), help="thresholds")
+  comp.add_argument("--base", help="base entry: commit (prefix) or history index (default: previous entry)")
+  args = parser.parse_args()
+  if args.history is None:
+    args.history = os.path.join(args.build, HISTORY)
+
+  if args.command == "record":
+    record(args)
+  else:
+    compare(args)
+
+
+if __name__ == "__main__":
+  main()
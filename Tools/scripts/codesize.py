@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""
+Attribute code size to source lines and functions, next to coverage counts
+
+The bytes of each address range of the DWARF line table (one "readelf" pass,
+no disassembly) are attributed to its source line and to the function
+containing it. The line execution counts of a gcovr JSON report (e.g.
+"coverage.json" of "process_coverage.sh") are merged, and per file and
+function the bytes of lines never executed are summed:
+
+  bytes       code bytes of the file (including inlined code of the file in
+              other functions) or function
+  unexecuted  bytes of lines with an execution count of 0
+  unknown     bytes of lines without coverage data (e.g. files that are not
+              instrumented)
+
+The release image gives the sizes of the shipped code; the counts of the
+coverage report apply to it line by line. Prints the files sorted by bytes
+never executed; --json writes the gcovr report with the sizes added ("bytes"
+per line, function and file, "unexecuted_bytes" per file and function), and
+--html a report with sortable file and function tables and per-line sizes.
+
+Usage: codesize.py <elf> <coverage.json> [-r <source root>] [--json <file>] [--html <file>] [--top <n>]
+"""
+
+import argparse
+import bisect
+import html
+import json
+import os
+import sys
+from collections import defaultdict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import elfinfo
+
+
+def attribute(elf):
+  """Code bytes: dict path -> dict line -> bytes, dict function -> dict (path, line) -> bytes"""
+  funcs = elfinfo.functions(elf)
+  starts = [f.addr for f in funcs]
+  lines = defaultdict(lambda: defaultdict(int))
+  by_func = defaultdict(lambda: defaultdict(int))
+  for start, end, path, lineno in elfinfo.line_table(elf):
+    lines[path][lineno] += end - start
+    i = bisect.bisect_right(starts, start) - 1
+    if i >= 0 and start < funcs[i].addr + funcs[i].size:
+      by_func[funcs[i].name][(path, lineno)] += end - start
+  return lines, by_func
+
+
+def load_report(path, root):
+  """gcovr JSON report and the line counts: dict path -> dict line -> count"""
+  with open(path) as f:
+    report = json.load(f)
+  counts = {}
+  for entry in report.get("files", []):
+    lines = counts.setdefault(os.path.normpath(os.path.join(root, entry["file"])), {})
+    for line in entry.get("lines", []):
+      lines[line["line_number"]] = lines.get(line["line_number"], 0) + line.get("count", 0)
+  return report, counts
+
+
+def summarise(sizes, counts):
+  """Bytes, bytes never executed and bytes without coverage data of (path, line) -> bytes"""
+  total = unexecuted = unknown = 0
+  for (path, lineno), size in sizes.items():
+    total += size
+    count = counts.get(path, {}).get(lineno)
+    if count is None:
+      unknown += size
+    elif count == 0:
+      unexecuted += size
+  return {"bytes": total, "unexecuted_bytes": unexecuted, "unknown_bytes": unknown}
+
+
+def analyse(elf, counts, root):
+  """Per-file and per-function results, sorted by bytes never executed"""
+  lines, by_func = attribute(elf)
+  files = []
+  for path, sizes in lines.items():
+    entry = summarise({(path, n): b for n, b in sizes.items()}, counts)
+    entry.update(file=os.path.relpath(path, root), path=path, lines=dict(sizes))
+    files.append(entry)
+  functions = []
+  for name, sizes in by_func.items():
+    entry = summarise(sizes, counts)
+    # Source file: the one with most bytes of the function
+    path = max(sizes, key=sizes.get)[0]
+    entry.update(name=name, file=os.path.relpath(path, root))
+    functions.append(entry)
+  key = lambda e: (-e["unexecuted_bytes"], -e["bytes"])
+  return sorted(files, key=key), sorted(functions, key=key)
+
+
+def merge(report, files, functions, root):
+  """Add the sizes to the gcovr report (in place)"""
+  by_path = {f["path"]: f for f in files}
+  by_name = {f["name"]: f for f in functions}
+  for entry in report.get("files", []):
+    result = by_path.get(os.path.normpath(os.path.join(root, entry["file"])))
+    sizes = result["lines"] if result else {}
+    for line in entry.get("lines", []):
+      line["bytes"] = sizes.get(line["line_number"], 0)
+    entry["bytes"] = result["bytes"] if result else 0
+    entry["unexecuted_bytes"] = result["unexecuted_bytes"] if result else 0
+    for func in entry.get("functions", []):
+      size = by_name.get(func.get("name")) or by_name.get(func.get("demangled_name"))
+      func["bytes"] = size["bytes"] if size else 0
+      func["unexecuted_bytes"] = size["unexecuted_bytes"] if size else 0
+
+
+# Click on a column header sorts the table by the column (numbers descending)
+_SORT_SCRIPT = """
+document.querySelectorAll("table.sort th").forEach(function(th) {
+  th.onclick = function() {
+    var col = th.cellIndex, body = th.closest("table").tBodies[0], rows = Array.from(body.rows);
+    if (!rows.length) return;
+    var num = !isNaN(parseFloat(rows[0].cells[col].textContent));
+    var dir = th.dataset.dir = (th.dataset.dir === "1") ? "-1" : "1";
+    rows.sort(function(a, b) {
+      var x = a.cells[col].textContent, y = b.cells[col].textContent;
+      return (num ? parseFloat(y) - parseFloat(x) : x.localeCompare(y)) * dir;
+    });
+    rows.forEach(function(r) { body.appendChild(r); });
+  };
+});
+"""
+
+
+def write_html(path, files, functions, counts):
+  """Write an HTML report: sortable file and function tables, line sizes and counts"""
+  def row(cells):
+    return "<tr>%s</tr>\n" % "".join("<td>%s</td>" % c for c in cells)
+
+  def sizes(e):
+    pct = 100.0 * e["unexecuted_bytes"] / e["bytes"] if e["bytes"] else 0.0
+    return [e["bytes"], e["unexecuted_bytes"], "%.1f" % pct, e["unknown_bytes"]]
+
+  head = "<th>bytes</th><th>never executed</th><th>%</th><th>no data</th>"
+  with open(path, "w") as f:
+    f.write("<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Code size</title><style>\n"
+            "body{font-family:sans-serif} pre{margin:0} td{padding:0 6px;vertical-align:top}\n"
+            "th{cursor:pointer;text-align:left} .none{background:#fdd} .hit{background:#dfd}\n"
+            "</style></head><body>\n<h1>Code size</h1>\n")
+    f.write("<h2>Files</h2>\n<table class=\"sort\"><thead><tr><th>file</th>%s</tr></thead><tbody>\n" % head)
+    for e in files:
+      f.write(row(["<a href=\"#%s\">%s</a>" % (html.escape(e["file"]), html.escape(e["file"]))] + sizes(e)))
+    f.write("</tbody></table>\n")
+    f.write("<h2>Functions</h2>\n<table class=\"sort\"><thead><tr><th>function</th><th>file</th>%s</tr></thead>"
+            "<tbody>\n" % head)
+    for e in functions:
+      f.write(row([html.escape(e["name"]), html.escape(e["file"])] + sizes(e)))
+    f.write("</tbody></table>\n")
+    for e in files:
+      try:
+        with open(e["path"], errors="replace") as src:
+          text = src.read().splitlines()
+      except OSError:
+        continue
+      lines = counts.get(e["path"], {})
+      f.write("<h2 id=\"%s\">%s</h2>\n<table>\n<tr><th>line</th><th>count</th><th>bytes</th><th></th></tr>\n" % (
+        html.escape(e["file"]), html.escape(e["file"])))
+      for lineno, content in enumerate(text, start=1):
+        count, size = lines.get(lineno), e["lines"].get(lineno)
+        cls = "" if count is None else " class=\"%s\"" % ("hit" if count else "none")
+        f.write("<tr%s><td>%d</td><td>%s</td><td>%s</td><td><pre>%s</pre></td></tr>\n" % (
+          cls, lineno, "" if count is None else count, size or "", html.escape(content)))
+      f.write("</table>\n")
+    f.write("<script>%s</script>\n</body></html>\n" % _SORT_SCRIPT)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("elf", help="firmware image (e.g. the release image)")
+  parser.add_argument("report", help="gcovr JSON report")
+  parser.add_argument("-r", "--root", default=".", help="source root of the gcovr report")
+  parser.add_argument("--json", help="write the gcovr report with code sizes")
+  parser.add_argument("--html", help="write an HTML report")
+  parser.add_argument("--top", type=int, default=20, help="files and functions printed")
+  args = parser.parse_args()
+
+  root = os.path.normpath(os.path.abspath(args.root))
+  report, counts = load_report(args.report, root)
+  files, functions = analyse(args.elf, counts, root)
+
+  for title, entries, name in (("file", files, "file"), ("function", functions, "name")):
+    print("%-48s %8s %8s %8s" % (title, "bytes", "never", "no data"))
+    for e in entries[:args.top]:
+      print("%-48s %8d %8d %8d" % (e[name], e["bytes"], e["unexecuted_bytes"], e["unknown_bytes"]))
+    print()
+  total = summarise({(f["path"], n): b for f in files for n, b in f["lines"].items()}, counts)
+  print("total: %d bytes, %d never executed, %d without coverage data" % (
+    total["bytes"], total["unexecuted_bytes"], total["unknown_bytes"]))
+
+  if args.json:
+    merge(report, files, functions, root)
+    with open(args.json, "w") as f:
+      json.dump(report, f, indent=1)
+  if args.html:
+    write_html(args.html, files, functions, counts)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Summarise condition coverage from .gcov text files
+
+Reads the condition lines written by "gcov --conditions" (GCC 14 or later,
+sources compiled with -fcondition-coverage):
+
+  condition outcomes covered 1/4
+  condition  0 not covered (true false)
+
+and prints the covered condition outcomes per source file, followed by the
+outcomes not covered. Files without condition data are skipped.
+
+Usage: conditions.py [<.gcov files or directories>...] [-r <source root>] [--json <file>]
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+_LINE = re.compile(r"^\s*(\S+):\s*(\d+):")
+_SOURCE = re.compile(r"^\s*-:\s*0:Source:(.*)$")
+_COVERED = re.compile(r"^condition outcomes covered (\d+)/(\d+)$")
+_NOT_COVERED = re.compile(r"^condition\s+(\d+) not covered \((.*)\)$")
+
+
+def gcov_files(paths):
+  for path in paths:
+    if os.path.isdir(path):
+      for base, _, names in os.walk(path):
+        yield from (os.path.join(base, n) for n in sorted(names) if n.endswith(".gcov"))
+    else:
+      yield path
+
+
+def parse(path):
+  """Source path and list of (line, covered, total, list of (condition, missing outcomes))"""
+  source, decisions, lineno = None, [], 0
+  with open(path, errors="replace") as f:
+    for line in f:
+      line = line.rstrip("\n")
+      m = _SOURCE.match(line)
+      if m:
+        source = m.group(1)
+        continue
+      m = _COVERED.match(line)
+      if m:
+        decisions.append((lineno, int(m.group(1)), int(m.group(2)), []))
+        continue
+      m = _NOT_COVERED.match(line)
+      if m and decisions:
+        decisions[-1][3].append((int(m.group(1)), m.group(2).split()))
+        continue
+      m = _LINE.match(line)
+      if m:
+        lineno = int(m.group(2))
+  return source, decisions
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("paths", nargs="*", default=["."], help=".gcov files or directories (default: .)")
+  parser.add_argument("-r", "--root", default=None, help="only report sources below this directory")
+  parser.add_argument("--json", help="write the summary as JSON")
+  args = parser.parse_args()
+  root = os.path.normpath(os.path.abspath(args.root)) if args.root else None
+
+  files = {}
+  for path in gcov_files(args.paths):
+    source, decisions = parse(path)
+    if not source or not decisions:
+      continue
+    source = os.path.normpath(os.path.abspath(source))
+    if root and not source.startswith(root + os.sep):
+      continue
+    files.setdefault(source, {})
+    for decision in decisions:
+      files[source][decision[0]] = decision
+
+  report, all_covered, all_total = [], 0, 0
+  for source in sorted(files):
+    decisions = [files[source][n] for n in sorted(files[source])]
+    covered, total = sum(d[1] for d in decisions), sum(d[2] for d in decisions)
+    all_covered, all_total = all_covered + covered, all_total + total
+    print("%s: %u/%u condition outcomes (%.1f%%)" % (os.path.relpath(source), covered, total, 100.0 * covered / total))
+    report.append({"file": source, "covered": covered, "total": total, "decisions": [
+      {"line": n, "covered": c, "total": t, "not_covered": [{"condition": i, "outcomes": o} for i, o in missing]}
+      for n, c, t, missing in decisions]})
+
+  for entry in report:
+    for decision in entry["decisions"]:
+      for missing in decision["not_covered"]:
+        print("%s:%u: condition %u not covered (%s)" % (os.path.relpath(entry["file"]), decision["line"],
+                                                         missing["condition"], " ".join(missing["outcomes"])))
+  if all_total:
+    print("total: %u/%u condition outcomes (%.1f%%)" % (all_covered, all_total, 100.0 * all_covered / all_total))
+
+  if args.json:
+    with open(args.json, "w") as f:
+      json.dump(report, f, indent=2)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,321 @@
+#!/usr/bin/env python3
+"""
+Report the memory cost of coverage instrumentation per unit
+
+Attributes the FLASH and RAM used by coverage instrumentation to the instru-
+mented units, using the ELF symbols and contents (independent of LTO, which
+merges the object files):
+
+  code      code growth of the unit's functions, compared to --baseline (an
+            image built with -DCOVERAGE_INSTRUMENT=OFF); clones of a function
+            (".constprop.N", ".isra.N", ".part.N", ".lto_priv.N") are counted
+            as the function
+  counters  arc counter arrays "__gcov0.<function>" (RAM, .bss)
+  conds     condition counter arrays "__gcov8.<function>" (RAM, .bss), in
+            builds with COVERAGE_CONDITIONS
+  fn_info   function info "__gcov_.<function>" (FLASH; RAM as well if placed
+            in .data)
+  unit      gcov_info structure of the unit with its function list, data file
+            name and entry in the ".gcov_info" section (FLASH; RAM as well if
+            placed in .data)
+
+The units and their functions are taken from "coverage_functions.txt" (see
+"Coverage/coverage_filter.cmake"); a gcov_info structure belongs to the unit
+of its data file name. The gcov runtime (libgcov archive members in the
+linker map file) and the memory usage are reported from the map files next
+to the images ("<name>.map").
+
+Usage: covcost.py <elf> <coverage_functions.txt> [--baseline <elf>] [--json <file>]
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+from collections import defaultdict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import elfinfo
+
+COUNTER_PREFIX = "__gcov0."
+CONDITION_PREFIX = "__gcov8."
+FN_INFO_PREFIX = "__gcov_."
+
+# Section with a pointer to the gcov_info structure of each unit
+GCOV_INFO_SECTION = ".gcov_info"
+
+# Sections holding gcov_info structures, function lists and file names
+GCOV_DATA_SECTIONS = (GCOV_INFO_SECTION, ".rodata", ".data")
+
+# Number of merge functions in gcov_info (GCOV_COUNTERS) tried, by GCC version
+GCOV_COUNTERS = (8, 9, 10, 11)
+
+# Suffixes of function clones created by IPA and LTO
+_CLONE_SUFFIX = re.compile(r"(\.(constprop|isra|part|lto_priv)\.\d+)+$")
+
+# Input section line of the map file: " .section 0xaddr 0xsize object", the
+# section name may be on a line of its own
+_MAP_SECTION = re.compile(r"^ (\.\S+|COMMON)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*))?$")
+_MAP_CONTINUED = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+_MAP_REGION = re.compile(r"^(\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)")
+
+# Sections not loaded to the target
+_NOT_LOADED = (".comment", ".debug", ".ARM.attributes", ".note", ".stab")
+
+
+def load_functions(path):
+  """Read filter function list: dict unit -> list of function names"""
+  units = defaultdict(list)
+  with open(path) as f:
+    for line in f:
+      parts = line.rstrip("\n").split("\t")
+      if len(parts) == 3:
+        units[parts[0]].append(parts[1])
+  return units
+
+
+def load_map(path):
+  """Read memory regions and input sections of a map file: dict region ->
+  (origin, length), list of (section, address, size, object)"""
+  regions, sections = {}, []
+  with open(path) as f:
+    lines = f.read().splitlines()
+  state, pending = None, None
+  for line in lines:
+    if line.startswith("Memory Configuration"):
+      state = "memory"
+      continue
+    if line.startswith("Linker script and memory map"):
+      state = "sections"
+      continue
+    if state == "memory":
+      m = _MAP_REGION.match(line)
+      if m and m.group(1) != "Name" and m.group(1) != "*default*":
+        regions[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+    elif state == "sections":
+      if pending:
+        m = _MAP_CONTINUED.match(line)
+        if m and not pending.startswith(_NOT_LOADED):
+          sections.append((pending, int(m.group(1), 16), int(m.group(2), 16), m.group(3).strip()))
+        pending = None
+        continue
+      m = _MAP_SECTION.match(line)
+      if m and m.group(2) is None:
+        pending = m.group(1)
+      elif m and not m.group(1).startswith(_NOT_LOADED):
+        sections.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16), m.group(4).strip()))
+  return regions, sections
+
+
+def section_kind(name):
+  """Cost category of an input section: text, rodata, data, bss"""
+  if name.startswith((".bss", "COMMON")):
+    return "bss"
+  if name.startswith(".data"):
+    return "data"
+  if name.startswith((".rodata", ".gcov_info")):
+    return "rodata"
+  return "text"
+
+
+def runtime_sizes(sections):
+  """Section sizes of the libgcov archive members by category"""
+  sizes = defaultdict(int)
+  for name, addr, size, obj in sections:
+    if addr != 0 and "libgcov.a(" in obj:
+      sizes[section_kind(name)] += size
+  return sizes
+
+
+def symbol_sizes(elf):
+  """dict name -> (address, size) of all sized symbols; compiler suffixes such
+  as ".lto_priv.0" of gcov symbols and clone suffixes are removed, the sizes of
+  the symbols of one name are summed"""
+  result = {}
+  for s in elfinfo.symbols(elf):
+    name = _CLONE_SUFFIX.sub("", s.name)
+    for prefix in (COUNTER_PREFIX, CONDITION_PREFIX, FN_INFO_PREFIX):
+      if name.startswith(prefix):
+        name = prefix + name[len(prefix):].split(".")[0]
+    if s.size:
+      addr, size = result.get(name, (s.addr, 0))
+      result[name] = (addr, size + s.size)
+  return result
+
+
+class Memory:
+  """Contents of the loaded sections holding gcov data"""
+
+  def __init__(self, elf):
+    self.sections = [elfinfo.section_data(elf, name) for name in GCOV_DATA_SECTIONS]
+
+  def read(self, addr, size):
+    for start, data in self.sections:
+      if start <= addr and addr + size <= start + len(data):
+        return data[addr - start:addr - start + size]
+    return None
+
+  def word(self, addr):
+    data = self.read(addr, 4)
+    return int.from_bytes(data, "little") if data is not None else None
+
+  def string(self, addr):
+    for start, data in self.sections:
+      if start <= addr < start + len(data):
+        end = data.find(b"\0", addr - start)
+        return data[addr - start:end if end >= 0 else len(data)].decode(errors="replace")
+    return None
+
+
+def unit_infos(elf, syms):
+  """gcov_info structures of the units: list of (data file name, names of the
+  functions, [(address, size)] of the structure, function list and file name)
+
+  struct gcov_info: version, next, stamp, checksum, filename,
+  merge[GCOV_COUNTERS], n_functions, functions. GCOV_COUNTERS depends on the
+  GCC version; it is the count for which the function lists point to the
+  "__gcov_." symbols."""
+  memory = Memory(elf)
+  start, data = elfinfo.section_data(elf, GCOV_INFO_SECTION)
+  infos = [int.from_bytes(data[i:i + 4], "little") for i in range(0, len(data) - 3, 4)]
+  fn_infos = {addr: name[len(FN_INFO_PREFIX):] for name, (addr, _) in syms.items() if name.startswith(FN_INFO_PREFIX)}
+
+  def functions(info, counters):
+    count, array = memory.word(info + 4 * (5 + counters)), memory.word(info + 4 * (6 + counters))
+    if count is None or array is None or count > len(fn_infos):
+      return None
+    names = [fn_infos.get(memory.word(array + 4 * i)) for i in range(count)]
+    return (array, names) if names and None not in names else None
+
+  counters = None
+  for n in GCOV_COUNTERS:
+    if any(functions(info, n) for info in infos if info):
+      counters = n
+      break
+  if counters is None:
+    return []
+  result = []
+  for i, info in enumerate(infos):
+    found = functions(info, counters) if info else None
+    if found is None:
+      continue
+    array, names = found
+    filename = memory.string(memory.word(info + 16) or 0) or ""
+    parts = [(start + 4 * i, 4), (info, 4 * (7 + counters)), (array, 4 * len(names)),
+             (memory.word(info + 16) or 0, len(filename.encode()) + 1)]
+    result.append((filename, names, parts))
+  return result
+
+
+def unit_of(filename, names, units):
+  """Unit of a gcov_info structure: by data file name, else by its functions"""
+  for unit in units:
+    if filename == unit + ".gcda" or filename.endswith("/" + unit + ".gcda"):
+      return unit
+  for unit, functions in units.items():
+    if names and set(names) <= set(functions):
+      return unit
+  return None
+
+
+def in_region(addr, regions, name):
+  origin, length = regions.get(name, (None, 0))
+  return origin is not None and origin <= addr < origin + length
+
+
+def map_path(elf):
+  """Map file next to an image (<name>.map), or None"""
+  path = os.path.splitext(elf)[0] + ".map"
+  return path if os.path.exists(path) else None
+
+
+def memory_usage(regions, sections):
+  """dict region -> {used, size} of FLASH and RAM (initial values of .data are
+  stored in FLASH as well)"""
+  usage = {}
+  for region in ("FLASH", "RAM"):
+    if region in regions:
+      used = sum(size for _, addr, size, _ in sections if in_region(addr, regions, region))
+      if region == "FLASH":
+        used += sum(size for name, addr, size, _ in sections
+                    if section_kind(name) == "data" and in_region(addr, regions, "RAM"))
+      usage[region] = {"used": used, "size": regions[region][1]}
+  return usage
+
+
+def analyse(elf, functions, baseline=None):
+  """Cost per unit, libgcov runtime cost and memory usage"""
+  units = load_functions(functions)
+  syms = symbol_sizes(elf)
+  regions, sections = load_map(map_path(elf)) if map_path(elf) else ({}, [])
+  base_syms = symbol_sizes(baseline) if baseline else None
+  ram = lambda addr: in_region(addr, regions, "RAM") if regions else addr >= 0x20000000
+  infos = defaultdict(list)
+  for filename, names, parts in unit_infos(elf, syms):
+    infos[unit_of(filename, names, units)] += parts
+
+  result = []
+  for unit, names in units.items():
+    cost = {"unit": unit, "code": None, "counters": 0, "conds": 0, "fn_info": 0, "unit_info": None, "flash": 0, "ram": 0}
+    fn_info_ram = 0
+    for name in names:
+      if COUNTER_PREFIX + name in syms:
+        cost["counters"] += syms[COUNTER_PREFIX + name][1]
+      if CONDITION_PREFIX + name in syms:
+        cost["conds"] += syms[CONDITION_PREFIX + name][1]
+      if FN_INFO_PREFIX + name in syms:
+        addr, size = syms[FN_INFO_PREFIX + name]
+        cost["fn_info"] += size
+        fn_info_ram += size if ram(addr) else 0
+    cost["flash"] = cost["fn_info"]
+    cost["ram"] = cost["counters"] + cost["conds"] + fn_info_ram
+
+    if base_syms is not None:
+      cost["code"] = sum(syms.get(n, (0, 0))[1] - base_syms.get(n, (0, 0))[1] for n in names)
+      cost["flash"] += cost["code"]
+
+    if unit in infos:
+      cost["unit_info"] = sum(size for _, size in infos[unit])
+      cost["flash"] += cost["unit_info"]
+      cost["ram"] += sum(size for addr, size in infos[unit] if ram(addr))
+    result.append(cost)
+  result.sort(key=lambda c: (c["flash"] + c["ram"], c["unit"]), reverse=True)
+
+  runtime = None
+  if sections:
+    sizes = runtime_sizes(sections)
+    runtime = {"flash": sizes["text"] + sizes["rodata"] + sizes["data"], "ram": sizes["data"] + sizes["bss"]}
+
+  return result, runtime, memory_usage(regions, sections)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("elf", help="instrumented firmware image")
+  parser.add_argument("functions", help="function list of the coverage filter")
+  parser.add_argument("--baseline", help="uninstrumented firmware image")
+  parser.add_argument("--json", help="write the report as JSON")
+  args = parser.parse_args()
+
+  result, runtime, usage = analyse(args.elf, args.functions, args.baseline)
+
+  fmt = lambda v: "-" if v is None else str(v)
+  print("%-56s %7s %8s %6s %7s %7s %7s %7s" % ("unit", "code", "counters", "conds", "fn_info", "unit", "FLASH", "RAM"))
+  for c in result:
+    print("%-56s %7s %8u %6u %7u %7s %7u %7u" % (c["unit"], fmt(c["code"]), c["counters"], c["conds"],
+                                                 c["fn_info"], fmt(c["unit_info"]), c["flash"], c["ram"]))
+  total = "%-56s %38s %7u %7u"
+  print(total % ("total", "", sum(c["flash"] for c in result), sum(c["ram"] for c in result)))
+  if runtime:
+    print(total % ("gcov runtime (libgcov)", "", runtime["flash"], runtime["ram"]))
+  for region, value in usage.items():
+    print("%s: %u of %u bytes used, %u free" % (region, value["used"], value["size"], value["size"] - value["used"]))
+
+  if args.json:
+    with open(args.json, "w") as f:
+      json.dump({"units": result, "runtime": runtime, "usage": usage}, f, indent=2)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,165 @@
+"""
+ELF, disassembly and DWARF line information
+
+Thin wrappers around the GNU binutils of the cross toolchain. The tool prefix
+defaults to "arm-none-eabi-" and can be changed using the CROSS_COMPILE envi-
+ronment variable.
+"""
+
+import os
+import re
+import subprocess
+from collections import namedtuple
+
+CROSS_COMPILE = os.environ.get("CROSS_COMPILE", "arm-none-eabi-")
+
+Symbol = namedtuple("Symbol", "addr size type name")
+Insn = namedtuple("Insn", "addr size mnemonic operands")
+
+# Thumb conditional branches (b<cond>, cbz, cbnz), with optional width suffix
+_COND_BRANCH = re.compile(r"^(b(eq|ne|cs|hs|cc|lo|mi|pl|vs|vc|hi|ls|ge|lt|gt|le)|cbn?z)(\.[nw])?$")
+
+# Instructions ending a basic block unconditionally
+_UNCOND_BRANCH = re.compile(r"^(b|bx|tbb|tbh)(\.[nw])?$")
+
+# Calls and exception-generating instructions
+_CALL = re.compile(r"^(blx?|bkpt|svc|udf)(\.[nw])?$")
+
+# Disassembly line: "address: raw-halfwords mnemonic operands"
+_INSN_LINE = re.compile(r"^\s*([0-9a-f]+):\s+((?:[0-9a-f]{2,8} )+)\s*(\S+)\s*(.*)$")
+
+# Decoded line table row ("readelf --debug-dump=decodedline"): "file line
+# address [view] [stmt]", line "-" at the end of a sequence
+_LINE_ROW = re.compile(r"^\S+\s+(\d+|-)\s+(0x[0-9a-f]+)(?:\s+\d+)?(?:\s+x)?\s*$")
+
+# Section dump line ("objdump -s"): "address data-words  ASCII"
+_DUMP_LINE = re.compile(r"^ ([0-9a-f]+)((?: [0-9a-f]{2,8}){1,4})  ")
+
+
+def tool(name):
+  """Full command name of a binutils program"""
+  return CROSS_COMPILE + name
+
+
+def run(name, *args, stdin=None):
+  """Run a binutils program and return its output"""
+  return subprocess.run([tool(name), *args], input=stdin, check=True,
+                        capture_output=True, text=True).stdout
+
+
+def symbols(elf):
+  """All defined symbols, sorted by address. Thumb bit is cleared for code."""
+  result = []
+  for line in run("nm", "-S", "-n", "--defined-only", elf).splitlines():
+    parts = line.split()
+    if len(parts) == 4:
+      addr, size, typ, name = int(parts[0], 16), int(parts[1], 16), parts[2], parts[3]
+    elif len(parts) == 3:
+      addr, size, typ, name = int(parts[0], 16), 0, parts[1], parts[2]
+    else:
+      continue
+    if typ in "tTwW":
+      addr &= ~1
+    result.append(Symbol(addr, size, typ, name))
+  return result
+
+
+def functions(elf):
+  """Function symbols with non-zero size, sorted by address"""
+  return [s for s in symbols(elf) if s.type in "tTwW" and s.size > 0]
+
+
+def instructions(elf):
+  """All instructions in executable sections, sorted by address. Literal pool
+  entries (.word etc.) are excluded."""
+  result = []
+  for line in run("objdump", "-d", elf).splitlines():
+    m = _INSN_LINE.match(line)
+    if not m:
+      continue
+    mnemonic = m.group(3)
+    if mnemonic.startswith("."):
+      continue
+    operands = re.split(r"\s[@;]", m.group(4))[0].strip()
+    size = len(m.group(2).replace(" ", "")) // 2
+    result.append(Insn(int(m.group(1), 16), size, mnemonic, operands))
+  return result
+
+
+def is_cond_branch(insn):
+  """Instruction is a conditional branch"""
+  return _COND_BRANCH.match(insn.mnemonic) is not None
+
+
+def ends_block(insn):
+  """Instruction ends a basic block (branch, call, return or other PC write)"""
+  if is_cond_branch(insn) or _UNCOND_BRANCH.match(insn.mnemonic) or _CALL.match(insn.mnemonic):
+    return True
+  if insn.mnemonic.startswith(("pop", "ldm")):
+    return re.search(r"\bpc\b", insn.operands) is not None
+  return insn.operands.split(",")[0].strip() == "pc"
+
+
+def branch_target(insn):
+  """Direct branch target address, or None for indirect branches"""
+  m = re.search(r"(?:^|,\s*)([0-9a-f]+)\s+<", insn.operands)
+  return int(m.group(1), 16) if m else None
+
+
+def line_info(elf, addrs):
+  """Map addresses to (source path, line number) using the DWARF line table.
+  Addresses without line information are omitted from the result."""
+  addrs = list(addrs)
+  output = run("addr2line", "-e", elf, "-a", stdin="".join("%x\n" % a for a in addrs))
+  result = {}
+  lines = output.splitlines()
+  for i in range(0, len(lines) - 1, 2):
+    addr = int(lines[i], 16)
+    loc = lines[i + 1].split(" (discriminator")[0]
+    path, _, lineno = loc.rpartition(":")
+    if path.startswith("??") or not lineno.isdigit() or int(lineno) == 0:
+      continue
+    result[addr] = (os.path.normpath(os.path.abspath(path)), int(lineno))
+  return result
+
+
+def section_data(elf, name):
+  """Address and contents of a section, or (0, b"") if missing"""
+  try:
+    output = run("objdump", "-s", "-j", name, elf)
+  except subprocess.CalledProcessError:
+    return 0, bytes()
+  addr, data = None, bytearray()
+  for line in output.splitlines():
+    m = _DUMP_LINE.match(line)
+    if m:
+      if addr is None:
+        addr = int(m.group(1), 16)
+      data += bytes.fromhex(m.group(2).replace(" ", ""))
+  return addr or 0, bytes(data)
+
+
+def section_words(elf, name):
+  """Contents of a section as 32-bit little-endian words, or [] if missing"""
+  data = section_data(elf, name)[1]
+  return [int.from_bytes(data[i:i + 4], "little") for i in range(0, len(data) - 3, 4)]
+
+
+def line_table(elf):
+  """Address ranges of the DWARF line table: list of (start, end, source path,
+  line number), sorted by address. Relative paths are resolved against the
+  folder of the image (the compilation folder of a reproducible build)."""
+  base = os.path.dirname(os.path.abspath(elf))
+  ranges, path, prev = [], None, None
+  for line in run("readelf", "--wide", "--debug-dump=decodedline", elf).splitlines():
+    m = _LINE_ROW.match(line)
+    if m:
+      addr = int(m.group(2), 16)
+      if prev is not None and addr > prev[0]:
+        ranges.append((prev[0], addr, prev[1], prev[2]))
+      prev = None if m.group(1) == "-" else (addr, path, int(m.group(1)))
+    elif line.startswith("CU: ") or (line.endswith(":") and " " not in line.strip()):
+      name = line[4:] if line.startswith("CU: ") else line
+      path = os.path.normpath(os.path.join(base, name.rstrip(":")))
+  ranges.sort()
+  return ranges
@@ -0,0 +1,49 @@
+"""
+gcov text file output
+
+Writes intermediate ".gcov" text files in the format produced by "gcov -b -c".
+These are picked up by "gcovr -g" (--use-gcov-files), so coverage data from
+sources other than the gcov runtime can be fed into the existing report flow.
+"""
+
+import os
+
+
+def _count(value):
+  """Format an execution count column"""
+  if value is None:
+    return "-"
+  return str(value) if value > 0 else "#####"
+
+
+def gcov_name(source):
+  """Output file name for a source file, with mangled path (cf. "gcov -p")"""
+  return source.replace(os.sep, "#") + ".gcov"
+
+
+def write(out_dir, source, lines, branches=None, runs=1):
+  """Write a .gcov file for one source file.
+
+  lines     dict: line number -> execution count (lines with code only)
+  branches  dict: line number -> list of (count or None, is fallthrough); a
+            count of None marks a branch that has never been executed
+  """
+  branches = branches or {}
+  try:
+    with open(source, errors="replace") as f:
+      text = f.read().splitlines()
+  except OSError:
+    return None
+
+  path = os.path.join(out_dir, gcov_name(source))
+  with open(path, "w") as f:
+    f.write("%9s:%5u:Source:%s\n" % ("-", 0, source))
+    f.write("%9s:%5u:Runs:%u\n" % ("-", 0, runs))
+    for lineno, content in enumerate(text, start=1):
+      f.write("%9s:%5u:%s\n" % (_count(lines.get(lineno)), lineno, content))
+      for index, (count, fallthrough) in enumerate(branches.get(lineno, [])):
+        if count is None:
+          f.write("branch %2u never executed\n" % index)
+        else:
+          f.write("branch %2u taken %u%s\n" % (index, count, " (fallthrough)" if fallthrough else ""))
+  return path
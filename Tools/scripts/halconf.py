@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Generate a minimal HAL configuration header
+
+Determines the HAL modules referenced by the application and writes a copy of
+the full "stm32f1xx_hal_conf.h" with all other modules disabled:
+
+  1. The identifiers declared by each module header ("stm32f1xx_hal_<module>.h"
+     and "..._ex.h": macros, types, enumerators, function prototypes) are
+     collected from the HAL include folder.
+  2. A module is enabled if the application sources use one of its
+     identifiers, or if an enabled module (header or driver source) does.
+  3. Modules disabled in the full configuration stay disabled.
+
+The enabled modules are written to --modules, one per line (lower case, e.g.
+"gpio"), for the build to skip the driver sources of all other modules.
+
+Usage: halconf.py <full conf> <HAL folder> <application sources>... -o <conf> [--modules <file>]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+_MODULE = re.compile(r"^(\s*/\*\s*)?#define\s+HAL_(\w+)_MODULE_ENABLED\b.*$")
+_IDENT = re.compile(r"\b[A-Za-z_]\w*\b")
+_COMMENT = re.compile(r"/\*.*?\*/|//[^\n]*", re.S)
+_DEFINE = re.compile(r"^\s*#\s*define\s+(\w+)", re.M)
+_DIRECTIVE = re.compile(r"^\s*#.*?(?<!\\)$", re.M | re.S)
+_TYPEDEF_NAME = re.compile(r"\}\s*(\w+)\s*;")
+_TYPEDEF_ALIAS = re.compile(r"\btypedef\s+[^;{}]*?\b(\w+)\s*;")
+_ENUM = re.compile(r"\benum\s*\w*\s*\{(.*?)\}", re.S)
+_PROTOTYPE = re.compile(r"\b(\w+)\s*\((?:[^;{}()]|\([^()]*\))*\)\s*;")
+_BODY = re.compile(r"\)\s*\{")
+_KEYWORDS = {"if", "while", "for", "switch", "return", "sizeof", "void"}
+
+
+def read(path):
+  with open(path, errors="replace") as f:
+    return _COMMENT.sub(" ", f.read())
+
+
+def strip_bodies(code):
+  """Remove the bodies of inline functions"""
+  out, pos = [], 0
+  for m in _BODY.finditer(code):
+    if m.start() < pos:
+      continue
+    depth, end = 0, m.end() - 1
+    while end < len(code):
+      depth += {"{": 1, "}": -1}.get(code[end], 0)
+      end += 1
+      if depth == 0:
+        break
+    out.append(code[pos:m.start() + 1] + ";")
+    pos = end
+  return "".join(out) + code[pos:]
+
+
+def declared(text):
+  """Identifiers declared by a header"""
+  names = set(_DEFINE.findall(text))
+  code = strip_bodies(_DIRECTIVE.sub(" ", text))
+  names.update(_TYPEDEF_NAME.findall(code))
+  names.update(_TYPEDEF_ALIAS.findall(code))
+  for body in _ENUM.findall(code):
+    names.update(m.group(0) for m in (_IDENT.match(item.strip()) for item in body.split(",")) if m)
+  names.update(_PROTOTYPE.findall(code))
+  return names - _KEYWORDS
+
+
+def module_files(hal_dir, module):
+  """Existing (headers, sources) of a module"""
+  name = "stm32f1xx_hal_" + module.lower()
+  headers = [os.path.join(hal_dir, "inc", name + suffix + ".h") for suffix in ("", "_ex")]
+  sources = [os.path.join(hal_dir, "src", name + suffix + ".c") for suffix in ("", "_ex")]
+  return [p for p in headers if os.path.exists(p)], [p for p in sources if os.path.exists(p)]
+
+
+def load_conf(path):
+  """Lines of the configuration and the modules enabled in it"""
+  with open(path) as f:
+    lines = f.read().splitlines(keepends=True)
+  modules = [m.group(2) for m in map(_MODULE.match, lines) if m and not m.group(1)]
+  return lines, modules
+
+
+def analyse(modules, hal_dir, sources):
+  """Enabled modules: used by the sources, or by another enabled module"""
+  owners, files, fixed = {}, {}, set()
+  for module in modules:
+    headers, driver = module_files(hal_dir, module)
+    files[module] = headers + driver
+    if not headers:
+      fixed.add(module) # not analysable (e.g. legacy drivers), keep as configured
+    for header in headers:
+      for name in declared(read(header)):
+        owners.setdefault(name, set()).add(module)
+
+  def used_by(paths):
+    result = set()
+    for path in paths:
+      for name in set(_IDENT.findall(read(path))):
+        result |= owners.get(name, set())
+    return result
+
+  enabled = used_by(sources) | fixed
+  pending = list(enabled)
+  while pending:
+    for module in used_by(files[pending.pop()]) - enabled:
+      enabled.add(module)
+      pending.append(module)
+  return enabled
+
+
+def write(path, text):
+  """Write a file if its content changed, so dependent objects aren't rebuilt"""
+  if os.path.exists(path):
+    with open(path) as f:
+      if f.read() == text:
+        return
+  os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+  with open(path, "w") as f:
+    f.write(text)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("conf", help="full HAL configuration header")
+  parser.add_argument("hal", help="HAL driver folder (with inc/ and src/)")
+  parser.add_argument("sources", nargs="+", help="application sources and headers")
+  parser.add_argument("-o", "--output", required=True, help="minimal configuration header")
+  parser.add_argument("--modules", help="write the enabled modules")
+  args = parser.parse_args()
+
+  lines, modules = load_conf(args.conf)
+  if not modules or not os.path.isdir(os.path.join(args.hal, "inc")):
+    sys.exit("error: no HAL modules found")
+  enabled = analyse(modules, args.hal, args.sources)
+
+  # Disable the unused modules in a copy of the full configuration
+  out = ["/* Generated by halconf.py from %s, do not edit */\n" % os.path.basename(args.conf)]
+  for line in lines:
+    m = _MODULE.match(line)
+    if m and not m.group(1) and m.group(2) in modules and m.group(2) not in enabled:
+      line = "/* %s */\n" % line.rstrip("\n")
+    out.append(line)
+  write(args.output, "".join(out))
+  if args.modules:
+    write(args.modules, "".join(m.lower() + "\n" for m in sorted(enabled)))
+  print("HAL modules: %u of %u enabled (%s)" % (len(enabled), len(modules), ", ".join(sorted(enabled))))
+
+
+if __name__ == "__main__":
+  main()
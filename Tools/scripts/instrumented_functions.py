@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+Report the functions instrumented for coverage
+
+Compares the function list written by "Coverage/coverage_filter.cmake"
+("coverage_functions.txt": unit, function, instrument/exclude) with the gcov
+counter arrays ("__gcov0.<function>") present in the linked image. A summary
+per unit is printed; the full list is written with -o and --json.
+
+Status of each function:
+  instrumented    counters present
+  excluded        excluded by the filter, no counters
+  removed         to be instrumented, but not in the image (unused/inlined)
+  not excluded    excluded by the filter, but counters present (error)
+  unlisted        counters present, definition not found by the filter
+
+The exit status is 1 if an excluded function has counters.
+
+Usage: instrumented_functions.py <elf> <coverage_functions.txt> [-o <file>] [--json <file>]
+"""
+
+import argparse
+import json
+import os
+import sys
+from collections import defaultdict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import elfinfo
+
+COUNTER_PREFIX = "__gcov0."
+
+
+def load(path):
+  """Read function list: list of (unit, function, instrument)"""
+  result = []
+  with open(path) as f:
+    for line in f:
+      parts = line.rstrip("\n").split("\t")
+      if len(parts) == 3:
+        result.append((parts[0], parts[1], parts[2] == "instrument"))
+  return result
+
+
+def counters(elf):
+  """Names of functions with counter arrays (compiler suffixes removed)"""
+  return {s.name[len(COUNTER_PREFIX):].split(".")[0]
+          for s in elfinfo.symbols(elf) if s.name.startswith(COUNTER_PREFIX)}
+
+
+def classify(functions, present):
+  """List of (unit, function, status)"""
+  result, listed = [], set()
+  for unit, name, instrument in functions:
+    listed.add(name)
+    if instrument:
+      status = "instrumented" if name in present else "removed"
+    else:
+      status = "not excluded" if name in present else "excluded"
+    result.append((unit, name, status))
+  result.extend(("?", name, "unlisted") for name in sorted(present - listed))
+  return result
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("elf", help="instrumented firmware image")
+  parser.add_argument("functions", help="function list of the coverage filter")
+  parser.add_argument("-o", "--output", help="write the full list as text")
+  parser.add_argument("--json", help="write the full list as JSON")
+  args = parser.parse_args()
+
+  result = classify(load(args.functions), counters(args.elf))
+
+  summary = defaultdict(lambda: defaultdict(int))
+  for unit, _, status in result:
+    summary[unit][status] += 1
+  for unit in sorted(summary):
+    print("%s: %s" % (unit, ", ".join("%d %s" % (n, s) for s, n in sorted(summary[unit].items()))))
+  for unit, name, status in result:
+    if status == "not excluded":
+      print("error: %s: %s excluded from instrumentation, but has counters" % (unit, name))
+
+  if args.output:
+    with open(args.output, "w") as f:
+      for unit, name, status in result:
+        f.write("%-60s %-40s %s\n" % (unit, name, status))
+  if args.json:
+    with open(args.json, "w") as f:
+      json.dump([{"unit": u, "function": n, "status": s} for u, n, s in result], f, indent=2)
+
+  sys.exit(1 if any(s == "not excluded" for _, _, s in result) else 0)
+
+
+if __name__ == "__main__":
+  main()
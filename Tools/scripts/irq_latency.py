@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+Report the interrupt latency and handler duration distributions
+
+Runs the "bench_irq_*" kernels ("Benchmark/irq_latency.c": SysTick, TIM2,
+EXTI line 0) on the release and the coverage image of a build folder, in each
+NVIC priority configuration:
+
+  thread   triggered in thread mode
+  preempt  triggered in a low-priority handler, preempted
+  tail     triggered in a high-priority handler, tail-chained
+
+and prints one table with the minimum, median, 90th percentile and maximum
+cycles of both images. Runs in QEMU (default, SysTick timestamps: relative
+comparisons only) or armsim (DWT cycle counter).
+
+Usage: irq_latency.py <build dir> [--qemu <path> | --armsim <path>] [--samples <n>] [--json <file>]
+"""
+
+import argparse
+import json
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import budget
+
+CONFIGS = ("thread", "preempt", "tail")
+IMAGES = (("release", budget.RELEASE_IMAGE), ("coverage", budget.IMAGE))
+STATS = ("min", "p50", "p90", "max")
+
+
+def measure(args):
+  """Metrics: dict (image, config, source) -> metrics"""
+  results = {}
+  for label, image in IMAGES:
+    for config in CONFIGS:
+      params = ["tests=bench_irq_*", "config=" + config, "samples=%u" % args.samples]
+      cases = budget.run(args, args.build, image, params, "irq_%s_%s.bin" % (label, config))
+      for name, _, _, _, _, metrics, _ in cases:
+        results[(label, config, name[len("bench_irq_"):])] = metrics
+  return results
+
+
+def table(results):
+  """Text table: one row per interrupt source, configuration and interval"""
+  sources = sorted({source for _, _, source in results})
+  header = "%-8s %-8s %-4s" % ("source", "config", "") + "".join(
+    " %8s" % ("%s %s" % (label[:3], stat)) for label, _ in IMAGES for stat in STATS)
+  lines = [header, "-" * len(header)]
+  for source in sources:
+    for config in CONFIGS:
+      for interval in ("lat", "dur"):
+        row = "%-8s %-8s %-4s" % (source, config, interval)
+        for label, _ in IMAGES:
+          metrics = results.get((label, config, source), {})
+          for stat in STATS:
+            value = metrics.get("%s_%s" % (interval, stat))
+            row += " %8s" % ("-" if value is None else value)
+        nvic = any(results.get((label, config, source), {}).get("nvic") for label, _ in IMAGES)
+        lines.append(row + ("  (NVIC trigger)" if nvic and interval == "lat" else ""))
+  return "\n".join(lines)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("build", help="build folder with both images")
+  parser.add_argument("--qemu", default="qemu-system-arm", help="QEMU executable")
+  parser.add_argument("--machine", default=budget.QEMU_MACHINE, help="QEMU machine")
+  parser.add_argument("--armsim", help="run in armsim instead of QEMU")
+  parser.add_argument("--samples", type=int, default=100, help="samples per kernel")
+  parser.add_argument("--json", help="write the metrics to a JSON file")
+  args = parser.parse_args()
+
+  results = measure(args)
+  print(table(results))
+  if args.json:
+    data = [{"image": label, "config": config, "source": source, "metrics": metrics}
+            for (label, config, source), metrics in sorted(results.items())]
+    with open(args.json, "w") as f:
+      json.dump(data, f, indent=2)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+"""
+Breakpoint-harvesting line coverage via the GDB remote serial protocol (RSP)
+
+Connects to a GDB server (QEMU gdbstub, OpenOCD, J-Link GDB server, ...) and
+places a breakpoint on every basic block entry of the image. Each breakpoint is
+removed on its first hit, so every block costs at most one debug halt. The
+result is "hit-only" line coverage of an unmodified image, written as gcov
+text files for the existing gcovr report flow.
+
+Hardware breakpoint units are small (the Cortex-M3 FPB has 6 instruction com-
+parators), so with "--hw N" only N breakpoints are armed at a time. The armed
+set is refilled on every hit and rotated after each time slice without hits.
+Blocks that only execute while not armed are not observed in this mode.
+
+Usage: rspcov.py <elf> [--target host:port] [--hw N] [--slice s] [--idle n] [--time s]
+"""
+
+import argparse
+import json
+import os
+import socket
+import sys
+import time
+from collections import deque
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import elfinfo
+import gcovfile
+
+# ARM register number of the program counter in the GDB target description
+REG_PC = 15
+
+# Stop signal reported for breakpoint hits
+SIGTRAP = 5
+
+# Breakpoint kind of the Z/z packets per instruction size (ARM target
+# description: 2 for 16-bit Thumb, 3 for 32-bit Thumb-2)
+BP_KIND = {2: 2, 4: 3}
+
+
+class RspError(Exception):
+  pass
+
+
+class Rsp:
+  """Minimal GDB remote serial protocol client"""
+
+  def __init__(self, target, timeout=5.0):
+    host, _, port = target.rpartition(":")
+    self.sock = socket.create_connection((host or "localhost", int(port)), timeout)
+    self.buf = b""
+    self.ack = True
+    self.ops = 0
+    if self.request("QStartNoAckMode") == "OK":
+      self.ack = False
+
+  def _recv(self, timeout):
+    self.sock.settimeout(timeout)
+    data = self.sock.recv(4096)
+    if not data:
+      raise RspError("connection closed by GDB server")
+    self.buf += data
+
+  def send(self, payload):
+    """Send a packet, without waiting for the reply"""
+    packet = b"$%s#%02x" % (payload.encode(), sum(payload.encode()) & 0xFF)
+    self.sock.sendall(packet)
+    self.ops += 1
+    while self.ack:
+      if not self.buf:
+        self._recv(5.0)
+      char, self.buf = self.buf[:1], self.buf[1:]
+      if char == b"+":
+        break
+      if char == b"-":
+        self.sock.sendall(packet)
+
+  def receive(self, timeout=5.0):
+    """Receive a packet; returns None on timeout"""
+    deadline = time.monotonic() + timeout
+    while True:
+      start = self.buf.find(b"$")
+      end = self.buf.find(b"#", start)
+      if start >= 0 and end >= 0 and len(self.buf) >= end + 3:
+        payload = self.buf[start + 1:end].decode(errors="replace")
+        self.buf = self.buf[end + 3:]
+        if self.ack:
+          self.sock.sendall(b"+")
+        # Skip console output packets
+        if payload.startswith("O") and payload != "OK":
+          continue
+        return payload
+      remaining = deadline - time.monotonic()
+      if remaining <= 0:
+        return None
+      try:
+        self._recv(remaining)
+      except socket.timeout:
+        return None
+
+  def request(self, payload, timeout=5.0):
+    """Send a packet and wait for the reply"""
+    self.send(payload)
+    reply = self.receive(timeout)
+    if reply is None:
+      raise RspError("no reply to \"%s\"" % payload)
+    return reply
+
+  def interrupt(self):
+    """Halt the running target"""
+    self.sock.sendall(b"\x03")
+
+  def pc(self, stop_reply):
+    """Program counter from a stop reply, read from the target if missing"""
+    for field in stop_reply[3:].split(";"):
+      reg, _, value = field.partition(":")
+      if reg and all(c in "0123456789abcdef" for c in reg) and int(reg, 16) == REG_PC:
+        return int.from_bytes(bytes.fromhex(value), "little")
+    return int.from_bytes(bytes.fromhex(self.request("p%x" % REG_PC)), "little")
+
+
+def basic_blocks(elf):
+  """Basic block entry addresses and the instructions of each block"""
+  insns = elfinfo.instructions(elf)
+  addrs = {i.addr for i in insns}
+  leaders = {f.addr for f in elfinfo.functions(elf) if f.addr in addrs}
+  for prev, insn in zip(insns, insns[1:]):
+    if elfinfo.ends_block(prev):
+      leaders.add(insn.addr)
+  for insn in insns:
+    target = elfinfo.branch_target(insn)
+    if target in addrs:
+      leaders.add(target)
+
+  blocks, current = {}, None
+  for insn in insns:
+    if insn.addr in leaders:
+      current = blocks.setdefault(insn.addr, [])
+    if current is not None:
+      current.append(insn)
+  return blocks
+
+
+def harvest(rsp, blocks, sizes, hw, slice_time, idle, total_time, log):
+  """Arm breakpoints and collect first hits. Returns hit addresses and stats."""
+  pending = deque(sorted(blocks))
+  armed, hits = set(), set()
+  kind, remove = ("Z1", "z1") if hw else ("Z0", "z0")
+  capacity = hw if hw else len(pending)
+  # In hardware mode, a full rotation through all blocks may pass without hits
+  idle_limit = idle + (len(blocks) + hw - 1) // hw if hw else idle
+  rotations, idle_slices, exited = 0, 0, False
+  start = time.monotonic()
+
+  def record(reply):
+    """Record and remove the armed breakpoint of a stop reply; False if none"""
+    if reply[0] not in "TS" or int(reply[1:3], 16) != SIGTRAP:
+      return False
+    pc = rsp.pc(reply) & ~1
+    if pc not in armed:
+      return False
+    rsp.request("%s,%x,%x" % (remove, pc, BP_KIND[sizes[pc]]))
+    armed.discard(pc)
+    hits.add(pc)
+    if log and len(hits) % 100 == 0:
+      log("%u/%u blocks hit" % (len(hits), len(blocks)))
+    return True
+
+  while (armed or pending) and idle_slices < idle_limit and time.monotonic() - start < total_time:
+    while pending and len(armed) < capacity:
+      addr = pending.popleft()
+      reply = rsp.request("%s,%x,%x" % (kind, addr, BP_KIND[sizes[addr]]))
+      if reply != "OK":
+        raise RspError("cannot set breakpoint at 0x%08x: %s" % (addr, reply or "unsupported"))
+      armed.add(addr)
+
+    rsp.send("c")
+    reply = rsp.receive(slice_time)
+    timed_out = reply is None
+    if timed_out:
+      # Time slice without hits: halt. The stop reply may still be a
+      # breakpoint hit that raced the interrupt, so it is recorded before the
+      # armed set is rotated.
+      rsp.interrupt()
+      reply = rsp.receive(5.0)
+      if reply is None:
+        raise RspError("target does not halt")
+
+    if reply[0] in "WX":
+      exited = True
+      break
+    if record(reply):
+      idle_slices = 0
+    elif timed_out:
+      idle_slices += 1
+      if hw and pending:
+        for addr in sorted(armed):
+          rsp.request("%s,%x,%x" % (remove, addr, BP_KIND[sizes[addr]]))
+          pending.append(addr)
+        armed.clear()
+        rotations += 1
+
+  elapsed = time.monotonic() - start
+  return hits, {
+    "blocks": len(blocks),
+    "blocks_hit": len(hits),
+    "blocks_unresolved": len(blocks) - len(hits),
+    "elapsed_s": round(elapsed, 3),
+    "blocks_per_s": round(len(hits) / elapsed, 1) if elapsed > 0 else 0.0,
+    "rsp_packets": rsp.ops,
+    "rotations": rotations,
+    "target_exited": exited,
+  }
+
+
+def report(elf, blocks, hits, out_dir, root):
+  """Write hit-only line coverage as .gcov files"""
+  insns = [i for b in blocks.values() for i in b]
+  locs = elfinfo.line_info(elf, (i.addr for i in insns))
+  lines = {}
+  for entry, block in blocks.items():
+    for insn in block:
+      loc = locs.get(insn.addr)
+      if loc is None or (root and not loc[0].startswith(root + os.sep)):
+        continue
+      per_file = lines.setdefault(loc[0], {})
+      per_file[loc[1]] = max(per_file.get(loc[1], 0), 1 if entry in hits else 0)
+
+  os.makedirs(out_dir, exist_ok=True)
+  for path in sorted(lines):
+    gcovfile.write(out_dir, path, lines[path])
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("elf", help="firmware image running on the target")
+  parser.add_argument("--target", default="localhost:1234", help="GDB server address (host:port)")
+  parser.add_argument("--hw", type=int, default=0, metavar="N",
+                      help="use N hardware breakpoints (default: unlimited software breakpoints)")
+  parser.add_argument("--slice", type=float, default=2.0, help="time slice before rotating breakpoints (s)")
+  parser.add_argument("--idle", type=int, default=3, help="stop after this many time slices without hits")
+  parser.add_argument("--time", type=float, default=60.0, help="total time limit (s)")
+  parser.add_argument("-o", "--output", default="rspcov", help="output directory for .gcov files")
+  parser.add_argument("-r", "--root", default=None, help="only report sources below this directory")
+  parser.add_argument("--json", default=None, help="write throughput metrics to this file")
+  parser.add_argument("-v", "--verbose", action="store_true")
+  args = parser.parse_args()
+
+  root = os.path.normpath(os.path.abspath(args.root)) if args.root else None
+  blocks = basic_blocks(args.elf)
+  sizes = {addr: block[0].size for addr, block in blocks.items()}
+
+  rsp = Rsp(args.target)
+  log = (lambda msg: print(msg, file=sys.stderr)) if args.verbose else None
+  hits, stats = harvest(rsp, blocks, sizes, args.hw, args.slice, args.idle, args.time, log)
+
+  report(args.elf, blocks, hits, args.output, root)
+  print("%(blocks_hit)u/%(blocks)u blocks hit in %(elapsed_s).2f s (%(blocks_per_s).1f blocks/s), "
+        "%(rsp_packets)u RSP packets, %(rotations)u rotations" % stats)
+  if args.json:
+    with open(args.json, "w") as f:
+      json.dump(stats, f, indent=2)
+
+
+if __name__ == "__main__":
+  main()
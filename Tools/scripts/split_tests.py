@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Split the output file of the on-target test runner ("tests.bin")
+
+Prints the result, the metrics (e.g. benchmark cycles) and the stack and heap
+usage of each test case, writes the coverage stream recorded for
+each case to "<output dir>/<test>.bin" (input for "gcov-tool merge-stream"),
+and optionally writes a JUnit XML report. The exit status is 1 if a case
+failed or the run is incomplete (no end record, e.g. after a fault).
+
+Usage: split_tests.py <tests.bin> [-o <output dir>] [--junit <file>]
+"""
+
+import argparse
+import os
+import struct
+import sys
+from xml.sax.saxutils import quoteattr
+
+STATUS_PASS = 0
+MEMORY_FIELDS = ("stack_used", "stack_size", "heap_used", "heap_size", "free")
+
+
+def load(path):
+  """Read records: command line, list of (name, status, ms, message, gcov, metrics, memory), summary"""
+  with open(path, "rb") as f:
+    data = f.read()
+  cmdline, cases, summary = None, [], None
+  pos = 0
+  while pos + 8 <= len(data):
+    tag, length = data[pos:pos + 4], struct.unpack_from("<I", data, pos + 4)[0]
+    payload = data[pos + 8:pos + 8 + length]
+    if len(payload) != length:
+      break
+    pos += 8 + length
+    if tag == b"TRUN":
+      cmdline = payload.decode(errors="replace")
+    elif tag == b"TCAS":
+      status, ms = struct.unpack_from("<II", payload)
+      name, message = payload[8:].split(b"\0")[:2]
+      cases.append([name.decode(), status, ms, message.decode(errors="replace"), b"", {}, {}])
+    elif tag == b"TMET" and cases:
+      while len(payload) > 4:
+        value, = struct.unpack_from("<I", payload)
+        name, _, payload = payload[4:].partition(b"\0")
+        cases[-1][5][name.decode()] = value
+    elif tag == b"TMEM" and cases:
+      cases[-1][6] = dict(zip(MEMORY_FIELDS, struct.unpack_from("<%dI" % len(MEMORY_FIELDS), payload)))
+    elif tag == b"GCOV" and cases:
+      cases[-1][4] = payload
+    elif tag == b"TEND":
+      summary = struct.unpack_from("<II", payload)
+  if cmdline is None:
+    raise ValueError("%s: not a test results file" % path)
+  return cmdline, cases, summary
+
+
+def write_junit(path, cases):
+  failed = sum(1 for c in cases if c[1] != STATUS_PASS)
+  with open(path, "w") as f:
+    f.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+    f.write('<testsuite name="target" tests="%d" failures="%d">\n' % (len(cases), failed))
+    for name, status, ms, message, _, _, _ in cases:
+      f.write('  <testcase name=%s time="%.3f"' % (quoteattr(name), ms / 1000.0))
+      if status == STATUS_PASS:
+        f.write("/>\n")
+      else:
+        f.write(">\n    <failure message=%s/>\n  </testcase>\n" % quoteattr(message))
+    f.write("</testsuite>\n")
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("results", help="test runner output file")
+  parser.add_argument("-o", "--output", default="tests", help="output directory for per-test coverage streams")
+  parser.add_argument("--junit", help="write JUnit XML report")
+  args = parser.parse_args()
+
+  cmdline, cases, summary = load(args.results)
+  os.makedirs(args.output, exist_ok=True)
+  print("command line: %s" % cmdline)
+  for name, status, ms, message, gcov, metrics, memory in cases:
+    print("%s %s (%d ms)%s" % ("PASS" if status == STATUS_PASS else "FAIL", name, ms,
+                               ": " + message if message else ""))
+    for key, value in metrics.items():
+      print("  %s = %u" % (key, value))
+    if memory.get("stack_size"):
+      print("  stack: %u of %u bytes, heap: %u of %u bytes, free RAM: %u bytes" %
+            tuple(memory[k] for k in MEMORY_FIELDS))
+    if gcov:
+      with open(os.path.join(args.output, name + ".bin"), "wb") as f:
+        f.write(gcov)
+  if args.junit:
+    write_junit(args.junit, cases)
+
+  failed = sum(1 for c in cases if c[1] != STATUS_PASS)
+  if summary is None:
+    print("incomplete run: %d tests recorded" % len(cases))
+    sys.exit(1)
+  print("%d tests, %d failed" % (len(cases), failed))
+  sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+  main()
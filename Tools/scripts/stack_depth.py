@@ -0,0 +1,361 @@
+#!/usr/bin/env python3
+"""
+Report the worst-case stack depth per entry point, with executed call paths
+
+Builds the call graph of an image from its disassembly (direct calls, and tail
+calls: branches to the start of another function) and takes the stack frame of
+each function from the "-fstack-usage" files (.su) of the build (CMake option
+STACK_USAGE). Frames of functions without an entry (assembly, C library,
+libgcc) are estimated from their prologue ("push", "sub sp") and marked "~".
+
+The worst-case depth is computed for main and each exception handler of the
+vector table (".isr_vector"), and for the functions given with --entry.
+Handlers include the exception frame stacked by the core (32 bytes, plus 4
+bytes of alignment). Coverage data marks each call site as executed or not:
+
+  --tbcov  output of the QEMU TCG plugin ("tbcov.bin", see "Tools/tbcov"):
+           all code of the uninstrumented image
+  --gcovr  gcovr JSON report ("coverage.json" of "process_coverage.sh"):
+           call sites in the instrumented units only, others are unknown
+
+and a second depth is computed without the call sites never executed (unknown
+call sites are kept). The path of both depths is printed, each call marked
+"+" (executed), "-" (not executed) or "?" (unknown).
+
+Indirect calls (function pointers) aren't followed; add the edges with --call
+<caller>=<callee>. Entry points reaching recursion, dynamic stack allocation
+or indirect calls are flagged, their depth is a lower bound. The total is the
+depth of main plus the deepest handlers (--nesting: handlers preempting each
+other), compared with the reserved stack ("_Min_Stack_Size").
+
+Usage: stack_depth.py <elf> [--su <.su files or directories>...] [--tbcov <file> | --gcovr <file> -r <source root>]
+                      [--entry <function>...] [--call <caller>=<callee>...] [--nesting <n>] [--json <file>]
+"""
+
+import argparse
+import bisect
+import json
+import os
+import re
+import sys
+from collections import defaultdict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import elfinfo
+import tbcov2gcov
+
+# Exception entry: 8 stacked registers, plus 4 bytes to align the stack to 8
+EXCEPTION_FRAME = 32 + 4
+
+# Vector table section and the first exception handler entry (after the
+# initial stack pointer and the reset vector)
+VECTOR_SECTION = ".isr_vector"
+FIRST_HANDLER = 2
+
+# Prologue instructions: register pushes and stack allocation
+_PUSH = re.compile(r"^(push|stmdb)(\.w)?$")
+_SUB_SP = re.compile(r"^sp,\s*(?:sp,\s*)?#(\d+)")
+
+MARKS = {True: "+", False: "-", None: "?"}
+
+# Preferred symbol of aliased functions: global, weak, local
+_RANK = {"T": 0, "W": 1, "t": 2, "w": 3}
+
+
+class Image:
+  """Functions, call graph and stack frames of an image"""
+
+  def __init__(self, elf):
+    symbols = elfinfo.symbols(elf)
+    by_addr = {}
+    for sym in elfinfo.functions(elf):
+      if sym.addr not in by_addr or _RANK[sym.type] < _RANK[by_addr[sym.addr].type]:
+        by_addr[sym.addr] = sym
+    self.funcs = sorted(by_addr.values())
+    self.starts = [f.addr for f in self.funcs]
+    self.by_name = {f.name: f for f in self.funcs}
+    self.absolute = {s.name: s.addr for s in symbols if s.type in "aA"}
+    self.insns = defaultdict(list)
+    for insn in elfinfo.instructions(elf):
+      func = self.at(insn.addr)
+      if func:
+        self.insns[func.name].append(insn)
+
+  def at(self, addr):
+    """Function containing an address, or None"""
+    i = bisect.bisect_right(self.starts, addr) - 1
+    if i >= 0 and addr < self.funcs[i].addr + max(self.funcs[i].size, 1):
+      return self.funcs[i]
+    return None
+
+  def call_graph(self):
+    """Calls per function: dict name -> list of (site, callee, tail call); set of
+    functions with indirect calls"""
+    graph, indirect = defaultdict(list), set()
+    for name, insns in self.insns.items():
+      func = self.by_name[name]
+      for insn in insns:
+        mnemonic = insn.mnemonic.split(".")[0]
+        call = mnemonic in ("bl", "blx")
+        if not call and not (mnemonic == "b" or elfinfo.is_cond_branch(insn) or mnemonic == "bx"):
+          continue
+        target = elfinfo.branch_target(insn)
+        if target is None:
+          if call or (mnemonic == "bx" and insn.operands != "lr"):
+            indirect.add(name)
+          continue
+        callee = self.at(target)
+        if callee is None or (not call and (callee is func or target != callee.addr)):
+          continue
+        graph[name].append((insn.addr, callee.name, not call))
+    return graph, indirect
+
+  def prologue_frame(self, name):
+    """Stack frame estimated from the register pushes and the allocation of the prologue"""
+    size = 0
+    for insn in self.insns.get(name, [])[:8]:
+      mnemonic = insn.mnemonic
+      if _PUSH.match(mnemonic) and (mnemonic.startswith("push") or insn.operands.startswith("sp!")):
+        size += 4 * count_registers(insn.operands)
+      elif mnemonic.split(".")[0] == "sub" and _SUB_SP.match(insn.operands):
+        size += int(_SUB_SP.match(insn.operands).group(1))
+      elif elfinfo.ends_block(insn):
+        break
+    return size
+
+
+def count_registers(operands):
+  """Number of registers in a register list, e.g. "{r4-r7, lr}" """
+  count = 0
+  for reg in operands[operands.find("{") + 1:operands.find("}")].split(","):
+    low, _, high = reg.strip().partition("-")
+    count += int(high[1:]) - int(low[1:]) + 1 if high else 1
+  return count
+
+
+def su_files(paths, elf):
+  """.su files of the arguments (files or directories); default: the build folder of the image"""
+  if not paths:
+    build = os.path.dirname(os.path.abspath(elf))
+    image = os.path.splitext(os.path.basename(elf))[0]
+    dirs = ["%s.dir" % image, "firmware-objects.dir"] + (["firmware-units.dir"] if image.endswith("-release") else [])
+    result = []
+    for base, _, names in os.walk(build):
+      in_objects = any(os.sep + d in base + os.sep for d in dirs)
+      for n in sorted(names):
+        # Link-time code generation writes "<image>.<...>.su" files
+        if n.endswith(".su") and (in_objects or n.startswith(image + ".")):
+          result.append(os.path.join(base, n))
+    return result
+  result = []
+  for path in paths:
+    if os.path.isdir(path):
+      for base, _, names in os.walk(path):
+        result.extend(os.path.join(base, n) for n in sorted(names) if n.endswith(".su"))
+    else:
+      result.append(path)
+  return result
+
+
+def load_su(paths):
+  """Stack frames: dict function name -> (bytes, qualifiers); the largest of duplicates"""
+  frames = {}
+  for path in paths:
+    with open(path, errors="replace") as f:
+      for line in f:
+        parts = line.rstrip("\n").split("\t")
+        if len(parts) != 3 or not parts[1].isdigit():
+          continue
+        name, size = parts[0].rsplit(":", 1)[-1], int(parts[1])
+        if name not in frames or size > frames[name][0]:
+          frames[name] = (size, parts[2])
+  return frames
+
+
+class Coverage:
+  """Executed call sites: True, False or None (unknown)"""
+
+  def __init__(self, elf, tbcov=None, gcovr=None, root="."):
+    self.elf, self.tbs, self.lines, self.root = elf, None, None, os.path.abspath(root)
+    if tbcov:
+      self.tbs = sorted((pc, pc + size) for pc, size, count in tbcov2gcov.load(tbcov)[0] if count)
+      self.tb_starts = [start for start, _ in self.tbs]
+    if gcovr:
+      with open(gcovr) as f:
+        data = json.load(f)
+      self.lines = defaultdict(dict)
+      for entry in data.get("files", []):
+        path = os.path.normpath(os.path.join(self.root, entry["file"]))
+        for line in entry.get("lines", []):
+          lines = self.lines[path]
+          lines[line["line_number"]] = lines.get(line["line_number"], 0) + line.get("count", 0)
+    self.locs = {}
+
+  def resolve(self, sites):
+    """Look up the source lines of the call sites (gcovr data only)"""
+    if self.lines is not None:
+      self.locs = elfinfo.line_info(self.elf, sites)
+
+  def executed(self, site):
+    if site is None:
+      return None
+    if self.tbs is not None:
+      i = bisect.bisect_right(self.tb_starts, site)
+      # Translation blocks are short: the covering block starts shortly before
+      while i > 0 and self.tbs[i - 1][0] > site - 4096:
+        i -= 1
+        if self.tbs[i][0] <= site < self.tbs[i][1]:
+          return True
+      return False
+    if self.lines is not None:
+      loc = self.locs.get(site)
+      if loc and loc[0] in self.lines and loc[1] in self.lines[loc[0]]:
+        return self.lines[loc[0]][loc[1]] > 0
+    return None
+
+
+class Analysis:
+  """Worst-case stack depth over the call graph"""
+
+  def __init__(self, image, frames, graph, indirect, coverage):
+    self.image, self.frames, self.graph, self.indirect, self.coverage = image, frames, graph, indirect, coverage
+
+  def frame(self, name):
+    """Frame size, estimated (no .su entry) and flags of a function"""
+    entry = self.frames.get(name) or self.frames.get(name.split(".")[0])
+    if entry:
+      flags = {"dynamic"} if "dynamic" in entry[1] and "bounded" not in entry[1] else set()
+      return entry[0], False, flags
+    return self.image.prologue_frame(name), True, set()
+
+  def worst(self, name, executed_only, memo, active):
+    """Depth, path (list of (site, callee)) and flags of the deepest call chain from a function"""
+    if name in memo:
+      return memo[name]
+    active.add(name)
+    frame, _, flags = self.frame(name)
+    flags = set(flags) | ({"indirect"} if name in self.indirect else set())
+    call, tail = (0, []), (0, [])
+    for site, callee, is_tail in self.graph.get(name, []):
+      if executed_only and self.coverage.executed(site) is False:
+        continue
+      if callee in active:
+        flags.add("recursion")
+        continue
+      depth, path, sub = self.worst(callee, executed_only, memo, active)
+      flags |= sub
+      if is_tail and (depth > tail[0] or not tail[1]):
+        tail = (depth, [(site, callee)] + path)
+      elif not is_tail and (depth > call[0] or not call[1]):
+        call = (depth, [(site, callee)] + path)
+    active.discard(name)
+    # Tail calls run after the epilogue: the frame is released
+    result = (frame + call[0], call[1], flags) if frame + call[0] >= tail[0] else (tail[0], tail[1], flags)
+    memo[name] = result
+    return result
+
+  def entry(self, name, handler):
+    """Static and executed-only depth of an entry point"""
+    extra = EXCEPTION_FRAME if handler else 0
+    result = {"entry": name, "handler": handler}
+    for key, executed_only in (("static", False), ("executed", True)):
+      depth, path, flags = self.worst(name, executed_only, {}, set())
+      result[key] = {"bytes": depth + extra, "flags": sorted(flags), "path": [
+        {"function": callee, "frame": self.frame(callee)[0], "estimated": self.frame(callee)[1],
+         "site": site, "executed": self.coverage.executed(site)} for site, callee in path]}
+    result["frame"], result["estimated"] = self.frame(name)[:2]
+    return result
+
+
+def entry_points(image, elf, extra):
+  """main, the exception handlers of the vector table and additional functions: list of (name, handler)"""
+  entries = [("main", False)] if "main" in image.by_name else []
+  seen = set()
+  for vector in elfinfo.section_words(elf, VECTOR_SECTION)[FIRST_HANDLER:]:
+    func = image.at(vector & ~1) if vector else None
+    if func and func.name not in seen:
+      seen.add(func.name)
+      entries.append((func.name, True))
+  for name in extra:
+    if name not in image.by_name:
+      sys.exit("error: function %s not found" % name)
+    entries.append((name, name in seen))
+  return entries
+
+
+def format_path(result, key):
+  """Call chain of an entry point: frame sizes and coverage marks"""
+  text = "%s %s%d" % (result["entry"], "~" if result["estimated"] else "", result["frame"])
+  for hop in result[key]["path"]:
+    text += " %s%s %s%d" % (MARKS[hop["executed"]], hop["function"], "~" if hop["estimated"] else "", hop["frame"])
+  return text
+
+
+def report(results, image, nesting):
+  """Text report: table of entry points, totals and the worst paths"""
+  lines = ["%-32s %8s %8s  %s" % ("entry", "static", "executed", "flags"), "-" * 60]
+  for r in results:
+    flags = sorted(set(r["static"]["flags"]) | set(r["executed"]["flags"]))
+    lines.append("%-32s %8d %8d  %s" % (r["entry"], r["static"]["bytes"], r["executed"]["bytes"], " ".join(flags)))
+
+  size = image.absolute.get("_Min_Stack_Size")
+  threads = [r for r in results if not r["handler"]]
+  handlers = [r for r in results if r["handler"]]
+  totals = {}
+  for key in ("static", "executed"):
+    deepest = sorted((r[key]["bytes"] for r in handlers), reverse=True)[:nesting]
+    totals[key] = max((r[key]["bytes"] for r in threads), default=0) + sum(deepest)
+  lines.append("-" * 60)
+  lines.append("%-32s %8d %8d" % ("total (+%d handler%s)" % (nesting, "s" if nesting != 1 else ""),
+                                   totals["static"], totals["executed"]))
+  if size is not None:
+    lines.append("%-32s %8d %8d" % ("margin to %d bytes" % size, size - totals["static"], size - totals["executed"]))
+
+  for r in results:
+    lines.append("")
+    lines.append("%s: %d bytes" % (r["entry"], r["static"]["bytes"]))
+    lines.append("  static:   " + format_path(r, "static"))
+    if r["executed"]["path"] != r["static"]["path"]:
+      lines.append("  executed: " + format_path(r, "executed"))
+  return "\n".join(lines), totals, size
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("elf", help="firmware image")
+  parser.add_argument("--su", nargs="+", default=[], help=".su files or directories (default: build folder of the image)")
+  group = parser.add_mutually_exclusive_group()
+  group.add_argument("--tbcov", help="QEMU TCG plugin coverage of the image")
+  group.add_argument("--gcovr", help="gcovr JSON report")
+  parser.add_argument("-r", "--root", default=".", help="source root of the gcovr report")
+  parser.add_argument("--entry", nargs="+", default=[], help="additional entry points")
+  parser.add_argument("--call", action="append", default=[], help="indirect call edge <caller>=<callee>")
+  parser.add_argument("--nesting", type=int, default=1, help="handlers preempting each other")
+  parser.add_argument("--json", help="write the results to a JSON file")
+  args = parser.parse_args()
+
+  image = Image(args.elf)
+  frames = load_su(su_files(args.su, args.elf))
+  if not frames:
+    print("warning: no .su files, all frames estimated (build with -DSTACK_USAGE=ON)", file=sys.stderr)
+  graph, indirect = image.call_graph()
+  for edge in args.call:
+    caller, _, callee = edge.partition("=")
+    if caller not in image.by_name or callee not in image.by_name:
+      sys.exit("error: %s: function not found" % edge)
+    graph[caller].append((None, callee, False))
+
+  coverage = Coverage(args.elf, args.tbcov, args.gcovr, args.root)
+  coverage.resolve([site for calls in graph.values() for site, _, _ in calls if site is not None])
+  analysis = Analysis(image, frames, graph, indirect, coverage)
+  results = [analysis.entry(name, handler) for name, handler in entry_points(image, args.elf, args.entry)]
+
+  text, totals, size = report(results, image, args.nesting)
+  print(text)
+  if args.json:
+    with open(args.json, "w") as f:
+      json.dump({"entries": results, "totals": totals, "stack_size": size, "nesting": args.nesting}, f, indent=2)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Compare the stack margin of the release and the coverage image
+
+Runs the selected test cases on the release and the coverage image of a build
+folder in QEMU (or armsim) and prints the stack high-water mark of each case
+("TMEM" records of the test runner, see "Memory/memory.h") in both images:
+the bytes used, the increase by the instrumentation, and the margin to the
+reserved stack size ("_Min_Stack_Size"). The stack is shared by all exception
+handlers, so the values include the interrupts taken during a case.
+
+QEMU doesn't model the STM32F1 peripherals, so only the cases valid without
+them run by default (QEMU_TESTS: delays, vector streaming and the kernels of
+the performance budget); armsim runs all cases by default.
+
+A negative margin means the stack grew into the free RAM below its reserved
+area; "overflow" marks cases where it reached the heap. The exit status is 1
+if the margin of a case is below --min-margin (default 0) in either image.
+
+Usage: stack_margin.py <build dir> [--qemu <path> | --armsim <path>] [--tests <pattern>] [--min-margin <bytes>] [--json <file>]
+"""
+
+import argparse
+import json
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import budget
+
+IMAGES = (("release", budget.RELEASE_IMAGE), ("coverage", budget.IMAGE))
+
+# Test cases valid in QEMU ("tests=" filter)
+QEMU_TESTS = "hal_delay,timebase_delay,vector_stream_*," + budget.KERNELS
+
+
+def measure(args):
+  """Memory usage per case: dict name -> dict image label -> memory"""
+  results = {}
+  for label, image in IMAGES:
+    cases = budget.run(args, args.build, image, ["tests=" + args.tests], "stack_%s.bin" % label)
+    for name, _, _, _, _, _, memory in cases:
+      if memory:
+        results.setdefault(name, {})[label] = memory
+  return results
+
+
+def margin(memory):
+  """Reserved stack size minus high-water mark (negative: exceeded)"""
+  return memory["stack_size"] - memory["stack_used"]
+
+
+def table(results):
+  """Text table: one row per test case, worst coverage margin first"""
+  header = "%-28s %8s %8s %8s %8s %8s" % ("test", "rel used", "cov used", "delta", "rel marg", "cov marg")
+  lines = [header, "-" * len(header)]
+  rows = sorted(results.items(), key=lambda item: margin(item[1]["coverage"]) if "coverage" in item[1] else 0)
+  for name, images in rows:
+    release, coverage = images.get("release"), images.get("coverage")
+    row = "%-28s %8s %8s" % (name, release["stack_used"] if release else "-",
+                             coverage["stack_used"] if coverage else "-")
+    row += " %8s" % ("%+d" % (coverage["stack_used"] - release["stack_used"]) if release and coverage else "-")
+    row += " %8s %8s" % (margin(release) if release else "-", margin(coverage) if coverage else "-")
+    if any(memory["free"] == 0 for memory in images.values()):
+      row += "  overflow"
+    lines.append(row)
+  return "\n".join(lines)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("build", help="build folder with both images")
+  parser.add_argument("--qemu", default="qemu-system-arm", help="QEMU executable")
+  parser.add_argument("--machine", default=budget.QEMU_MACHINE, help="QEMU machine")
+  parser.add_argument("--armsim", help="run in armsim instead of QEMU")
+  parser.add_argument("--tests", help="test case selection (\"tests=\" parameter; default: all cases in armsim, "
+                      "the cases valid without STM32F1 peripherals in QEMU)")
+  parser.add_argument("--min-margin", type=int, default=0, help="minimum stack margin in bytes")
+  parser.add_argument("--json", help="write the memory usage to a JSON file")
+  args = parser.parse_args()
+  if args.tests is None:
+    args.tests = "*" if args.armsim else QEMU_TESTS
+
+  results = measure(args)
+  if not results:
+    sys.exit("error: no memory records (images without stack painting?)")
+  print(table(results))
+  if args.json:
+    with open(args.json, "w") as f:
+      json.dump(results, f, indent=2, sort_keys=True)
+
+  low = sorted(name for name, images in results.items()
+               if any(margin(memory) < args.min_margin or memory["free"] == 0 for memory in images.values()))
+  if low:
+    print("stack margin below %d bytes: %s" % (args.min_margin, " ".join(low)))
+    sys.exit(1)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""
+Convert QEMU TCG plugin coverage ("tbcov.bin") into gcov text files
+
+Translation block (TB) execution counts are mapped to source lines using the
+DWARF line table of the uninstrumented .elf file. A line's execution count is
+the highest count of all TBs containing instructions of that line. Lines with
+code that is not covered by any executed TB are reported as not executed.
+
+Branch outcomes are derived from the recorded TB-to-TB edges: for each condi-
+tional branch instruction ending a TB, the edges to the branch target and to
+the following instruction are reported as "taken" and "fallthrough" branches.
+
+Usage: tbcov2gcov.py <elf> <tbcov.bin> [-o <output dir>] [-r <source root>]
+"""
+
+import argparse
+import os
+import struct
+import sys
+from collections import defaultdict
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import elfinfo
+import gcovfile
+
+TBCOV_MAGIC = b"TBCV"
+TBCOV_VERSION = 1
+
+
+def _uleb(data, pos):
+  result, shift = 0, 0
+  while True:
+    byte = data[pos]
+    pos += 1
+    result |= (byte & 0x7F) << shift
+    shift += 7
+    if not byte & 0x80:
+      return result, pos
+
+
+def _sleb(data, pos):
+  result, shift = 0, 0
+  while True:
+    byte = data[pos]
+    pos += 1
+    result |= (byte & 0x7F) << shift
+    shift += 7
+    if not byte & 0x80:
+      if byte & 0x40:
+        result -= 1 << shift
+      return result, pos
+
+
+def load(path):
+  """Read plugin output: list of (pc, size, count), dict (from, to) -> count"""
+  with open(path, "rb") as f:
+    data = f.read()
+  if data[:4] != TBCOV_MAGIC:
+    raise ValueError("%s: not a tbcov file" % path)
+  version, n_tbs, n_edges = struct.unpack_from("<III", data, 4)
+  if version != TBCOV_VERSION:
+    raise ValueError("%s: unsupported format version %u" % (path, version))
+
+  pos, pc, tbs = 16, 0, []
+  for _ in range(n_tbs):
+    delta, pos = _uleb(data, pos)
+    size, pos = _uleb(data, pos)
+    count, pos = _uleb(data, pos)
+    pc += delta
+    tbs.append((pc, size, count))
+
+  src, edges = 0, {}
+  for _ in range(n_edges):
+    delta, pos = _uleb(data, pos)
+    offset, pos = _sleb(data, pos)
+    count, pos = _uleb(data, pos)
+    src += delta
+    edges[(src, src + offset)] = count
+  return tbs, edges
+
+
+def convert(elf, tbs, edges, out_dir, root):
+  """Map TB coverage to source lines and write .gcov files"""
+  insns = elfinfo.instructions(elf)
+  locs = elfinfo.line_info(elf, (i.addr for i in insns))
+  by_addr = {i.addr: i for i in insns}
+
+  # Execution count per instruction (highest count of the covering TBs)
+  insn_count = defaultdict(int)
+  tb_ends = defaultdict(list)
+  for pc, size, count in tbs:
+    addr = pc
+    while addr < pc + size and addr in by_addr:
+      insn_count[addr] = max(insn_count[addr], count)
+      addr += by_addr[addr].size
+    tb_ends[pc + size].append(pc)
+
+  lines = defaultdict(dict)
+  branches = defaultdict(lambda: defaultdict(list))
+  for insn in insns:
+    loc = locs.get(insn.addr)
+    if loc is None or (root and not loc[0].startswith(root + os.sep)):
+      continue
+    path, lineno = loc
+    lines[path][lineno] = max(lines[path].get(lineno, 0), insn_count[insn.addr])
+
+    if elfinfo.is_cond_branch(insn):
+      target = elfinfo.branch_target(insn)
+      following = insn.addr + insn.size
+      if insn_count[insn.addr] == 0:
+        outcomes = [(None, False), (None, True)]
+      else:
+        sources = tb_ends.get(following, [])
+        outcomes = [
+          (sum(edges.get((s, target), 0) for s in sources), False),
+          (sum(edges.get((s, following), 0) for s in sources), True),
+        ]
+      branches[path][lineno].extend(outcomes)
+
+  os.makedirs(out_dir, exist_ok=True)
+  for path in sorted(lines):
+    gcovfile.write(out_dir, path, lines[path], branches[path])
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("elf", help="uninstrumented firmware image")
+  parser.add_argument("tbcov", help="TCG plugin output file")
+  parser.add_argument("-o", "--output", default="tbcov", help="output directory for .gcov files")
+  parser.add_argument("-r", "--root", default=None, help="only report sources below this directory")
+  args = parser.parse_args()
+
+  tbs, edges = load(args.tbcov)
+  root = os.path.normpath(os.path.abspath(args.root)) if args.root else None
+  convert(args.elf, tbs, edges, args.output, root)
+
+
+if __name__ == "__main__":
+  main()
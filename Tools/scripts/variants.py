@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""
+Compare firmware build variants
+
+Collects for each build folder (see "Variants/CMakeLists.txt"):
+
+  options   cache variables differing from the defaults (CMakeCache.txt)
+  release   FLASH/RAM usage of the release image (map file)
+  coverage  FLASH/RAM usage of the coverage image (map file)
+  instr     FLASH/RAM cost of the instrumentation: instrumented units and gcov
+            runtime ("coverage_cost.json", see "Tools/scripts/covcost.py")
+  cycles    cycles per HAL_GPIO_Init() call of the release and the coverage
+            image: "gpio_init" test case with 100 and 200 iterations in armsim
+
+and prints one comparative table. Values that can't be determined (e.g. no
+armsim, COVERAGE_INSTRUMENT=OFF) are shown as "-".
+
+Usage: variants.py <build dir>... [--armsim <path>] [--json <file>] [--markdown <file>]
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import covcost
+
+IMAGE = "gcov-demo-stm32f103"
+RELEASE_IMAGE = IMAGE + "-release"
+
+# Options varied between builds, and their defaults
+OPTIONS = {
+  "FIRMWARE_OPTIMIZATION": "-O1",
+  "HAL_CONF": "minimal",
+  "COVERAGE_INSTRUMENT": "ON",
+  "COVERAGE_CONDITIONS": "OFF",
+  "COVERAGE_CONDITION_SOURCES": "",
+  "COVERAGE_BANKS": "OFF",
+  "COVERAGE_EXCLUDE_FUNCTIONS": "",
+  "COVERAGE_INCLUDE_FUNCTIONS": "",
+  "COVERAGE_DUMP_BOOST": "OFF",
+  "GPIO_FAST_OUT_OF_LINE": "OFF",
+  "TICKLESS_IDLE": "OFF",
+  "STACK_USAGE": "OFF",
+}
+
+_CACHE = re.compile(r"^(\w+):\w+=(.*)$")
+_CYCLES = re.compile(r"^\s*(\d+) cycles")
+
+
+def options(build):
+  """Cache variables of OPTIONS differing from their defaults"""
+  result = {}
+  try:
+    with open(os.path.join(build, "CMakeCache.txt")) as f:
+      for line in f:
+        m = _CACHE.match(line.rstrip("\n"))
+        if m and m.group(1) in OPTIONS and m.group(2) != OPTIONS[m.group(1)]:
+          result[m.group(1)] = m.group(2)
+  except OSError:
+    pass
+  return result
+
+
+def usage(build, image):
+  """(FLASH, RAM) used by an image, or None"""
+  path = os.path.join(build, image + ".map")
+  if not os.path.exists(path):
+    return None
+  regions, sections = covcost.load_map(path)
+  result = covcost.memory_usage(regions, sections)
+  return (result["FLASH"]["used"], result["RAM"]["used"]) if "FLASH" in result and "RAM" in result else None
+
+
+def instrumentation(build):
+  """(FLASH, RAM) cost of the instrumentation including the gcov runtime, or None"""
+  path = os.path.join(build, "coverage_cost.json")
+  if not os.path.exists(path):
+    return None
+  with open(path) as f:
+    cost = json.load(f)
+  runtime = cost.get("runtime") or {"flash": 0, "ram": 0}
+  return (sum(u["flash"] for u in cost["units"]) + runtime["flash"],
+          sum(u["ram"] for u in cost["units"]) + runtime["ram"])
+
+
+def cycles(armsim, build, image, iterations):
+  out = subprocess.run([armsim, "--stats", "--root", build,
+                        "--cmdline", "tests=gpio_init iterations=%u out=measure.bin" % iterations,
+                        os.path.join(build, image + ".elf")],
+                       capture_output=True, text=True)
+  for line in (out.stdout + out.stderr).splitlines():
+    m = _CYCLES.match(line)
+    if m:
+      return int(m.group(1))
+  return None
+
+
+def benchmark(armsim, build, image):
+  """Cycles per HAL_GPIO_Init() call, or None"""
+  if not armsim or not os.path.exists(os.path.join(build, image + ".elf")):
+    return None
+  c1, c2 = cycles(armsim, build, image, 100), cycles(armsim, build, image, 200)
+  return (c2 - c1) // 100 if c1 is not None and c2 is not None else None
+
+
+def collect(build, armsim):
+  return {
+    "variant": os.path.basename(os.path.normpath(build)),
+    "options": options(build),
+    "release": usage(build, RELEASE_IMAGE),
+    "coverage": usage(build, IMAGE),
+    "instr": instrumentation(build),
+    "cycles": (benchmark(armsim, build, RELEASE_IMAGE), benchmark(armsim, build, IMAGE)),
+  }
+
+
+def rows(results):
+  """Table header and rows of strings"""
+  fmt = lambda v: "-" if v is None else str(v)
+  pair = lambda p, i: fmt(p[i] if p else None)
+  header = ["variant", "options", "release FLASH", "release RAM", "coverage FLASH", "coverage RAM",
+            "instr FLASH", "instr RAM", "cycles release", "cycles coverage"]
+  body = []
+  for r in results:
+    body.append([r["variant"], " ".join("%s=%s" % kv for kv in sorted(r["options"].items())) or "(defaults)",
+                 pair(r["release"], 0), pair(r["release"], 1), pair(r["coverage"], 0), pair(r["coverage"], 1),
+                 pair(r["instr"], 0), pair(r["instr"], 1), pair(r["cycles"], 0), pair(r["cycles"], 1)])
+  return header, body
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+  parser.add_argument("builds", nargs="+", help="variant build folders")
+  parser.add_argument("--armsim", help="armsim executable for the benchmark runs")
+  parser.add_argument("--json", help="write the results as JSON")
+  parser.add_argument("--markdown", help="write the table as Markdown")
+  args = parser.parse_args()
+
+  armsim = args.armsim if args.armsim and os.path.exists(args.armsim) else None
+  if args.armsim and not armsim:
+    print("warning: %s not found, no benchmark runs" % args.armsim)
+  results = [collect(build, armsim) for build in args.builds]
+
+  header, body = rows(results)
+  widths = [max(len(row[i]) for row in [header] + body) for i in range(len(header))]
+  for row in [header] + body:
+    print("  ".join(cell.ljust(w) if i < 2 else cell.rjust(w) for i, (cell, w) in enumerate(zip(row, widths))))
+
+  if args.json:
+    with open(args.json, "w") as f:
+      json.dump(results, f, indent=2)
+  if args.markdown:
+    with open(args.markdown, "w") as f:
+      f.write("| %s |\n" % " | ".join(header))
+      f.write("|%s|\n" % "|".join(["---"] * 2 + ["--:"] * (len(header) - 2)))
+      f.writelines("| %s |\n" % " | ".join(row) for row in body)
+
+
+if __name__ == "__main__":
+  main()
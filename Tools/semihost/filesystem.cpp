@@ -0,0 +1,408 @@
+/*!****************************************************************************
+ * @file
+ * filesystem.cpp
+ *
+ * @brief
+ * File systems for semihosting file operations: host directory or in-memory
+ *
+ * The in-memory file system makes runs independent of the host: the target
+ * only sees imported files, and its output stays in memory until it is
+ * exported (e.g. the coverage dump after the run), or is inspected directly by
+ * a unit test.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "filesystem.h"
+
+
+namespace semihost {
+
+/*- Macros -------------------------------------------------------------------*/
+/// Number of SYS_OPEN modes
+static constexpr unsigned NUM_MODES = 12u;
+
+/// Host open() flags per SYS_OPEN mode (r, rb, r+, r+b, w, wb, w+, w+b, a, ...)
+static const int s_aiOpenFlags[NUM_MODES] = {
+  O_RDONLY, O_RDONLY, O_RDWR, O_RDWR,
+  O_WRONLY | O_CREAT | O_TRUNC, O_WRONLY | O_CREAT | O_TRUNC,
+  O_RDWR | O_CREAT | O_TRUNC, O_RDWR | O_CREAT | O_TRUNC,
+  O_WRONLY | O_CREAT | O_APPEND, O_WRONLY | O_CREAT | O_APPEND,
+  O_RDWR | O_CREAT | O_APPEND, O_RDWR | O_CREAT | O_APPEND
+};
+
+
+/*- Prototypes ---------------------------------------------------------------*/
+static bool bLeavesRoot(const std::string& path);
+
+
+/*- Host file system ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Close all files left open by the target
+ ******************************************************************************/
+HostFileSystem::~HostFileSystem()
+{
+  for (auto& fd : m_open) ::close(fd.first);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Open host file
+ *
+ * @param[in] path  Target path, relative to the root directory
+ * @param[in] mode  SYS_OPEN mode
+ * @return  (int) Host descriptor, or -errno
+ * @date  17.10.2026
+ ******************************************************************************/
+int HostFileSystem::open(const std::string& path, unsigned mode)
+{
+  if (mode >= NUM_MODES) return -EINVAL;
+  std::string host = (s_aiOpenFlags[mode] == O_RDONLY) ? hostPath(path) : outputPath(path, true);
+  if (host.empty()) return -EACCES;
+  int fd = ::open(host.c_str(), s_aiOpenFlags[mode], 0666);
+  if (fd < 0) return -errno;
+  m_open[fd] = true;
+  return fd;
+}
+
+int HostFileSystem::close(int fd)
+{
+  if (m_open.erase(fd) == 0u) return -EBADF;
+  return (::close(fd) == 0) ? 0 : -errno;
+}
+
+long HostFileSystem::read(int fd, void* pBuf, size_t len)
+{
+  if (m_open.count(fd) == 0u) return -EBADF;
+  ssize_t got = ::read(fd, pBuf, len);
+  return (got < 0) ? -errno : (long)got;
+}
+
+long HostFileSystem::write(int fd, const void* pData, size_t len)
+{
+  if (m_open.count(fd) == 0u) return -EBADF;
+  const uint8_t* pucData = static_cast<const uint8_t*>(pData);
+  size_t done = 0u;
+  while (done < len)
+  {
+    ssize_t written = ::write(fd, pucData + done, len - done);
+    if (written <= 0) return (done != 0u) ? (long)done : -errno;
+    done += (size_t)written;
+  }
+  return (long)done;
+}
+
+int HostFileSystem::seek(int fd, uint32_t pos)
+{
+  if (m_open.count(fd) == 0u) return -EBADF;
+  return (lseek(fd, (off_t)pos, SEEK_SET) < 0) ? -errno : 0;
+}
+
+long HostFileSystem::length(int fd)
+{
+  struct stat st;
+  if (m_open.count(fd) == 0u) return -EBADF;
+  return (fstat(fd, &st) != 0) ? -errno : (long)st.st_size;
+}
+
+int HostFileSystem::remove(const std::string& path)
+{
+  std::string host = outputPath(path, false);
+  if (host.empty()) return -EACCES;
+  return (unlink(host.c_str()) != 0) ? -errno : 0;
+}
+
+int HostFileSystem::rename(const std::string& from, const std::string& to)
+{
+  std::string hostFrom = outputPath(from, true), hostTo = outputPath(to, false);
+  if (hostFrom.empty() || hostTo.empty()) return -EACCES;
+  return (std::rename(hostFrom.c_str(), hostTo.c_str()) != 0) ? -errno : 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Resolve target path relative to the root directory
+ *
+ * The target only reaches files below the root: absolute paths and paths with
+ * ".." components are rejected.
+ *
+ * @param[in] path  Target path
+ * @return  (std::string) Host path (empty: rejected)
+ * @date  17.10.2026
+ ******************************************************************************/
+std::string HostFileSystem::hostPath(const std::string& path) const
+{
+  if (path.empty() || (path[0] == '/') || bLeavesRoot(path)) return std::string();
+  if (!m_output.empty())
+  {
+    struct stat st;
+    std::string output = m_output + "/" + path;
+    if (stat(output.c_str(), &st) == 0) return output;
+  }
+  return m_root + "/" + path;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Resolve target path of a file that is written, removed or renamed
+ *
+ * Without an output directory this is the path below the root. Otherwise the
+ * parent directories are created below the output directory, and a file only
+ * present below the root is copied first if the target modifies it in place.
+ *
+ * @param[in] path  Target path
+ * @param[in] bCopy Copy the file from the root directory if needed
+ * @return  (std::string) Host path (empty: rejected)
+ * @date  17.10.2026
+ ******************************************************************************/
+std::string HostFileSystem::outputPath(const std::string& path, bool bCopy) const
+{
+  if (m_output.empty()) return hostPath(path);
+  if (path.empty() || (path[0] == '/') || bLeavesRoot(path)) return std::string();
+  std::string output = m_output + "/" + path;
+  for (size_t pos = m_output.size() - 1u; (pos = output.find('/', pos + 1u)) != std::string::npos; )
+  {
+    mkdir(output.substr(0u, pos).c_str(), 0777);
+  }
+  struct stat st;
+  if (bCopy && (stat(output.c_str(), &st) != 0))
+  {
+    std::ifstream in(m_root + "/" + path, std::ios::binary);
+    if (in)
+    {
+      std::ofstream out(output, std::ios::binary);
+      out << in.rdbuf();
+    }
+  }
+  return output;
+}
+
+
+/*- In-memory file system ----------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Add or replace a file (not marked as modified)
+ ******************************************************************************/
+void MemoryFileSystem::add(const std::string& path, std::vector<uint8_t> data)
+{
+  auto file = std::make_shared<File>();
+  file->data = std::move(data);
+  m_files[normalise(path)] = file;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Add a copy of a host file
+ *
+ * @param[in] path      Target path
+ * @param[in] hostPath  Host file to copy
+ * @return  (bool)  Host file read
+ * @date  17.10.2026
+ ******************************************************************************/
+bool MemoryFileSystem::import(const std::string& path, const std::string& hostPath)
+{
+  std::ifstream in(hostPath, std::ios::binary);
+  if (!in) return false;
+  add(path, std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write modified files to the host
+ *
+ * Parent directories are created as needed; absolute target paths are placed
+ * below the root directory as well.
+ *
+ * @param[in] root  Host directory
+ * @return  (size_t)  Number of files written
+ * @date  17.10.2026
+ ******************************************************************************/
+size_t MemoryFileSystem::exportModified(const std::string& root) const
+{
+  size_t count = 0u;
+  for (const auto& entry : m_files)
+  {
+    if (!entry.second->modified) continue;
+    std::string hostPath = root + "/" + entry.first;
+    for (size_t pos = root.size() + 1u; (pos = hostPath.find('/', pos + 1u)) != std::string::npos; )
+    {
+      mkdir(hostPath.substr(0u, pos).c_str(), 0777);
+    }
+    std::ofstream out(hostPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(entry.second->data.data()), (std::streamsize)entry.second->data.size());
+    if (!out) throw std::runtime_error("cannot write " + hostPath);
+    ++count;
+  }
+  return count;
+}
+
+const MemoryFileSystem::File* MemoryFileSystem::find(const std::string& path) const
+{
+  auto it = m_files.find(normalise(path));
+  return (it != m_files.end()) ? it->second.get() : nullptr;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Open in-memory file
+ *
+ * Modes "w" create or truncate, "a" create and append, "r" require an existing
+ * file; "+" adds the other direction. Paths with ".." components are rejected
+ * (exported files stay below the root directory).
+ *
+ * @param[in] path  Target path
+ * @param[in] mode  SYS_OPEN mode
+ * @return  (int) Descriptor, or -errno
+ * @date  17.10.2026
+ ******************************************************************************/
+int MemoryFileSystem::open(const std::string& path, unsigned mode)
+{
+  if (mode >= NUM_MODES) return -EINVAL;
+  if (bLeavesRoot(path)) return -EACCES;
+  std::string name = normalise(path);
+  auto it = m_files.find(name);
+  unsigned kind = mode / 4u;          // 0: r, 1: w, 2: a
+  bool update = (mode & 2u) != 0u;
+  if (it == m_files.end())
+  {
+    if (kind == 0u) return -ENOENT;
+    it = m_files.emplace(name, std::make_shared<File>()).first;
+    it->second->modified = true;
+  }
+  else if (kind == 1u)
+  {
+    it->second->data.clear();
+    it->second->modified = true;
+  }
+
+  Handle handle;
+  handle.file = it->second;
+  handle.readable = (kind == 0u) || update;
+  handle.writable = (kind != 0u) || update;
+  handle.append = (kind == 2u);
+  m_handles[m_nextFd] = handle;
+  return m_nextFd++;
+}
+
+int MemoryFileSystem::close(int fd)
+{
+  return (m_handles.erase(fd) != 0u) ? 0 : -EBADF;
+}
+
+long MemoryFileSystem::read(int fd, void* pBuf, size_t len)
+{
+  auto it = m_handles.find(fd);
+  if (it == m_handles.end()) return -EBADF;
+  Handle& handle = it->second;
+  if (!handle.readable) return -EBADF;
+  const std::vector<uint8_t>& data = handle.file->data;
+  size_t count = (handle.pos < data.size()) ? std::min(len, data.size() - handle.pos) : 0u;
+  if (count != 0u) std::memcpy(pBuf, &data[handle.pos], count);
+  handle.pos += count;
+  return (long)count;
+}
+
+long MemoryFileSystem::write(int fd, const void* pData, size_t len)
+{
+  auto it = m_handles.find(fd);
+  if (it == m_handles.end()) return -EBADF;
+  Handle& handle = it->second;
+  if (!handle.writable) return -EBADF;
+  std::vector<uint8_t>& data = handle.file->data;
+  if (handle.append) handle.pos = data.size();
+  if (data.size() < handle.pos + len) data.resize(handle.pos + len);
+  if (len != 0u) std::memcpy(&data[handle.pos], pData, len);
+  handle.pos += len;
+  handle.file->modified = true;
+  return (long)len;
+}
+
+int MemoryFileSystem::seek(int fd, uint32_t pos)
+{
+  auto it = m_handles.find(fd);
+  if (it == m_handles.end()) return -EBADF;
+  it->second.pos = pos;
+  return 0;
+}
+
+long MemoryFileSystem::length(int fd)
+{
+  auto it = m_handles.find(fd);
+  return (it != m_handles.end()) ? (long)it->second.file->data.size() : -EBADF;
+}
+
+int MemoryFileSystem::remove(const std::string& path)
+{
+  return (m_files.erase(normalise(path)) != 0u) ? 0 : -ENOENT;
+}
+
+int MemoryFileSystem::rename(const std::string& from, const std::string& to)
+{
+  if (bLeavesRoot(to)) return -EACCES;
+  auto it = m_files.find(normalise(from));
+  if (it == m_files.end()) return -ENOENT;
+  std::shared_ptr<File> file = it->second;
+  m_files.erase(it);
+  file->modified = true;
+  m_files[normalise(to)] = file;
+  return 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Canonical file name: no leading "./" or "/", no repeated separators
+ ******************************************************************************/
+std::string MemoryFileSystem::normalise(const std::string& path)
+{
+  std::string name;
+  for (size_t pos = 0u; pos < path.size(); )
+  {
+    size_t end = path.find('/', pos);
+    if (end == std::string::npos) end = path.size();
+    std::string part = path.substr(pos, end - pos);
+    if (!part.empty() && (part != "."))
+    {
+      if (!name.empty()) name += '/';
+      name += part;
+    }
+    pos = end + 1u;
+  }
+  return name;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Check for ".." path components
+ *
+ * @param[in] path  Target path
+ * @return  (bool)  Path may resolve outside of its base directory
+ * @date  17.10.2026
+ ******************************************************************************/
+static bool bLeavesRoot(const std::string& path)
+{
+  for (size_t pos = 0u; pos <= path.size(); )
+  {
+    size_t end = path.find('/', pos);
+    if (end == std::string::npos) end = path.size();
+    if (path.compare(pos, end - pos, "..") == 0) return true;
+    pos = end + 1u;
+  }
+  return false;
+}
+
+} // namespace semihost
@@ -0,0 +1,129 @@
+/*!****************************************************************************
+ * @file
+ * filesystem.h
+ *
+ * @brief
+ * File systems for semihosting file operations: host directory or in-memory
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef SEMIHOST_FILESYSTEM_H_
+#define SEMIHOST_FILESYSTEM_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace semihost {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// File operations behind SYS_OPEN ... SYS_RENAME. Failures return -errno.
+class FileSystem
+{
+public:
+  virtual ~FileSystem() = default;
+
+  /// Open file in SYS_OPEN mode 0..11 (r, rb, r+, r+b, w, ..., a+b); returns
+  /// a descriptor >= 0
+  virtual int open(const std::string& path, unsigned mode) = 0;
+  virtual int close(int fd) = 0;
+
+  /// Transfer up to len bytes; returns the number of bytes transferred
+  virtual long read(int fd, void* pBuf, size_t len) = 0;
+  virtual long write(int fd, const void* pData, size_t len) = 0;
+
+  virtual int seek(int fd, uint32_t pos) = 0;
+  virtual long length(int fd) = 0;
+  virtual int remove(const std::string& path) = 0;
+  virtual int rename(const std::string& from, const std::string& to) = 0;
+};
+
+/// Host file system; relative paths are resolved against a root directory.
+/// Absolute paths and ".." components are rejected with -EACCES.
+/// With a separate output directory, files opened for writing, removed or
+/// renamed are placed there; reads fall back to the root directory.
+class HostFileSystem : public FileSystem
+{
+public:
+  explicit HostFileSystem(std::string root, std::string output = std::string())
+    : m_root(std::move(root)), m_output(std::move(output)) {}
+  ~HostFileSystem() override;
+
+  int open(const std::string& path, unsigned mode) override;
+  int close(int fd) override;
+  long read(int fd, void* pBuf, size_t len) override;
+  long write(int fd, const void* pData, size_t len) override;
+  int seek(int fd, uint32_t pos) override;
+  long length(int fd) override;
+  int remove(const std::string& path) override;
+  int rename(const std::string& from, const std::string& to) override;
+
+private:
+  std::string hostPath(const std::string& path) const;
+  std::string outputPath(const std::string& path, bool bCopy) const;
+
+  std::string m_root;
+  std::string m_output;               ///< Directory of written files (empty: root)
+  std::map<int, bool> m_open;         ///< Descriptors opened by the target
+};
+
+/// In-memory file system: no host side effects until files are exported
+class MemoryFileSystem : public FileSystem
+{
+public:
+  /// File contents
+  struct File
+  {
+    std::vector<uint8_t> data;
+    bool modified = false;            ///< Written, created or renamed by the target
+  };
+
+  /// Add or replace a file
+  void add(const std::string& path, std::vector<uint8_t> data);
+
+  /// Add a copy of a host file; returns false if it cannot be read
+  bool import(const std::string& path, const std::string& hostPath);
+
+  /// Write all modified files below a host directory; returns the number of
+  /// files written. Removals are not propagated.
+  size_t exportModified(const std::string& root) const;
+
+  /// File lookup (nullptr if not present)
+  const File* find(const std::string& path) const;
+  const std::map<std::string, std::shared_ptr<File>>& files() const { return m_files; }
+
+  int open(const std::string& path, unsigned mode) override;
+  int close(int fd) override;
+  long read(int fd, void* pBuf, size_t len) override;
+  long write(int fd, const void* pData, size_t len) override;
+  int seek(int fd, uint32_t pos) override;
+  long length(int fd) override;
+  int remove(const std::string& path) override;
+  int rename(const std::string& from, const std::string& to) override;
+
+private:
+  /// Open file description
+  struct Handle
+  {
+    std::shared_ptr<File> file;       ///< Stays valid if the file is removed
+    size_t pos = 0u;
+    bool readable = false;
+    bool writable = false;
+    bool append = false;
+  };
+
+  static std::string normalise(const std::string& path);
+
+  std::map<std::string, std::shared_ptr<File>> m_files;
+  std::map<int, Handle> m_handles;
+  int m_nextFd = 3;
+};
+
+} // namespace semihost
+
+#endif // SEMIHOST_FILESYSTEM_H_
@@ -0,0 +1,519 @@
+/*!****************************************************************************
+ * @file
+ * semihost_rsp.cpp
+ *
+ * @brief
+ * semihost-rsp: serve semihosting requests of a target through a GDB server
+ *
+ * Connects to a GDB remote serial protocol server (QEMU "-s", OpenOCD, J-Link
+ * GDB server) and places a breakpoint on the "bkpt 0xAB" instruction in
+ * ullSemihostReqOp(). On each hit, the request in r0/r1 is executed by the
+ * semihosting library on target memory, r0 is set to the result and the
+ * "bkpt" is skipped. The target's own semihosting support (QEMU
+ * "-semihosting", probe firmware) is bypassed, so file operations, latency
+ * and recording/replay behave the same as in the simulator.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <netdb.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "session.h"
+
+using namespace semihost;
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// Register numbers in the GDB ARM target description
+static constexpr unsigned REG_R0 = 0u;
+static constexpr unsigned REG_R1 = 1u;
+static constexpr unsigned REG_PC = 15u;
+
+/// Maximum payload per memory read/write packet
+static constexpr size_t MAX_TRANSFER = 256u;
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Command-line options
+struct Options
+{
+  SessionConfig session;
+  std::string target = "localhost:1234";
+  std::string image;
+  uint32_t bkpt = 0u;
+  bool hw = false;
+  bool sleep = false;
+};
+
+/// GDB remote serial protocol connection
+class RspClient
+{
+public:
+  explicit RspClient(const std::string& target);
+  ~RspClient() { ::close(m_fd); }
+
+  /// Send packet and wait for its reply
+  std::string transact(const std::string& payload) { send(payload); return receive(); }
+
+  void send(const std::string& payload);
+  std::string receive();
+
+  /*! @brief Register access (32-bit, target byte order)
+   *  @{                                                                      */
+  uint32_t readReg(unsigned n);
+  void writeReg(unsigned n, uint32_t value);
+  /*! @}                                                                      */
+
+private:
+  int getChar();
+
+  int m_fd;
+  char m_acBuf[4096];
+  size_t m_bufLen = 0u;
+  size_t m_bufPos = 0u;
+};
+
+/// Target memory accessed with "m"/"M" packets
+class RspMemory : public TargetMemory
+{
+public:
+  explicit RspMemory(RspClient& rsp) : m_rsp(rsp) {}
+
+  void read(uint32_t addr, void* pBuf, size_t len) override;
+  void write(uint32_t addr, const void* pData, size_t len) override;
+
+private:
+  RspClient& m_rsp;
+};
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Print usage
+ ******************************************************************************/
+static void vUsage(const char* pszProg)
+{
+  std::fprintf(stderr,
+    "usage: %s [options] [image.elf]\n"
+    "  --target HOST:PORT  GDB server (localhost:1234)\n"
+    "  --bkpt ADDR         address of \"bkpt 0xAB\" (default: ullSemihostReqOp in image)\n"
+    "  --hw                use a hardware breakpoint\n"
+    "  --cmdline STR       SYS_GET_CMDLINE string\n"
+    "  --root DIR          base directory for relative semihosting paths (.)\n"
+    "  --allow-system      permit SYS_SYSTEM\n"
+    "  --vfs               serve files from memory, write modified files to --root at exit\n"
+    "  --vfs-import PATH   copy file from --root into memory (repeatable)\n"
+    "  --latency SPEC      service time per operation, e.g. \"*=20000,write=50000+100\" (ns)\n"
+    "  --sleep             delay each request by its service time\n"
+    "  --record FILE       record semihosting traffic\n"
+    "  --replay FILE       replay recorded traffic instead of accessing the host\n"
+    "  --no-verify         do not compare target memory with the recording\n",
+    pszProg);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Hex digit value
+ ******************************************************************************/
+static unsigned hexValue(char c)
+{
+  if ((c >= '0') && (c <= '9')) return (unsigned)(c - '0');
+  if ((c >= 'a') && (c <= 'f')) return (unsigned)(c - 'a' + 10);
+  if ((c >= 'A') && (c <= 'F')) return (unsigned)(c - 'A' + 10);
+  throw std::runtime_error(std::string("invalid hex digit in RSP reply: ") + c);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read ELF32 symbol table
+ *
+ * @param[in] path  Image path
+ * @return  (std::map)  Symbol name -> value
+ * @date  17.10.2026
+ ******************************************************************************/
+static std::map<std::string, uint32_t> readSymbols(const std::string& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::runtime_error("cannot open " + path);
+  std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  auto get32 = [&](size_t off) -> uint32_t {
+    if (off + 4u > image.size()) throw std::runtime_error(path + ": truncated ELF file");
+    return image[off] | (image[off + 1u] << 8) | (image[off + 2u] << 16) | ((uint32_t)image[off + 3u] << 24);
+  };
+  auto get16 = [&](size_t off) -> uint32_t { return get32(off) & 0xFFFFu; };
+  if ((image.size() < 52u) || (std::memcmp(image.data(), "\x7F" "ELF\x01\x01", 6u) != 0))
+  {
+    throw std::runtime_error(path + ": not a little-endian ELF32 file");
+  }
+
+  std::map<std::string, uint32_t> symbols;
+  uint32_t ulShOff = get32(32u), ulShEntSize = get16(46u), ulShNum = get16(48u);
+  for (uint32_t i = 0u; i < ulShNum; ++i)
+  {
+    size_t sh = ulShOff + i * ulShEntSize;
+    if (get32(sh + 4u) != 2u) continue;   // SHT_SYMTAB
+    size_t strSh = ulShOff + get32(sh + 24u) * ulShEntSize;
+    uint32_t ulStrOff = get32(strSh + 16u), ulStrSize = get32(strSh + 20u);
+    uint32_t ulSymOff = get32(sh + 16u), ulSymSize = get32(sh + 20u);
+    for (uint32_t sym = 16u; sym + 16u <= ulSymSize; sym += 16u)
+    {
+      uint32_t ulName = get32(ulSymOff + sym);
+      if ((ulName == 0u) || (ulName >= ulStrSize) || (ulStrOff + ulStrSize > image.size())) continue;
+      const char* pszName = reinterpret_cast<const char*>(&image[ulStrOff + ulName]);
+      symbols[std::string(pszName, strnlen(pszName, ulStrSize - ulName))] = get32(ulSymOff + sym + 4u);
+    }
+  }
+  return symbols;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Parse command line
+ *
+ * @return  (bool)  Options valid
+ * @date  17.10.2026
+ ******************************************************************************/
+static bool bParseArgs(int argc, char* argv[], Options& opts)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    auto value = [&]() -> const char* {
+      if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+      return argv[++i];
+    };
+    if (arg == "--target") opts.target = value();
+    else if (arg == "--bkpt") opts.bkpt = (uint32_t)std::strtoul(value(), nullptr, 0);
+    else if (arg == "--hw") opts.hw = true;
+    else if (arg == "--cmdline") opts.session.server.cmdline = value();
+    else if (arg == "--root") opts.session.root = value();
+    else if (arg == "--allow-system") opts.session.server.allowSystem = true;
+    else if (arg == "--vfs") opts.session.vfs = true;
+    else if (arg == "--vfs-import") opts.session.vfsImport.push_back(value());
+    else if (arg == "--latency") opts.session.server.latency = parseLatency(value());
+    else if (arg == "--sleep") opts.sleep = true;
+    else if (arg == "--record") opts.session.record = value();
+    else if (arg == "--replay") opts.session.replay = value();
+    else if (arg == "--no-verify") opts.session.verify = false;
+    else if ((arg == "-h") || (arg == "--help")) return false;
+    else if (arg[0] == '-') throw std::runtime_error("unknown option " + arg);
+    else opts.image = arg;
+  }
+  if (!opts.session.record.empty() && !opts.session.replay.empty())
+  {
+    throw std::runtime_error("--record and --replay are exclusive");
+  }
+  return (opts.bkpt != 0u) || !opts.image.empty();
+}
+
+
+/*- RSP client ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Connect to GDB server
+ *
+ * @param[in] target  "host:port"
+ * @date  17.10.2026
+ ******************************************************************************/
+RspClient::RspClient(const std::string& target)
+{
+  size_t colon = target.rfind(':');
+  if (colon == std::string::npos) throw std::runtime_error("invalid target " + target);
+  std::string host = target.substr(0u, colon), port = target.substr(colon + 1u);
+
+  struct addrinfo hints = {};
+  struct addrinfo* pResult = nullptr;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.empty() ? "localhost" : host.c_str(), port.c_str(), &hints, &pResult) != 0)
+  {
+    throw std::runtime_error("cannot resolve " + target);
+  }
+  m_fd = -1;
+  for (struct addrinfo* p = pResult; (p != nullptr) && (m_fd < 0); p = p->ai_next)
+  {
+    m_fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+    if ((m_fd >= 0) && (connect(m_fd, p->ai_addr, p->ai_addrlen) != 0))
+    {
+      ::close(m_fd);
+      m_fd = -1;
+    }
+  }
+  freeaddrinfo(pResult);
+  if (m_fd < 0) throw std::runtime_error("cannot connect to " + target);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send packet, retransmit until acknowledged
+ ******************************************************************************/
+void RspClient::send(const std::string& payload)
+{
+  uint8_t ucSum = 0u;
+  for (char c : payload) ucSum = (uint8_t)(ucSum + (uint8_t)c);
+  char acSum[4];
+  std::snprintf(acSum, sizeof(acSum), "%02x", ucSum);
+  std::string packet = "$" + payload + "#" + acSum;
+
+  for (;;)
+  {
+    if (::send(m_fd, packet.data(), packet.size(), 0) != (ssize_t)packet.size())
+    {
+      throw std::runtime_error("RSP connection lost");
+    }
+    int c;
+    while (((c = getChar()) != '+') && (c != '-')) {}
+    if (c == '+') return;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Receive packet; escapes and run-length encoding are expanded
+ ******************************************************************************/
+std::string RspClient::receive()
+{
+  for (;;)
+  {
+    while (getChar() != '$') {}
+    std::string payload;
+    uint8_t ucSum = 0u;
+    for (int c; (c = getChar()) != '#'; )
+    {
+      ucSum = (uint8_t)(ucSum + (uint8_t)c);
+      if (c == '}')
+      {
+        int next = getChar();
+        ucSum = (uint8_t)(ucSum + (uint8_t)next);
+        payload.push_back((char)(next ^ 0x20));
+      }
+      else if ((c == '*') && !payload.empty())
+      {
+        int count = getChar();
+        ucSum = (uint8_t)(ucSum + (uint8_t)count);
+        payload.append((size_t)(count - 29), payload.back());
+      }
+      else
+      {
+        payload.push_back((char)c);
+      }
+    }
+    unsigned sum = hexValue((char)getChar()) << 4;
+    sum |= hexValue((char)getChar());
+    bool ok = (sum == ucSum);
+    (void)::send(m_fd, ok ? "+" : "-", 1u, 0);
+    if (ok) return payload;
+  }
+}
+
+uint32_t RspClient::readReg(unsigned n)
+{
+  char acCmd[16];
+  std::snprintf(acCmd, sizeof(acCmd), "p%x", n);
+  std::string reply = transact(acCmd);
+  if (reply.size() < 8u) throw std::runtime_error("cannot read register " + std::to_string(n) + ": " + reply);
+  uint32_t value = 0u;
+  for (unsigned i = 0u; i < 4u; ++i)
+  {
+    value |= ((hexValue(reply[2u * i]) << 4) | hexValue(reply[2u * i + 1u])) << (8u * i);
+  }
+  return value;
+}
+
+void RspClient::writeReg(unsigned n, uint32_t value)
+{
+  char acCmd[32];
+  std::snprintf(acCmd, sizeof(acCmd), "P%x=%02x%02x%02x%02x", n, value & 0xFFu, (value >> 8) & 0xFFu,
+                (value >> 16) & 0xFFu, value >> 24);
+  std::string reply = transact(acCmd);
+  if (reply != "OK") throw std::runtime_error("cannot write register " + std::to_string(n) + ": " + reply);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Next received character
+ ******************************************************************************/
+int RspClient::getChar()
+{
+  if (m_bufPos == m_bufLen)
+  {
+    ssize_t got = recv(m_fd, m_acBuf, sizeof(m_acBuf), 0);
+    if (got <= 0) throw std::runtime_error("RSP connection closed");
+    m_bufLen = (size_t)got;
+    m_bufPos = 0u;
+  }
+  return (unsigned char)m_acBuf[m_bufPos++];
+}
+
+void RspMemory::read(uint32_t addr, void* pBuf, size_t len)
+{
+  uint8_t* pucBuf = static_cast<uint8_t*>(pBuf);
+  for (size_t done = 0u; done < len; )
+  {
+    size_t chunk = std::min(len - done, MAX_TRANSFER);
+    char acCmd[32];
+    std::snprintf(acCmd, sizeof(acCmd), "m%x,%zx", addr + (uint32_t)done, chunk);
+    std::string reply = m_rsp.transact(acCmd);
+    if ((reply.size() != 2u * chunk) || (reply[0] == 'E'))
+    {
+      throw std::runtime_error(std::string("cannot read target memory: ") + acCmd + " -> " + reply);
+    }
+    for (size_t i = 0u; i < chunk; ++i)
+    {
+      pucBuf[done + i] = (uint8_t)((hexValue(reply[2u * i]) << 4) | hexValue(reply[2u * i + 1u]));
+    }
+    done += chunk;
+  }
+}
+
+void RspMemory::write(uint32_t addr, const void* pData, size_t len)
+{
+  const uint8_t* pucData = static_cast<const uint8_t*>(pData);
+  for (size_t done = 0u; done < len; )
+  {
+    size_t chunk = std::min(len - done, MAX_TRANSFER);
+    char acCmd[32];
+    std::snprintf(acCmd, sizeof(acCmd), "M%x,%zx:", addr + (uint32_t)done, chunk);
+    std::string packet = acCmd;
+    for (size_t i = 0u; i < chunk; ++i)
+    {
+      char acByte[4];
+      std::snprintf(acByte, sizeof(acByte), "%02x", pucData[done + i]);
+      packet += acByte;
+    }
+    std::string reply = m_rsp.transact(packet);
+    if (reply != "OK") throw std::runtime_error(std::string("cannot write target memory: ") + acCmd + " -> " + reply);
+    done += chunk;
+  }
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Program entry point
+ *
+ * @return  (int) Exit code of the target (SYS_EXIT), 1 on errors or unexpected
+ *                stops, 2 on invalid usage
+ * @date  17.10.2026
+ ******************************************************************************/
+int main(int argc, char* argv[])
+{
+  Options opts;
+  try
+  {
+    if (!bParseArgs(argc, argv, opts))
+    {
+      vUsage(argv[0]);
+      return 2;
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 2;
+  }
+
+  try
+  {
+    if (!opts.image.empty())
+    {
+      auto symbols = readSymbols(opts.image);
+      opts.session.server.heap = heapInfo(symbols);
+      auto it = symbols.find("ullSemihostReqOp");
+      if ((opts.bkpt == 0u) && (it == symbols.end()))
+      {
+        throw std::runtime_error(opts.image + ": no symbol ullSemihostReqOp, use --bkpt");
+      }
+      if (opts.bkpt == 0u) opts.bkpt = it->second & ~1u;
+    }
+
+    Session session(opts.session);
+    RspClient rsp(opts.target);
+    RspMemory mem(rsp);
+
+    char acCmd[32];
+    (void)rsp.transact("?");
+    std::snprintf(acCmd, sizeof(acCmd), "Z%c,%x,2", opts.hw ? '1' : '0', opts.bkpt);
+    std::string reply = rsp.transact(acCmd);
+    if (reply != "OK") throw std::runtime_error(std::string("cannot set breakpoint: ") + acCmd + " -> " + reply);
+
+    uint64_t ullRequests = 0u, ullLatencyNs = 0u;
+    int exitCode = 1;
+    for (;;)
+    {
+      rsp.send("c");
+      std::string stop = rsp.receive();
+      while (!stop.empty() && (stop[0] == 'O') && (stop != "OK"))
+      {
+        // Console output of the GDB server (hex)
+        for (size_t i = 1u; i + 1u < stop.size(); i += 2u)
+        {
+          std::fputc((int)((hexValue(stop[i]) << 4) | hexValue(stop[i + 1u])), stdout);
+        }
+        stop = rsp.receive();
+      }
+      if (!stop.empty() && ((stop[0] == 'W') || (stop[0] == 'X')))
+      {
+        std::fprintf(stderr, "target terminated (%s)\n", stop.c_str());
+        break;
+      }
+
+      uint32_t ulPc = rsp.readReg(REG_PC);
+      if (ulPc != opts.bkpt)
+      {
+        std::fprintf(stderr, "target stopped at pc=0x%08x (%s)\n", ulPc, stop.c_str());
+        break;
+      }
+
+      Response res = session.handle(rsp.readReg(REG_R0), rsp.readReg(REG_R1), mem);
+      ++ullRequests;
+      ullLatencyNs += res.latencyNs;
+      if (!res.console.empty())
+      {
+        std::fwrite(res.console.data(), 1u, res.console.size(), stdout);
+        std::fflush(stdout);
+      }
+      if (opts.sleep && (res.latencyNs != 0u))
+      {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(res.latencyNs));
+      }
+      if (res.exit)
+      {
+        exitCode = res.exitCode;
+        try
+        {
+          rsp.send("k");            // GDB server may close without acknowledge
+        }
+        catch (const std::runtime_error&) {}
+        break;
+      }
+      rsp.writeReg(REG_R0, res.r0);
+      rsp.writeReg(REG_PC, opts.bkpt + 2u);
+    }
+
+    session.finish();
+    std::fprintf(stderr, "%llu semihosting requests, %.3f ms modelled service time, exit code %d\n",
+                 (unsigned long long)ullRequests, ullLatencyNs / 1e6, exitCode);
+    return exitCode;
+  }
+  catch (const std::exception& e)
+  {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,385 @@
+/*!****************************************************************************
+ * @file
+ * server.cpp
+ *
+ * @brief
+ * Arm semihosting service: operation handling and latency model
+ *
+ * Implements the operations used by the firmware's semihost.c independently of
+ * the transport: the simulator calls the server from its "bkpt 0xAB" handler,
+ * semihost-rsp from a GDB breakpoint, and unit tests directly on a buffer.
+ * File operations go to a FileSystem, console output is returned with the
+ * response, and every response carries the service time of a modelled probe,
+ * which the caller turns into simulated cycles or a real delay.
+ *
+ * Reference: https://github.com/ARM-software/abi-aa/blob/main/semihosting/semihosting.rst
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <stdexcept>
+#include "server.h"
+
+
+namespace semihost {
+
+/*- Macros -------------------------------------------------------------------*/
+/// SYS_EXIT reason: ADP_Stopped_ApplicationExit
+static constexpr uint32_t ADP_APPLICATION_EXIT = 0x20026u;
+
+/// Target handles of the console streams
+static constexpr int32_t HANDLE_STDIN       = 0;
+static constexpr int32_t HANDLE_STDOUT      = 1;
+static constexpr int32_t HANDLE_STDERR      = 2;
+
+/// Operation names for traces and latency specifications
+static const std::map<uint32_t, const char*> s_opNames = {
+  { SYS_OPEN, "open" }, { SYS_CLOSE, "close" }, { SYS_WRITEC, "writec" },
+  { SYS_WRITE0, "write0" }, { SYS_WRITE, "write" }, { SYS_READ, "read" },
+  { SYS_READC, "readc" }, { SYS_ISERROR, "iserror" }, { SYS_ISTTY, "istty" },
+  { SYS_SEEK, "seek" }, { SYS_FLEN, "flen" }, { SYS_TMPNAM, "tmpnam" },
+  { SYS_REMOVE, "remove" }, { SYS_RENAME, "rename" }, { SYS_CLOCK, "clock" },
+  { SYS_TIME, "time" }, { SYS_SYSTEM, "system" }, { SYS_ERRNO, "errno" },
+  { SYS_GET_CMDLINE, "get_cmdline" }, { SYS_HEAPINFO, "heapinfo" },
+  { SYS_EXIT, "exit" }, { SYS_EXIT_EXTENDED, "exit_extended" },
+  { SYS_ELAPSED, "elapsed" }, { SYS_TICKFREQ, "tickfreq" }
+};
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Parse latency specification
+ *
+ * Example: "*=20000,write=50000+100,open=2000000" models a probe with 20 us
+ * per request, plus 100 ns per byte written and 2 ms per file open.
+ *
+ * @param[in] spec  Comma-separated "op=NS[+NS]" entries
+ * @return  (LatencyModel)  Latency per operation
+ * @date  17.10.2026
+ ******************************************************************************/
+LatencyModel parseLatency(const std::string& spec)
+{
+  LatencyModel model;
+  for (size_t pos = 0u; pos < spec.size(); )
+  {
+    size_t end = spec.find(',', pos);
+    if (end == std::string::npos) end = spec.size();
+    std::string entry = spec.substr(pos, end - pos);
+    pos = end + 1u;
+
+    size_t eq = entry.find('=');
+    if (eq == std::string::npos) throw std::runtime_error("invalid latency entry: " + entry);
+    std::string name = entry.substr(0u, eq);
+    uint32_t op = 0u;
+    if (name != "*")
+    {
+      char* pEnd;
+      op = (uint32_t)std::strtoul(name.c_str(), &pEnd, 0);
+      if (name.empty() || (*pEnd != '\0'))
+      {
+        op = 0u;
+        for (const auto& known : s_opNames)
+        {
+          if (name == known.second) op = known.first;
+        }
+        if (op == 0u) throw std::runtime_error("unknown semihosting operation: " + name);
+      }
+    }
+
+    char* pEnd;
+    Latency latency;
+    latency.fixedNs = std::strtoull(entry.c_str() + eq + 1u, &pEnd, 0);
+    if (*pEnd == '+') latency.perByteNs = std::strtoull(pEnd + 1, &pEnd, 0);
+    if (*pEnd != '\0') throw std::runtime_error("invalid latency entry: " + entry);
+    model[op] = latency;
+  }
+  return model;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Operation name
+ ******************************************************************************/
+std::string opName(uint32_t op)
+{
+  auto it = s_opNames.find(op);
+  if (it != s_opNames.end()) return it->second;
+  char acBuf[16];
+  std::snprintf(acBuf, sizeof(acBuf), "0x%02x", op);
+  return acBuf;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Create server
+ *
+ * @param[in] config  Configuration
+ * @param[in] fs      File system for file operations
+ * @param[in] env     Time and input sources
+ * @date  17.10.2026
+ ******************************************************************************/
+Server::Server(ServerConfig config, FileSystem& fs, Environment env)
+  : m_config(std::move(config)), m_fs(fs), m_env(std::move(env))
+{
+  if (!m_env.nanoseconds)
+  {
+    auto start = std::chrono::steady_clock::now();
+    m_env.nanoseconds = [start]() {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start).count();
+    };
+  }
+  if (!m_env.ticks) m_env.ticks = m_env.nanoseconds;
+  if (!m_env.tickFreq) m_env.tickFreq = []() { return 1000000000u; };
+  if (!m_env.unixTime) m_env.unixTime = []() { return (uint32_t)std::time(nullptr); };
+  if (!m_env.readChar) m_env.readChar = []() { return std::getchar(); };
+}
+
+/*!****************************************************************************
+ * @brief
+ * Handle semihosting request
+ *
+ * @param[in] op      Operation number (r0)
+ * @param[in] arg     Argument (r1), usually a parameter block address
+ * @param[inout] mem  Target memory
+ * @return  (Response)  Result and service time
+ * @date  17.10.2026
+ ******************************************************************************/
+Response Server::handle(uint32_t op, uint32_t arg, TargetMemory& mem)
+{
+  Response rsp;
+  uint64_t bytes = 0u;
+  ++m_opCounts[op];
+  rsp.r0 = execute(op, arg, mem, rsp, bytes);
+
+  auto it = m_config.latency.find(op);
+  if (it == m_config.latency.end()) it = m_config.latency.find(0u);
+  if (it != m_config.latency.end()) rsp.latencyNs = it->second.fixedNs + it->second.perByteNs * bytes;
+  return rsp;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Execute semihosting operation
+ *
+ * @param[in] op      Operation number
+ * @param[in] arg     Argument
+ * @param[inout] mem  Target memory
+ * @param[out] rsp    Response (exit request, console output)
+ * @param[out] bytes  Payload size for the latency model
+ * @return  (uint32_t)  Result (r0)
+ * @date  17.10.2026
+ ******************************************************************************/
+uint32_t Server::execute(uint32_t op, uint32_t arg, TargetMemory& mem, Response& rsp, uint64_t& bytes)
+{
+  auto param = [&](unsigned i) { return mem.read32(arg + 4u * i); };
+
+  switch (op)
+  {
+    case SYS_OPEN:
+    {
+      std::string path = mem.readString(param(0u), param(2u));
+      uint32_t ulMode = param(1u);
+      if (ulMode >= 12u) return fail(EINVAL);
+      if (path == ":tt")
+      {
+        return (ulMode < 4u) ? HANDLE_STDIN : (ulMode < 8u) ? HANDLE_STDOUT : HANDLE_STDERR;
+      }
+      int fd = m_fs.open(path, ulMode);
+      return (fd < 0) ? fail(-fd) : (uint32_t)fd;
+    }
+
+    case SYS_CLOSE:
+    {
+      int32_t lHandle = (int32_t)param(0u);
+      if ((lHandle >= 0) && (lHandle <= HANDLE_STDERR)) return 0u;
+      int err = m_fs.close(lHandle);
+      return (err < 0) ? fail(-err) : 0u;
+    }
+
+    case SYS_WRITEC:
+      rsp.console.push_back((char)mem.read8(arg));
+      bytes = 1u;
+      return 0u;
+
+    case SYS_WRITE0:
+      rsp.console = mem.readString(arg, UINT32_MAX);
+      bytes = rsp.console.size();
+      return 0u;
+
+    case SYS_WRITE:
+    {
+      int32_t lHandle = (int32_t)param(0u);
+      uint32_t ulAddr = param(1u), ulLen = param(2u);
+      std::string data = mem.readString(ulAddr, ulLen);
+      if ((lHandle == HANDLE_STDOUT) || (lHandle == HANDLE_STDERR))
+      {
+        rsp.console = data;
+        bytes = ulLen;
+        return 0u;
+      }
+      long written = m_fs.write(lHandle, data.data(), data.size());
+      if (written < 0)
+      {
+        fail((int)-written);
+        return ulLen;
+      }
+      bytes = (uint64_t)written;
+      return ulLen - (uint32_t)written;
+    }
+
+    case SYS_READ:
+    {
+      int32_t lHandle = (int32_t)param(0u);
+      uint32_t ulAddr = param(1u), ulLen = param(2u);
+      std::string buf(ulLen, '\0');
+      long got = 0;
+      if (lHandle == HANDLE_STDIN)
+      {
+        // Line-buffered like a debugger console
+        for (int c = 0; ((uint32_t)got < ulLen) && (c != '\n'); )
+        {
+          if ((c = m_env.readChar()) < 0) break;
+          buf[(size_t)got++] = (char)c;
+        }
+      }
+      else
+      {
+        got = m_fs.read(lHandle, &buf[0], ulLen);
+        if (got < 0)
+        {
+          fail((int)-got);
+          return ulLen;
+        }
+      }
+      if (got > 0) mem.write(ulAddr, buf.data(), (size_t)got);
+      bytes = (uint64_t)got;
+      return ulLen - (uint32_t)got;
+    }
+
+    case SYS_READC:
+    {
+      int c = m_env.readChar();
+      return (c < 0) ? (uint32_t)-1 : (uint32_t)c;
+    }
+
+    case SYS_ISERROR:
+      return ((int32_t)param(0u) < 0) ? 1u : 0u;
+
+    case SYS_ISTTY:
+    {
+      int32_t lHandle = (int32_t)param(0u);
+      return ((lHandle >= 0) && (lHandle <= HANDLE_STDERR)) ? 1u : 0u;
+    }
+
+    case SYS_SEEK:
+    {
+      int err = m_fs.seek((int32_t)param(0u), param(1u));
+      return (err < 0) ? fail(-err) : 0u;
+    }
+
+    case SYS_FLEN:
+    {
+      long len = m_fs.length((int32_t)param(0u));
+      return (len < 0) ? fail((int)-len) : (uint32_t)len;
+    }
+
+    case SYS_TMPNAM:
+    {
+      char acName[32];
+      int len = std::snprintf(acName, sizeof(acName), "tmp/semihost%03u.tmp", param(1u) & 0xFFu);
+      if ((uint32_t)len + 1u > param(2u)) return (uint32_t)-1;
+      mem.write(param(0u), acName, (size_t)len + 1u);
+      return 0u;
+    }
+
+    case SYS_REMOVE:
+    {
+      int err = m_fs.remove(mem.readString(param(0u), param(1u)));
+      if (err < 0) fail(-err);
+      return (uint32_t)-err;
+    }
+
+    case SYS_RENAME:
+    {
+      std::string from = mem.readString(param(0u), param(1u));
+      std::string to = mem.readString(param(2u), param(3u));
+      int err = m_fs.rename(from, to);
+      if (err < 0) fail(-err);
+      return (uint32_t)-err;
+    }
+
+    case SYS_CLOCK:
+      return (uint32_t)(m_env.nanoseconds() / 10000000u);
+
+    case SYS_TIME:
+      return m_env.unixTime();
+
+    case SYS_SYSTEM:
+    {
+      if (!m_config.allowSystem) return (uint32_t)-1;
+      std::fflush(stdout);
+      return (uint32_t)std::system(mem.readString(param(0u), param(1u)).c_str());
+    }
+
+    case SYS_ERRNO:
+      return (uint32_t)m_errno;
+
+    case SYS_GET_CMDLINE:
+    {
+      uint32_t ulBuf = param(0u), ulSize = param(1u);
+      const std::string& cmdline = m_config.cmdline;
+      if (cmdline.size() + 1u > ulSize) return (uint32_t)-1;
+      mem.write(ulBuf, cmdline.c_str(), cmdline.size() + 1u);
+      mem.write32(arg + 4u, (uint32_t)cmdline.size());
+      bytes = cmdline.size();
+      return 0u;
+    }
+
+    case SYS_HEAPINFO:
+    {
+      uint32_t ulBlock = mem.read32(arg);
+      mem.write32(ulBlock + 0u, m_config.heap.heapBase);
+      mem.write32(ulBlock + 4u, m_config.heap.heapLimit);
+      mem.write32(ulBlock + 8u, m_config.heap.stackBase);
+      mem.write32(ulBlock + 12u, m_config.heap.stackLimit);
+      return 0u;
+    }
+
+    case SYS_EXIT:
+      // AArch32: r1 holds the reason code directly
+      rsp.exit = true;
+      rsp.exitCode = (arg == ADP_APPLICATION_EXIT) ? 0 : 1;
+      return 0u;
+
+    case SYS_EXIT_EXTENDED:
+      rsp.exit = true;
+      rsp.exitCode = (param(0u) == ADP_APPLICATION_EXIT) ? (int)param(1u) : 1;
+      return 0u;
+
+    case SYS_ELAPSED:
+    {
+      uint64_t ullTicks = m_env.ticks();
+      mem.write32(arg, (uint32_t)ullTicks);
+      mem.write32(arg + 4u, (uint32_t)(ullTicks >> 32));
+      return 0u;
+    }
+
+    case SYS_TICKFREQ:
+      return m_env.tickFreq();
+
+    default:
+      return (uint32_t)-1;
+  }
+}
+
+} // namespace semihost
@@ -0,0 +1,144 @@
+/*!****************************************************************************
+ * @file
+ * server.h
+ *
+ * @brief
+ * Arm semihosting service: operation handling and latency model
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef SEMIHOST_SERVER_H_
+#define SEMIHOST_SERVER_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include "filesystem.h"
+#include "target.h"
+
+
+namespace semihost {
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Semihosting operation numbers
+ *  @{                                                                        */
+static constexpr uint32_t SYS_OPEN          = 0x01u;
+static constexpr uint32_t SYS_CLOSE         = 0x02u;
+static constexpr uint32_t SYS_WRITEC        = 0x03u;
+static constexpr uint32_t SYS_WRITE0        = 0x04u;
+static constexpr uint32_t SYS_WRITE         = 0x05u;
+static constexpr uint32_t SYS_READ          = 0x06u;
+static constexpr uint32_t SYS_READC         = 0x07u;
+static constexpr uint32_t SYS_ISERROR       = 0x08u;
+static constexpr uint32_t SYS_ISTTY         = 0x09u;
+static constexpr uint32_t SYS_SEEK          = 0x0Au;
+static constexpr uint32_t SYS_FLEN          = 0x0Cu;
+static constexpr uint32_t SYS_TMPNAM        = 0x0Du;
+static constexpr uint32_t SYS_REMOVE        = 0x0Eu;
+static constexpr uint32_t SYS_RENAME        = 0x0Fu;
+static constexpr uint32_t SYS_CLOCK         = 0x10u;
+static constexpr uint32_t SYS_TIME          = 0x11u;
+static constexpr uint32_t SYS_SYSTEM        = 0x12u;
+static constexpr uint32_t SYS_ERRNO         = 0x13u;
+static constexpr uint32_t SYS_GET_CMDLINE   = 0x15u;
+static constexpr uint32_t SYS_HEAPINFO      = 0x16u;
+static constexpr uint32_t SYS_EXIT          = 0x18u;
+static constexpr uint32_t SYS_EXIT_EXTENDED = 0x20u;
+static constexpr uint32_t SYS_ELAPSED       = 0x30u;
+static constexpr uint32_t SYS_TICKFREQ      = 0x31u;
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Result of a semihosting request
+struct Response
+{
+  uint32_t r0 = 0u;                   ///< Result register
+  bool exit = false;                  ///< SYS_EXIT or SYS_EXIT_EXTENDED
+  int exitCode = 0;
+  uint64_t latencyNs = 0u;            ///< Modelled service time
+  std::string console;                ///< Output for the debugger console
+};
+
+/// Semihosting service: executes the request in r0 (operation) and r1
+/// (argument) against target memory
+class Service
+{
+public:
+  virtual ~Service() = default;
+  virtual Response handle(uint32_t op, uint32_t arg, TargetMemory& mem) = 0;
+};
+
+/// Service time of an operation: fixed part plus transferred bytes
+struct Latency
+{
+  uint64_t fixedNs = 0u;
+  uint64_t perByteNs = 0u;
+};
+
+/// Latency per operation number; key 0 is the default for all others
+using LatencyModel = std::map<uint32_t, Latency>;
+
+/// Parse latency specification "op=NS[+NS/B],...", where op is a number or a
+/// name (open, write, ...) or "*" for the default. Throws std::runtime_error.
+LatencyModel parseLatency(const std::string& spec);
+
+/// Operation name ("open", "write", ...) or hex number
+std::string opName(uint32_t op);
+
+/// Target-side memory layout for SYS_HEAPINFO
+struct HeapInfo
+{
+  uint32_t heapBase = 0u;
+  uint32_t heapLimit = 0u;
+  uint32_t stackBase = 0u;
+  uint32_t stackLimit = 0u;
+};
+
+/// Host environment of the server; unset callbacks use the host clock/stdin
+struct Environment
+{
+  std::function<uint64_t()> nanoseconds;  ///< Execution time (SYS_CLOCK)
+  std::function<uint64_t()> ticks;        ///< SYS_ELAPSED counter
+  std::function<uint32_t()> tickFreq;     ///< SYS_TICKFREQ
+  std::function<uint32_t()> unixTime;     ///< SYS_TIME
+  std::function<int()> readChar;          ///< Console input, -1 on EOF
+};
+
+/// Server configuration
+struct ServerConfig
+{
+  std::string cmdline;                ///< SYS_GET_CMDLINE result
+  bool allowSystem = false;           ///< Permit SYS_SYSTEM
+  HeapInfo heap;
+  LatencyModel latency;
+};
+
+/// Semihosting server for all operations of the Arm specification
+class Server : public Service
+{
+public:
+  Server(ServerConfig config, FileSystem& fs, Environment env = Environment());
+
+  Response handle(uint32_t op, uint32_t arg, TargetMemory& mem) override;
+
+  /// Number of calls per operation number
+  const std::map<uint32_t, uint64_t>& opCounts() const { return m_opCounts; }
+
+private:
+  uint32_t execute(uint32_t op, uint32_t arg, TargetMemory& mem, Response& rsp, uint64_t& bytes);
+  uint32_t fail(int err) { m_errno = err; return (uint32_t)-1; }
+
+  ServerConfig m_config;
+  FileSystem& m_fs;
+  Environment m_env;
+  int m_errno = 0;
+  std::map<uint32_t, uint64_t> m_opCounts;
+};
+
+} // namespace semihost
+
+#endif // SEMIHOST_SERVER_H_
@@ -0,0 +1,123 @@
+/*!****************************************************************************
+ * @file
+ * session.cpp
+ *
+ * @brief
+ * Semihosting session: file system, server, recording and replay per run
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdexcept>
+#include "session.h"
+
+
+namespace semihost {
+
+/*- Private functions --------------------------------------------------------*/
+/// Symbol lookup with default
+static uint32_t symbol(const std::map<std::string, uint32_t>& symbols, const char* pszName, uint32_t fallback)
+{
+  auto it = symbols.find(pszName);
+  return (it != symbols.end()) ? it->second : fallback;
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Create session
+ *
+ * @param[in] config  Configuration
+ * @param[in] env     Time and input sources of the server
+ * @date  17.10.2026
+ ******************************************************************************/
+Session::Session(const SessionConfig& config, Environment env)
+  : m_config(config)
+{
+  if (!m_config.replay.empty())
+  {
+    std::ifstream in(m_config.replay);
+    if (!in) throw std::runtime_error("cannot open " + m_config.replay);
+    m_replayer.reset(new Replayer(in, m_config.verify));
+    m_service = m_replayer.get();
+    return;
+  }
+
+  if (m_config.vfs)
+  {
+    auto pMemFs = new MemoryFileSystem();
+    m_fs.reset(pMemFs);
+    for (const std::string& path : m_config.vfsImport)
+    {
+      if (!pMemFs->import(path, m_config.root + "/" + path))
+      {
+        throw std::runtime_error("cannot import " + m_config.root + "/" + path);
+      }
+    }
+  }
+  else
+  {
+    m_fs.reset(new HostFileSystem(m_config.root, m_config.output));
+  }
+  m_server.reset(new Server(m_config.server, *m_fs, std::move(env)));
+  m_service = m_server.get();
+
+  if (!m_config.record.empty())
+  {
+    m_recordFile.open(m_config.record, std::ios::trunc);
+    if (!m_recordFile) throw std::runtime_error("cannot write " + m_config.record);
+    m_recorder.reset(new Recorder(*m_server, m_recordFile));
+    m_service = m_recorder.get();
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Handle semihosting request
+ ******************************************************************************/
+Response Session::handle(uint32_t op, uint32_t arg, TargetMemory& mem)
+{
+  ++m_opCounts[op];
+  return m_service->handle(op, arg, mem);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Complete run
+ ******************************************************************************/
+void Session::finish()
+{
+  if (m_recordFile.is_open()) m_recordFile.flush();
+  if (m_config.vfs && m_fs)
+  {
+    const std::string& output = m_config.output.empty() ? m_config.root : m_config.output;
+    static_cast<MemoryFileSystem&>(*m_fs).exportModified(output);
+  }
+  if (m_replayer && (m_replayer->position() != m_replayer->size()))
+  {
+    throw std::runtime_error("semihosting replay stopped after " + std::to_string(m_replayer->position()) +
+                             " of " + std::to_string(m_replayer->size()) + " requests");
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * SYS_HEAPINFO layout from linker script symbols
+ *
+ * @param[in] symbols Image symbol table
+ * @return  (HeapInfo)  Heap from "end" to the stack limit; zero if unknown
+ * @date  17.10.2026
+ ******************************************************************************/
+HeapInfo heapInfo(const std::map<std::string, uint32_t>& symbols)
+{
+  HeapInfo info;
+  info.heapBase = symbol(symbols, "end", symbol(symbols, "_end", 0u));
+  info.stackBase = symbol(symbols, "_estack", 0u);
+  info.stackLimit = info.stackBase - symbol(symbols, "_Min_Stack_Size", 0u);
+  info.heapLimit = info.stackLimit;
+  return info;
+}
+
+} // namespace semihost
@@ -0,0 +1,77 @@
+/*!****************************************************************************
+ * @file
+ * session.h
+ *
+ * @brief
+ * Semihosting session: file system, server, recording and replay per run
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef SEMIHOST_SESSION_H_
+#define SEMIHOST_SESSION_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "filesystem.h"
+#include "server.h"
+#include "trace.h"
+
+
+namespace semihost {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Session configuration, shared by the command-line front ends
+struct SessionConfig
+{
+  std::string root = ".";             ///< Base directory for relative paths
+  std::string output;                 ///< Directory of written files (empty: root)
+  bool vfs = false;                   ///< Serve files from memory
+  std::vector<std::string> vfsImport; ///< Files copied from root into memory
+  std::string record;                 ///< Trace output file
+  std::string replay;                 ///< Trace input file (no host access)
+  bool verify = true;                 ///< Check memory read during replay
+  ServerConfig server;
+};
+
+/// Service stack of one run: server on the host or in-memory file system,
+/// optionally recorded, or replay of a recording
+class Session : public Service
+{
+public:
+  Session(const SessionConfig& config, Environment env = Environment());
+
+  Response handle(uint32_t op, uint32_t arg, TargetMemory& mem) override;
+
+  /// End of run: write files modified in the in-memory file system to the
+  /// output directory, and check that a replayed trace was used completely.
+  /// Throws std::runtime_error.
+  void finish();
+
+  /// Number of calls per operation number
+  const std::map<uint32_t, uint64_t>& opCounts() const { return m_opCounts; }
+
+private:
+  SessionConfig m_config;
+  std::unique_ptr<FileSystem> m_fs;
+  std::unique_ptr<Server> m_server;
+  std::ofstream m_recordFile;
+  std::unique_ptr<Recorder> m_recorder;
+  std::unique_ptr<Replayer> m_replayer;
+  Service* m_service = nullptr;
+  std::map<uint32_t, uint64_t> m_opCounts;
+};
+
+/*- Public interface ---------------------------------------------------------*/
+/// SYS_HEAPINFO layout from the linker script symbols "end", "_estack" and
+/// "_Min_Stack_Size"
+HeapInfo heapInfo(const std::map<std::string, uint32_t>& symbols);
+
+} // namespace semihost
+
+#endif // SEMIHOST_SESSION_H_
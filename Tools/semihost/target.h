@@ -0,0 +1,114 @@
+/*!****************************************************************************
+ * @file
+ * target.h
+ *
+ * @brief
+ * Target memory access for semihosting services
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef SEMIHOST_TARGET_H_
+#define SEMIHOST_TARGET_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace semihost {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Target memory as seen by the semihosting service (little-endian)
+class TargetMemory
+{
+public:
+  virtual ~TargetMemory() = default;
+
+  /*! @brief Block access; implementations throw std::runtime_error on faults
+   *  @{                                                                      */
+  virtual void read(uint32_t addr, void* pBuf, size_t len) = 0;
+  virtual void write(uint32_t addr, const void* pData, size_t len) = 0;
+  /*! @}                                                                      */
+
+  /*! @brief Word and string helpers
+   *  @{                                                                      */
+  uint8_t read8(uint32_t addr) { uint8_t value; read(addr, &value, 1u); return value; }
+  uint32_t read32(uint32_t addr)
+  {
+    uint8_t aucBuf[4];
+    read(addr, aucBuf, 4u);
+    return aucBuf[0] | (aucBuf[1] << 8) | (aucBuf[2] << 16) | ((uint32_t)aucBuf[3] << 24);
+  }
+  void write32(uint32_t addr, uint32_t value)
+  {
+    uint8_t aucBuf[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    write(addr, aucBuf, 4u);
+  }
+
+  /// Read string of given length, or null-terminated for len == UINT32_MAX
+  std::string readString(uint32_t addr, uint32_t len)
+  {
+    std::string str;
+    if (len != UINT32_MAX)
+    {
+      str.resize(len);
+      if (len != 0u) read(addr, &str[0], len);
+      return str;
+    }
+    // Aligned chunks: fewer transfers on slow links, no access past the block
+    // holding the terminator
+    for (;;)
+    {
+      char acChunk[32];
+      size_t chunk = sizeof(acChunk) - (addr % sizeof(acChunk));
+      read(addr, acChunk, chunk);
+      size_t len = strnlen(acChunk, chunk);
+      str.append(acChunk, len);
+      if (len < chunk) return str;
+      addr += (uint32_t)chunk;
+    }
+  }
+  /*! @}                                                                      */
+};
+
+/// Flat memory block, e.g. for unit tests of target-side semihosting code
+class BufferMemory : public TargetMemory
+{
+public:
+  BufferMemory(uint32_t base, size_t size) : m_base(base), m_data(size, 0u) {}
+
+  void read(uint32_t addr, void* pBuf, size_t len) override
+  {
+    std::memcpy(pBuf, &m_data[offset(addr, len)], len);
+  }
+  void write(uint32_t addr, const void* pData, size_t len) override
+  {
+    std::memcpy(&m_data[offset(addr, len)], pData, len);
+  }
+
+  std::vector<uint8_t>& data() { return m_data; }
+
+private:
+  size_t offset(uint32_t addr, size_t len) const
+  {
+    if ((addr < m_base) || (addr - m_base + len > m_data.size()))
+    {
+      char acMsg[64];
+      std::snprintf(acMsg, sizeof(acMsg), "semihosting access outside target memory: 0x%08x", addr);
+      throw std::runtime_error(acMsg);
+    }
+    return addr - m_base;
+  }
+
+  uint32_t m_base;
+  std::vector<uint8_t> m_data;
+};
+
+} // namespace semihost
+
+#endif // SEMIHOST_TARGET_H_
@@ -0,0 +1,340 @@
+/*!****************************************************************************
+ * @file
+ * test_filesystem.cpp
+ *
+ * @brief
+ * Unit tests of the semihosting file systems (host directory and in-memory)
+ *
+ * Each case runs on both file systems unless it tests behaviour of only one;
+ * the host file system works in a temporary directory, which is removed
+ * afterwards. Prints the failed checks; the exit status is 1 if a check
+ * failed.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "filesystem.h"
+
+using namespace semihost;
+
+
+/*- Macros -------------------------------------------------------------------*/
+/// SYS_OPEN modes
+static constexpr unsigned MODE_RB = 1u;
+static constexpr unsigned MODE_RPB = 3u;
+static constexpr unsigned MODE_WB = 5u;
+static constexpr unsigned MODE_WPB = 7u;
+static constexpr unsigned MODE_AB = 9u;
+
+/// Record a failed check with its source line
+#define CHECK(cond)                                                           \
+  do                                                                          \
+  {                                                                           \
+    if (!(cond)) vFail(__FILE__, __LINE__, #cond);                            \
+  } while (0)
+
+
+/*- Global data --------------------------------------------------------------*/
+static unsigned s_uFailures = 0u;     ///< Failed checks
+static const char* s_pszCase = "";    ///< Current test case
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Report a failed check
+ ******************************************************************************/
+static void vFail(const char* pszFile, int iLine, const char* pszCond)
+{
+  std::printf("%s:%d: %s: check failed: %s\n", pszFile, iLine, s_pszCase, pszCond);
+  ++s_uFailures;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write a string to a file; returns the result of the write
+ ******************************************************************************/
+static long lWrite(FileSystem& fs, int fd, const std::string& text)
+{
+  return fs.write(fd, text.data(), text.size());
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read up to len bytes of a file into a string
+ ******************************************************************************/
+static std::string readString(FileSystem& fs, int fd, size_t len)
+{
+  std::string text(len, '\0');
+  long got = fs.read(fd, &text[0], len);
+  text.resize((got > 0) ? (size_t)got : 0u);
+  return text;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Contents of a file, opened read-only ("" if it cannot be opened)
+ ******************************************************************************/
+static std::string contents(FileSystem& fs, const std::string& path)
+{
+  int fd = fs.open(path, MODE_RB);
+  if (fd < 0) return std::string();
+  std::string text = readString(fs, fd, 4096u);
+  fs.close(fd);
+  return text;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Contents of a host file ("" if it cannot be read)
+ ******************************************************************************/
+static std::string hostContents(const std::string& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Open modes: "r" requires the file, "w" truncates, "a" appends, "+" adds the
+ * other direction; invalid modes are rejected
+ ******************************************************************************/
+static void vTestOpenModes(FileSystem& fs)
+{
+  char acBuf[4];
+  CHECK(fs.open("missing.bin", MODE_RB) == -ENOENT);
+  CHECK(fs.open("file.bin", 12u) == -EINVAL);
+
+  int fd = fs.open("file.bin", MODE_WB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(fs, fd, "hello") == 5);
+  CHECK(fs.read(fd, acBuf, sizeof(acBuf)) == -EBADF);
+  CHECK(fs.close(fd) == 0);
+  CHECK(contents(fs, "file.bin") == "hello");
+
+  fd = fs.open("file.bin", MODE_AB);
+  CHECK(fd >= 0);
+  CHECK(fs.seek(fd, 0u) == 0);
+  CHECK(lWrite(fs, fd, " world") == 6);
+  CHECK(fs.close(fd) == 0);
+  CHECK(contents(fs, "file.bin") == "hello world");
+
+  fd = fs.open("file.bin", MODE_RB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(fs, fd, "x") == -EBADF);
+  CHECK(fs.close(fd) == 0);
+
+  fd = fs.open("file.bin", MODE_RPB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(fs, fd, "J") == 1);
+  CHECK(readString(fs, fd, 4u) == "ello");
+  CHECK(fs.close(fd) == 0);
+  CHECK(contents(fs, "file.bin") == "Jello world");
+
+  fd = fs.open("file.bin", MODE_WB);
+  CHECK(fd >= 0);
+  CHECK(fs.length(fd) == 0);
+  CHECK(fs.close(fd) == 0);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reads and writes at seek positions, file length, end of file
+ ******************************************************************************/
+static void vTestReadWriteSeek(FileSystem& fs)
+{
+  int fd = fs.open("data.bin", MODE_WPB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(fs, fd, "0123456789") == 10);
+  CHECK(fs.length(fd) == 10);
+
+  CHECK(fs.seek(fd, 4u) == 0);
+  CHECK(readString(fs, fd, 3u) == "456");
+  CHECK(readString(fs, fd, 10u) == "789");
+  CHECK(readString(fs, fd, 10u).empty());
+
+  CHECK(fs.seek(fd, 2u) == 0);
+  CHECK(lWrite(fs, fd, "ab") == 2);
+  CHECK(fs.seek(fd, 0u) == 0);
+  CHECK(readString(fs, fd, 10u) == "01ab456789");
+
+  CHECK(fs.seek(fd, 12u) == 0);
+  CHECK(lWrite(fs, fd, "z") == 1);
+  CHECK(fs.length(fd) == 13);
+  CHECK(fs.close(fd) == 0);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Error codes of invalid descriptors, removal and renaming
+ ******************************************************************************/
+static void vTestErrors(FileSystem& fs)
+{
+  char acBuf[4];
+  CHECK(fs.close(1000) == -EBADF);
+  CHECK(fs.read(1000, acBuf, sizeof(acBuf)) == -EBADF);
+  CHECK(fs.write(1000, acBuf, sizeof(acBuf)) == -EBADF);
+  CHECK(fs.seek(1000, 0u) == -EBADF);
+  CHECK(fs.length(1000) == -EBADF);
+
+  int fd = fs.open("err.bin", MODE_WB);
+  CHECK(fd >= 0);
+  CHECK(fs.close(fd) == 0);
+  CHECK(fs.close(fd) == -EBADF);
+
+  CHECK(fs.rename("err.bin", "moved.bin") == 0);
+  CHECK(fs.open("err.bin", MODE_RB) == -ENOENT);
+  CHECK(fs.remove("moved.bin") == 0);
+  CHECK(fs.remove("moved.bin") == -ENOENT);
+  CHECK(fs.rename("moved.bin", "again.bin") == -ENOENT);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Paths leaving the root directory are rejected
+ ******************************************************************************/
+static void vTestPathEscape(FileSystem& fs)
+{
+  CHECK(fs.open("../escape.bin", MODE_WB) == -EACCES);
+  CHECK(fs.open("dir/../../escape.bin", MODE_WB) == -EACCES);
+  CHECK(fs.open("..", MODE_RB) == -EACCES);
+
+  int fd = fs.open("inside.bin", MODE_WB);
+  CHECK(fd >= 0);
+  CHECK(fs.close(fd) == 0);
+  CHECK(fs.rename("inside.bin", "../escape.bin") == -EACCES);
+  CHECK(fs.remove("inside.bin") == 0);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Host file system: relative paths below the root, absolute paths rejected
+ ******************************************************************************/
+static void vTestHostPaths(const std::string& root)
+{
+  HostFileSystem fs(root);
+  int fd = fs.open("mapped.bin", MODE_WB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(fs, fd, "mapped") == 6);
+  CHECK(fs.close(fd) == 0);
+  CHECK(hostContents(root + "/mapped.bin") == "mapped");
+
+  CHECK(fs.open(root + "/mapped.bin", MODE_RB) == -EACCES);
+  CHECK(fs.open("/etc/passwd", MODE_RB) == -EACCES);
+  CHECK(fs.open("", MODE_RB) == -EACCES);
+  CHECK(fs.remove(root + "/mapped.bin") == -EACCES);
+  CHECK(fs.remove("mapped.bin") == 0);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Host file system with output directory: written, removed and renamed files
+ * below the output directory, reads falling back to the root directory
+ ******************************************************************************/
+static void vTestHostOutput(const std::string& root)
+{
+  const std::string output = root + "/out";
+  HostFileSystem input(root);
+  int fd = input.open("shared.bin", MODE_WB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(input, fd, "shared") == 6);
+  CHECK(input.close(fd) == 0);
+
+  HostFileSystem fs(root, output);
+  CHECK(contents(fs, "shared.bin") == "shared");
+  fd = fs.open("build/result.bin", MODE_WB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(fs, fd, "result") == 6);
+  CHECK(fs.close(fd) == 0);
+  CHECK(hostContents(output + "/build/result.bin") == "result");
+  CHECK(contents(fs, "build/result.bin") == "result");
+
+  fd = fs.open("shared.bin", MODE_RPB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(fs, fd, "S") == 1);
+  CHECK(fs.close(fd) == 0);
+  CHECK(hostContents(output + "/shared.bin") == "Shared");
+  CHECK(hostContents(root + "/shared.bin") == "shared");
+
+  CHECK(fs.rename("shared.bin", "moved.bin") == 0);
+  CHECK(fs.remove("moved.bin") == 0);
+  CHECK(fs.remove("build/result.bin") == 0);
+  CHECK(input.remove("shared.bin") == 0);
+  CHECK(fs.open("../escape.bin", MODE_WB) == -EACCES);
+}
+
+/*!****************************************************************************
+ * @brief
+ * In-memory file system: name normalisation, modification flags and export
+ ******************************************************************************/
+static void vTestMemoryExport(const std::string& root)
+{
+  MemoryFileSystem fs;
+  fs.add("input.bin", std::vector<uint8_t>{ 'i', 'n' });
+  CHECK(contents(fs, "./input.bin") == "in");
+  CHECK(contents(fs, "/input.bin") == "in");
+  CHECK(!fs.find("input.bin")->modified);
+
+  int fd = fs.open("out//dir/result.bin", MODE_WB);
+  CHECK(fd >= 0);
+  CHECK(lWrite(fs, fd, "result") == 6);
+  CHECK(fs.close(fd) == 0);
+  CHECK(fs.find("out/dir/result.bin") != nullptr);
+  CHECK(fs.find("out/dir/result.bin")->modified);
+
+  CHECK(fs.exportModified(root) == 1u);
+  CHECK(hostContents(root + "/out/dir/result.bin") == "result");
+  CHECK(hostContents(root + "/input.bin").empty());
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+int main()
+{
+  char acRoot[] = "/tmp/semihost-test-XXXXXX";
+  if (mkdtemp(acRoot) == nullptr)
+  {
+    std::perror("mkdtemp");
+    return 1;
+  }
+  std::string root(acRoot);
+
+  const std::vector<std::pair<const char*, std::function<void(FileSystem&)>>> cases = {
+    { "open_modes", vTestOpenModes },
+    { "read_write_seek", vTestReadWriteSeek },
+    { "errors", vTestErrors },
+    { "path_escape", vTestPathEscape },
+  };
+  for (const auto& entry : cases)
+  {
+    s_pszCase = entry.first;
+    HostFileSystem host(root);
+    entry.second(host);
+    MemoryFileSystem memory;
+    entry.second(memory);
+  }
+  s_pszCase = "host_paths";
+  vTestHostPaths(root);
+  s_pszCase = "host_output";
+  vTestHostOutput(root);
+  s_pszCase = "memory_export";
+  vTestMemoryExport(root);
+
+  std::string command = "rm -rf '" + root + "'";
+  if (std::system(command.c_str()) != 0) std::printf("cannot remove %s\n", root.c_str());
+
+  std::printf("%u failed checks\n", s_uFailures);
+  return (s_uFailures != 0u) ? 1 : 0;
+}
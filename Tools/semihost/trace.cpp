@@ -0,0 +1,311 @@
+/*!****************************************************************************
+ * @file
+ * trace.cpp
+ *
+ * @brief
+ * Recording and replay of semihosting traffic
+ *
+ * Trace format (text, one item per line, numbers in hex):
+ *
+ *     # semihost trace v1
+ *     req <op> <arg> <name>       request (r0, r1)
+ *     rd <addr> <bytes>           target memory read by the host
+ *     wr <addr> <bytes>           target memory written by the host
+ *     con <bytes>                 console output
+ *     rsp <r0> <exit> <code> <ns> result, exit request and service time
+ *
+ * Contiguous accesses of the same direction are merged into one line.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include "trace.h"
+
+
+namespace semihost {
+
+/*- Macros -------------------------------------------------------------------*/
+/// First line of a trace
+static const char* const TRACE_HEADER = "# semihost trace v1";
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Target memory wrapper that logs all accesses of a request
+class RecordingMemory : public TargetMemory
+{
+public:
+  explicit RecordingMemory(TargetMemory& inner) : m_inner(inner) {}
+
+  void read(uint32_t addr, void* pBuf, size_t len) override
+  {
+    m_inner.read(addr, pBuf, len);
+    log(false, addr, pBuf, len);
+  }
+
+  void write(uint32_t addr, const void* pData, size_t len) override
+  {
+    m_inner.write(addr, pData, len);
+    log(true, addr, pData, len);
+  }
+
+  /// Access lines in order
+  std::string lines() const { return m_lines.str() + flush(); }
+
+private:
+  void log(bool write, uint32_t addr, const void* pData, size_t len)
+  {
+    const uint8_t* pucData = static_cast<const uint8_t*>(pData);
+    if (m_pending.empty() || (write != m_write) || (addr != m_addr + m_pending.size()))
+    {
+      m_lines << flush();
+      m_pending.clear();
+      m_write = write;
+      m_addr = addr;
+    }
+    m_pending.insert(m_pending.end(), pucData, pucData + len);
+  }
+
+  std::string flush() const;
+
+  TargetMemory& m_inner;
+  std::ostringstream m_lines;
+  std::vector<uint8_t> m_pending;
+  bool m_write = false;
+  uint32_t m_addr = 0u;
+};
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Hex dump of a byte sequence
+ ******************************************************************************/
+static std::string toHex(const uint8_t* pucData, size_t len)
+{
+  static const char acDigits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(2u * len);
+  for (size_t i = 0u; i < len; ++i)
+  {
+    hex.push_back(acDigits[pucData[i] >> 4]);
+    hex.push_back(acDigits[pucData[i] & 0x0Fu]);
+  }
+  return hex;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Parse hex dump
+ ******************************************************************************/
+static std::vector<uint8_t> fromHex(const std::string& hex)
+{
+  if ((hex.size() % 2u) != 0u) throw std::runtime_error("odd-length hex data in trace");
+  std::vector<uint8_t> data(hex.size() / 2u);
+  for (size_t i = 0u; i < data.size(); ++i)
+  {
+    data[i] = (uint8_t)std::stoul(hex.substr(2u * i, 2u), nullptr, 16);
+  }
+  return data;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Pending access line
+ ******************************************************************************/
+std::string RecordingMemory::flush() const
+{
+  if (m_pending.empty()) return std::string();
+  char acAddr[16];
+  std::snprintf(acAddr, sizeof(acAddr), "%08x", m_addr);
+  return std::string(m_write ? "wr " : "rd ") + acAddr + " " + toHex(m_pending.data(), m_pending.size()) + "\n";
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Create recorder
+ *
+ * @param[in] inner Service executing the requests
+ * @param[in] out   Trace output
+ * @date  17.10.2026
+ ******************************************************************************/
+Recorder::Recorder(Service& inner, std::ostream& out)
+  : m_inner(inner), m_out(out)
+{
+  m_out << TRACE_HEADER << "\n";
+}
+
+/*!****************************************************************************
+ * @brief
+ * Forward and record request
+ *
+ * The record is written after the request completed, including requests that
+ * fail with an exception (without response), so the trace ends at the failure.
+ *
+ * @param[in] op      Operation number
+ * @param[in] arg     Argument
+ * @param[inout] mem  Target memory
+ * @return  (Response)  Response of the inner service
+ * @date  17.10.2026
+ ******************************************************************************/
+Response Recorder::handle(uint32_t op, uint32_t arg, TargetMemory& mem)
+{
+  char acBuf[96];
+  std::snprintf(acBuf, sizeof(acBuf), "req %x %08x %s\n", op, arg, opName(op).c_str());
+  m_out << acBuf;
+
+  RecordingMemory recording(mem);
+  Response rsp;
+  try
+  {
+    rsp = m_inner.handle(op, arg, recording);
+  }
+  catch (...)
+  {
+    m_out << recording.lines() << std::flush;
+    throw;
+  }
+
+  m_out << recording.lines();
+  if (!rsp.console.empty())
+  {
+    m_out << "con " << toHex(reinterpret_cast<const uint8_t*>(rsp.console.data()), rsp.console.size()) << "\n";
+  }
+  std::snprintf(acBuf, sizeof(acBuf), "rsp %08x %d %d %llu\n", rsp.r0, rsp.exit ? 1 : 0, rsp.exitCode,
+                (unsigned long long)rsp.latencyNs);
+  m_out << acBuf;
+  if (rsp.exit) m_out.flush();
+  return rsp;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Load trace for replay
+ *
+ * @param[in] in      Trace input
+ * @param[in] verify  Compare memory read by the host with the recording
+ * @date  17.10.2026
+ ******************************************************************************/
+Replayer::Replayer(std::istream& in, bool verify)
+  : m_verify(verify)
+{
+  std::string line;
+  if (!std::getline(in, line) || (line != TRACE_HEADER)) throw std::runtime_error("not a semihosting trace");
+
+  bool complete = true;
+  for (unsigned lineNo = 2u; std::getline(in, line); ++lineNo)
+  {
+    std::istringstream fields(line);
+    std::string tag, value;
+    fields >> tag;
+    try
+    {
+      if (tag == "req")
+      {
+        if (!complete) throw std::runtime_error("request without response");
+        m_records.emplace_back();
+        fields >> std::hex >> m_records.back().op >> m_records.back().arg;
+        complete = false;
+      }
+      else if (tag.empty() || (tag[0] == '#'))
+      {
+        continue;
+      }
+      else if (complete)
+      {
+        throw std::runtime_error("'" + tag + "' outside request");
+      }
+      else if ((tag == "rd") || (tag == "wr"))
+      {
+        Access access;
+        access.write = (tag == "wr");
+        fields >> std::hex >> access.addr >> value;
+        access.data = fromHex(value);
+        m_records.back().accesses.push_back(std::move(access));
+      }
+      else if (tag == "con")
+      {
+        fields >> value;
+        std::vector<uint8_t> data = fromHex(value);
+        m_records.back().response.console.assign(data.begin(), data.end());
+      }
+      else if (tag == "rsp")
+      {
+        Response& rsp = m_records.back().response;
+        int exit = 0;
+        fields >> std::hex >> rsp.r0 >> std::dec >> exit >> rsp.exitCode >> rsp.latencyNs;
+        rsp.exit = (exit != 0);
+        complete = true;
+      }
+      else
+      {
+        throw std::runtime_error("unknown tag '" + tag + "'");
+      }
+      if (fields.fail()) throw std::runtime_error("malformed line");
+    }
+    catch (const std::exception& e)
+    {
+      throw std::runtime_error("trace line " + std::to_string(lineNo) + ": " + e.what());
+    }
+  }
+
+  // A trace cut off by a failed request ends before that request
+  if (!complete) m_records.pop_back();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Replay next request
+ *
+ * @param[in] op      Operation number
+ * @param[in] arg     Argument
+ * @param[inout] mem  Target memory
+ * @return  (Response)  Recorded response
+ * @date  17.10.2026
+ ******************************************************************************/
+Response Replayer::handle(uint32_t op, uint32_t arg, TargetMemory& mem)
+{
+  char acBuf[160];
+  if (m_next == m_records.size())
+  {
+    std::snprintf(acBuf, sizeof(acBuf), "semihosting trace ended before request %zu (%s)",
+                  m_next + 1u, opName(op).c_str());
+    throw std::runtime_error(acBuf);
+  }
+  const Record& record = m_records[m_next++];
+  if ((record.op != op) || (record.arg != arg))
+  {
+    std::snprintf(acBuf, sizeof(acBuf),
+                  "semihosting trace diverges at request %zu: %s(0x%08x), recorded %s(0x%08x)",
+                  m_next, opName(op).c_str(), arg, opName(record.op).c_str(), record.arg);
+    throw std::runtime_error(acBuf);
+  }
+
+  for (const Access& access : record.accesses)
+  {
+    if (access.write)
+    {
+      mem.write(access.addr, access.data.data(), access.data.size());
+    }
+    else if (m_verify)
+    {
+      std::vector<uint8_t> data(access.data.size());
+      mem.read(access.addr, data.data(), data.size());
+      if (data != access.data)
+      {
+        std::snprintf(acBuf, sizeof(acBuf),
+                      "semihosting trace diverges at request %zu (%s): memory at 0x%08x differs",
+                      m_next, opName(op).c_str(), access.addr);
+        throw std::runtime_error(acBuf);
+      }
+    }
+  }
+  return record.response;
+}
+
+} // namespace semihost
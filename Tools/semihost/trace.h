@@ -0,0 +1,82 @@
+/*!****************************************************************************
+ * @file
+ * trace.h
+ *
+ * @brief
+ * Recording and replay of semihosting traffic
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+#ifndef SEMIHOST_TRACE_H_
+#define SEMIHOST_TRACE_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "server.h"
+
+
+namespace semihost {
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Recording decorator: forwards requests and writes each request, the target
+/// memory it read and wrote, and the response to a text trace
+class Recorder : public Service
+{
+public:
+  Recorder(Service& inner, std::ostream& out);
+
+  Response handle(uint32_t op, uint32_t arg, TargetMemory& mem) override;
+
+private:
+  Service& m_inner;
+  std::ostream& m_out;
+};
+
+/// Replay of a recorded trace without host access: the recorded responses and
+/// memory writes are reproduced, and the request sequence and the memory read
+/// by the host are checked against the recording. A mismatch (divergence) or
+/// the end of the trace throws std::runtime_error.
+class Replayer : public Service
+{
+public:
+  explicit Replayer(std::istream& in, bool verify = true);
+
+  Response handle(uint32_t op, uint32_t arg, TargetMemory& mem) override;
+
+  /// Number of requests replayed
+  size_t position() const { return m_next; }
+
+  /// Number of requests in the trace
+  size_t size() const { return m_records.size(); }
+
+private:
+  /// Memory access of a record
+  struct Access
+  {
+    bool write;
+    uint32_t addr;
+    std::vector<uint8_t> data;
+  };
+
+  /// Recorded request
+  struct Record
+  {
+    uint32_t op = 0u;
+    uint32_t arg = 0u;
+    std::vector<Access> accesses;
+    Response response;
+  };
+
+  std::vector<Record> m_records;
+  size_t m_next = 0u;
+  bool m_verify;
+};
+
+} // namespace semihost
+
+#endif // SEMIHOST_TRACE_H_
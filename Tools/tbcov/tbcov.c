@@ -0,0 +1,538 @@
+/*!****************************************************************************
+ * @file
+ * tbcov.c
+ *
+ * @brief
+ * QEMU TCG plugin: translation block coverage collector
+ *
+ * Records the execution count of every translation block (TB) and of the con-
+ * trol flow edges between consecutively executed TBs. No firmware instrumenta-
+ * tion is required; the uninstrumented .elf file is run as-is. The results are
+ * written into a compact binary file on exit, which is then converted into gcov
+ * text files by "Tools/scripts/tbcov2gcov.py".
+ *
+ * Usage:
+ *   qemu-system-arm ... -plugin libtbcov.so,out=tbcov.bin[,lo=...][,hi=...]
+ *
+ * Arguments:
+ *   out   Output file name (default: "tbcov.bin")
+ *   lo    Lowest TB address to be recorded (default: 0)
+ *   hi    Highest TB address to be recorded, exclusive (default: unlimited)
+ *
+ * Output file format (all integers little-endian or LEB128 encoded):
+ *   char[4]  "TBCV"
+ *   u32      Format version
+ *   u32      Number of TB records
+ *   u32      Number of edge records
+ *   TB records, sorted by address:
+ *     uleb128  Start address, delta to previous record
+ *     uleb128  Size in bytes
+ *     uleb128  Execution count
+ *   Edge records, sorted by source and destination address:
+ *     uleb128  Source TB start address, delta to previous record
+ *     sleb128  Destination address, relative to source TB start address
+ *     uleb128  Execution count
+ *
+ * @note Counters are not updated atomically. This is sufficient for single-core
+ * machines such as the Cortex-M3 targets this plugin is intended for.
+ *
+ * @date  17.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <qemu-plugin.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Output file format
+ *  @{                                                                        */
+#define TBCOV_MAGIC                   "TBCV"  ///< File magic
+#define TBCOV_VERSION                 1u      ///< File format version
+/*! @}                                                                        */
+
+/*! @brief Container sizing
+ *  @{                                                                        */
+#define TB_POOL_CHUNK                 4096u   ///< TB entries per pool chunk
+#define MAP_INITIAL_SIZE              4096u   ///< Initial hash-map slot count
+#define SUCC_CACHE_SIZE               2u      ///< Cached successors per TB
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/// Successor edge, cached within its source TB
+typedef struct TbSucc
+{
+  uint64_t ullPc;                     ///< Destination address
+  uint64_t ullCount;                  ///< Number of transitions
+} TbSucc;
+
+/// Translation block record
+typedef struct TbEntry
+{
+  uint64_t ullPc;                     ///< Start address
+  uint64_t ullCount;                  ///< Execution count
+  uint32_t ulSize;                    ///< Size in bytes
+  uint32_t ulSuccs;                   ///< Number of cached successors in use
+  TbSucc asSucc[SUCC_CACHE_SIZE];     ///< Successor cache
+} TbEntry;
+
+/// Edge record for successors not fitting into the TB successor cache
+typedef struct EdgeEntry
+{
+  uint64_t ullFrom;                   ///< Source TB start address
+  uint64_t ullTo;                     ///< Destination address
+  uint64_t ullCount;                  ///< Number of transitions (0: unused)
+} EdgeEntry;
+
+/// Open-addressing hash-map: TB start address to TB pool index
+typedef struct TbMap
+{
+  uint32_t* pulSlots;                 ///< Pool index + 1 (0: unused slot)
+  uint32_t ulSize;                    ///< Number of slots (power of two)
+  uint32_t ulUsed;                    ///< Number of slots in use
+} TbMap;
+
+/// Open-addressing hash-map: overflow edges
+typedef struct EdgeMap
+{
+  EdgeEntry* psSlots;                 ///< Edge slots
+  uint32_t ulSize;                    ///< Number of slots (power of two)
+  uint32_t ulUsed;                    ///< Number of slots in use
+} EdgeMap;
+
+
+/*- Global data --------------------------------------------------------------*/
+QEMU_PLUGIN_EXPORT int qemu_plugin_version = QEMU_PLUGIN_VERSION;
+
+static TbEntry** s_ppsPool;           ///< TB pool chunks (stable addresses)
+static uint32_t s_ulPoolChunks;       ///< Number of allocated pool chunks
+static uint32_t s_ulTbCount;          ///< Number of TB entries in use
+static TbMap s_sTbMap;                ///< TB lookup
+static EdgeMap s_sEdgeMap;            ///< Overflow edges
+static TbEntry** s_ppsLast;           ///< Last executed TB, per vCPU
+static uint32_t s_ulVcpus;            ///< Number of entries in s_ppsLast
+
+static const char* s_pszOutput = "tbcov.bin";
+static uint64_t s_ullLo = 0uLL;
+static uint64_t s_ullHi = UINT64_MAX;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Hash function for 64-bit keys (Fibonacci hashing)
+ *
+ * @param[in] ullKey  Key
+ * @param[in] ulSize  Table size (power of two)
+ * @return  (uint32_t)  Slot index
+ * @date  17.10.2026
+ ******************************************************************************/
+static inline uint32_t ulHash(uint64_t ullKey, uint32_t ulSize)
+{
+  return (uint32_t)((ullKey * 0x9E3779B97F4A7C15uLL) >> 32) & (ulSize - 1u);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get TB entry by pool index
+ *
+ * @param[in] ulIdx Pool index
+ * @return  (TbEntry*)  TB entry
+ * @date  17.10.2026
+ ******************************************************************************/
+static inline TbEntry* psPoolGet(uint32_t ulIdx)
+{
+  return &s_ppsPool[ulIdx / TB_POOL_CHUNK][ulIdx % TB_POOL_CHUNK];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Allocate a new TB entry from the pool
+ *
+ * Entries are allocated in chunks, so their addresses remain valid for the
+ * lifetime of the plugin. This allows the execution callback to update the
+ * entry directly, without a hash-map lookup.
+ *
+ * @return  (uint32_t)  Pool index of the new entry
+ * @date  17.10.2026
+ ******************************************************************************/
+static uint32_t ulPoolAlloc(void)
+{
+  if (s_ulTbCount == s_ulPoolChunks * TB_POOL_CHUNK)
+  {
+    s_ppsPool = realloc(s_ppsPool, (s_ulPoolChunks + 1u) * sizeof(TbEntry*));
+    s_ppsPool[s_ulPoolChunks++] = calloc(TB_POOL_CHUNK, sizeof(TbEntry));
+  }
+  return s_ulTbCount++;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Look up or insert a TB entry
+ *
+ * @param[in] ullPc TB start address
+ * @return  (TbEntry*)  TB entry
+ * @date  17.10.2026
+ ******************************************************************************/
+static TbEntry* psTbMapGet(uint64_t ullPc)
+{
+  // Grow at 50% load factor
+  if (2u * (s_sTbMap.ulUsed + 1u) > s_sTbMap.ulSize)
+  {
+    uint32_t ulSize = s_sTbMap.ulSize ? 2u * s_sTbMap.ulSize : MAP_INITIAL_SIZE;
+    uint32_t* pulSlots = calloc(ulSize, sizeof(uint32_t));
+    for (uint32_t i = 0u; i < s_sTbMap.ulSize; ++i)
+    {
+      if (s_sTbMap.pulSlots[i] == 0u) continue;
+      uint32_t j = ulHash(psPoolGet(s_sTbMap.pulSlots[i] - 1u)->ullPc, ulSize);
+      while (pulSlots[j] != 0u) j = (j + 1u) & (ulSize - 1u);
+      pulSlots[j] = s_sTbMap.pulSlots[i];
+    }
+    free(s_sTbMap.pulSlots);
+    s_sTbMap.pulSlots = pulSlots;
+    s_sTbMap.ulSize = ulSize;
+  }
+
+  // Linear probing
+  uint32_t i = ulHash(ullPc, s_sTbMap.ulSize);
+  while (s_sTbMap.pulSlots[i] != 0u)
+  {
+    TbEntry* psTb = psPoolGet(s_sTbMap.pulSlots[i] - 1u);
+    if (psTb->ullPc == ullPc) return psTb;
+    i = (i + 1u) & (s_sTbMap.ulSize - 1u);
+  }
+
+  uint32_t ulIdx = ulPoolAlloc();
+  s_sTbMap.pulSlots[i] = ulIdx + 1u;
+  ++s_sTbMap.ulUsed;
+
+  TbEntry* psTb = psPoolGet(ulIdx);
+  psTb->ullPc = ullPc;
+  return psTb;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Count an edge that does not fit into the successor cache
+ *
+ * @param[in] ullFrom Source TB start address
+ * @param[in] ullTo   Destination address
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vEdgeMapCount(uint64_t ullFrom, uint64_t ullTo)
+{
+  // Grow at 50% load factor
+  if (2u * (s_sEdgeMap.ulUsed + 1u) > s_sEdgeMap.ulSize)
+  {
+    uint32_t ulSize = s_sEdgeMap.ulSize ? 2u * s_sEdgeMap.ulSize : MAP_INITIAL_SIZE;
+    EdgeEntry* psSlots = calloc(ulSize, sizeof(EdgeEntry));
+    for (uint32_t i = 0u; i < s_sEdgeMap.ulSize; ++i)
+    {
+      const EdgeEntry* psOld = &s_sEdgeMap.psSlots[i];
+      if (psOld->ullCount == 0uLL) continue;
+      uint32_t j = ulHash(psOld->ullFrom ^ (psOld->ullTo << 1), ulSize);
+      while (psSlots[j].ullCount != 0uLL) j = (j + 1u) & (ulSize - 1u);
+      psSlots[j] = *psOld;
+    }
+    free(s_sEdgeMap.psSlots);
+    s_sEdgeMap.psSlots = psSlots;
+    s_sEdgeMap.ulSize = ulSize;
+  }
+
+  // Linear probing
+  uint32_t i = ulHash(ullFrom ^ (ullTo << 1), s_sEdgeMap.ulSize);
+  while (s_sEdgeMap.psSlots[i].ullCount != 0uLL)
+  {
+    EdgeEntry* psEdge = &s_sEdgeMap.psSlots[i];
+    if ((psEdge->ullFrom == ullFrom) && (psEdge->ullTo == ullTo))
+    {
+      ++psEdge->ullCount;
+      return;
+    }
+    i = (i + 1u) & (s_sEdgeMap.ulSize - 1u);
+  }
+
+  s_sEdgeMap.psSlots[i] = (EdgeEntry){ ullFrom, ullTo, 1uLL };
+  ++s_sEdgeMap.ulUsed;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Callback: TB executed
+ *
+ * Hot path. Increments the TB counter and the edge counter from the previously
+ * executed TB on this vCPU. Most edges are resolved in the source TB's succes-
+ * sor cache; the hash-map is only consulted for indirect branches and excep-
+ * tion entries.
+ *
+ * @param[in] uVcpu Index of the executing vCPU
+ * @param[in] pUser TB entry
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vTbExecCb(unsigned int uVcpu, void* pUser)
+{
+  TbEntry* psTb = pUser;
+  ++psTb->ullCount;
+
+  if (uVcpu >= s_ulVcpus) return;
+  TbEntry* psLast = s_ppsLast[uVcpu];
+  s_ppsLast[uVcpu] = psTb;
+  if (psLast == NULL) return;
+
+  for (uint32_t i = 0u; i < psLast->ulSuccs; ++i)
+  {
+    if (psLast->asSucc[i].ullPc == psTb->ullPc)
+    {
+      ++psLast->asSucc[i].ullCount;
+      return;
+    }
+  }
+  if (psLast->ulSuccs < SUCC_CACHE_SIZE)
+  {
+    psLast->asSucc[psLast->ulSuccs++] = (TbSucc){ psTb->ullPc, 1uLL };
+    return;
+  }
+  vEdgeMapCount(psLast->ullPc, psTb->ullPc);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Callback: TB translated
+ *
+ * Registers the execution callback for TBs within the recorded address range.
+ * A TB may be translated several times (e.g. after a TB cache flush); all
+ * translations share one entry.
+ *
+ * @param[in] id    Plugin ID
+ * @param[in] psTb  Translated TB
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vTbTransCb(qemu_plugin_id_t id, struct qemu_plugin_tb* psTb)
+{
+  (void)id;
+
+  uint64_t ullPc = qemu_plugin_tb_vaddr(psTb);
+  size_t uInsns = qemu_plugin_tb_n_insns(psTb);
+  if ((ullPc < s_ullLo) || (ullPc >= s_ullHi) || (uInsns == 0u)) return;
+
+  struct qemu_plugin_insn* psLast = qemu_plugin_tb_get_insn(psTb, uInsns - 1u);
+  uint64_t ullEnd = qemu_plugin_insn_vaddr(psLast) + qemu_plugin_insn_size(psLast);
+
+  TbEntry* psEntry = psTbMapGet(ullPc);
+  if ((uint32_t)(ullEnd - ullPc) > psEntry->ulSize)
+  {
+    psEntry->ulSize = (uint32_t)(ullEnd - ullPc);
+  }
+  qemu_plugin_register_vcpu_tb_exec_cb(psTb, vTbExecCb, QEMU_PLUGIN_CB_NO_REGS, psEntry);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write unsigned LEB128 value
+ *
+ * @param[in] pFile   Output file
+ * @param[in] ullVal  Value
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vWriteUleb(FILE* pFile, uint64_t ullVal)
+{
+  do
+  {
+    uint8_t ucByte = ullVal & 0x7Fu;
+    ullVal >>= 7;
+    if (ullVal != 0uLL) ucByte |= 0x80u;
+    fputc(ucByte, pFile);
+  } while (ullVal != 0uLL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write signed LEB128 value
+ *
+ * @param[in] pFile   Output file
+ * @param[in] llVal   Value
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vWriteSleb(FILE* pFile, int64_t llVal)
+{
+  bool bMore = true;
+  while (bMore)
+  {
+    uint8_t ucByte = llVal & 0x7F;
+    llVal >>= 7;
+    bMore = !(((llVal == 0) && !(ucByte & 0x40u)) || ((llVal == -1) && (ucByte & 0x40u)));
+    if (bMore) ucByte |= 0x80u;
+    fputc(ucByte, pFile);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write 32-bit little-endian value
+ *
+ * @param[in] pFile   Output file
+ * @param[in] ulVal   Value
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vWriteU32(FILE* pFile, uint32_t ulVal)
+{
+  for (int i = 0; i < 4; ++i) fputc((ulVal >> (8 * i)) & 0xFFu, pFile);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Comparison function: TB entries by start address
+ ******************************************************************************/
+static int iCompareTb(const void* pA, const void* pB)
+{
+  const TbEntry* psA = *(TbEntry* const*)pA;
+  const TbEntry* psB = *(TbEntry* const*)pB;
+  return (psA->ullPc > psB->ullPc) - (psA->ullPc < psB->ullPc);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Comparison function: edges by source and destination address
+ ******************************************************************************/
+static int iCompareEdge(const void* pA, const void* pB)
+{
+  const EdgeEntry* psA = pA;
+  const EdgeEntry* psB = pB;
+  if (psA->ullFrom != psB->ullFrom) return (psA->ullFrom > psB->ullFrom) ? 1 : -1;
+  return (psA->ullTo > psB->ullTo) - (psA->ullTo < psB->ullTo);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Callback: QEMU exiting, write output file
+ *
+ * @param[in] id    Plugin ID
+ * @param[in] pUser Unused
+ * @date  17.10.2026
+ ******************************************************************************/
+static void vExitCb(qemu_plugin_id_t id, void* pUser)
+{
+  (void)id; (void)pUser;
+
+  // Collect executed TBs
+  TbEntry** ppsTbs = malloc((s_ulTbCount + 1u) * sizeof(TbEntry*));
+  uint32_t ulTbs = 0u;
+  for (uint32_t i = 0u; i < s_ulTbCount; ++i)
+  {
+    if (psPoolGet(i)->ullCount != 0uLL) ppsTbs[ulTbs++] = psPoolGet(i);
+  }
+  qsort(ppsTbs, ulTbs, sizeof(TbEntry*), iCompareTb);
+
+  // Collect all edges: successor caches and overflow map
+  uint32_t ulEdgeCap = s_sEdgeMap.ulUsed + SUCC_CACHE_SIZE * ulTbs + 1u;
+  EdgeEntry* psEdges = malloc(ulEdgeCap * sizeof(EdgeEntry));
+  uint32_t ulEdges = 0u;
+  for (uint32_t i = 0u; i < ulTbs; ++i)
+  {
+    for (uint32_t j = 0u; j < ppsTbs[i]->ulSuccs; ++j)
+    {
+      psEdges[ulEdges++] = (EdgeEntry){
+        ppsTbs[i]->ullPc, ppsTbs[i]->asSucc[j].ullPc, ppsTbs[i]->asSucc[j].ullCount
+      };
+    }
+  }
+  for (uint32_t i = 0u; i < s_sEdgeMap.ulSize; ++i)
+  {
+    if (s_sEdgeMap.psSlots[i].ullCount != 0uLL) psEdges[ulEdges++] = s_sEdgeMap.psSlots[i];
+  }
+  qsort(psEdges, ulEdges, sizeof(EdgeEntry), iCompareEdge);
+
+  FILE* pFile = fopen(s_pszOutput, "wb");
+  if (pFile == NULL)
+  {
+    fprintf(stderr, "tbcov: cannot open \"%s\" for writing\n", s_pszOutput);
+  }
+  else
+  {
+    fwrite(TBCOV_MAGIC, 1u, 4u, pFile);
+    vWriteU32(pFile, TBCOV_VERSION);
+    vWriteU32(pFile, ulTbs);
+    vWriteU32(pFile, ulEdges);
+
+    uint64_t ullPrev = 0uLL;
+    for (uint32_t i = 0u; i < ulTbs; ++i)
+    {
+      vWriteUleb(pFile, ppsTbs[i]->ullPc - ullPrev);
+      vWriteUleb(pFile, ppsTbs[i]->ulSize);
+      vWriteUleb(pFile, ppsTbs[i]->ullCount);
+      ullPrev = ppsTbs[i]->ullPc;
+    }
+
+    ullPrev = 0uLL;
+    for (uint32_t i = 0u; i < ulEdges; ++i)
+    {
+      vWriteUleb(pFile, psEdges[i].ullFrom - ullPrev);
+      vWriteSleb(pFile, (int64_t)(psEdges[i].ullTo - psEdges[i].ullFrom));
+      vWriteUleb(pFile, psEdges[i].ullCount);
+      ullPrev = psEdges[i].ullFrom;
+    }
+    fclose(pFile);
+  }
+
+  free(psEdges);
+  free(ppsTbs);
+}
+
+
+/*- Public interface ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Plugin entry point
+ *
+ * @param[in] id      Plugin ID
+ * @param[in] psInfo  QEMU system information
+ * @param[in] argc    Number of plugin arguments
+ * @param[in] argv    Plugin arguments ("key=value")
+ * @return  (int) 0 on success
+ * @date  17.10.2026
+ ******************************************************************************/
+QEMU_PLUGIN_EXPORT int qemu_plugin_install(qemu_plugin_id_t id,
+                                           const qemu_info_t* psInfo,
+                                           int argc, char** argv)
+{
+  for (int i = 0; i < argc; ++i)
+  {
+    const char* pszVal = strchr(argv[i], '=');
+    if (pszVal == NULL)
+    {
+      fprintf(stderr, "tbcov: invalid argument \"%s\"\n", argv[i]);
+      return -1;
+    }
+    ++pszVal;
+
+    if (strncmp(argv[i], "out=", 4) == 0)
+    {
+      s_pszOutput = strdup(pszVal);
+    }
+    else if (strncmp(argv[i], "lo=", 3) == 0)
+    {
+      s_ullLo = strtoull(pszVal, NULL, 0);
+    }
+    else if (strncmp(argv[i], "hi=", 3) == 0)
+    {
+      s_ullHi = strtoull(pszVal, NULL, 0);
+    }
+    else
+    {
+      fprintf(stderr, "tbcov: unknown argument \"%s\"\n", argv[i]);
+      return -1;
+    }
+  }
+
+  s_ulVcpus = psInfo->system_emulation ? (uint32_t)psInfo->system.max_vcpus : 1u;
+  s_ppsLast = calloc(s_ulVcpus, sizeof(TbEntry*));
+
+  qemu_plugin_register_vcpu_tb_trans_cb(id, vTbTransCb);
+  qemu_plugin_register_atexit_cb(id, vExitCb, NULL);
+  return 0;
+}
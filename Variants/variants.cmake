@@ -0,0 +1,10 @@
+# Variants of the pre-release sweep: variant(<name> [<cache variable>=<value>...])
+# Omitted options use the defaults of the firmware build (see "CMakeLists.txt",
+# "Controller/hal_conf.cmake" and "Coverage/coverage.cmake").
+variant(default)
+variant(os FIRMWARE_OPTIMIZATION=-Os)
+variant(o2 FIRMWARE_OPTIMIZATION=-O2)
+variant(hal-full HAL_CONF=full)
+variant(no-systick COVERAGE_EXCLUDE_FUNCTIONS=HAL_IncTick|HAL_GetTick)
+variant(banks COVERAGE_BANKS=ON)
+variant(tickless TICKLESS_IDLE=ON)
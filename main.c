@@ -11,6 +11,10 @@
 /*- Header files -------------------------------------------------------------*/
 #include "stm32f1xx.h"
 #include "coverage.h"
+#include "memory.h"
+#include "semihost.h"
+#include "testing.h"
+#include "timebase.h"
 
 
 /*!****************************************************************************
@@ -21,9 +25,24 @@
  ******************************************************************************/
 int main(void)
 {
+  // Stack high-water mark since boot, recorded with the coverage data
+  Memory_vPaint();
   Coverage_vInit();
 
   HAL_Init();
+  Timebase_vInit();
+
+  // Test cases selected on the command line replace the demo sequence;
+  // "exit=1" ends a simulator session with the test result
+  if (Testing_bInit())
+  {
+    uint32_t ulFailed = Testing_ulRun(TESTING_OUTPUT_FILE);
+    if (Testing_lParam("exit", 0) != 0)
+    {
+      vSemihostExit((ulFailed == 0uL) ? SEMIHOST_EXIT_SUCCESS : SEMIHOST_EXIT_ERROR);
+    }
+    return 0;
+  }
 
   __HAL_RCC_GPIOC_CLK_ENABLE();
   HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_SET);
@@ -40,6 +59,6 @@ int main(void)
     HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13);
   }
 
-  Coverage_vDump("build/coverage.bin");
+  Coverage_vDump(COVERAGE_OUTPUT_FILE);
 }
 
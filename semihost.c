@@ -155,7 +155,8 @@ uint32_t ulSemihostGetCmdline(void* pBuf, uint32_t ulSize)
 {
   uint32_t aulArgs[2] = { (uint32_t)pBuf, ulSize };
   uint64_t ullResult = ullSemihostReqOp(SYS_GET_CMDLINE, (uint32_t)aulArgs);
-  return ((uint32_t)ullResult == 0uL) ? (ullResult >> 32) : 0uL;
+  // The host stores the string length in the second word of the block
+  return ((uint32_t)ullResult == 0uL) ? aulArgs[1] : 0uL;
 }
 
 /*!****************************************************************************
@@ -530,3 +531,22 @@ bool bSemihostGetHeapInfo(Semihost_HeapInfo* psInfo)
   return ((psInfo->pHeapBase  != NULL) && (psInfo->pHeapLimit  != NULL) && \
           (psInfo->pStackBase != NULL) && (psInfo->pStackLimit != NULL));
 }
+
+/*!****************************************************************************
+ * @brief
+ * Report application exit to the host
+ *
+ * Uses the "SYS_EXIT" [1] command. Simulators (e.g. QEMU, armsim) terminate
+ * with exit status 0 for @c SEMIHOST_EXIT_SUCCESS, and 1 for other reasons;
+ * a debugger halts the target.
+ *
+ * References:
+ * [1] https://developer.arm.com/documentation/dui0203/j/semihosting/semihosting-operations/angel-swireason-reportexception--0x18-
+ *
+ * @param[in] ulReason  Exit reason "SEMIHOST_EXIT_..." (passed in r1 directly)
+ * @date  17.10.2026
+ ******************************************************************************/
+void vSemihostExit(uint32_t ulReason)
+{
+  (void)ullSemihostReqOp(SYS_EXIT, ulReason);
+}
@@ -24,6 +24,12 @@
 #define SEMIHOST_STDERR               2L  ///< stderr
 /*! @}                                                                        */
 
+/*! @brief Exit reasons for @c vSemihostExit
+ *  @{                                                                        */
+#define SEMIHOST_EXIT_SUCCESS         0x20026uL ///< ADP_Stopped_ApplicationExit
+#define SEMIHOST_EXIT_ERROR           0x20023uL ///< ADP_Stopped_RunTimeErrorUnknown
+/*! @}                                                                        */
+
 
 /*- Type definitions ---------------------------------------------------------*/
 /// System heap information returned by @c bSemihostGetHeapInfo
@@ -75,5 +81,6 @@ uint32_t ulSemihostGetTickFreq(void);
 
 // Miscellaneous
 bool bSemihostGetHeapInfo(Semihost_HeapInfo* psInfo);
+void vSemihostExit(uint32_t ulReason);
 
 #endif // SEMIHOST_H_